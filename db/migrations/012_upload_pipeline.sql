@@ -0,0 +1,96 @@
+-- Migration 012: Single round-trip upload pipeline
+-- Versions were allocated with MAX(version)+1 in a separate transaction, so
+-- concurrent uploads to the same named config could race for a version.
+-- A counter row per (service_name, config_name) now hands out versions under
+-- a row lock, and create_config_version() writes metadata, content and the
+-- audit row in the same statement.
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Version Counters
+-- ═══════════════════════════════════════════════════════════════════
+
+CREATE TABLE IF NOT EXISTS config_version_counters (
+    service_name VARCHAR(255) NOT NULL,
+    config_name  VARCHAR(255) NOT NULL,
+    last_version BIGINT       NOT NULL,
+    PRIMARY KEY (service_name, config_name)
+);
+
+-- Seed counters from existing versions
+INSERT INTO config_version_counters (service_name, config_name, last_version)
+SELECT service_name, config_name, MAX(version)
+FROM config_metadata
+GROUP BY service_name, config_name
+ON CONFLICT (service_name, config_name) DO UPDATE
+    SET last_version = GREATEST(config_version_counters.last_version, EXCLUDED.last_version);
+
+-- ═══════════════════════════════════════════════════════════════════
+-- create_config_version
+-- ═══════════════════════════════════════════════════════════════════
+-- Allocates the next version and stores it. Concurrent calls for the same
+-- named config serialize on its counter row; different named configs do not
+-- contend. The first version of a named config is auto-activated, as is any
+-- version created with p_activate (rollbacks).
+-- p_audit_details NULL records 'Version N'.
+
+CREATE OR REPLACE FUNCTION create_config_version(
+    p_service_name  VARCHAR,
+    p_config_name   VARCHAR,
+    p_format        VARCHAR,
+    p_created_by    VARCHAR,
+    p_description   TEXT,
+    p_content       TEXT,
+    p_content_hash  VARCHAR,
+    p_audit_action  VARCHAR,
+    p_performed_by  VARCHAR,
+    p_audit_details TEXT,
+    p_activate      BOOLEAN DEFAULT false
+)
+RETURNS TABLE (config_id VARCHAR, version BIGINT, is_active BOOLEAN) AS $$
+#variable_conflict use_column
+DECLARE
+    v_version   BIGINT;
+    v_config_id VARCHAR;
+    v_active    BOOLEAN;
+BEGIN
+    INSERT INTO config_version_counters AS c (service_name, config_name, last_version)
+    VALUES (p_service_name, p_config_name,
+            COALESCE((SELECT MAX(m.version) FROM config_metadata m
+                      WHERE m.service_name = p_service_name
+                        AND m.config_name = p_config_name), 0) + 1)
+    ON CONFLICT (service_name, config_name) DO UPDATE
+        SET last_version = c.last_version + 1
+    RETURNING c.last_version INTO v_version;
+
+    -- The distribution service rebuilds this id from Kafka events
+    v_config_id := p_service_name || '-' || p_config_name || '-v' || v_version;
+
+    v_active := p_activate OR NOT EXISTS (
+        SELECT 1 FROM config_metadata m
+        WHERE m.service_name = p_service_name AND m.config_name = p_config_name);
+
+    IF p_activate THEN
+        UPDATE config_metadata m SET is_active = false
+        WHERE m.service_name = p_service_name AND m.config_name = p_config_name
+          AND m.is_active;
+    END IF;
+
+    INSERT INTO config_metadata
+        (config_id, service_name, config_name, version, format, created_by, description, is_active)
+    VALUES
+        (v_config_id, p_service_name, p_config_name, v_version, p_format, p_created_by,
+         p_description, v_active);
+
+    INSERT INTO config_data (config_id, content, content_hash, size_bytes)
+    VALUES (v_config_id, p_content, p_content_hash, octet_length(p_content));
+
+    INSERT INTO audit_log (config_id, action, performed_by, details)
+    VALUES (v_config_id, p_audit_action, p_performed_by,
+            jsonb_build_object('service_name', p_service_name::text,
+                               'details', COALESCE(p_audit_details, 'Version ' || v_version)));
+
+    RETURN QUERY SELECT v_config_id, v_version, v_active;
+END;
+$$ LANGUAGE plpgsql;
+
+SELECT '012: Upload pipeline migration complete' AS status;
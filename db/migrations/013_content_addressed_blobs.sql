@@ -0,0 +1,159 @@
+-- Migration 013: Content-addressed config bodies
+-- config_data now points at config_blobs by content_hash (lower-case hex
+-- SHA-256) instead of holding its own copy of the content, so identical
+-- uploads and rollbacks share one body. Earlier builds stored non-portable
+-- std::hash values in content_hash; those are recomputed here.
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Config Blobs
+-- ═══════════════════════════════════════════════════════════════════
+
+CREATE TABLE IF NOT EXISTS config_blobs (
+    content_hash VARCHAR(64) PRIMARY KEY,
+    content      TEXT        NOT NULL,
+    size_bytes   BIGINT      NOT NULL,
+    created_at   TIMESTAMP DEFAULT CURRENT_TIMESTAMP
+);
+
+-- Re-hash existing bodies with SHA-256 and move them into config_blobs (once: the
+-- content column is gone after the first run)
+DO $$
+BEGIN
+    IF EXISTS (SELECT 1 FROM information_schema.columns
+               WHERE table_name = 'config_data' AND column_name = 'content') THEN
+        UPDATE config_data
+        SET content_hash = encode(sha256(convert_to(content, 'UTF8')), 'hex');
+
+        INSERT INTO config_blobs (content_hash, content, size_bytes)
+        SELECT DISTINCT ON (content_hash) content_hash, content, octet_length(content)
+        FROM config_data
+        ON CONFLICT (content_hash) DO NOTHING;
+
+        ALTER TABLE config_data DROP COLUMN content;
+    END IF;
+END $$;
+
+ALTER TABLE config_data DROP CONSTRAINT IF EXISTS config_data_content_hash_fkey;
+ALTER TABLE config_data
+    ADD CONSTRAINT config_data_content_hash_fkey
+    FOREIGN KEY (content_hash) REFERENCES config_blobs (content_hash);
+
+CREATE INDEX IF NOT EXISTS idx_config_data_content_hash ON config_data (content_hash);
+
+-- ═══════════════════════════════════════════════════════════════════
+-- create_config_version (replaces the 012 version)
+-- ═══════════════════════════════════════════════════════════════════
+-- p_content may be NULL when the blob for p_content_hash already exists
+-- (rollbacks), so multi-MB bodies are not sent or stored again.
+-- With p_skip_unchanged, an upload whose hash equals the latest version's
+-- returns that version with unchanged = true and creates nothing.
+-- Concurrent calls for the same config serialize on its config_version_counters
+-- row, taken before the unchanged check, so two identical uploads cannot both
+-- see a change. The blob row is key-share locked too (uploads never block each
+-- other on it), so a concurrent delete's cleanup cannot remove it before
+-- config_data references it.
+
+DROP FUNCTION IF EXISTS create_config_version(VARCHAR, VARCHAR, VARCHAR, VARCHAR, TEXT, TEXT,
+                                              VARCHAR, VARCHAR, VARCHAR, TEXT, BOOLEAN);
+
+CREATE OR REPLACE FUNCTION create_config_version(
+    p_service_name    VARCHAR,
+    p_config_name     VARCHAR,
+    p_format          VARCHAR,
+    p_created_by      VARCHAR,
+    p_description     TEXT,
+    p_content         TEXT,
+    p_content_hash    VARCHAR,
+    p_audit_action    VARCHAR,
+    p_performed_by    VARCHAR,
+    p_audit_details   TEXT,
+    p_activate        BOOLEAN DEFAULT false,
+    p_skip_unchanged  BOOLEAN DEFAULT false
+)
+RETURNS TABLE (config_id VARCHAR, version BIGINT, is_active BOOLEAN, unchanged BOOLEAN) AS $$
+#variable_conflict use_column
+DECLARE
+    v_version   BIGINT;
+    v_config_id VARCHAR;
+    v_active    BOOLEAN;
+    v_size      BIGINT;
+BEGIN
+    -- Make sure the counter row exists, then lock it
+    INSERT INTO config_version_counters AS c (service_name, config_name, last_version)
+    VALUES (p_service_name, p_config_name,
+            COALESCE((SELECT MAX(m.version) FROM config_metadata m
+                      WHERE m.service_name = p_service_name
+                        AND m.config_name = p_config_name), 0))
+    ON CONFLICT (service_name, config_name) DO NOTHING;
+
+    PERFORM 1 FROM config_version_counters c
+    WHERE c.service_name = p_service_name AND c.config_name = p_config_name
+    FOR UPDATE;
+
+    IF p_skip_unchanged THEN
+        SELECT m.config_id, m.version, m.is_active
+        INTO v_config_id, v_version, v_active
+        FROM config_metadata m
+        JOIN config_data d ON d.config_id = m.config_id
+        WHERE m.service_name = p_service_name AND m.config_name = p_config_name
+          AND d.content_hash = p_content_hash
+          AND m.version = (SELECT MAX(m2.version) FROM config_metadata m2
+                           WHERE m2.service_name = p_service_name
+                             AND m2.config_name = p_config_name);
+        IF FOUND THEN
+            RETURN QUERY SELECT v_config_id, v_version, v_active, true;
+            RETURN;
+        END IF;
+    END IF;
+
+    -- Lock the blob, storing it first if missing (again if a cleanup removed it meanwhile)
+    LOOP
+        SELECT b.size_bytes INTO v_size FROM config_blobs b
+        WHERE b.content_hash = p_content_hash
+        FOR KEY SHARE;
+        EXIT WHEN FOUND OR p_content IS NULL;
+
+        INSERT INTO config_blobs (content_hash, content, size_bytes)
+        VALUES (p_content_hash, p_content, octet_length(p_content))
+        ON CONFLICT (content_hash) DO NOTHING;
+    END LOOP;
+    IF v_size IS NULL THEN
+        RAISE EXCEPTION 'No stored content for hash %', p_content_hash;
+    END IF;
+
+    UPDATE config_version_counters c SET last_version = c.last_version + 1
+    WHERE c.service_name = p_service_name AND c.config_name = p_config_name
+    RETURNING c.last_version INTO v_version;
+
+    -- The distribution service rebuilds this id from Kafka events
+    v_config_id := p_service_name || '-' || p_config_name || '-v' || v_version;
+
+    v_active := p_activate OR NOT EXISTS (
+        SELECT 1 FROM config_metadata m
+        WHERE m.service_name = p_service_name AND m.config_name = p_config_name);
+
+    IF p_activate THEN
+        UPDATE config_metadata m SET is_active = false
+        WHERE m.service_name = p_service_name AND m.config_name = p_config_name
+          AND m.is_active;
+    END IF;
+
+    INSERT INTO config_metadata
+        (config_id, service_name, config_name, version, format, created_by, description, is_active)
+    VALUES
+        (v_config_id, p_service_name, p_config_name, v_version, p_format, p_created_by,
+         p_description, v_active);
+
+    INSERT INTO config_data (config_id, content_hash, size_bytes)
+    VALUES (v_config_id, p_content_hash, v_size);
+
+    INSERT INTO audit_log (config_id, action, performed_by, details)
+    VALUES (v_config_id, p_audit_action, p_performed_by,
+            jsonb_build_object('service_name', p_service_name::text,
+                               'details', COALESCE(p_audit_details, 'Version ' || v_version)));
+
+    RETURN QUERY SELECT v_config_id, v_version, v_active, false;
+END;
+$$ LANGUAGE plpgsql;
+
+SELECT '013: Content-addressed blobs migration complete' AS status;
@@ -0,0 +1,24 @@
+-- Migration 014: Keyset pagination indexes
+-- ListConfigs and GetAuditLog page with opaque cursors instead of OFFSET, so
+-- each page is an index range scan starting right after the previous page.
+--
+-- ListConfigs walks config_metadata_service_config_version_key
+-- (service_name, config_name, version) backwards and needs nothing new.
+-- GetAuditLog orders by (created_at DESC, id DESC); id breaks ties between
+-- rows written in the same transaction.
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Audit Log
+-- ═══════════════════════════════════════════════════════════════════
+
+CREATE INDEX IF NOT EXISTS idx_audit_created_at_id
+    ON audit_log (created_at DESC, id DESC);
+
+-- Service-filtered audit pages (service_name lives in details)
+CREATE INDEX IF NOT EXISTS idx_audit_service_created_at_id
+    ON audit_log ((details->>'service_name'), created_at DESC, id DESC);
+
+-- Superseded by idx_audit_created_at_id
+DROP INDEX IF EXISTS idx_audit_created_at;
+
+SELECT '014: Keyset pagination migration complete' AS status;
@@ -0,0 +1,182 @@
+-- Migration 015: Incrementally maintained summaries
+-- GetStats, ListServices and ListNamedConfigs aggregated config_metadata and
+-- rollout_state on every call, so their cost grew with version history.
+-- Triggers now keep one summary row per named config (plus a counter row for
+-- active schemas) and the RPCs read those instead.
+--
+-- Writes to a named config touch only its own summary row, which uploads
+-- already serialize on through config_version_counters, so there is no new
+-- global hot row on the upload path.
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Named Config Summaries
+-- ═══════════════════════════════════════════════════════════════════
+
+CREATE TABLE IF NOT EXISTS named_config_summaries (
+    service_name      VARCHAR(255) NOT NULL,
+    config_name       VARCHAR(255) NOT NULL,
+    version_count     BIGINT       NOT NULL DEFAULT 0,
+    latest_version    BIGINT       NOT NULL DEFAULT 0,
+    latest_created_at TIMESTAMP,
+    format            VARCHAR(50),
+    active_rollouts   INTEGER      NOT NULL DEFAULT 0,  -- PENDING / IN_PROGRESS
+    PRIMARY KEY (service_name, config_name)
+);
+
+CREATE OR REPLACE FUNCTION maintain_named_config_summary()
+RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP = 'INSERT' THEN
+        INSERT INTO named_config_summaries AS s
+            (service_name, config_name, version_count, latest_version, latest_created_at, format)
+        VALUES (NEW.service_name, NEW.config_name, 1, NEW.version, NEW.created_at, NEW.format)
+        ON CONFLICT (service_name, config_name) DO UPDATE SET
+            version_count     = s.version_count + 1,
+            format            = CASE WHEN EXCLUDED.latest_version > s.latest_version
+                                     THEN EXCLUDED.format ELSE s.format END,
+            latest_version    = GREATEST(s.latest_version, EXCLUDED.latest_version),
+            latest_created_at = GREATEST(s.latest_created_at, EXCLUDED.latest_created_at);
+        RETURN NULL;
+    END IF;
+
+    -- DELETE
+    UPDATE named_config_summaries s SET version_count = s.version_count - 1
+    WHERE s.service_name = OLD.service_name AND s.config_name = OLD.config_name;
+
+    DELETE FROM named_config_summaries s
+    WHERE s.service_name = OLD.service_name AND s.config_name = OLD.config_name
+      AND s.version_count <= 0;
+
+    -- Deleting the newest version: step back to the next one (one index probe)
+    UPDATE named_config_summaries s
+    SET (latest_version, latest_created_at, format) = (
+        SELECT m.version, m.created_at, m.format
+        FROM config_metadata m
+        WHERE m.service_name = OLD.service_name AND m.config_name = OLD.config_name
+        ORDER BY m.version DESC
+        LIMIT 1)
+    WHERE s.service_name = OLD.service_name AND s.config_name = OLD.config_name
+      AND s.latest_version = OLD.version;
+
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE OR REPLACE FUNCTION maintain_rollout_summary()
+RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP = 'UPDATE' AND OLD.status IS NOT DISTINCT FROM NEW.status
+       AND OLD.config_id IS NOT DISTINCT FROM NEW.config_id THEN
+        RETURN NULL;
+    END IF;
+
+    IF TG_OP <> 'INSERT' AND OLD.status IN ('IN_PROGRESS', 'PENDING') THEN
+        UPDATE named_config_summaries s SET active_rollouts = s.active_rollouts - 1
+        FROM config_metadata m
+        WHERE m.config_id = OLD.config_id
+          AND s.service_name = m.service_name AND s.config_name = m.config_name;
+    END IF;
+
+    IF TG_OP <> 'DELETE' AND NEW.status IN ('IN_PROGRESS', 'PENDING') THEN
+        UPDATE named_config_summaries s SET active_rollouts = s.active_rollouts + 1
+        FROM config_metadata m
+        WHERE m.config_id = NEW.config_id
+          AND s.service_name = m.service_name AND s.config_name = m.config_name;
+    END IF;
+
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Global Counters
+-- ═══════════════════════════════════════════════════════════════════
+
+CREATE TABLE IF NOT EXISTS konfig_counters (
+    name  VARCHAR(64) PRIMARY KEY,
+    value BIGINT      NOT NULL DEFAULT 0
+);
+
+CREATE OR REPLACE FUNCTION maintain_schema_counter()
+RETURNS TRIGGER AS $$
+DECLARE
+    v_delta INTEGER := 0;
+BEGIN
+    IF TG_OP <> 'INSERT' AND OLD.is_active THEN
+        v_delta := v_delta - 1;
+    END IF;
+    IF TG_OP <> 'DELETE' AND NEW.is_active THEN
+        v_delta := v_delta + 1;
+    END IF;
+
+    IF v_delta <> 0 THEN
+        UPDATE konfig_counters SET value = value + v_delta WHERE name = 'active_schemas';
+    END IF;
+
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Backfill and Triggers
+-- ═══════════════════════════════════════════════════════════════════
+-- One transaction with the source tables locked, so no write slips in
+-- between the backfill and the triggers becoming active.
+
+BEGIN;
+
+LOCK TABLE config_metadata, rollout_state, validation_schemas IN SHARE ROW EXCLUSIVE MODE;
+
+TRUNCATE named_config_summaries;
+
+INSERT INTO named_config_summaries
+    (service_name, config_name, version_count, latest_version, latest_created_at, format)
+SELECT DISTINCT ON (service_name, config_name)
+    service_name, config_name,
+    COUNT(*) OVER (PARTITION BY service_name, config_name),
+    version,
+    created_at,
+    format
+FROM config_metadata
+ORDER BY service_name, config_name, version DESC;
+
+UPDATE named_config_summaries s
+SET active_rollouts = a.active
+FROM (SELECT m.service_name, m.config_name, COUNT(*) AS active
+      FROM rollout_state r
+      JOIN config_metadata m ON m.config_id = r.config_id
+      WHERE r.status IN ('IN_PROGRESS', 'PENDING')
+      GROUP BY m.service_name, m.config_name) a
+WHERE s.service_name = a.service_name AND s.config_name = a.config_name;
+
+INSERT INTO konfig_counters (name, value)
+SELECT 'active_schemas', COUNT(*) FROM validation_schemas WHERE is_active = true
+ON CONFLICT (name) DO UPDATE SET value = EXCLUDED.value;
+
+DROP TRIGGER IF EXISTS named_config_summary_sync ON config_metadata;
+CREATE TRIGGER named_config_summary_sync
+    AFTER INSERT OR DELETE ON config_metadata
+    FOR EACH ROW EXECUTE FUNCTION maintain_named_config_summary();
+
+DROP TRIGGER IF EXISTS rollout_summary_sync ON rollout_state;
+CREATE TRIGGER rollout_summary_sync
+    AFTER INSERT OR DELETE OR UPDATE OF status, config_id ON rollout_state
+    FOR EACH ROW EXECUTE FUNCTION maintain_rollout_summary();
+
+DROP TRIGGER IF EXISTS schema_counter_sync ON validation_schemas;
+CREATE TRIGGER schema_counter_sync
+    AFTER INSERT OR DELETE OR UPDATE OF is_active ON validation_schemas
+    FOR EACH ROW EXECUTE FUNCTION maintain_schema_counter();
+
+COMMIT;
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Connected Instances
+-- ═══════════════════════════════════════════════════════════════════
+-- Liveness is time-based and cannot be kept by triggers; this index turns
+-- the heartbeat count into a range scan over recently seen instances only.
+
+CREATE INDEX IF NOT EXISTS idx_service_instances_heartbeat
+    ON service_instances (last_heartbeat);
+
+SELECT '015: Summary counters migration complete' AS status;
@@ -0,0 +1,54 @@
+-- Migration 016: Validation rule set versions
+-- The validation service compiles each service's rules once and caches the
+-- result. Rules are edited directly in SQL, so a trigger bumps a per-service
+-- version on every change and the service compares that single row against
+-- the version it compiled instead of reloading every rule per request.
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Rule Set Versions
+-- ═══════════════════════════════════════════════════════════════════
+
+CREATE TABLE IF NOT EXISTS validation_rule_versions (
+    service_name VARCHAR(255) PRIMARY KEY,
+    version      BIGINT    NOT NULL DEFAULT 1,
+    updated_at   TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP
+);
+
+CREATE OR REPLACE FUNCTION bump_validation_rule_version(p_service_name VARCHAR)
+RETURNS VOID AS $$
+BEGIN
+    INSERT INTO validation_rule_versions AS v (service_name)
+    VALUES (p_service_name)
+    ON CONFLICT (service_name) DO UPDATE SET
+        version    = v.version + 1,
+        updated_at = CURRENT_TIMESTAMP;
+END;
+$$ LANGUAGE plpgsql;
+
+CREATE OR REPLACE FUNCTION maintain_validation_rule_version()
+RETURNS TRIGGER AS $$
+BEGIN
+    IF TG_OP IN ('UPDATE', 'DELETE') THEN
+        PERFORM bump_validation_rule_version(OLD.service_name);
+    END IF;
+    IF TG_OP = 'INSERT' OR (TG_OP = 'UPDATE' AND NEW.service_name <> OLD.service_name) THEN
+        PERFORM bump_validation_rule_version(NEW.service_name);
+    END IF;
+    RETURN NULL;
+END;
+$$ LANGUAGE plpgsql;
+
+BEGIN;
+
+INSERT INTO validation_rule_versions (service_name)
+SELECT DISTINCT service_name FROM validation_rules
+ON CONFLICT (service_name) DO NOTHING;
+
+DROP TRIGGER IF EXISTS validation_rule_version_sync ON validation_rules;
+CREATE TRIGGER validation_rule_version_sync
+    AFTER INSERT OR UPDATE OR DELETE ON validation_rules
+    FOR EACH ROW EXECUTE FUNCTION maintain_validation_rule_version();
+
+COMMIT;
+
+SELECT '016: Validation rule versions migration complete' AS status;
@@ -0,0 +1,95 @@
+-- Migration 017: Deduplicated, prunable validation history
+-- validation_history copied every validated body into config_content. Rows
+-- now reference config_blobs by content_hash (the same SHA-256 the API
+-- stores uploads under), so re-validating an uploaded config stores nothing
+-- new. repeat_count folds identical validations written in one batch into a
+-- single row. prune_validation_history() enforces the retention window and
+-- drops bodies nothing references any more.
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Content by hash
+-- ═══════════════════════════════════════════════════════════════════
+
+ALTER TABLE validation_history ADD COLUMN IF NOT EXISTS content_hash VARCHAR(64);
+ALTER TABLE validation_history ADD COLUMN IF NOT EXISTS repeat_count INTEGER NOT NULL DEFAULT 1;
+
+DO $$
+BEGIN
+    IF EXISTS (SELECT 1 FROM information_schema.columns
+               WHERE table_name = 'validation_history' AND column_name = 'config_content') THEN
+        UPDATE validation_history
+        SET content_hash = encode(sha256(convert_to(config_content, 'UTF8')), 'hex')
+        WHERE content_hash IS NULL;
+
+        INSERT INTO config_blobs (content_hash, content, size_bytes)
+        SELECT DISTINCT ON (content_hash) content_hash, config_content,
+               octet_length(config_content)
+        FROM validation_history
+        ON CONFLICT (content_hash) DO NOTHING;
+
+        ALTER TABLE validation_history DROP COLUMN config_content;
+    END IF;
+END $$;
+
+ALTER TABLE validation_history ALTER COLUMN content_hash SET NOT NULL;
+
+ALTER TABLE validation_history DROP CONSTRAINT IF EXISTS validation_history_content_hash_fkey;
+ALTER TABLE validation_history
+    ADD CONSTRAINT validation_history_content_hash_fkey
+    FOREIGN KEY (content_hash) REFERENCES config_blobs (content_hash);
+
+CREATE INDEX IF NOT EXISTS idx_validation_history_content_hash
+    ON validation_history (content_hash);
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Retention
+-- ═══════════════════════════════════════════════════════════════════
+-- Deletes at most p_batch_size rows older than p_retention_days, then the
+-- bodies of those rows that neither config_data nor newer history uses.
+-- Returns the number of history rows deleted; callers repeat while it
+-- equals p_batch_size.
+
+CREATE OR REPLACE FUNCTION prune_validation_history(
+    p_retention_days INTEGER,
+    p_batch_size     INTEGER DEFAULT 10000
+)
+RETURNS INTEGER AS $$
+DECLARE
+    v_hashes  VARCHAR[];
+    v_deleted INTEGER;
+BEGIN
+    WITH doomed AS (
+        DELETE FROM validation_history
+        WHERE id IN (SELECT id FROM validation_history
+                     WHERE validated_at < NOW() - make_interval(days => p_retention_days)
+                     ORDER BY id
+                     LIMIT p_batch_size)
+        RETURNING content_hash
+    )
+    SELECT array_agg(DISTINCT content_hash), COUNT(*) INTO v_hashes, v_deleted FROM doomed;
+
+    DELETE FROM config_blobs b
+    WHERE b.content_hash = ANY (v_hashes)
+      AND NOT EXISTS (SELECT 1 FROM config_data d WHERE d.content_hash = b.content_hash)
+      AND NOT EXISTS (SELECT 1 FROM validation_history h WHERE h.content_hash = b.content_hash);
+
+    RETURN v_deleted;
+END;
+$$ LANGUAGE plpgsql;
+
+-- ═══════════════════════════════════════════════════════════════════
+-- Views
+-- ═══════════════════════════════════════════════════════════════════
+
+CREATE OR REPLACE VIEW validation_stats AS
+SELECT
+    service_name,
+    SUM(repeat_count) as total_validations,
+    SUM(CASE WHEN validation_result = true THEN repeat_count ELSE 0 END) as successful,
+    SUM(CASE WHEN validation_result = false THEN repeat_count ELSE 0 END) as failed,
+    ROUND(100.0 * SUM(CASE WHEN validation_result = true THEN repeat_count ELSE 0 END) /
+          NULLIF(SUM(repeat_count), 0), 2) as success_rate
+FROM validation_history
+GROUP BY service_name;
+
+SELECT '017: Validation history blobs migration complete' AS status;
@@ -12,6 +12,13 @@
 \i /docker-entrypoint-initdb.d/migrations/008_permissions.sql
 \i /docker-entrypoint-initdb.d/migrations/009_named_configs.sql
 \i /docker-entrypoint-initdb.d/migrations/010_fix_active_flag.sql
+\i /docker-entrypoint-initdb.d/migrations/011_service_tokens.sql
+\i /docker-entrypoint-initdb.d/migrations/012_upload_pipeline.sql
+\i /docker-entrypoint-initdb.d/migrations/013_content_addressed_blobs.sql
+\i /docker-entrypoint-initdb.d/migrations/014_keyset_pagination.sql
+\i /docker-entrypoint-initdb.d/migrations/015_summary_counters.sql
+\i /docker-entrypoint-initdb.d/migrations/016_validation_rule_versions.sql
+\i /docker-entrypoint-initdb.d/migrations/017_validation_history_blobs.sql
 
 -- Log completion
 SELECT 'All migrations applied successfully' as status;
@@ -0,0 +1,172 @@
+#include "jsonscan/json_scanner.h"
+#include "validation_service/incremental.h"
+#include "validation_service/json_schema.h"
+#include "validation_service/rule_set.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// libFuzzer target for incremental validation: the input is edited a byte at a time, and
+// every edit that still parses is validated in full and against the version before it, the
+// base diffed by text (as JSON is) and node by node (as YAML and TOML are). Rules and schema
+// must find exactly the same errors either way. More edits are made than a chain of records
+// is long, so copying the base verdicts in is covered too.
+
+namespace {
+
+const char kSchema[] = R"({
+  "type": "object",
+  "properties": {
+    "services": {
+      "type": "object",
+      "additionalProperties": {"$ref": "#/$defs/service"}
+    },
+    "list": {"type": "array", "items": {"$ref": "#/$defs/service"}, "maxItems": 8},
+    "settings": {
+      "oneOf": [
+        {"type": "object", "required": ["max_connections"]},
+        {"type": "array", "uniqueItems": true}
+      ]
+    }
+  },
+  "anyOf": [{"required": ["service"]}, {"required": ["services"]}],
+  "$defs": {
+    "service": {
+      "type": "object",
+      "properties": {
+        "port": {"type": "integer", "minimum": 1, "maximum": 65535},
+        "host": {"type": "string", "pattern": "^[a-z0-9.-]+$"},
+        "tags": {"type": "array", "items": {"type": "string"}, "uniqueItems": true},
+        "nested": {"$ref": "#/$defs/service"}
+      },
+      "required": ["port"],
+      "not": {"required": ["disabled"]}
+    }
+  }
+})";
+
+std::shared_ptr<const validationservice::CompiledRuleSet> BuildRules() {
+    std::vector<validationservice::ValidationRule> rules = {
+        {"r1", "fuzz", "service", "required", "{}", "service is required"},
+        {"r2", "fuzz", "services.*.port", "range", "{\"min\": 1, \"max\": 65535}", "bad port"},
+        {"r3", "fuzz", "*.*.host", "format", "{\"pattern\": \"^[a-z0-9.-]+$\"}", "bad host"},
+        {"r4", "fuzz", "*.database.host", "required", "{}", "database host is required"},
+    };
+    return validationservice::CompiledRuleSet::Compile(rules, 1);
+}
+
+// A validated version, diffed both ways: by text, and numbered by AssignPositions()
+struct Version {
+    std::string text;
+    jsonscan::Value document;
+    jsonscan::Value numbered;
+    std::shared_ptr<validationservice::PassRecord> records[4];  // Rules, schema; numbered too
+};
+
+bool Same(const std::vector<configservice::ValidationError>& a,
+          const std::vector<configservice::ValidationError>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].field() != b[i].field() || a[i].error_type() != b[i].error_type() ||
+            a[i].message() != b[i].message()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Rules then schema, as ValidateConfig runs them
+std::vector<configservice::ValidationError> Validate(
+    const jsonscan::Value& document, validationservice::IncrementalPass* rule_pass,
+    validationservice::IncrementalPass* schema_pass) {
+    static const auto schema = validationservice::CompiledSchema::Compile(kSchema);
+    static const auto rules = BuildRules();
+
+    std::vector<configservice::ValidationError> errors;
+    rules->Evaluate(document, errors, nullptr, rule_pass);
+    schema->Validate(document, errors, nullptr, schema_pass);
+    return errors;
+}
+
+// Validates version in full and against base (when there is one), recording its verdicts;
+// false if the base's records could not serve as one (cut short at the error limit)
+bool Check(Version& version, const Version* base) {
+    using validationservice::DocumentDiff;
+    using validationservice::IncrementalPass;
+    using validationservice::PassRecord;
+
+    auto full = Validate(version.document, nullptr, nullptr);
+
+    std::shared_ptr<const DocumentDiff> diffs[2];
+    if (base) {
+        diffs[0] = std::make_shared<DocumentDiff>(version.document, version.text,
+                                                  base->document, base->text);
+        diffs[1] = std::make_shared<DocumentDiff>(version.numbered, base->numbered);
+    }
+    for (int way = 0; way < 2; ++way) {
+        for (int pass = 0; pass < 2; ++pass) {
+            version.records[2 * way + pass] = std::make_shared<PassRecord>();
+        }
+        IncrementalPass rule_pass(version.records[2 * way].get(), diffs[way],
+                                  base ? base->records[2 * way] : nullptr);
+        IncrementalPass schema_pass(version.records[2 * way + 1].get(), diffs[way],
+                                    base ? base->records[2 * way + 1] : nullptr);
+        const auto& document = way == 0 ? version.document : version.numbered;
+        if (!Same(full, Validate(document, &rule_pass, &schema_pass))) {
+            __builtin_trap();
+        }
+    }
+    return version.records[1]->errors.size() < validationservice::CompiledSchema::kMaxErrors;
+}
+
+}  // anonymous namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size == 0) {
+        return 0;
+    }
+
+    auto base = std::make_unique<Version>();
+    base->text.assign(reinterpret_cast<const char*>(data), size);
+    if (!jsonscan::Parse(base->text, base->document).valid) {
+        return 0;
+    }
+    base->numbered = base->document;
+    validationservice::AssignPositions(base->numbered);
+    if (!Check(*base, nullptr)) {
+        return 0;
+    }
+
+    // Deletes, repeats or overwrites (with another byte of the input) one byte at a time
+    for (size_t edit = 0; edit < 2 * validationservice::PassRecord::kMaxChain; ++edit) {
+        auto version = std::make_unique<Version>();
+        version->text = base->text;
+        size_t at = (edit * 2654435761u + size) % version->text.size();
+        switch (edit % 3) {
+            case 0:
+                version->text.erase(at, 1);
+                break;
+            case 1:
+                version->text.insert(at, 1, version->text[at]);
+                break;
+            default:
+                version->text[at] = static_cast<char>(data[(at * 31 + edit) % size]);
+                break;
+        }
+        if (version->text.empty() ||
+            !jsonscan::Parse(version->text, version->document).valid) {
+            continue;
+        }
+        version->numbered = version->document;
+        validationservice::AssignPositions(version->numbered);
+        if (Check(*version, base.get())) {
+            base = std::move(version);
+        }
+    }
+    return 0;
+}
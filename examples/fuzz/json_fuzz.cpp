@@ -0,0 +1,52 @@
+#include "jsonscan/json_scanner.h"
+#include "validation_service/json_validator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// libFuzzer target for JsonValidator: the syntax scan and the tree build must agree on every
+// input, and a parsed document must survive the compiled schema below.
+
+namespace {
+
+const char kSchema[] = R"({
+  "type": "object",
+  "properties": {
+    "services": {
+      "type": "object",
+      "additionalProperties": {
+        "type": "object",
+        "properties": {
+          "port": {"type": "integer", "minimum": 1, "maximum": 65535},
+          "host": {"type": "string", "pattern": "^[a-z0-9.-]+$"},
+          "tags": {"type": "array", "items": {"type": "string"}, "uniqueItems": true}
+        },
+        "required": ["port"]
+      }
+    }
+  },
+  "anyOf": [{"required": ["service"]}, {"required": ["services"]}]
+})";
+
+}  // anonymous namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static const auto schema = validationservice::CompiledSchema::Compile(kSchema);
+
+    std::string content(reinterpret_cast<const char*>(data), size);
+    validationservice::JsonValidator validator;
+    std::vector<configservice::ValidationError> errors;
+    bool valid = validator.ValidateSyntax(content, errors);
+
+    jsonscan::Value document;
+    std::vector<configservice::ValidationError> parse_errors;
+    if (validator.Parse(content, document, parse_errors) != valid) {
+        __builtin_trap();
+    }
+    if (valid) {
+        validator.ValidateSchema(document, *schema, errors);
+    }
+    return 0;
+}
@@ -0,0 +1,48 @@
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Stand-in for libFuzzer's main, for compilers without -fsanitize=fuzzer: runs a fuzz target
+// once over every file given, directories included (a corpus, or crash reproducers).
+//
+// Usage: <target>_replay path...
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+namespace {
+
+void RunFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string input = buffer.str();
+    LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t*>(input.data()), input.size());
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    size_t inputs = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::filesystem::path path(argv[i]);
+        if (!std::filesystem::is_directory(path)) {
+            RunFile(path);
+            ++inputs;
+            continue;
+        }
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+            if (entry.is_regular_file()) {
+                RunFile(entry.path());
+                ++inputs;
+            }
+        }
+    }
+
+    std::cout << "[FuzzReplay] " << argv[0] << ": " << inputs << " inputs, no crashes"
+              << std::endl;
+    return 0;
+}
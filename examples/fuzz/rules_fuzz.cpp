@@ -0,0 +1,47 @@
+#include "jsonscan/json_scanner.h"
+#include "validation_service/rule_set.h"
+#include "validation_service/yaml_validator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// libFuzzer target for custom rules (what ApplyCustomRules runs): a fixed rule set with
+// wildcards, evaluated on the input as a JSON tree and streamed from the input as YAML.
+
+namespace {
+
+std::shared_ptr<const validationservice::CompiledRuleSet> BuildRules() {
+    std::vector<validationservice::ValidationRule> rules = {
+        {"r1", "fuzz", "service", "required", "{}", "service is required"},
+        {"r2", "fuzz", "services.*.port", "range", "{\"min\": 1, \"max\": 65535}", "bad port"},
+        {"r3", "fuzz", "services.*.host", "format", "{\"pattern\": \"^[a-z0-9.-]+$\"}",
+         "bad host"},
+        {"r4", "fuzz", "settings.max_connections", "range", "{\"min\": 1, \"max\": 10000}",
+         "bad max_connections"},
+        {"r5", "fuzz", "*.*.*", "format", "{\"pattern\": \"[^ ]\"}", "blank value"},
+        {"r6", "fuzz", "*.database.host", "required", "{}", "database host is required"},
+    };
+    return validationservice::CompiledRuleSet::Compile(rules, 1);
+}
+
+}  // anonymous namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static const auto rules = BuildRules();
+
+    std::string content(reinterpret_cast<const char*>(data), size);
+    std::vector<configservice::ValidationError> errors;
+
+    jsonscan::Value document;
+    if (jsonscan::Parse(content, document).valid) {
+        rules->Evaluate(document, errors);
+    }
+
+    std::vector<configservice::ValidationWarning> warnings;
+    validationservice::YamlValidator validator(64, 10000);
+    validationservice::RuleStream stream(*rules, errors);
+    validator.Stream(content, &stream, errors, warnings);
+    return 0;
+}
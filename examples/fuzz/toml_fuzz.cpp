@@ -0,0 +1,21 @@
+#include "validation_service/toml_validator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// libFuzzer target for TomlValidator: syntax only and with the tree must agree
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string content(reinterpret_cast<const char*>(data), size);
+    validationservice::TomlValidator validator;
+    std::vector<configservice::ValidationError> errors;
+    bool valid = validator.ValidateSyntax(content, errors);
+
+    jsonscan::Value document;
+    if (validator.Parse(content, document, errors) != valid) {
+        __builtin_trap();
+    }
+    return 0;
+}
@@ -0,0 +1,24 @@
+#include "validation_service/yaml_validator.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// libFuzzer target for YamlValidator: syntax check, tree build and the streaming pass, with
+// limits low enough that alias bombs and deep nesting are hit quickly.
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    std::string content(reinterpret_cast<const char*>(data), size);
+    validationservice::YamlValidator validator(64, 10000);
+    std::vector<configservice::ValidationError> errors;
+    std::vector<configservice::ValidationWarning> warnings;
+
+    validator.ValidateSyntax(content, errors);
+
+    jsonscan::Value document;
+    validator.Parse(content, document, errors, warnings);
+
+    validator.Stream(content, nullptr, errors, warnings);
+    return 0;
+}
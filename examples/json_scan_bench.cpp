@@ -0,0 +1,107 @@
+#include "jsonscan/json_scanner.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Throughput benchmark for the shared JSON syntax scanner.
+//
+// Each input is scanned repeatedly for at least --seconds; reported as MB/s.
+// Besides every file as-is, two synthetic documents are built from the same inputs:
+//   array x N   - the files concatenated into one ~1 MB JSON array (the upload size limit)
+//   indented    - the same array with deep indentation, i.e. long whitespace runs
+//
+// Usage: json_scan_bench [file.json ...]   (default: examples/configs/*.json)
+
+namespace {
+
+constexpr double kMinSeconds = 0.5;
+constexpr size_t kSyntheticBytes = 1024 * 1024;
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+void Measure(const std::string& label, const std::string& json) {
+    auto scan = jsonscan::Validate(json);
+
+    size_t iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    do {
+        for (int i = 0; i < 64; ++i) {
+            scan = jsonscan::Validate(json);
+        }
+        iterations += 64;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < kMinSeconds);
+
+    double mb_per_s = static_cast<double>(json.size()) * iterations / seconds / (1024 * 1024);
+
+    std::cout << "  " << std::left << std::setw(36) << label << std::right << std::setw(10)
+              << json.size() << " B  " << std::setw(10) << std::fixed << std::setprecision(1)
+              << mb_per_s << " MB/s  " << (scan.valid ? "valid" : scan.Describe()) << std::endl;
+}
+
+std::string BuildArray(const std::vector<std::string>& documents, const std::string& indent) {
+    std::string array = "[";
+    bool first = true;
+    while (array.size() < kSyntheticBytes) {
+        for (const auto& doc : documents) {
+            array += first ? "\n" : ",\n";
+            first = false;
+            for (char c : doc) {
+                array += c;
+                if (c == '\n') {
+                    array += indent;
+                }
+            }
+        }
+    }
+    array += "\n]";
+    return array;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths(argv + 1, argv + argc);
+    if (paths.empty()) {
+        for (const auto& entry : std::filesystem::directory_iterator("examples/configs")) {
+            if (entry.path().extension() == ".json") {
+                paths.push_back(entry.path().string());
+            }
+        }
+    }
+
+    std::vector<std::string> documents;
+    std::cout << "[JsonScanBench] " << paths.size() << " input files" << std::endl;
+    std::cout << std::endl;
+
+    for (const auto& path : paths) {
+        std::string json = ReadFile(path);
+        if (json.empty()) {
+            std::cerr << "[JsonScanBench] ✗ Cannot read " << path << std::endl;
+            continue;
+        }
+        Measure(std::filesystem::path(path).filename().string(), json);
+        if (jsonscan::Validate(json).valid) {
+            documents.push_back(json);
+        }
+    }
+
+    if (!documents.empty()) {
+        Measure("array x N (~1 MB)", BuildArray(documents, "  "));
+        Measure("indented (~1 MB, 32-space indent)", BuildArray(documents, std::string(32, ' ')));
+    }
+
+    return 0;
+}
@@ -0,0 +1,236 @@
+#include "validation_service/json_schema.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Throughput benchmark for compiled JSON Schema validation.
+//
+// A service-catalog style config (an array of service entries with nested limits, labels and
+// endpoints) is generated at several sizes and validated against a schema that uses $ref,
+// required, enum, pattern, ranges, additionalProperties and uniqueItems. Reported per size:
+//   validate      - CompiledSchema::Validate on an already parsed document
+//   parse+validate - jsonscan::Parse followed by Validate, i.e. what ValidateConfig does
+// Then a series of one-port edits is validated, each against the version before it as base
+// (the diff plus an incremental Validate that records verdicts for the next edit), next to a
+// full Validate of the same documents; with and without parsing them.
+//
+// Usage: schema_bench
+
+namespace {
+
+constexpr double kMinSeconds = 0.5;
+
+const char* kSchema = R"({
+  "$schema": "https://json-schema.org/draft/2020-12/schema",
+  "type": "object",
+  "required": ["version", "services"],
+  "additionalProperties": false,
+  "properties": {
+    "version": {"type": "integer", "minimum": 1},
+    "services": {"type": "array", "items": {"$ref": "#/$defs/service"}}
+  },
+  "$defs": {
+    "service": {
+      "type": "object",
+      "required": ["name", "port", "replicas", "environment", "limits"],
+      "additionalProperties": false,
+      "properties": {
+        "name": {"type": "string", "pattern": "^[a-z][a-z0-9-]*$", "maxLength": 63},
+        "port": {"type": "integer", "minimum": 1, "maximum": 65535},
+        "replicas": {"type": "integer", "minimum": 0, "maximum": 100},
+        "environment": {"enum": ["dev", "staging", "prod"]},
+        "limits": {
+          "type": "object",
+          "required": ["cpu", "memory_mb"],
+          "properties": {
+            "cpu": {"type": "number", "exclusiveMinimum": 0, "multipleOf": 0.25},
+            "memory_mb": {"type": "integer", "minimum": 64}
+          }
+        },
+        "labels": {
+          "type": "object",
+          "propertyNames": {"maxLength": 32},
+          "additionalProperties": {"type": "string"}
+        },
+        "endpoints": {
+          "type": "array",
+          "uniqueItems": true,
+          "items": {"type": "string", "minLength": 1}
+        },
+        "tls": {"type": "boolean"}
+      },
+      "dependentRequired": {"tls": ["port"]}
+    }
+  }
+})";
+
+std::string BuildConfig(size_t services, bool with_errors) {
+    static const char* kEnvironments[] = {"dev", "staging", "prod"};
+
+    std::string json = "{\n  \"version\": 3,\n  \"services\": [";
+    for (size_t i = 0; i < services; ++i) {
+        bool broken = with_errors && i % 10 == 0;
+        std::string id = std::to_string(i);
+
+        json += i ? ",\n    {" : "\n    {";
+        json += "\"name\": \"" + std::string(broken ? "Service_" : "service-") + id + "\", ";
+        json += "\"port\": " + std::to_string(broken ? 70000 : 8000 + i % 1000) + ", ";
+        json += "\"replicas\": " + std::to_string(1 + i % 5) + ", ";
+        json += "\"environment\": \"" + std::string(kEnvironments[i % 3]) + "\", ";
+        json += "\"limits\": {\"cpu\": " + std::string(broken ? "0.3" : "1.5") +
+                ", \"memory_mb\": 512}, ";
+        json += "\"labels\": {\"team\": \"payments\", \"tier\": \"backend\", \"shard\": \"" +
+                id + "\"}, ";
+        json += "\"endpoints\": [\"/health\", \"/metrics\", \"/v1/items/" + id + "\"], ";
+        json += "\"tls\": true}";
+    }
+    json += "\n  ]\n}\n";
+    return json;
+}
+
+// Runs fn repeatedly for at least kMinSeconds; returns calls per second
+double Rate(const std::function<void()>& fn) {
+    size_t iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    do {
+        fn();
+        ++iterations;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < kMinSeconds);
+    return iterations / seconds;
+}
+
+void Measure(const validationservice::CompiledSchema& schema, size_t services, bool with_errors) {
+    std::string json = BuildConfig(services, with_errors);
+
+    jsonscan::Value document;
+    jsonscan::Parse(json, document);
+
+    std::vector<configservice::ValidationError> errors;
+    schema.Validate(document, errors);
+    size_t error_count = errors.size();
+
+    double validate_rate = Rate([&] {
+        errors.clear();
+        schema.Validate(document, errors);
+    });
+    double full_rate = Rate([&] {
+        jsonscan::Value parsed;
+        jsonscan::Parse(json, parsed);
+        errors.clear();
+        schema.Validate(parsed, errors);
+    });
+
+    double mb = static_cast<double>(json.size()) / (1024 * 1024);
+    std::cout << "  " << std::left << std::setw(8) << services << std::right << std::setw(10)
+              << json.size() << " B  " << std::setw(8) << (with_errors ? "invalid" : "valid")
+              << std::fixed << std::setprecision(1) << std::setw(12) << validate_rate << "/s"
+              << std::setw(12) << full_rate << "/s" << std::setw(10) << full_rate * mb
+              << " MB/s  " << error_count << " errors" << std::endl;
+}
+
+void MeasureIncremental(const validationservice::CompiledSchema& schema, size_t services) {
+    using validationservice::DocumentDiff;
+    using validationservice::IncrementalPass;
+    using validationservice::PassRecord;
+
+    // A cycle of versions, each one port away from the one before: four services get an out
+    // of range port, then their own back
+    std::string json = BuildConfig(services, false);
+    std::vector<std::string> texts;
+    for (size_t step = 0; step < 8; ++step) {
+        size_t service = (step % 4 + 1) * services / 5;
+        size_t entry = json.find("\"service-" + std::to_string(service) + "\"");
+        size_t port = json.find("\"port\": ", entry) + 8;
+        json.replace(port, json.find(',', port) - port,
+                     step < 4 ? "70000" : std::to_string(8000 + service % 1000));
+        texts.push_back(json);
+    }
+    std::vector<jsonscan::Value> documents(texts.size());
+    for (size_t i = 0; i < texts.size(); ++i) {
+        jsonscan::Parse(texts[i], documents[i]);
+    }
+
+    std::vector<configservice::ValidationError> errors;
+    size_t version = 0;
+    double full_rate = Rate([&] {
+        errors.clear();
+        schema.Validate(documents[version], errors);
+        version = (version + 1) % texts.size();
+    });
+    double full_parse_rate = Rate([&] {
+        jsonscan::Value parsed;
+        jsonscan::Parse(texts[version], parsed);
+        errors.clear();
+        schema.Validate(parsed, errors);
+        version = (version + 1) % texts.size();
+    });
+
+    // As in ValidationService, each version's record is the base of the next one's
+    auto first = std::make_shared<PassRecord>();
+    IncrementalPass recording(first.get());
+    schema.Validate(documents.back(), errors, nullptr, &recording);
+    std::shared_ptr<const PassRecord> record = first;
+    version = 0;
+    size_t error_count = 0;
+    auto validate_next = [&](const jsonscan::Value& document) {
+        size_t previous = (version + texts.size() - 1) % texts.size();
+        auto diff = std::make_shared<const DocumentDiff>(document, texts[version],
+                                                         documents[previous], texts[previous]);
+        auto next = std::make_shared<PassRecord>();
+        IncrementalPass pass(next.get(), diff, record);
+        errors.clear();
+        schema.Validate(document, errors, nullptr, &pass);
+        record = next;
+        error_count = std::max(error_count, errors.size());
+        version = (version + 1) % texts.size();
+    };
+    double incremental_rate = Rate([&] { validate_next(documents[version]); });
+    double incremental_parse_rate = Rate([&] {
+        jsonscan::Value parsed;
+        jsonscan::Parse(texts[version], parsed);
+        validate_next(parsed);
+    });
+
+    std::cout << "  " << std::left << std::setw(8) << services << std::right << std::setw(10)
+              << json.size() << " B" << std::fixed << std::setprecision(1) << std::setw(12)
+              << full_rate << "/s" << std::setw(12) << incremental_rate << "/s" << std::setw(14)
+              << full_parse_rate << "/s" << std::setw(14) << incremental_parse_rate << "/s  "
+              << error_count << " errors" << std::endl;
+}
+
+}  // anonymous namespace
+
+int main() {
+    auto compile_start = std::chrono::steady_clock::now();
+    auto schema = validationservice::CompiledSchema::Compile(kSchema);
+    auto compile_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                          std::chrono::steady_clock::now() - compile_start)
+                          .count();
+
+    std::cout << "[SchemaBench] Schema compiled in " << compile_us << " us ("
+              << schema->node_count() << " nodes)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "  services      bytes  document    validate  parse+validate" << std::endl;
+
+    for (size_t services : {10, 100, 1000, 4000}) {
+        Measure(*schema, services, false);
+    }
+    Measure(*schema, 4000, true);
+
+    std::cout << std::endl;
+    std::cout << "  services      bytes      validate  incremental  parse+validate"
+              << "  parse+incremental" << std::endl;
+    for (size_t services : {1000, 4000}) {
+        MeasureIncremental(*schema, services);
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+#include "jsonscan/json_scanner.h"
+#include "validation_service/toml_validator.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Throughput benchmark for the TOML parser, next to the JSON path it has to keep up with.
+//
+// Each input is run repeatedly for at least kMinSeconds; reported as MB/s. Two passes per
+// input: "syntax" checks only (what the service does with no rules or schema), "parse" also
+// builds the jsonscan tree rules and schemas run on. Besides every file as-is, one synthetic
+// ~1 MB document is generated in both formats with the same content, so the two rows for it
+// compare the parsers directly.
+//
+// Usage: toml_bench [file.toml ...]   (default: examples/configs/*.toml)
+
+namespace {
+
+constexpr double kMinSeconds = 0.5;
+constexpr size_t kSyntheticBytes = 1024 * 1024;
+
+std::string ReadFile(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+// Runs check until kMinSeconds have passed; returns MB/s
+double Throughput(size_t bytes, const std::function<bool()>& check) {
+    size_t iterations = 0;
+    auto start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    do {
+        for (int i = 0; i < 16; ++i) {
+            check();
+        }
+        iterations += 16;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < kMinSeconds);
+
+    return static_cast<double>(bytes) * iterations / seconds / (1024 * 1024);
+}
+
+void Report(const std::string& label, size_t bytes, double syntax, double parse,
+            const jsonscan::ScanResult& scan) {
+    std::cout << "  " << std::left << std::setw(28) << label << std::right << std::setw(10)
+              << bytes << " B  " << std::fixed << std::setprecision(1) << std::setw(8) << syntax
+              << " MB/s syntax  " << std::setw(8) << parse << " MB/s parse  "
+              << (scan.valid ? "valid" : scan.Describe()) << std::endl;
+}
+
+void MeasureToml(const std::string& label, const std::string& toml) {
+    jsonscan::Value document;
+    auto scan = validationservice::ParseToml(toml, nullptr);
+    double syntax = Throughput(toml.size(), [&] {
+        return validationservice::ParseToml(toml, nullptr).valid;
+    });
+    double parse = Throughput(toml.size(), [&] {
+        return validationservice::ParseToml(toml, &document).valid;
+    });
+    Report(label, toml.size(), syntax, parse, scan);
+}
+
+void MeasureJson(const std::string& label, const std::string& json) {
+    jsonscan::Value document;
+    auto scan = jsonscan::Validate(json);
+    double syntax = Throughput(json.size(), [&] { return jsonscan::Validate(json).valid; });
+    double parse = Throughput(json.size(), [&] { return jsonscan::Parse(json, document).valid; });
+    Report(label, json.size(), syntax, parse, scan);
+}
+
+// The same service registry as TOML tables and as a JSON object
+void BuildRegistry(std::string& toml, std::string& json) {
+    json = "{\n  \"services\": {";
+    for (int i = 0; toml.size() < kSyntheticBytes; ++i) {
+        std::string name = "svc-" + std::to_string(10000 + i);
+        std::string port = std::to_string(8000 + i % 1000);
+
+        toml += "[services." + name + "]\n";
+        toml += "name = \"" + name + "\"\n";
+        toml += "host = \"" + name + ".internal\"\n";
+        toml += "port = " + port + "\n";
+        toml += "timeout_ms = 2_500\n";
+        toml += "ratio = 0.75\n";
+        toml += "enabled = true\n";
+        toml += "tags = [\"payments\", \"tier-1\", \"eu-west\"]\n";
+        toml += "limits = { max_connections = 100, burst = 20 }\n\n";
+
+        json += i == 0 ? "\n" : ",\n";
+        json += "    \"" + name + "\": {\n";
+        json += "      \"name\": \"" + name + "\",\n";
+        json += "      \"host\": \"" + name + ".internal\",\n";
+        json += "      \"port\": " + port + ",\n";
+        json += "      \"timeout_ms\": 2500,\n";
+        json += "      \"ratio\": 0.75,\n";
+        json += "      \"enabled\": true,\n";
+        json += "      \"tags\": [\"payments\", \"tier-1\", \"eu-west\"],\n";
+        json += "      \"limits\": {\"max_connections\": 100, \"burst\": 20}\n";
+        json += "    }";
+    }
+    json += "\n  }\n}\n";
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths(argv + 1, argv + argc);
+    if (paths.empty()) {
+        for (const auto& entry : std::filesystem::directory_iterator("examples/configs")) {
+            if (entry.path().extension() == ".toml") {
+                paths.push_back(entry.path().string());
+            }
+        }
+    }
+
+    std::cout << "[TomlBench] " << paths.size() << " input files" << std::endl;
+    std::cout << std::endl;
+
+    for (const auto& path : paths) {
+        std::string toml = ReadFile(path);
+        if (toml.empty()) {
+            std::cerr << "[TomlBench] ✗ Cannot read " << path << std::endl;
+            continue;
+        }
+        MeasureToml(std::filesystem::path(path).filename().string(), toml);
+    }
+
+    std::string toml;
+    std::string json;
+    BuildRegistry(toml, json);
+    MeasureToml("registry.toml (~1 MB)", toml);
+    MeasureJson("registry.json (same data)", json);
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+#include "api.grpc.pb.h"
+
+#include <grpcpp/grpcpp.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace configservice;
+
+// Upload throughput benchmark for the API service.
+//
+// Phase 1: every thread uploads to the same named config (versions contend on
+//          one counter row, so this measures the serialized path).
+// Phase 2: every thread uploads to its own named config (no contention).
+// Phase 3: the same number of named configs in one streaming UploadConfigs call.
+//
+// Phases 1-2 check that no version was handed out twice.
+//
+// Usage: upload_bench [api_address] [threads] [uploads_per_thread]
+
+namespace {
+
+struct PhaseResult {
+    int ok = 0;
+    int failed = 0;
+    int duplicate_versions = 0;
+    double seconds = 0;
+    std::vector<double> latencies_ms;
+};
+
+PhaseResult RunPhase(const std::shared_ptr<grpc::Channel>& channel, const std::string& service,
+                     bool shared_config, int threads, int uploads_per_thread) {
+    PhaseResult result;
+    std::mutex result_mutex;
+    std::vector<std::set<int64_t>> versions(shared_config ? 1 : threads);
+    std::atomic<int> ok(0), failed(0);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t] {
+            auto stub = ConfigAPIService::NewStub(channel);
+            std::string config_name = shared_config ? "bench-shared" : "bench-" + std::to_string(t);
+            std::vector<std::pair<double, int64_t>> local;
+
+            for (int i = 0; i < uploads_per_thread; ++i) {
+                UploadConfigRequest request;
+                request.set_service_name(service);
+                request.set_config_name(config_name);
+                request.set_format("json");
+                request.set_created_by("upload-bench");
+                request.set_content("{\"thread\": " + std::to_string(t) +
+                                    ", \"seq\": " + std::to_string(i) + "}");
+
+                UploadConfigResponse response;
+                grpc::ClientContext context;
+                auto begin = std::chrono::steady_clock::now();
+                grpc::Status status = stub->UploadConfig(&context, request, &response);
+                auto end = std::chrono::steady_clock::now();
+
+                if (status.ok() && response.success()) {
+                    ok++;
+                    local.emplace_back(
+                        std::chrono::duration<double, std::milli>(end - begin).count(),
+                        response.version());
+                } else {
+                    failed++;
+                    std::cerr << "[UploadBench] ✗ "
+                              << (status.ok() ? response.message() : status.error_message())
+                              << std::endl;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(result_mutex);
+            auto& seen = versions[shared_config ? 0 : t];
+            for (const auto& [latency, version] : local) {
+                result.latencies_ms.push_back(latency);
+                if (!seen.insert(version).second) {
+                    result.duplicate_versions++;
+                }
+            }
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    result.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    result.ok = ok;
+    result.failed = failed;
+    std::sort(result.latencies_ms.begin(), result.latencies_ms.end());
+    return result;
+}
+
+struct BulkResult {
+    int uploaded = 0;
+    int failed = 0;
+    double seconds = 0;
+};
+
+BulkResult RunBulkPhase(const std::shared_ptr<grpc::Channel>& channel, const std::string& service,
+                        int items) {
+    BulkResult result;
+    auto stub = ConfigAPIService::NewStub(channel);
+
+    UploadConfigsResponse response;
+    grpc::ClientContext context;
+    auto start = std::chrono::steady_clock::now();
+
+    auto writer = stub->UploadConfigs(&context, &response);
+    for (int i = 0; i < items; ++i) {
+        UploadConfigsRequest request;
+        auto* item = request.mutable_item();
+        item->set_service_name(service);
+        item->set_config_name("bulk-" + std::to_string(i));
+        item->set_format("json");
+        item->set_created_by("upload-bench");
+        item->set_content("{\"bulk\": " + std::to_string(i) + "}");
+        if (!writer->Write(request)) {
+            break;
+        }
+    }
+    writer->WritesDone();
+    grpc::Status status = writer->Finish();
+
+    result.seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!status.ok()) {
+        std::cerr << "[UploadBench] ✗ UploadConfigs: " << status.error_message() << std::endl;
+        result.failed = items;
+        return result;
+    }
+    result.uploaded = response.uploaded_count() + response.unchanged_count();
+    result.failed = response.failed_count();
+    return result;
+}
+
+double Percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty())
+        return 0;
+    size_t idx = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[idx];
+}
+
+void PrintResult(const std::string& name, const PhaseResult& r) {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  " << name << std::endl;
+    std::cout << "    uploads    : " << r.ok << " ok, " << r.failed << " failed" << std::endl;
+    std::cout << "    throughput : " << (r.seconds > 0 ? r.ok / r.seconds : 0) << " uploads/s"
+              << std::endl;
+    std::cout << "    latency    : p50 " << Percentile(r.latencies_ms, 0.50) << " ms, p99 "
+              << Percentile(r.latencies_ms, 0.99) << " ms" << std::endl;
+    std::cout << "    duplicates : " << r.duplicate_versions
+              << (r.duplicate_versions == 0 ? " ✓" : " ✗") << std::endl;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    std::string api_address = argc > 1 ? argv[1] : "localhost:8081";
+    int threads = argc > 2 ? std::stoi(argv[2]) : 8;
+    int uploads_per_thread = argc > 3 ? std::stoi(argv[3]) : 50;
+
+    // Fresh service per run so version counters start from 1
+    std::string service =
+        "upload-bench-" +
+        std::to_string(std::chrono::system_clock::now().time_since_epoch().count() % 1000000);
+
+    std::cout << "[UploadBench] api     : " << api_address << std::endl;
+    std::cout << "[UploadBench] service : " << service << std::endl;
+    std::cout << "[UploadBench] " << threads << " threads x " << uploads_per_thread << " uploads"
+              << std::endl;
+
+    auto channel = grpc::CreateChannel(api_address, grpc::InsecureChannelCredentials());
+
+    PhaseResult same = RunPhase(channel, service, /*shared_config=*/true, threads,
+                                uploads_per_thread);
+    PhaseResult distinct = RunPhase(channel, service, /*shared_config=*/false, threads,
+                                    uploads_per_thread);
+
+    BulkResult bulk = RunBulkPhase(channel, service, threads * uploads_per_thread);
+
+    std::cout << std::endl;
+    PrintResult("Same named config", same);
+    PrintResult("Different named configs", distinct);
+
+    std::cout << "  Bulk UploadConfigs stream" << std::endl;
+    std::cout << "    uploads    : " << bulk.uploaded << " ok, " << bulk.failed << " failed"
+              << std::endl;
+    std::cout << "    throughput : " << (bulk.seconds > 0 ? bulk.uploaded / bulk.seconds : 0)
+              << " uploads/s" << std::endl;
+
+    return (same.failed + distinct.failed + bulk.failed + same.duplicate_versions +
+            distinct.duplicate_versions) == 0
+               ? 0
+               : 1;
+}
@@ -0,0 +1,303 @@
+#include "jsonscan/json_scanner.h"
+#include "validation_service/json_validator.h"
+#include "validation_service/rule_set.h"
+#include "validation_service/yaml_validator.h"
+
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Throughput and allocation benchmark for the validation hot path (Google Benchmark).
+//
+// One benchmark per validator and config shape, named "<validator>/<shape>":
+//   json_syntax   JsonValidator::ValidateSyntax
+//   json_parse    JsonValidator::Parse (the tree rules and schemas run on)
+//   yaml_syntax   YamlValidator::ValidateSyntax
+//   yaml_parse    YamlValidator::Parse
+//   yaml_stream   YamlValidator::Stream with the custom rules checked on the fly
+//   custom_rules  CompiledRuleSet::Evaluate on a parsed document (what ApplyCustomRules runs)
+// Shapes are generated with the same content in JSON and block YAML:
+//   small ~1 KB, medium ~64 KB and huge ~1 MB (max_config_size) service registries,
+//   deep (objects nested 200 levels) and wide (one object with 20000 members).
+//
+// bytes_per_second is the input size (the JSON size for custom_rules); allocs and
+// alloc_bytes are operator new calls and bytes per validation. `make bench-validation` also
+// writes every result as JSON to build/bench-validation.json.
+//
+// Usage: validation_bench [--benchmark_filter=yaml_.*/huge] [other Google Benchmark flags]
+
+namespace {
+
+std::atomic<size_t> allocations{0};
+std::atomic<size_t> allocated_bytes{0};
+
+}  // anonymous namespace
+
+// Counts every allocation in the process, yaml-cpp and protobuf included. GCC sees the
+// free() in the replaced deletes inlined next to new-expressions and warns; they match.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+
+void* operator new(size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    if (void* memory = std::malloc(size ? size : 1)) {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+    std::free(memory);
+}
+
+#pragma GCC diagnostic pop
+
+namespace {
+
+using configservice::ValidationError;
+using configservice::ValidationWarning;
+using validationservice::CompiledRuleSet;
+using validationservice::JsonValidator;
+using validationservice::RuleStream;
+using validationservice::YamlValidator;
+
+struct Shape {
+    std::string name;
+    std::string json;
+    std::string yaml;
+    jsonscan::Value document;
+};
+
+// Rules touching every shape: registry ports and hosts, the wide limits, the deepest port
+std::shared_ptr<const CompiledRuleSet> BuildRules() {
+    std::string deep_port = "nested";
+    for (int i = 1; i < 200; ++i) {
+        deep_port += ".nested";
+    }
+    deep_port += ".port";
+
+    std::vector<validationservice::ValidationRule> rules = {
+        {"r1", "bench", "version", "required", "{}", "version is required"},
+        {"r2", "bench", "services.*.port", "range", "{\"min\": 1, \"max\": 65535}", "bad port"},
+        {"r3", "bench", "services.*.host", "format", "{\"pattern\": \"^[a-z0-9.-]+$\"}",
+         "bad host"},
+        {"r4", "bench", "limits.*", "range", "{\"min\": 0, \"max\": 1000000}", "bad limit"},
+        {"r5", "bench", deep_port, "range", "{\"min\": 1, \"max\": 65535}", "bad port"},
+    };
+    return CompiledRuleSet::Compile(rules, 1);
+}
+
+std::string Registry(size_t bytes) {
+    std::string json = "{\n  \"version\": 1,\n  \"services\": {";
+    for (int i = 0; json.size() < bytes; ++i) {
+        std::string name = "svc-" + std::to_string(10000 + i);
+        json += i == 0 ? "\n" : ",\n";
+        json += "    \"" + name + "\": {\n";
+        json += "      \"host\": \"" + name + ".internal\",\n";
+        json += "      \"port\": " + std::to_string(8000 + i % 1000) + ",\n";
+        json += "      \"timeout_ms\": 2500,\n";
+        json += "      \"ratio\": 0.75,\n";
+        json += "      \"enabled\": true,\n";
+        json += "      \"tags\": [\"payments\", \"tier-1\", \"eu-west\"],\n";
+        json += "      \"limits\": {\"max_connections\": 100, \"burst\": 20}\n";
+        json += "    }";
+    }
+    return json + "\n  }\n}\n";
+}
+
+std::string Deep(int levels) {
+    std::string json = "{\"version\": 1";
+    for (int i = 0; i < levels; ++i) {
+        json += ", \"nested\": {\"level\": " + std::to_string(i) + ", \"name\": \"n\"";
+    }
+    json += ", \"port\": 8080";
+    return json + std::string(levels, '}') + "}\n";
+}
+
+std::string Wide(int members) {
+    std::string json = "{\n  \"version\": 1,\n  \"limits\": {";
+    for (int i = 0; i < members; ++i) {
+        json += i == 0 ? "\n" : ",\n";
+        json += "    \"limit-" + std::to_string(i) + "\": " + std::to_string(i * 7 % 100000);
+    }
+    return json + "\n  }\n}\n";
+}
+
+std::string Quoted(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// Block-style YAML with the same content (the generated JSON has no empty containers)
+void EmitYaml(const jsonscan::Value& value, int indent, std::string& yaml) {
+    auto scalar = [](const jsonscan::Value& scalar_value) -> std::string {
+        switch (scalar_value.type) {
+            case jsonscan::Value::Type::kNull:
+                return "null";
+            case jsonscan::Value::Type::kBool:
+                return scalar_value.boolean ? "true" : "false";
+            case jsonscan::Value::Type::kNumber:
+                return scalar_value.string;
+            default:
+                return Quoted(scalar_value.string);
+        }
+    };
+    auto is_container = [](const jsonscan::Value& child) {
+        return child.is_object() || child.is_array();
+    };
+
+    std::string pad(indent, ' ');
+    for (const auto& [key, member] : value.members) {
+        if (is_container(member)) {
+            yaml += pad + key + ":\n";
+            EmitYaml(member, indent + 2, yaml);
+        } else {
+            yaml += pad + key + ": " + scalar(member) + "\n";
+        }
+    }
+    for (const auto& item : value.items) {
+        if (is_container(item)) {
+            yaml += pad + "-\n";
+            EmitYaml(item, indent + 2, yaml);
+        } else {
+            yaml += pad + "- " + scalar(item) + "\n";
+        }
+    }
+}
+
+std::vector<Shape> BuildShapes() {
+    std::vector<Shape> shapes = {
+        {"small", Registry(1024), "", {}},          {"medium", Registry(64 * 1024), "", {}},
+        {"huge", Registry(1024 * 1024), "", {}},    {"deep", Deep(200), "", {}},
+        {"wide", Wide(20000), "", {}},
+    };
+    for (auto& shape : shapes) {
+        auto scan = jsonscan::Parse(shape.json, shape.document);
+        if (!scan.valid) {
+            std::cerr << "[ValidationBench] ✗ Generated " << shape.name
+                      << " config is invalid: " << scan.Describe() << std::endl;
+            std::exit(1);
+        }
+        EmitYaml(shape.document, 0, shape.yaml);
+    }
+    return shapes;
+}
+
+// Runs validate once per iteration; reports MB/s of bytes and allocations per validation
+template <typename Validate>
+void Run(benchmark::State& state, size_t bytes, Validate validate) {
+    size_t allocations_before = allocations.load(std::memory_order_relaxed);
+    size_t bytes_before = allocated_bytes.load(std::memory_order_relaxed);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(validate());
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * bytes));
+    state.counters["allocs"] = benchmark::Counter(
+        static_cast<double>(allocations.load(std::memory_order_relaxed) - allocations_before),
+        benchmark::Counter::kAvgIterations);
+    state.counters["alloc_bytes"] = benchmark::Counter(
+        static_cast<double>(allocated_bytes.load(std::memory_order_relaxed) - bytes_before),
+        benchmark::Counter::kAvgIterations);
+}
+
+void Register(const Shape& shape, const CompiledRuleSet& rules) {
+    const std::string& json = shape.json;
+    const std::string& yaml = shape.yaml;
+
+    benchmark::RegisterBenchmark(("json_syntax/" + shape.name).c_str(), [&](auto& state) {
+        JsonValidator validator;
+        std::vector<ValidationError> errors;
+        Run(state, json.size(), [&] {
+            errors.clear();
+            return validator.ValidateSyntax(json, errors);
+        });
+    });
+    benchmark::RegisterBenchmark(("json_parse/" + shape.name).c_str(), [&](auto& state) {
+        JsonValidator validator;
+        jsonscan::Value document;
+        std::vector<ValidationError> errors;
+        Run(state, json.size(), [&] {
+            errors.clear();
+            return validator.Parse(json, document, errors);
+        });
+    });
+    benchmark::RegisterBenchmark(("yaml_syntax/" + shape.name).c_str(), [&](auto& state) {
+        YamlValidator validator;
+        std::vector<ValidationError> errors;
+        Run(state, yaml.size(), [&] {
+            errors.clear();
+            return validator.ValidateSyntax(yaml, errors);
+        });
+    });
+    benchmark::RegisterBenchmark(("yaml_parse/" + shape.name).c_str(), [&](auto& state) {
+        YamlValidator validator;
+        jsonscan::Value document;
+        std::vector<ValidationError> errors;
+        std::vector<ValidationWarning> warnings;
+        Run(state, yaml.size(), [&] {
+            errors.clear();
+            warnings.clear();
+            return validator.Parse(yaml, document, errors, warnings);
+        });
+    });
+    benchmark::RegisterBenchmark(("yaml_stream/" + shape.name).c_str(), [&](auto& state) {
+        YamlValidator validator;
+        std::vector<ValidationError> errors;
+        std::vector<ValidationWarning> warnings;
+        Run(state, yaml.size(), [&] {
+            errors.clear();
+            warnings.clear();
+            RuleStream stream(rules, errors);
+            return validator.Stream(yaml, &stream, errors, warnings);
+        });
+    });
+    benchmark::RegisterBenchmark(("custom_rules/" + shape.name).c_str(), [&](auto& state) {
+        std::vector<ValidationError> errors;
+        Run(state, json.size(), [&] {
+            errors.clear();
+            return rules.Evaluate(shape.document, errors);
+        });
+    });
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+
+    auto rules = BuildRules();
+    if (!rules->skipped().empty()) {
+        std::cerr << "[ValidationBench] ✗ Rule not compiled: " << rules->skipped().front()
+                  << std::endl;
+        return 1;
+    }
+    // Registered benchmarks refer to these until the run ends
+    static const std::vector<Shape> shapes = BuildShapes();
+    for (const auto& shape : shapes) {
+        Register(shape, *rules);
+    }
+
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
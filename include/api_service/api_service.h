@@ -5,10 +5,13 @@
 #include <grpcpp/grpcpp.h>
 
 #include <librdkafka/rdkafkacpp.h>
+#include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 
 #include "api.grpc.pb.h"
+#include "cache_manager.h"
 #include "database_manager.h"
 #include "statsdclient/statsd_client.h"
 #include "validation_client.h"
@@ -31,10 +34,18 @@ class ApiServiceImpl final : public configservice::ConfigAPIService::Service {
                               const configservice::UploadConfigRequest* request,
                               configservice::UploadConfigResponse* response) override;
 
+    grpc::Status UploadConfigs(grpc::ServerContext* context,
+                               grpc::ServerReader<configservice::UploadConfigsRequest>* reader,
+                               configservice::UploadConfigsResponse* response) override;
+
     grpc::Status GetConfig(grpc::ServerContext* context,
                            const configservice::GetConfigRequest* request,
                            configservice::GetConfigResponse* response) override;
 
+    grpc::Status BatchGetConfigs(grpc::ServerContext* context,
+                                 const configservice::BatchGetConfigsRequest* request,
+                                 configservice::BatchGetConfigsResponse* response) override;
+
     grpc::Status ListConfigs(grpc::ServerContext* context,
                              const configservice::ListConfigsRequest* request,
                              configservice::ListConfigsResponse* response) override;
@@ -63,6 +74,14 @@ class ApiServiceImpl final : public configservice::ConfigAPIService::Service {
                              const configservice::GetAuditLogRequest* request,
                              configservice::GetAuditLogResponse* response) override;
 
+    grpc::Status ExportAuditLog(
+        grpc::ServerContext* context, const configservice::ExportAuditLogRequest* request,
+        grpc::ServerWriter<configservice::ExportAuditLogResponse>* writer) override;
+
+    grpc::Status ExportConfigHistory(
+        grpc::ServerContext* context, const configservice::ExportConfigHistoryRequest* request,
+        grpc::ServerWriter<configservice::ExportConfigHistoryResponse>* writer) override;
+
     grpc::Status GetStats(grpc::ServerContext* context,
                           const configservice::GetStatsRequest* request,
                           configservice::GetStatsResponse* response) override;
@@ -82,19 +101,32 @@ class ApiServiceImpl final : public configservice::ConfigAPIService::Service {
    private:
     ServiceConfig config_;
     std::unique_ptr<DatabaseManager> db_;
+    std::unique_ptr<CacheManager> cache_;
     std::unique_ptr<RdKafka::Producer> kafka_producer_;
     std::unique_ptr<statsdclient::StatsDClient> statsd_;
     std::unique_ptr<ValidationClient> validation_client_;
+    std::atomic<int> active_exports_;
     bool initialized_;
 
     // Helpers
     bool ValidateContent(const std::string& format, const std::string& content,
                          std::vector<std::string>& errors);
     bool PublishEvent(const std::string& event_type, const std::string& service_name,
-                      int64_t version, const std::string& performed_by);
+                      int64_t version, const std::string& performed_by,
+                      const std::string& config_name = "");
+    // Field checks and inline syntax check. Fills response and returns false when the upload
+    // must be rejected; safe to call concurrently.
+    bool CheckUpload(const configservice::UploadConfigRequest& request,
+                     configservice::UploadConfigResponse* response);
+    // Same contract for the validation service's verdict on an upload
+    bool CheckValidationResult(const configservice::ValidateConfigResponse& val_response,
+                               configservice::UploadConfigResponse* response);
+    configservice::ConfigData BuildUploadConfig(const configservice::UploadConfigRequest& request);
     void RecordMetric(const std::string& metric);
-    std::string GenerateConfigId(const std::string& service_name, const std::string& config_name,
-                                 int64_t version);
+    void InvalidateCachedLists(const std::string& service_name);
+    grpc::Status FinishExport(const std::string& kind, bool success, const std::string& error,
+                              bool cancelled, int64_t rows,
+                              std::chrono::steady_clock::time_point start);
     std::string ComputeHash(const std::string& content);
 };
 
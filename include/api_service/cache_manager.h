@@ -0,0 +1,62 @@
+#pragma once
+
+#include "config.h"
+
+#include <hiredis/hiredis.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace apiservice {
+
+/**
+ * @brief Redis read-through cache for the API service's read RPCs.
+ *
+ * Config versions are immutable, so GetConfig entries are keyed by config_id and never
+ * expire; they are only removed when the version is deleted. List responses are keyed by a
+ * per-service generation counter: any write to a service bumps the counter, which orphans
+ * every list entry cached under the old generation (those then age out via cache_ttl).
+ *
+ * All operations degrade to a miss / no-op while Redis is unreachable, and a dropped
+ * connection is re-established lazily on a later call.
+ */
+class CacheManager {
+   public:
+    explicit CacheManager(const RedisConfig& config);
+    ~CacheManager();
+
+    bool Initialize();
+    void Shutdown();
+
+    // Cache operations
+    bool Set(const std::string& key, const std::string& value, int ttl_seconds = 0);
+    bool Get(const std::string& key, std::string& value);
+    bool Delete(const std::string& key);
+    int64_t IncrementCounter(const std::string& key);
+
+    // Key scheme
+    static std::string ConfigKey(const std::string& config_id);
+    static std::string GenerationKey(const std::string& service_name);
+
+    /** @brief Current write generation of a service ("0" if never written or unavailable). */
+    std::string GetGeneration(const std::string& service_name);
+
+    /** @brief Invalidates every cached list response for a service. */
+    void InvalidateService(const std::string& service_name);
+
+    int ListTtlSeconds() const { return config_.cache_ttl_seconds; }
+
+   private:
+    RedisConfig config_;
+    redisContext* context_;
+    std::mutex mutex_;
+    bool initialized_;
+    std::chrono::steady_clock::time_point last_connect_attempt_;
+
+    bool Connect();
+    bool EnsureConnected();
+    void Disconnect();
+};
+
+}  // namespace apiservice
@@ -24,6 +24,7 @@ struct RedisConfig {
     std::string host = "redis";
     int port = 6379;
     int cache_ttl_seconds = 300;
+    int connection_timeout_seconds = 2;
 };
 
 struct StatsDConfig {
@@ -39,6 +40,8 @@ struct ServerConfig {
 
 struct ValidationServiceConfig {
     std::string address = "validation-service:8083";
+    int channel_pool_size = 4;
+    int timeout_ms = 10000;  // Upper bound; callers' own deadlines still apply
 };
 
 struct ServiceConfig {
@@ -3,16 +3,31 @@
 #include "config.h"
 #include "config.pb.h"
 
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <pqxx/pqxx>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "api.pb.h"
 
 namespace apiservice {
 
+// Outcome of one item of CreateConfigVersions
+struct VersionResult {
+    bool success = false;
+    bool unchanged = false;
+    std::string error;
+};
+
+// Paging result for keyset-paginated lists
+struct PageInfo {
+    std::string next_page_token;  // Empty on the last page
+    int total_count = 0;
+};
+
 class DatabaseManager {
    public:
     explicit DatabaseManager(const PostgresConfig& config);
@@ -25,16 +40,48 @@ class DatabaseManager {
     // Config operations
     // ─────────────────────────────────────────────
 
-    // Insert a new version — config.config_name() and config.version() must be populated
-    std::pair<bool, std::string> InsertConfig(const configservice::ConfigData& config,
-                                              const std::string& description);
+    // Allocate the next version of a named config and store metadata, content and an audit
+    // row in one round trip (create_config_version, migrations 012-013). On success fills
+    // config.version() and config.config_id(). Empty audit_details records "Version N".
+    // Bodies are content-addressed by config.content_hash(): leave content empty to reuse an
+    // existing blob (rollbacks). With skip_unchanged, content identical to the latest version
+    // creates nothing; the latest version is returned and *unchanged is set.
+    std::pair<bool, std::string> CreateConfigVersion(configservice::ConfigData& config,
+                                                     const std::string& description,
+                                                     const std::string& audit_action,
+                                                     const std::string& performed_by,
+                                                     const std::string& audit_details = "",
+                                                     bool activate = false,
+                                                     bool skip_unchanged = false,
+                                                     bool* unchanged = nullptr);
+
+    // Bulk CreateConfigVersion for uploads (audit action "uploaded", skip_unchanged). Items
+    // go to the database in batches, each batch as one jsonb parameter and one statement.
+    // atomic: a single transaction, so any failure stores nothing. Otherwise each batch
+    // commits on its own and a failing batch is retried item by item, so a bad item fails
+    // alone. descriptions is parallel to configs; results are in the same order.
+    std::vector<VersionResult> CreateConfigVersions(std::vector<configservice::ConfigData>& configs,
+                                                    const std::vector<std::string>& descriptions,
+                                                    bool atomic);
 
     // Get full config data by config_id
     configservice::ConfigData GetConfigById(const std::string& config_id);
 
-    // Get the latest version of a named config
+    // Fetch many configs with one `= ANY($1)` query; missing ids are skipped and the result
+    // is unordered. Without include_content the blob join is skipped and content is empty.
+    std::vector<configservice::ConfigData> GetConfigsByIds(
+        const std::vector<std::string>& config_ids, bool include_content);
+
+    // Get the latest version of a named config; without include_content the blob join is
+    // skipped and content is empty (content_hash is still set)
     configservice::ConfigData GetLatestConfigByName(const std::string& service_name,
-                                                    const std::string& config_name);
+                                                    const std::string& config_name,
+                                                    bool include_content = true);
+
+    // Content hash of the latest version of each (service_name, config_name), in one query;
+    // empty for names with no version yet
+    std::vector<std::string> GetLatestContentHashes(
+        const std::vector<std::pair<std::string, std::string>>& names);
 
     // Get a specific version of a named config (used for rollback)
     configservice::ConfigData GetConfigByVersion(const std::string& service_name,
@@ -48,17 +95,23 @@ class DatabaseManager {
     void SetActiveConfig(const std::string& service_name, const std::string& config_name,
                          const std::string& config_id);
 
-    // List versions of a named config (paginated)
+    // List versions of a named config, newest first. A non-empty page_token continues after
+    // the previous page (offset is then ignored). total_count comes from the summary table
+    // unless include_total asks for a COUNT(*) over config_metadata. Throws
+    // std::invalid_argument for a malformed page_token.
     std::vector<configservice::ConfigMetadata> ListConfigs(const std::string& service_name,
                                                            const std::string& config_name,
-                                                           int limit, int offset, int& total_count);
+                                                           int limit, int offset,
+                                                           const std::string& page_token,
+                                                           bool include_total, PageInfo& page);
 
     // List all named configs for a service (one summary row per config_name)
     std::vector<configservice::NamedConfigSummary> ListNamedConfigs(
         const std::string& service_name);
 
     // Delete a specific config version by config_id
-    std::pair<bool, std::string> DeleteConfigById(const std::string& config_id);
+    std::pair<bool, std::string> DeleteConfigById(const std::string& config_id,
+                                                  std::string* service_name = nullptr);
 
     // ─────────────────────────────────────────────
     // Rollout operations
@@ -80,15 +133,34 @@ class DatabaseManager {
     // Helpers
     // ─────────────────────────────────────────────
 
-    // Next version number for a named config within a service
-    int64_t GetNextVersion(const std::string& service_name, const std::string& config_name);
-
     void RecordAuditEvent(const std::string& service_name, const std::string& config_id,
                           const std::string& action, const std::string& performed_by,
                           const std::string& details);
 
-    // Get recent audit log entries
-    std::vector<configservice::AuditEntry> GetAuditLog(const std::string& service_name, int limit);
+    // Get audit log entries, newest first, continuing after page_token when non-empty.
+    // Throws std::invalid_argument for a malformed page_token.
+    std::vector<configservice::AuditEntry> GetAuditLog(const std::string& service_name, int limit,
+                                                       const std::string& page_token,
+                                                       std::string& next_page_token);
+
+    // ─────────────────────────────────────────────
+    // Exports
+    // ─────────────────────────────────────────────
+    // Each export runs on its own connection through a server-side cursor, handing rows to
+    // on_chunk a few hundred at a time; on_chunk returns false to stop early. since/until
+    // are Unix seconds (0 = unbounded). Returns {false, error} if the query fails.
+
+    // Audit entries oldest first
+    std::pair<bool, std::string> ExportAuditLog(
+        const std::string& service_name, int64_t since, int64_t until,
+        const std::function<bool(const std::vector<configservice::AuditEntry>&)>& on_chunk);
+
+    // Versions ordered by config_name, then version; empty config_name exports all of them
+    std::pair<bool, std::string> ExportConfigHistory(
+        const std::string& service_name, const std::string& config_name, int64_t since,
+        int64_t until, bool include_content,
+        const std::function<bool(const std::vector<configservice::ConfigHistoryEntry>&)>&
+            on_chunk);
 
     // Get system-wide stats
     configservice::KonfigStats GetStats();
@@ -109,6 +181,7 @@ class DatabaseManager {
     std::string BuildConnectionString();
     configservice::ConfigData ParseConfigRow(const pqxx::row& row);
     configservice::ConfigMetadata ParseMetadataRow(const pqxx::row& row);
+    configservice::AuditEntry ParseAuditRow(const pqxx::row& row);
 };
 
 }  // namespace apiservice
\ No newline at end of file
@@ -1,33 +1,68 @@
 #pragma once
 
+#include "statsdclient/statsd_client.h"
+
 #include <grpcpp/grpcpp.h>
 
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "validation.grpc.pb.h"
 
 namespace apiservice {
 
+/**
+ * @brief Non-blocking client for the Validation Service.
+ *
+ * Calls use the gRPC callback API, so no API thread is held while a validation is in flight,
+ * and are spread round-robin over a small pool of channels (one HTTP/2 connection each).
+ * Each call's deadline is the caller's own deadline, capped at the configured timeout.
+ * Per-call latency is reported as `validation_client.<outcome>.duration` timings.
+ */
 class ValidationClient {
    public:
-    explicit ValidationClient(const std::string& server_address);
+    using Clock = std::chrono::system_clock;
+
+    ValidationClient(const std::string& server_address, int pool_size, int timeout_ms,
+                     statsdclient::StatsDClient* statsd = nullptr);
     ~ValidationClient();
 
     bool Initialize();
     void Shutdown();
 
-    // Validate config
-    configservice::ValidateConfigResponse ValidateConfig(const std::string& service_name,
-                                                         const std::string& content,
-                                                         const std::string& format,
-                                                         bool strict = false);
+    /**
+     * @brief Starts a validation and returns immediately.
+     *
+     * The future resolves when the call completes; transport errors and deadlines resolve to
+     * a response with valid() == false. Pass the incoming RPC's deadline
+     * (ServerContext::deadline()) so validation never outlives the request that needs it.
+     * base_content_hash names the version the content was edited from, if any, so only
+     * what changed since is re-checked.
+     */
+    std::future<configservice::ValidateConfigResponse> ValidateConfigAsync(
+        const std::string& service_name, const std::string& content, const std::string& format,
+        bool strict = false, Clock::time_point deadline = Clock::time_point::max(),
+        const std::string& base_content_hash = "");
+
+    // Blocking form of ValidateConfigAsync
+    configservice::ValidateConfigResponse ValidateConfig(
+        const std::string& service_name, const std::string& content, const std::string& format,
+        bool strict = false, Clock::time_point deadline = Clock::time_point::max(),
+        const std::string& base_content_hash = "");
 
    private:
     std::string server_address_;
-    std::shared_ptr<grpc::Channel> channel_;
-    std::unique_ptr<configservice::ValidationService::Stub> stub_;
+    size_t pool_size_;
+    std::chrono::milliseconds timeout_;
+    statsdclient::StatsDClient* statsd_;
+    std::vector<std::shared_ptr<grpc::Channel>> channels_;
+    std::vector<std::unique_ptr<configservice::ValidationService::Stub>> stubs_;
+    std::atomic<size_t> next_stub_;
     bool initialized_;
 };
 
-}  // namespace apiservice
\ No newline at end of file
+}  // namespace apiservice
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <grpcpp/grpcpp.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace configservice {
+
+/**
+ * @brief Tuning knobs applied when a channel is created.
+ *
+ * Two clients only share a channel when both the target and every option match.
+ * Zero / negative / empty values leave the gRPC default in place.
+ */
+struct ChannelOptions {
+    int keepalive_time_ms = 0;                    // GRPC_ARG_KEEPALIVE_TIME_MS
+    int keepalive_timeout_ms = 0;                 // GRPC_ARG_KEEPALIVE_TIMEOUT_MS
+    bool keepalive_permit_without_calls = false;  // ping even with no active RPC
+    int max_receive_message_size = -1;            // bytes
+    int max_send_message_size = -1;               // bytes
+    std::string compression;                      // "", "gzip" or "deflate"
+};
+
+/**
+ * @brief Process-wide registry of gRPC channels keyed by target address and options.
+ *
+ * Every ConfigClient in the process asks the registry for its channel, so
+ * clients pointing at the same distribution endpoint share one HTTP/2
+ * connection instead of opening one each. Channels are held weakly: a channel
+ * is closed once the last client using it is destroyed.
+ *
+ * Example:
+ * @code
+ *   ChannelOptions options;
+ *   options.keepalive_time_ms = 20000;
+ *   auto channel = ChannelRegistry::Instance().GetChannel("localhost:8082", options);
+ *   std::cout << ChannelRegistry::Instance().OpenConnectionCount() << std::endl;
+ * @endcode
+ */
+class ChannelRegistry {
+   public:
+    /**
+     * @brief The process-wide registry
+     */
+    static ChannelRegistry& Instance();
+
+    ChannelRegistry(const ChannelRegistry&) = delete;
+    ChannelRegistry& operator=(const ChannelRegistry&) = delete;
+
+    /**
+     * @brief Return the shared channel for (target, options), creating it if needed
+     */
+    std::shared_ptr<grpc::Channel> GetChannel(const std::string& target,
+                                              const ChannelOptions& options = ChannelOptions());
+
+    /**
+     * @brief Number of channels still referenced by at least one client
+     */
+    size_t ChannelCount();
+
+    /**
+     * @brief Number of channels with an established connection (state READY)
+     */
+    size_t OpenConnectionCount();
+
+   private:
+    ChannelRegistry() = default;
+
+    // Drop entries whose channel has been released. Caller must hold mutex_.
+    void PruneExpired();
+
+    static std::string BuildKey(const std::string& target, const ChannelOptions& options);
+    static grpc::ChannelArguments BuildArguments(const ChannelOptions& options);
+
+    std::mutex mutex_;
+    std::map<std::string, std::weak_ptr<grpc::Channel>> channels_;
+};
+
+}  // namespace configservice
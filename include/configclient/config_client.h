@@ -1,12 +1,14 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
+#include "configclient/channel_registry.h"
 #include "distribution.grpc.pb.h"
 #include "distribution.pb.h"
 
@@ -36,6 +38,18 @@ using ConnectionStatusCallback = std::function<void(bool connected)>;
  *   // ... your app runs ...
  *   client.Stop();
  * @endcode
+ *
+ * Several named configs, possibly owned by other services, can share the
+ * client's single stream:
+ * @code
+ *   ConfigClient client("localhost:8082", "my-service");
+ *   client.Subscribe("my-service", "database-config", OnDatabaseConfig);
+ *   client.Subscribe("my-service", "feature-flags", OnFeatureFlags);
+ *   client.Subscribe("global", "default");
+ *   client.Start();
+ *
+ *   ConfigData flags = client.GetConfig("my-service", "feature-flags");
+ * @endcode
  */
 class ConfigClient {
    public:
@@ -48,10 +62,13 @@ class ConfigClient {
      * @param cache_dir                  Directory for disk cache (default: ~/.konfig/cache/)
      * @param heartbeat_interval_seconds How often to send heartbeats (default: 30s)
      * @param max_heartbeat_failures     Consecutive failures before reconnecting (default: 3)
+     * @param channel_options            Channel tuning; clients with equal address and options
+     *                                   share one connection (see ChannelRegistry)
      */
     ConfigClient(const std::string& server_address, const std::string& service_name,
                  const std::string& instance_id = "", const std::string& cache_dir = "",
-                 int heartbeat_interval_seconds = 30, int max_heartbeat_failures = 3);
+                 int heartbeat_interval_seconds = 30, int max_heartbeat_failures = 3,
+                 const ChannelOptions& channel_options = ChannelOptions());
 
     ~ConfigClient();
 
@@ -64,6 +81,18 @@ class ConfigClient {
      */
     bool Start();
 
+    /**
+     * @brief Start and wait until the config is known to be fresh, or the deadline passes
+     *
+     * The disk cache is loaded while the connection is being established. Returns
+     * true as soon as the server confirms the cached versions are current (or
+     * delivers newer ones). Returns false at the deadline; the client keeps
+     * running and serves whatever the cache held, and later updates arrive as usual.
+     *
+     * @param timeout Longest time to wait for the server
+     */
+    bool StartAndWait(std::chrono::milliseconds timeout);
+
     /**
      * @brief Stop receiving updates
      */
@@ -75,10 +104,23 @@ class ConfigClient {
     bool IsConnected() const;
 
     /**
-     * @brief Register callback for config updates
+     * @brief Register callback for config updates (fires for every subscription)
      */
     void OnConfigUpdate(ConfigUpdateCallback callback);
 
+    /**
+     * @brief Subscribe to a named config over this client's stream
+     *
+     * May be called before or after Start(). If Subscribe() is never called,
+     * the client subscribes to every config of its own service_name.
+     *
+     * @param service_name Service that owns the config (need not be this client's service)
+     * @param config_name  Named config (e.g. "feature-flags"); empty means every config
+     * @param callback     Invoked for updates to this subscription only (optional)
+     */
+    void Subscribe(const std::string& service_name, const std::string& config_name,
+                   ConfigUpdateCallback callback = nullptr);
+
     /**
      * @brief Register callback for connection status
      */
@@ -94,6 +136,40 @@ class ConfigClient {
      */
     int64_t GetCurrentVersion() const;
 
+    /**
+     * @brief Get the latest config received for a subscription (thread-safe)
+     *
+     * A named config is also found through a whole-service subscription; an empty
+     * config_name returns the whole-service subscription's most recent update.
+     * Returns an empty ConfigData (version 0) if nothing has been received yet.
+     */
+    ConfigData GetConfig(const std::string& service_name, const std::string& config_name) const;
+
+    /**
+     * @brief Get the version held for a subscription (0 if none)
+     */
+    int64_t GetVersion(const std::string& service_name, const std::string& config_name) const;
+
+    /**
+     * @brief Milliseconds from Start() until a config was first available (cache or server),
+     *        or -1 if none yet
+     */
+    int64_t GetTimeToFirstConfigMs() const;
+
+    /**
+     * @brief Milliseconds from Start() until the server confirmed the config is current,
+     *        or -1 if not yet
+     */
+    int64_t GetTimeToSyncMs() const;
+
+    /**
+     * @brief Report start-up timings to StatsD (call before Start)
+     *
+     * Emits konfig.client.<service>.time_to_first_config and .time_to_sync timings,
+     * plus a .startup_cache_fallback counter when StartAndWait() times out.
+     */
+    void EnableMetrics(const std::string& statsd_host = "localhost", int statsd_port = 9125);
+
     /**
      * @brief Get service name
      */
@@ -104,6 +180,11 @@ class ConfigClient {
      */
     const std::string& GetInstanceId() const { return instance_id_; }
 
+    /**
+     * @brief Number of distribution-service connections open in this process
+     */
+    static size_t OpenConnectionCount();
+
    private:
     std::string server_address_;
     std::string service_name_;
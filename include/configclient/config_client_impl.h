@@ -2,12 +2,14 @@
 
 #include "config_client.h"
 #include "configclient/disk_cache.h"
+#include "statsdclient/statsd_client.h"
 
 #include <grpcpp/grpcpp.h>
 
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -20,48 +22,111 @@ class ConfigClientImpl {
    public:
     ConfigClientImpl(const std::string& server_address, const std::string& service_name,
                      const std::string& instance_id, const std::string& cache_dir = "",
-                     int heartbeat_interval_seconds = 30, int max_heartbeat_failures = 3);
+                     int heartbeat_interval_seconds = 30, int max_heartbeat_failures = 3,
+                     const ChannelOptions& channel_options = ChannelOptions());
 
     ~ConfigClientImpl();
 
     bool Start();
+    bool StartAndWait(std::chrono::milliseconds timeout);
     void Stop();
     bool IsConnected() const;
 
     void OnConfigUpdate(ConfigUpdateCallback callback);
     void OnConnectionStatus(ConnectionStatusCallback callback);
+    void Subscribe(const std::string& service_name, const std::string& config_name,
+                   ConfigUpdateCallback callback);
 
     ConfigData GetCurrentConfig() const;
     int64_t GetCurrentVersion() const;
+    ConfigData GetConfig(const std::string& service_name, const std::string& config_name) const;
+    int64_t GetVersion(const std::string& service_name, const std::string& config_name) const;
+
+    int64_t GetTimeToFirstConfigMs() const { return first_config_ms_.load(); }
+    int64_t GetTimeToSyncMs() const { return sync_ms_.load(); }
+    void EnableMetrics(const std::string& statsd_host, int statsd_port);
 
     const std::string& GetServiceName() const { return service_name_; }
     const std::string& GetInstanceId() const { return instance_id_; }
 
    private:
+    // One (service, named config) pair multiplexed over the stream
+    struct Subscription {
+        std::string service_name;
+        std::string config_name;  // empty = every config of service_name
+        ConfigData config;        // latest snapshot
+        int64_t version = 0;
+        ConfigUpdateCallback callback;
+
+        // Empty config_name instead keeps the latest snapshot per named config (versions only
+        // order within one named config) and the name of the one updated last
+        std::map<std::string, ConfigData> configs;
+        std::string last_config_name;
+    };
+
     void StreamLoop();
     void ConnectAndSubscribe();
     void HeartbeatLoop();
     void HandleConfigUpdate(const ConfigUpdate& update);
     void SetConnectionStatus(bool connected);
 
+    // Start-up timing: record the first config held and the server's sync confirmation
+    void MarkFirstConfig();
+    void MarkSynced();
+    int64_t MillisSinceStart() const;
+
+    // Write to the live stream; false if no stream is open or the write failed
+    bool WriteRequest(const SubscribeRequest& request);
+    // Caller must hold config_mutex_
+    void LoadCachedSubscription(Subscription& sub);
+    // Caller must hold config_mutex_
+    void StoreConfig(Subscription& sub, ConfigData config);
+    // Snapshot of config_name held for (service_name, config_name); nullptr if none.
+    // Caller must hold config_mutex_
+    const ConfigData* FindConfig(const std::string& service_name,
+                                 const std::string& config_name) const;
+    static void FillSubscription(const Subscription& sub, ConfigSubscription* out);
+    static std::string SubscriptionKey(const std::string& service_name,
+                                       const std::string& config_name);
+    static bool Matches(const Subscription& sub, const ConfigData& config);
+
     std::string server_address_;
     std::string service_name_;
     std::string instance_id_;
 
-    // gRPC
+    // gRPC (channel is shared through ChannelRegistry)
     std::shared_ptr<grpc::Channel> channel_;
     std::unique_ptr<DistributionService::Stub> stub_;
     std::unique_ptr<grpc::ClientContext> context_;
     std::unique_ptr<grpc::ClientReaderWriter<SubscribeRequest, ConfigUpdate>> stream_;
 
+    // Serializes stream writes; stream_open_ is true once the initial request is sent.
+    // Lock order: stream_mutex_ before config_mutex_.
+    std::mutex stream_mutex_;
+    bool stream_open_;
+
     // Disk cache
     std::unique_ptr<DiskCache> disk_cache_;
 
-    // Current config
+    // Current config (most recent update across all subscriptions)
     mutable std::mutex config_mutex_;
     ConfigData current_config_;
     int64_t current_version_;
 
+    // Subscriptions keyed by SubscriptionKey() (guarded by config_mutex_)
+    std::map<std::string, Subscription> subscriptions_;
+
+    // Start-up state (reset by Start). sync_mutex_ guards synced_ for StartAndWait.
+    std::chrono::steady_clock::time_point start_time_;
+    std::atomic<int64_t> first_config_ms_;
+    std::atomic<int64_t> sync_ms_;
+    std::mutex sync_mutex_;
+    std::condition_variable sync_cv_;
+    bool synced_;
+
+    // Optional StatsD reporting of start-up timings
+    std::unique_ptr<statsdclient::StatsDClient> statsd_;
+
     // Callbacks
     std::mutex callback_mutex_;
     ConfigUpdateCallback config_callback_;
@@ -2,59 +2,136 @@
 
 #include "config.pb.h"
 
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <vector>
 
 namespace configservice {
 
+/**
+ * @brief Zero-copy view of a cached config.
+ *
+ * `content` points straight into the memory-mapped cache file; `owner` keeps
+ * that mapping alive, so the view stays valid even after later saves remap
+ * or compact the file.
+ */
+struct CachedConfigView {
+    ConfigData metadata;  // every ConfigData field except content
+    std::string_view content;
+    std::shared_ptr<const void> owner;
+};
+
 /**
  * @brief Disk-based config cache for the Client SDK.
  *
- * Stores the last received ConfigData to disk using protobuf binary format.
- * On client startup, the cache is loaded and served immediately so the app
- * has a config even before the Distribution Service connection is established.
+ * Each service has one memory-mapped cache file holding the last
+ * `max_versions` versions of every (service, config_name) subscription, so
+ * the app has a config even before the Distribution Service connection is
+ * established.
  *
- * Cache location: {cache_dir}/{service_name}.cache
+ * Cache location: {cache_dir}/{service_name}.kcache
  * Default dir:    ~/.konfig/cache/
  *
- * Writes are atomic (write to .tmp, then rename) to prevent corruption.
- * Loads verify the content_hash field to detect corruption.
+ * File layout:
+ *
+ *   [FileHeader 64 B][IndexEntry x index_capacity][records ...]
+ *
+ * The index starts with 64 slots; when it fills up, compaction rewrites the
+ * file with room for twice the live entries.
+ *
+ * A record is the serialized ConfigData without its content, followed by the
+ * raw content bytes, so content can be handed out without copying or parsing.
+ *
+ * Saves are crash-safe appends: the record and its index entry are written
+ * and synced *before* the header's committed entry count and data end are
+ * advanced, so a torn write is simply never visible. Older versions past
+ * `max_versions` are marked dead and reclaimed by compaction (rewrite to
+ * .tmp, then rename). Writers across processes serialize on {file}.lock.
  */
 class DiskCache {
    public:
     /**
-     * @param cache_dir Directory to store cache files. Empty string uses ~/.konfig/cache/.
+     * @param cache_dir    Directory to store cache files. Empty string uses ~/.konfig/cache/.
+     * @param max_versions Versions kept per (service, config_name) (minimum 1).
      */
-    explicit DiskCache(const std::string& cache_dir = "");
+    explicit DiskCache(const std::string& cache_dir = "", int max_versions = 3);
+    ~DiskCache();
+
+    DiskCache(const DiskCache&) = delete;
+    DiskCache& operator=(const DiskCache&) = delete;
 
     /**
-     * @brief Atomically save a config to disk.
+     * @brief Append a config to the cache (crash-safe).
+     * @param config      Config to persist (filed under config.service_name()).
+     * @param config_name Subscription the entry belongs to. Empty files it under the service.
      * @return true on success, false on I/O error.
      */
-    bool Save(const ConfigData& config);
+    bool Save(const ConfigData& config, const std::string& config_name = "");
 
     /**
-     * @brief Load cached config for a service.
+     * @brief Load the newest cached config (copies content, verifies content_hash).
      * @param service_name Service to look up.
      * @param out         Populated on success.
-     * @return true if cache exists and passes integrity check.
+     * @param config_name Named config to look up. Empty loads the whole-service entry.
+     * @return true if an entry exists and passes the integrity check.
+     */
+    bool Load(const std::string& service_name, ConfigData& out,
+              const std::string& config_name = "");
+
+    /**
+     * @brief Zero-copy access to a cached config.
+     * @param version 0 for the newest cached version, otherwise that exact version.
+     * @return true if the entry exists and its content matches content_hash. Each entry is
+     *         hashed the first time it is viewed in this process; corrupt ones are skipped.
      */
-    bool Load(const std::string& service_name, ConfigData& out);
+    bool View(const std::string& service_name, CachedConfigView& out,
+              const std::string& config_name = "", int64_t version = 0);
 
     /**
-     * @brief Check whether a cache file exists for the service.
+     * @brief Cached versions for a subscription, newest first.
      */
-    bool Exists(const std::string& service_name) const;
+    std::vector<int64_t> ListVersions(const std::string& service_name,
+                                      const std::string& config_name = "");
+
+    /**
+     * @brief Named configs cached for a service, most recently saved first.
+     */
+    std::vector<std::string> ListConfigNames(const std::string& service_name);
+
+    /**
+     * @brief Check whether a cache entry exists for the service (and named config).
+     */
+    bool Exists(const std::string& service_name, const std::string& config_name = "");
 
     /**
      * @brief Full path to the cache file for a service.
      */
     std::string GetCachePath(const std::string& service_name) const;
 
+    /**
+     * @brief Lower-case hex SHA-256 of content (the format used in content_hash).
+     */
+    static std::string ComputeHash(const std::string& content);
+
    private:
+    struct Mapping;
+
     std::string cache_dir_;
+    int max_versions_;
+
+    // Read mappings per cache file, refreshed when the file changes on disk
+    std::mutex mutex_;
+    std::map<std::string, std::shared_ptr<Mapping>> mappings_;
 
     bool EnsureCacheDir() const;
-    static std::string ComputeHash(const std::string& content);
+    std::shared_ptr<Mapping> MapFile(const std::string& path);
+    bool Compact(const std::string& path);
+    static bool VerifyContent(Mapping& mapping, uint64_t record_offset, uint32_t meta_checksum,
+                              const ConfigData& metadata, std::string_view content);
     static std::string ResolveDefaultCacheDir();
 };
 
@@ -0,0 +1,181 @@
+#pragma once
+
+#include "config.pb.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace configservice {
+
+/**
+ * @brief Shared-memory layout used by konfig-agent and ShmConfigReader.
+ *
+ * One POSIX shared-memory segment holds a fixed table of entries, one per
+ * (service_name, config_name) subscription. Each entry owns two buffers of
+ * `buffer_capacity` bytes holding a serialized ConfigData:
+ *
+ *   [ShmHeader][ShmEntry x max_entries][buffers: entry0/0, entry0/1, entry1/0, ...]
+ *
+ * The agent is the only writer. A publish writes the inactive buffer, then
+ * flips `active`, bracketed by a seqlock counter. Readers never block the
+ * writer: they copy the active buffer and retry only if a *second* publish
+ * started while they were copying.
+ */
+namespace shm {
+
+constexpr uint32_t kMagic = 0x4B4E4647;  // "KNFG"
+constexpr uint32_t kLayoutVersion = 1;
+constexpr size_t kNameSize = 128;
+
+struct alignas(64) ShmHeader {
+    uint32_t magic;
+    uint32_t layout_version;
+    uint32_t max_entries;
+    uint32_t buffer_capacity;                // bytes per buffer
+    std::atomic<uint32_t> entry_count;       // entries [0, entry_count) are in use
+    std::atomic<uint64_t> publish_count;     // total publishes since creation
+    std::atomic<int64_t> heartbeat_unix_ms;  // refreshed by the agent while it runs
+    int64_t agent_pid;
+};
+
+struct alignas(64) ShmEntry {
+    char service_name[kNameSize];
+    char config_name[kNameSize];
+    std::atomic<uint64_t> seq;      // odd while a publish is in progress
+    std::atomic<int64_t> version;   // version in the active buffer (lock-free polling)
+    std::atomic<uint32_t> active;   // 0 or 1
+    std::atomic<uint32_t> size[2];  // serialized size per buffer
+};
+
+}  // namespace shm
+
+/**
+ * @brief Writer side of the shared-memory store (used by konfig-agent).
+ *
+ * Reopening an existing segment with the same geometry keeps its entries,
+ * so processes already attached survive an agent restart.
+ */
+class ShmConfigPublisher {
+   public:
+    /**
+     * @param shm_name         POSIX shm name (e.g. "/konfig")
+     * @param max_entries      Number of (service, config) slots
+     * @param buffer_capacity  Largest serialized config accepted, in bytes
+     */
+    ShmConfigPublisher(const std::string& shm_name, uint32_t max_entries = 64,
+                       uint32_t buffer_capacity = 1024 * 1024);
+    ~ShmConfigPublisher();
+
+    ShmConfigPublisher(const ShmConfigPublisher&) = delete;
+    ShmConfigPublisher& operator=(const ShmConfigPublisher&) = delete;
+
+    /**
+     * @brief Create (or reopen) and map the segment
+     */
+    bool Initialize();
+
+    /**
+     * @brief Unmap the segment. Pass unlink=true to remove it for all readers.
+     */
+    void Shutdown(bool unlink = false);
+
+    /**
+     * @brief Publish a config under the subscription (service_name, config_name)
+     * @return false if the table is full or the config exceeds buffer_capacity
+     */
+    bool Publish(const std::string& service_name, const std::string& config_name,
+                 const ConfigData& config);
+
+    /**
+     * @brief Refresh the liveness timestamp readers use to detect a dead agent
+     */
+    void Heartbeat();
+
+   private:
+    std::string shm_name_;
+    uint32_t max_entries_;
+    uint32_t buffer_capacity_;
+
+    int fd_;
+    void* base_;
+    size_t mapped_size_;
+
+    std::mutex write_mutex_;  // single-writer requirement of the seqlock
+    std::map<std::string, uint32_t> index_;
+
+    int FindOrClaimEntry(const std::string& service_name, const std::string& config_name);
+};
+
+/**
+ * @brief Read-only attach mode for processes co-located with konfig-agent.
+ *
+ * No gRPC, no stream, no disk cache: configs are read straight from the
+ * agent's shared-memory segment. GetVersion() is a single atomic load, so it
+ * can be polled on hot paths to detect changes; Read() copies the config.
+ *
+ * Example:
+ * @code
+ *   ShmConfigReader reader("/konfig");
+ *   if (reader.Attach()) {
+ *       ConfigData config;
+ *       if (reader.Read("payment-service", "database-config", config)) {
+ *           std::cout << config.version() << std::endl;
+ *       }
+ *   }
+ * @endcode
+ */
+class ShmConfigReader {
+   public:
+    explicit ShmConfigReader(const std::string& shm_name);
+    ~ShmConfigReader();
+
+    ShmConfigReader(const ShmConfigReader&) = delete;
+    ShmConfigReader& operator=(const ShmConfigReader&) = delete;
+
+    /**
+     * @brief Map the agent's segment read-only
+     * @return false if the agent has not created it or the layout is incompatible
+     */
+    bool Attach();
+
+    /**
+     * @brief Unmap the segment
+     */
+    void Detach();
+
+    /**
+     * @brief Entry index for a subscription, or -1 if the agent has not published it
+     */
+    int FindEntry(const std::string& service_name, const std::string& config_name) const;
+
+    /**
+     * @brief Version currently published for an entry (0 if none)
+     */
+    int64_t GetVersion(int entry) const;
+    int64_t GetVersion(const std::string& service_name, const std::string& config_name) const;
+
+    /**
+     * @brief Copy a consistent snapshot of an entry's config
+     */
+    bool Read(int entry, ConfigData& out) const;
+    bool Read(const std::string& service_name, const std::string& config_name,
+              ConfigData& out) const;
+
+    /**
+     * @brief Milliseconds since the agent last refreshed its heartbeat (-1 if detached)
+     */
+    int64_t HeartbeatAgeMs() const;
+
+   private:
+    std::string shm_name_;
+    const void* base_;
+    size_t mapped_size_;
+
+    static constexpr int kMaxReadRetries = 64;
+};
+
+}  // namespace configservice
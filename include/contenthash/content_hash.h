@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace contenthash {
+
+/**
+ * @brief Lower-case hex SHA-256 of content — the format stored in content_hash
+ *
+ * Used by every service and the SDK so hashes written by the API, cached by
+ * the validation service and verified by DiskCache always agree. OpenSSL's
+ * EVP digest picks the SHA-NI / ARMv8 crypto extensions when the CPU has them.
+ *
+ * Example:
+ * @code
+ *   std::string hash = contenthash::Sha256Hex(config.content());
+ * @endcode
+ */
+std::string Sha256Hex(std::string_view content);
+
+}  // namespace contenthash
@@ -26,7 +26,10 @@ class DatabaseManager {
 
     // Config operations
     ConfigData GetLatestConfig(const std::string& service_name);
-    ConfigData GetLatestRolledOutConfig(const std::string& service_name);
+    ConfigData GetLatestRolledOutConfig(const std::string& service_name,
+                                        const std::string& config_name);
+    // GetLatestRolledOutConfig for every named config of the service
+    std::vector<ConfigData> GetLatestRolledOutConfigs(const std::string& service_name);
     ConfigData GetConfigByVersion(const std::string& service_name, int64_t version);
     ConfigData GetConfigById(const std::string& config_id);
     std::vector<ConfigData> ListConfigs(const std::string& service_name, int limit);
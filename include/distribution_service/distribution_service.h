@@ -7,8 +7,10 @@
 #include <algorithm>
 #include <atomic>
 #include <librdkafka/rdkafkacpp.h>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <thread>
 #include <unordered_map>
 #include <unordered_set>
@@ -22,15 +24,28 @@
 
 namespace configservice {
 
-struct ClientInfo {
+// One (service, named config) pair carried on a client's stream
+struct ClientSubscription {
     std::string service_name;
+    std::string config_name;  // empty = every config of service_name (single-config clients)
+    int64_t current_version = 0;
+
+    // Empty config_name: version held per named config. current_version is then only the
+    // fallback for configs missing here (older clients report one version for the service).
+    std::map<std::string, int64_t> config_versions;
+};
+
+struct ClientInfo {
+    std::string service_name;  // service that opened the stream
     std::string instance_id;
-    int64_t current_version;
     grpc::ServerContext* context;  // needed to cancel stream on timeout
     grpc::ServerReaderWriter<ConfigUpdate, SubscribeRequest>* stream;
     std::chrono::steady_clock::time_point last_heartbeat;
     std::atomic<bool> active;
     std::mutex write_mutex;  // serializes all stream->Write() calls
+
+    std::mutex subscriptions_mutex;  // guards subscriptions
+    std::vector<ClientSubscription> subscriptions;
 };
 
 // Note: Class name is DistributionServiceImpl to avoid conflict with proto-generated
@@ -79,10 +94,22 @@ class DistributionServiceImpl final : public DistributionService::Service {
     // Helper methods
     ConfigData FetchConfig(const std::string& service_name, int64_t version);
     bool SendConfigToClient(std::shared_ptr<ClientInfo> client, const ConfigData& config);
+    // Send the latest rolled-out config (every named config for an empty config_name) if
+    // newer than the client's; *fetched is set to false when the lookup failed
+    bool SendInitialConfig(std::shared_ptr<ClientInfo> client, const ClientSubscription& sub,
+                           bool* fetched = nullptr);
+    std::vector<ClientSubscription> AddSubscriptions(std::shared_ptr<ClientInfo> client,
+                                                     const SubscribeRequest& request);
+    // One service_instances row per (instance, service), holding the highest version in
+    // `held` of any of that service's configs
+    void ReportClientStatus(const std::string& instance_id,
+                            const std::vector<ClientSubscription>& held,
+                            const std::set<std::string>& services, const std::string& status);
+    static std::vector<ClientSubscription> SnapshotSubscriptions(ClientInfo& client);
     void RegisterClient(const std::string& key, std::shared_ptr<ClientInfo> client);
     void UnregisterClient(const std::string& key);
     size_t GetActiveClientCount();
-    std::vector<std::shared_ptr<ClientInfo>> GetClientsForService(const std::string& service_name);
+    std::vector<std::shared_ptr<ClientInfo>> GetClientsForConfig(const ConfigData& config);
 
     // Heartbeat monitoring
     void StartHeartbeatMonitor();
@@ -97,11 +124,19 @@ class DistributionServiceImpl final : public DistributionService::Service {
     // Rollout execution
     void ExecuteRollout(const std::string& service_name, const std::string& config_id);
     void PollPendingRollouts();
+    // Rollout progress can flip the active version; drop the API service's cached lists
+    void InvalidateApiReadCache(const std::string& service_name);
 
     // Metrics
     void UpdateMetrics();
 
     // Utilities
+    static bool SubscriptionMatches(const ClientSubscription& sub, const ConfigData& config);
+    static ClientSubscription ParseSubscription(const ConfigSubscription& s,
+                                                const std::string& default_service);
+    static int64_t HeldVersion(const ClientSubscription& sub, const std::string& config_name);
+    static int64_t SubscribedVersion(ClientInfo& client, const ConfigData& config);
+    static std::set<std::string> SubscribedServices(const std::vector<ClientSubscription>& subs);
     static std::string ExtractJsonString(const std::string& json, const std::string& key);
     static int64_t ExtractJsonInt(const std::string& json, const std::string& key);
 };
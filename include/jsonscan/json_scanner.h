@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace jsonscan {
+
+/**
+ * @brief Outcome of a JSON syntax check
+ *
+ * On failure line and column point at the first offending character, so the message can be
+ * shown to whoever wrote the config as-is.
+ */
+struct ScanResult {
+    bool valid = true;
+    std::string message;  // What went wrong; empty when valid
+    size_t offset = 0;    // Byte offset of the error
+    int line = 0;         // 1-based
+    int column = 0;       // 1-based, counted in characters (UTF-8 code points)
+
+    // "<message> at line L, column C"
+    std::string Describe() const;
+};
+
+// Deeper documents are rejected instead of growing the container stack without bound
+constexpr size_t kDefaultMaxDepth = 512;
+
+/**
+ * @brief Single-pass RFC 8259 syntax check of a complete JSON text
+ *
+ * Checks the full grammar — literals, number syntax, escapes, UTF-8 and control characters
+ * in strings, trailing commas, trailing content — in one forward pass with an explicit
+ * container stack; nothing is allocated per value. On SSE2 targets string bodies and
+ * whitespace runs are skipped 16 bytes at a time. Shared by the API and Validation services
+ * so both report identical errors.
+ *
+ * Example:
+ * @code
+ *   auto scan = jsonscan::Validate(config.content());
+ *   if (!scan.valid) errors.push_back("Invalid JSON: " + scan.Describe());
+ * @endcode
+ */
+ScanResult Validate(std::string_view json, size_t max_depth = kDefaultMaxDepth);
+
+/**
+ * @brief Parsed JSON value
+ *
+ * A plain tree: containers own their children, object members keep document order.
+ * Parse() also records where each value's text is, as byte offsets [begin, end).
+ */
+struct Value {
+    enum class Type : uint8_t { kNull, kBool, kNumber, kString, kArray, kObject };
+
+    Type type = Type::kNull;
+    bool boolean = false;
+    uint32_t begin = 0;  // Position in the document; 0 for trees not built by Parse()
+    uint32_t end = 0;
+    double number = 0;
+    std::string string;                                  // Decoded string; a number's source text
+    std::vector<Value> items;                            // kArray
+    std::vector<std::pair<std::string, Value>> members;  // kObject
+
+    bool is_object() const { return type == Type::kObject; }
+    bool is_array() const { return type == Type::kArray; }
+
+    // Member named key, or nullptr (last one wins for duplicate names)
+    const Value* Find(std::string_view key) const;
+};
+
+/**
+ * @brief Validate() that also builds the document tree
+ *
+ * Same single pass and same errors as Validate(); root is reset when the text is invalid.
+ * Positions are left at 0 for texts of 4 GB or more.
+ */
+ScanResult Parse(std::string_view json, Value& root, size_t max_depth = kDefaultMaxDepth);
+
+}  // namespace jsonscan
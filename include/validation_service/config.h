@@ -34,9 +34,27 @@ struct StatsDConfig {
 
 struct ValidationConfig {
     size_t max_config_size = 1024 * 1024;  // 1MB
-    int timeout_seconds = 5;
+    int timeout_seconds = 5;  // Per config; enforced during parsing, rules and schemas
     bool enable_caching = true;
     bool strict_mode = false;
+    int schema_cache_ttl_seconds = 300;  // Compiled schemas; 0 = until re-registered
+    int rules_version_check_ms = 1000;   // How long compiled rules are trusted unchecked
+    size_t yaml_stream_threshold_bytes = 256 * 1024;  // Larger YAML is not built as a tree
+    size_t yaml_max_depth = 512;           // Nesting, counting values replayed from aliases
+    size_t yaml_max_alias_nodes = 100000;  // Values aliases may expand to per document
+    int incremental_cache_mb = 128;  // Documents kept as bases for incremental validation
+    size_t incremental_min_bytes = 64 * 1024;  // Smaller configs are always checked in full
+    int result_cache_max_mb = 64;  // In-process copy of cached responses, in front of Redis
+    int batch_workers = 0;         // ValidateConfigs threads; 0 = one per core
+};
+
+struct HistoryConfig {
+    bool enabled = true;
+    double sample_rate = 1.0;     // Share of passing validations recorded; failures always are
+    int flush_interval_ms = 1000;
+    size_t batch_size = 500;
+    int queue_max_mb = 64;        // Beyond this, records are dropped instead of queued
+    int retention_days = 30;      // 0 = keep forever
 };
 
 struct ServiceConfig {
@@ -45,6 +63,7 @@ struct ServiceConfig {
     RedisConfig redis;
     StatsDConfig statsd;
     ValidationConfig validation;
+    HistoryConfig history;
 
     static ServiceConfig LoadFromFile(const std::string& path);
     static ServiceConfig LoadDefaults();
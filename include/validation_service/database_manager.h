@@ -4,10 +4,13 @@
 
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <pqxx/pqxx>
 #include <string>
 #include <vector>
 
+#include "history_recorder.h"
+#include "rule_set.h"
 #include "validation.pb.h"
 
 namespace validationservice {
@@ -23,33 +26,34 @@ class DatabaseManager {
     // Schema operations
     std::pair<bool, std::string> RegisterSchema(const configservice::ValidationSchema& schema);
 
-    configservice::ValidationSchema GetSchema(const std::string& schema_id);
+    // Empty schema_id when there is no such schema, std::nullopt on error
+    std::optional<configservice::ValidationSchema> GetSchema(const std::string& schema_id);
 
     std::vector<configservice::ValidationSchema> ListSchemas(const std::string& service_name,
                                                              int limit, int offset,
                                                              int& total_count);
 
-    // Validation history
-    void RecordValidation(const std::string& service_name, const std::string& content, bool result,
-                          const std::string& errors, const std::string& warnings,
-                          const std::string& validated_by);
+    // Validation history, written by HistoryRecorder on a connection of its own so batches
+    // never queue behind request-path queries. One transaction per batch; bodies go to
+    // config_blobs.
+    bool RecordValidations(const std::vector<HistoryRecord>& records);
 
-    // Validation rules
-    struct ValidationRule {
-        std::string rule_id;
-        std::string service_name;
-        std::string field_path;
-        std::string rule_type;
-        std::string rule_config;
-        std::string error_message;
-    };
+    // prune_validation_history(): rows deleted (at most batch_size), -1 on error
+    int64_t PruneValidationHistory(int retention_days, int batch_size);
 
-    std::vector<ValidationRule> GetRulesForService(const std::string& service_name);
+    // Validation rules; std::nullopt on error
+    std::optional<std::vector<ValidationRule>> GetRulesForService(
+        const std::string& service_name);
+
+    // validation_rule_versions.version: 0 if the service never had rules, -1 on error
+    int64_t GetRuleSetVersion(const std::string& service_name);
 
    private:
     PostgresConfig config_;
     std::unique_ptr<pqxx::connection> conn_;
     std::mutex mutex_;
+    std::unique_ptr<pqxx::connection> history_conn_;  // Opened on first use
+    std::mutex history_mutex_;
     bool initialized_;
 
     std::string BuildConnectionString();
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "config.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace validationservice {
+
+// One validation_history row
+struct HistoryRecord {
+    std::string service_name;
+    std::string content_hash;
+    std::shared_ptr<const std::string> content;  // Null when the blob is known to exist
+    bool result = false;
+    std::string errors;    // JSON
+    std::string warnings;  // JSON
+    std::string validated_by;
+    std::chrono::system_clock::time_point validated_at;  // Latest of the folded validations
+    int repeat_count = 1;
+};
+
+/**
+ * @brief Writes validation history off the request path
+ *
+ * Record() only queues; a background thread writes the queue in one transaction per
+ * history.flush_interval_ms (or per history.batch_size records). Identical validations
+ * queued in the same window become one row with repeat_count, and a body whose blob was
+ * written recently is referenced by hash without being copied again. Passing validations
+ * are sampled at history.sample_rate; failures are always kept. When the queue exceeds
+ * history.queue_max_mb, new records are dropped rather than slowing requests down. The same
+ * thread prunes rows older than history.retention_days.
+ */
+class HistoryRecorder {
+   public:
+    enum class Outcome { kQueued, kMerged, kSampledOut, kDropped, kDisabled };
+
+    // Writes one batch; false if nothing was stored
+    using Writer = std::function<bool(const std::vector<HistoryRecord>& records)>;
+    // Deletes up to batch_size rows past retention; returns the count or -1 on error
+    using Pruner = std::function<int64_t(int retention_days, int batch_size)>;
+
+    HistoryRecorder(const HistoryConfig& config, Writer write, Pruner prune);
+    ~HistoryRecorder();
+
+    void Start();
+    void Stop();  // Writes what is still queued
+
+    Outcome Record(const std::string& service_name, const std::string& content,
+                   const std::string& content_hash, bool result, const std::string& errors,
+                   const std::string& warnings, const std::string& validated_by);
+
+   private:
+    HistoryConfig config_;
+    Writer write_;
+    Pruner prune_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::vector<HistoryRecord> pending_;
+    std::unordered_map<std::string, size_t> pending_index_;  // Fold key -> pending_ index
+    std::unordered_set<std::string> pending_blobs_;          // Hashes whose body is queued
+    size_t pending_bytes_ = 0;
+    // Bodies stored by recent batches, by hash, with when they were stored
+    std::unordered_map<std::string, std::chrono::steady_clock::time_point> known_blobs_;
+    bool running_ = false;
+    std::thread worker_;
+
+    void Run();
+    void Flush(std::vector<HistoryRecord> batch);
+    bool KnownBlob(const std::string& content_hash, std::chrono::steady_clock::time_point now);
+};
+
+}  // namespace validationservice
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "jsonscan/json_scanner.h"
+#include "validation.pb.h"
+
+namespace validationservice {
+
+/**
+ * @brief Open-addressing map from container positions to 32-bit indexes
+ *
+ * Verdicts are kept for most containers of a large document, where a node allocation per
+ * entry (std::unordered_map) cost more than the evaluation being saved.
+ */
+class PositionIndex {
+   public:
+    static constexpr uint32_t kNone = UINT32_MAX;
+
+    void Reserve(size_t count);
+
+    // Entry for position, inserted as kNone when missing
+    uint32_t& operator[](uint32_t position);
+
+    // kNone when missing
+    uint32_t Find(uint32_t position) const;
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+
+   private:
+    std::vector<std::pair<uint32_t, uint32_t>> slots_;  // Power of two; kNone keys are free
+    size_t size_ = 0;
+
+    size_t Slot(uint32_t position) const;
+};
+
+// Numbers a tree not built by jsonscan::Parse() (YAML, TOML) in document order: begin is a
+// node's index, end one past its last descendant's. Containers can then be keyed like JSON's.
+void AssignPositions(jsonscan::Value& document);
+
+/**
+ * @brief The containers of a document that are unchanged since a base version
+ *
+ * Unchanged containers are found as ranges of positions, each shifted by a fixed amount from
+ * the base document. For JSON the two texts are compared first: whatever ends before the
+ * first differing byte is unchanged in place, and in each container along the path to the
+ * edit, the children after it are unchanged (shifted by the change in length) from the first
+ * one that lines up with the base. Only the containers along that path are looked at, not
+ * the whole document. Trees numbered by AssignPositions() are compared node by node instead,
+ * object members by key and array items by index, keeping the largest unchanged containers.
+ */
+class DocumentDiff {
+   public:
+    // Both parsed by jsonscan::Parse() from text and base_text
+    DocumentDiff(const jsonscan::Value& document, std::string_view text,
+                 const jsonscan::Value& base, std::string_view base_text);
+    // Both numbered by AssignPositions()
+    DocumentDiff(const jsonscan::Value& document, const jsonscan::Value& base);
+
+    // Position in the base document of the unchanged container at [begin, end)
+    bool Map(uint32_t begin, uint32_t end, uint32_t* base_begin) const;
+
+    size_t ranges() const { return ranges_.size(); }
+    size_t HeapBytes() const { return ranges_.capacity() * sizeof(Range); }
+
+   private:
+    struct Range {
+        uint32_t begin;
+        uint32_t end;
+        int64_t shift;  // Position here minus position in the base
+    };
+
+    uint32_t prefix_ = 0;       // Containers ending here or before are unchanged in place
+    uint32_t changed_end_ = 0;  // End of the edited bytes, in this document's text
+    int64_t shift_ = 0;         // Of the text after the edit
+    std::vector<Range> ranges_;  // Sorted, disjoint
+    std::vector<std::pair<const jsonscan::Value*, const jsonscan::Value*>> pending_;
+
+    void Descend(const jsonscan::Value& value, const jsonscan::Value& base);
+    bool Compare(const jsonscan::Value& value, const jsonscan::Value& base);
+};
+
+/**
+ * @brief The errors of one validation pass (custom rules or a schema), by subtree
+ *
+ * A verdict is the slice of the pass's errors that one evaluation step produced for one
+ * container: the rule set, or a subschema at some evaluation depth, applied to the value at
+ * some path. Errors carry that path, and a step only looks at the path and the subtree below
+ * it, so on an equal subtree at the same path it produces exactly the same errors.
+ *
+ * A record made against a base version only holds the verdicts of the steps that ran; those
+ * on unchanged containers are looked up in the base's record, through the diff. The chain of
+ * records is cut every kMaxChain versions by copying them in.
+ */
+struct PassRecord {
+    static constexpr uint32_t kNone = PositionIndex::kNone;
+    static constexpr size_t kMaxChain = 8;
+
+    struct Verdict {
+        int step;        // Subschema index; 0 for custom rules
+        uint32_t depth;  // Evaluation depth the step ran at
+        uint32_t begin;  // errors[begin, end)
+        uint32_t end;
+        uint32_t next;  // Previous verdict on the same value, or kNone
+        bool ok;
+    };
+
+    std::vector<configservice::ValidationError> errors;
+    std::vector<Verdict> verdicts;
+    PositionIndex latest;  // Per container position, into verdicts
+
+    std::shared_ptr<const PassRecord> base;    // Null for a self-contained record
+    std::shared_ptr<const DocumentDiff> diff;  // From this version to base's
+    size_t chain = 0;                          // Records reachable through base
+
+    void Add(uint32_t position, const Verdict& verdict);
+    // Verdicts on the container at position are verdicts[First(position)], then following next
+    uint32_t First(uint32_t position) const;
+
+    // The verdict of step at depth on the container at [begin, end), here or in a base record;
+    // *owner is the record holding it (and its errors)
+    const Verdict* Find(uint32_t begin, uint32_t end, int step, uint32_t depth,
+                        const PassRecord** owner) const;
+};
+
+/**
+ * @brief Records the verdicts of a pass and, against a base version, replays them
+ *
+ * Evaluators call Replay() before running a step on a container. When the container is
+ * unchanged and the base has a verdict for that step, its errors are appended and the step
+ * is skipped; otherwise they run it and Record() the outcome. Replayed verdicts stay in the
+ * base's record, which this version's record links to, so it can be the base of the next one.
+ */
+class IncrementalPass {
+   public:
+    // record may be null (nothing kept); diff and base are null for a from-scratch pass
+    explicit IncrementalPass(PassRecord* record,
+                             std::shared_ptr<const DocumentDiff> diff = nullptr,
+                             std::shared_ptr<const PassRecord> base = nullptr);
+
+    // The pass's errors start at errors[offset]
+    void Start(size_t offset);
+
+    // Appends the base verdict's errors unless more than room of them; ok as recorded
+    bool Replay(const jsonscan::Value& value, int step, size_t depth,
+                std::vector<configservice::ValidationError>& errors, size_t room, bool* ok);
+
+    // errors[begin, end) came from running step on value
+    void Record(const jsonscan::Value& value, int step, size_t depth, size_t begin, size_t end,
+                bool ok);
+
+    // Copies the pass's errors on document into the record and links it to the base's
+    void Finish(const jsonscan::Value& document,
+                const std::vector<configservice::ValidationError>& errors);
+
+    size_t replayed() const { return replayed_; }
+
+   private:
+    PassRecord* record_;
+    std::shared_ptr<const DocumentDiff> diff_;
+    std::shared_ptr<const PassRecord> base_;
+    size_t offset_ = 0;
+    size_t replayed_ = 0;
+
+    // Copies the base verdicts on value and the containers below it into the record
+    void Flatten(const jsonscan::Value& value);
+};
+
+// What a later version needs to be validated incrementally against this one
+struct Baseline {
+    std::string content;  // JSON only: the text the document's positions refer to
+    jsonscan::Value document;
+    std::shared_ptr<PassRecord> rules = std::make_shared<PassRecord>();
+    std::shared_ptr<PassRecord> schema = std::make_shared<PassRecord>();
+};
+
+/**
+ * @brief LRU of baselines keyed like ResultCache, bounded by their approximate size
+ *
+ * The key covers the schema and rule set versions, so a baseline is only ever used with the
+ * rules it was validated against.
+ */
+class BaselineCache {
+   public:
+    explicit BaselineCache(size_t max_bytes);
+
+    // Null on a miss
+    std::shared_ptr<const Baseline> Get(const std::string& key);
+
+    void Put(const std::string& key, std::shared_ptr<const Baseline> baseline);
+
+   private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const Baseline> baseline;
+        size_t bytes;
+    };
+
+    size_t max_bytes_;
+    std::mutex mutex_;
+    std::list<Entry> entries_;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    size_t bytes_ = 0;
+
+    void Erase(std::list<Entry>::iterator entry);
+};
+
+}  // namespace validationservice
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "jsonscan/json_scanner.h"
+#include "validation.pb.h"
+#include "validation_service/incremental.h"
+#include "validation_service/validation_budget.h"
+
+namespace validationservice {
+
+/**
+ * @brief A JSON Schema compiled into a flat validation program
+ *
+ * Supports the draft 2020-12 validation vocabulary that configs actually use:
+ *   type, enum, const, allOf/anyOf/oneOf/not, if/then/else, $ref to local JSON pointers
+ *   ("#", "#/$defs/...", "#/definitions/..."), properties, patternProperties,
+ *   additionalProperties, propertyNames, required, dependentRequired, min/maxProperties,
+ *   prefixItems, items, contains, min/maxContains, min/maxItems, uniqueItems, minimum, maximum,
+ *   exclusiveMinimum, exclusiveMaximum, multipleOf, minLength, maxLength, pattern; also the
+ *   draft 7 dependencies and draft 4 boolean exclusiveMinimum/exclusiveMaximum.
+ * Annotations (title, description, default, examples, format, ...) are ignored. Keywords
+ * whose meaning cannot be honoured (unevaluated*, $dynamicRef, remote $ref) fail compilation
+ * instead of silently passing everything.
+ *
+ * Compilation does all per-schema work once: each subschema becomes a node in a vector,
+ * required keys and property names become hash lookups, enum/const values are stored as
+ * canonical strings in a hash set and patterns are compiled to std::regex. Validation is then
+ * a walk over the document that never touches the schema text. Instances are immutable and
+ * safe to share between threads.
+ */
+class CompiledSchema {
+   public:
+    // Error lists are truncated past this many entries
+    static constexpr size_t kMaxErrors = 100;
+
+    // Throws std::invalid_argument naming the offending keyword and its location
+    static std::shared_ptr<const CompiledSchema> Compile(const std::string& schema_json);
+
+    // Appends one "schema" error per violation; true when the document conforms. Stops
+    // without further errors once the budget (if any) is exhausted. With incremental, the
+    // verdicts are recorded and unchanged subtrees reuse those of the base version.
+    bool Validate(const jsonscan::Value& document,
+                  std::vector<configservice::ValidationError>& errors,
+                  ValidationBudget* budget = nullptr,
+                  IncrementalPass* incremental = nullptr) const;
+
+    // Number of compiled subschemas
+    size_t node_count() const;
+
+    CompiledSchema();
+    ~CompiledSchema();
+
+   private:
+    struct Node;
+    class Compiler;
+    class Evaluator;
+
+    std::vector<Node> nodes_;  // nodes_[0] is the root schema
+};
+
+/**
+ * @brief In-process cache of compiled schemas keyed by schema_id
+ *
+ * Entries expire after ttl so schemas changed behind the service's back are eventually
+ * picked up; RegisterSchema invalidates its id right away. Missing and uncompilable schemas
+ * are cached too, so a bad schema_id does not cost a database round trip per request;
+ * failed loads are not.
+ */
+class SchemaCache {
+   public:
+    struct Entry {
+        std::shared_ptr<const CompiledSchema> schema;  // Null when there is nothing to apply
+        std::string error;  // Why schema is null; empty when it is not a JSON Schema at all
+        std::string version;  // SHA-256 of the stored type and content; empty if not found
+        bool load_failed = false;  // The database could not be asked; nothing may be cached
+    };
+
+    // Empty schema_id when there is no such schema, std::nullopt when loading failed
+    using Loader =
+        std::function<std::optional<configservice::ValidationSchema>(const std::string& schema_id)>;
+
+    explicit SchemaCache(std::chrono::seconds ttl);
+
+    // Cached entry, or load + compile outside the lock on a miss. A failed load is returned
+    // with load_failed set and not cached, so the next request tries again.
+    Entry Get(const std::string& schema_id, const Loader& load);
+
+    void Invalidate(const std::string& schema_id);
+
+   private:
+    struct Slot {
+        Entry entry;
+        std::chrono::steady_clock::time_point loaded_at;
+    };
+
+    std::chrono::seconds ttl_;  // 0 = keep until invalidated
+    std::mutex mutex_;
+    std::unordered_map<std::string, Slot> slots_;
+    uint64_t generation_ = 0;  // Bumped by Invalidate so in-flight loads do not store stale data
+};
+
+}  // namespace validationservice
@@ -3,6 +3,8 @@
 #include <string>
 #include <vector>
 
+#include "jsonscan/json_scanner.h"
+#include "json_schema.h"
 #include "validation.pb.h"
 
 namespace validationservice {
@@ -15,10 +17,20 @@ class JsonValidator {
     bool ValidateSyntax(const std::string& content,
                         std::vector<configservice::ValidationError>& errors);
 
-    // Validate against JSON schema
+    // ValidateSyntax that also builds the document tree, for schema validation
+    bool Parse(const std::string& content, jsonscan::Value& document,
+               std::vector<configservice::ValidationError>& errors);
+
+    // Validate against JSON schema (compiles the schema on every call)
     bool ValidateSchema(const std::string& content, const std::string& schema,
                         std::vector<configservice::ValidationError>& errors);
 
+    // Validate a parsed document against an already compiled schema
+    bool ValidateSchema(const jsonscan::Value& document, const CompiledSchema& schema,
+                        std::vector<configservice::ValidationError>& errors,
+                        ValidationBudget* budget = nullptr,
+                        IncrementalPass* incremental = nullptr);
+
     // Validate value ranges
     bool ValidateRanges(const std::string& content, const std::string& service_name,
                         std::vector<configservice::ValidationError>& errors);
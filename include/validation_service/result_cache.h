@@ -0,0 +1,58 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "validation.pb.h"
+
+namespace validationservice {
+
+/**
+ * @brief In-process LRU of complete ValidateConfig responses, in front of Redis
+ *
+ * Keys come from Key(), which hashes everything a result depends on, so an entry never has
+ * to be invalidated: a changed schema or rule set simply produces a different key. Entries
+ * expire after ttl (the Redis TTL) and the least recently used ones are evicted once the
+ * serialized responses exceed max_bytes.
+ */
+class ResultCache {
+   public:
+    using Response = configservice::ValidateConfigResponse;
+
+    ResultCache(size_t max_bytes, std::chrono::seconds ttl);
+
+    // SHA-256 (hex) of the request fields that decide the result plus the schema and rule set
+    // versions they were validated against. content_hash is Sha256Hex(request.content()).
+    static std::string Key(const configservice::ValidateConfigRequest& request,
+                           const std::string& format, const std::string& content_hash,
+                           const std::string& schema_version, int64_t rules_version);
+
+    // Null on a miss
+    std::shared_ptr<const Response> Get(const std::string& key);
+
+    void Put(const std::string& key, std::shared_ptr<const Response> response);
+
+   private:
+    struct Entry {
+        std::string key;
+        std::shared_ptr<const Response> response;
+        size_t bytes;
+        std::chrono::steady_clock::time_point stored_at;
+    };
+
+    size_t max_bytes_;
+    std::chrono::seconds ttl_;
+    std::mutex mutex_;
+    std::list<Entry> entries_;  // Most recently used first
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+    size_t bytes_ = 0;
+
+    void Erase(std::list<Entry>::iterator entry);
+};
+
+}  // namespace validationservice
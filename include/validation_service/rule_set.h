@@ -0,0 +1,170 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "jsonscan/json_scanner.h"
+#include "validation.pb.h"
+#include "validation_service/incremental.h"
+#include "validation_service/validation_budget.h"
+
+namespace validationservice {
+
+// One row of validation_rules
+struct ValidationRule {
+    std::string rule_id;
+    std::string service_name;
+    std::string field_path;   // Dotted path; a "*" segment matches every member or element
+    std::string rule_type;    // required, range, format
+    std::string rule_config;  // JSON: {"min": 1, "max": 1000} or {"pattern": "^[a-z-]+$"}
+    std::string error_message;
+};
+
+/**
+ * @brief A service's custom rules compiled into a path trie
+ *
+ * Rules are grouped by field path, so evaluation is a single walk over the document that
+ * only descends into members some rule refers to: a config with thousands of keys and a
+ * handful of rules costs one hash lookup per member on the way down. rule_config is parsed
+ * once at compile time (min/max as doubles, patterns as std::regex).
+ *
+ * Rule semantics:
+ *   required - the path exists (each missing rule is reported once, at its full path)
+ *   range    - if present, the value is a number within [min, max]
+ *   format   - if present, the value is a string matching pattern (searched, not anchored)
+ * Rules below a "*" only apply to members that exist, so "servers.*.host" requires a host
+ * on every server without requiring servers itself.
+ */
+class CompiledRuleSet {
+   public:
+    // Rules that cannot be compiled are left out and described in skipped()
+    static std::shared_ptr<const CompiledRuleSet> Compile(const std::vector<ValidationRule>& rules,
+                                                          int64_t version);
+
+    // Appends one error per violated rule; true when every rule holds. Same as feeding the
+    // document to a RuleStream, minus the subtrees no rule looks at.
+    bool Evaluate(const jsonscan::Value& document,
+                  std::vector<configservice::ValidationError>& errors,
+                  ValidationBudget* budget = nullptr,
+                  IncrementalPass* incremental = nullptr) const;
+
+    bool empty() const { return rule_count_ == 0; }
+    size_t rule_count() const { return rule_count_; }
+    int64_t version() const { return version_; }  // validation_rule_versions.version
+    const std::vector<std::string>& skipped() const { return skipped_; }
+
+    CompiledRuleSet();
+    ~CompiledRuleSet();
+
+   private:
+    friend class RuleStream;
+
+    struct Rule;
+    struct TrieNode;
+
+    std::vector<std::unique_ptr<Rule>> rules_;
+    std::unique_ptr<TrieNode> root_;
+    size_t rule_count_ = 0;
+    int64_t version_ = 0;
+    std::vector<std::string> skipped_;
+};
+
+/**
+ * @brief Event-driven evaluation of a CompiledRuleSet
+ *
+ * For documents that are never materialized: a streaming parser reports the document as
+ * events and the rules are checked as the matching values go by, keeping only the path to
+ * the current value. Start*() and Key() return false when no rule looks at that value, so a
+ * producer that can skip it may go straight to End() (containers) or Skip() (member values).
+ * Alternatively every event may be sent; untracked subtrees are then ignored cheaply.
+ * Once the budget (if any) is exhausted every call is a no-op: the errors found so far stay,
+ * and nothing is reported as missing from the part that was never seen.
+ */
+class RuleStream {
+   public:
+    // incremental (if any) records verdicts and replays the base version's for Feed()
+    RuleStream(const CompiledRuleSet& rules, std::vector<configservice::ValidationError>& errors,
+               ValidationBudget* budget = nullptr, IncrementalPass* incremental = nullptr);
+    ~RuleStream();
+
+    bool StartObject();
+    bool StartArray();
+    void End();  // Closes the innermost object or array
+
+    // Names the next value inside an object
+    bool Key(const std::string& key);
+
+    void Scalar(const jsonscan::Value& value);
+
+    // Instead of the events of a value after Key() returned false
+    void Skip();
+
+    // A whole subtree at once (e.g. a YAML alias)
+    void Feed(const jsonscan::Value& value);
+
+   private:
+    struct Frame;
+
+    const CompiledRuleSet& rules_;
+    std::vector<configservice::ValidationError>& errors_;
+    ValidationBudget* budget_;
+    IncrementalPass* incremental_;
+    bool stopped_ = false;
+    std::vector<Frame> frames_;
+    std::vector<const CompiledRuleSet::TrieNode*> next_;  // Trie nodes matching the next value
+    std::vector<std::string> path_;                         // ".key" or "[i]" per level
+    size_t ignored_depth_ = 0;                              // Open containers nobody looks at
+
+    bool Stopped();
+    std::vector<const CompiledRuleSet::TrieNode*> StartValue();
+    void EndValue();
+    bool StartContainer(bool array);
+    void Check(const CompiledRuleSet::Rule& rule, const jsonscan::Value& value);
+    void ReportMissing(const CompiledRuleSet::TrieNode& child);
+    void Fail(const std::string& field, const char* type, const CompiledRuleSet::Rule& rule,
+              const std::string& default_message);
+    std::string Path() const;
+};
+
+/**
+ * @brief Compiled rule sets by service, revalidated against the rule set version
+ *
+ * A cached set is trusted for check_interval; after that one cheap version lookup decides
+ * whether the rules must be reloaded and recompiled.
+ */
+class RuleSetCache {
+   public:
+    // Current version for the service: 0 = no rules were ever defined, < 0 = unknown
+    using VersionLoader = std::function<int64_t()>;
+    // std::nullopt when the rules could not be loaded
+    using RulesLoader = std::function<std::optional<std::vector<ValidationRule>>()>;
+
+    explicit RuleSetCache(std::chrono::milliseconds check_interval);
+
+    // reloaded (optional) reports whether the rules were loaded and compiled on this call.
+    // When loading fails the result is an empty set with version -1, which is not kept, so
+    // the next call tries again and nothing validated against it is cached.
+    std::shared_ptr<const CompiledRuleSet> Get(const std::string& service_name,
+                                               const VersionLoader& load_version,
+                                               const RulesLoader& load_rules,
+                                               bool* reloaded = nullptr);
+
+   private:
+    struct Slot {
+        std::shared_ptr<const CompiledRuleSet> rules;
+        std::chrono::steady_clock::time_point checked_at;
+    };
+
+    std::chrono::milliseconds check_interval_;
+    std::mutex mutex_;
+    std::unordered_map<std::string, Slot> slots_;
+};
+
+}  // namespace validationservice
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "jsonscan/json_scanner.h"
+#include "validation.pb.h"
+
+namespace validationservice {
+
+// Deeper arrays and inline tables are rejected instead of recursing without bound
+constexpr size_t kTomlMaxDepth = 128;
+
+/**
+ * @brief Single-pass TOML 1.0 parser
+ *
+ * Reads the text in place: bare keys, literal strings and strings without escapes are
+ * referenced as slices of the input until the tree is built, and table lookups go through a
+ * per-table index rather than scanning members. Duplicate keys and tables defined twice are
+ * errors, as the spec requires. Tables become objects and arrays of tables arrays of objects;
+ * integers and floats are numbers, and dates and times stay strings in their source form, so
+ * the result feeds the same rules and schemas as a parsed JSON document.
+ *
+ * Positions follow jsonscan::ScanResult: the offending character's line and column.
+ */
+jsonscan::ScanResult ParseToml(std::string_view toml, jsonscan::Value* root,
+                               size_t max_depth = kTomlMaxDepth);
+
+class TomlValidator {
+   public:
+    TomlValidator() = default;
+
+    // Validate TOML syntax, including duplicate keys and redefined tables
+    bool ValidateSyntax(const std::string& content,
+                        std::vector<configservice::ValidationError>& errors);
+
+    // ValidateSyntax that also builds the document tree, for rules and schemas
+    bool Parse(const std::string& content, jsonscan::Value& document,
+               std::vector<configservice::ValidationError>& errors);
+
+   private:
+    void AddError(std::vector<configservice::ValidationError>& errors,
+                  const jsonscan::ScanResult& scan);
+};
+
+}  // namespace validationservice
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+namespace validationservice {
+
+/**
+ * @brief Time budget of one validation
+ *
+ * Built per request from validation.timeout_seconds, the client's deadline and its
+ * cancellation. Parsers, rules and schemas poll Exhausted() from their inner loops and stop
+ * early once it returns true; the pipeline then answers with what it found so far.
+ */
+class ValidationBudget {
+   public:
+    enum class State { kWithin, kDeadlineExceeded, kCancelled };
+    using Clock = std::chrono::steady_clock;
+
+    ValidationBudget();  // No deadline, never cancelled
+    ValidationBudget(Clock::time_point deadline, std::function<bool()> cancelled);
+
+    // Cheap enough per node or parser event: the clock and the cancel callback are only
+    // consulted every kCheckInterval calls. Once true, stays true.
+    bool Exhausted() {
+        if (state_ != State::kWithin) {
+            return true;
+        }
+        if (++calls_ < kCheckInterval) {
+            return false;
+        }
+        return Check();
+    }
+
+    // Looks right away, for stage boundaries
+    bool Check();
+
+    bool exhausted() const { return state_ != State::kWithin; }
+    State state() const { return state_; }
+    std::chrono::milliseconds elapsed() const;
+
+   private:
+    static constexpr uint32_t kCheckInterval = 256;
+
+    Clock::time_point start_;
+    Clock::time_point deadline_;
+    std::function<bool()> cancelled_;
+    uint32_t calls_ = 0;
+    State state_ = State::kWithin;
+};
+
+}  // namespace validationservice
@@ -10,9 +10,17 @@
 #include <string>
 
 #include "database_manager.h"
+#include "history_recorder.h"
+#include "incremental.h"
+#include "json_schema.h"
 #include "json_validator.h"
+#include "result_cache.h"
+#include "rule_set.h"
 #include "statsdclient/statsd_client.h"
+#include "toml_validator.h"
 #include "validation.grpc.pb.h"
+#include "validation_budget.h"
+#include "worker_pool.h"
 #include "yaml_validator.h"
 
 namespace validationservice {
@@ -33,6 +41,11 @@ class ValidationServiceImpl final : public configservice::ValidationService::Ser
                                 const configservice::ValidateConfigRequest* request,
                                 configservice::ValidateConfigResponse* response) override;
 
+    grpc::Status ValidateConfigs(
+        grpc::ServerContext* context,
+        grpc::ServerReaderWriter<configservice::ValidateConfigsResponse,
+                                 configservice::ValidateConfigsRequest>* stream) override;
+
     grpc::Status RegisterSchema(grpc::ServerContext* context,
                                 const configservice::RegisterSchemaRequest* request,
                                 configservice::RegisterSchemaResponse* response) override;
@@ -46,10 +59,26 @@ class ValidationServiceImpl final : public configservice::ValidationService::Ser
                              configservice::ListSchemasResponse* response) override;
 
    private:
+    // What a config is validated against, resolved once per call or batch
+    struct ValidationInputs {
+        std::shared_ptr<const CompiledRuleSet> rules;
+        SchemaCache::Entry schema;
+    };
+
+    // How a Validate call ended; the two budget outcomes leave a partial response
+    enum class Outcome { kValidated, kCached, kDeadlineExceeded, kCancelled };
+
     ServiceConfig config_;
     std::unique_ptr<DatabaseManager> db_;
     std::unique_ptr<JsonValidator> json_validator_;
     std::unique_ptr<YamlValidator> yaml_validator_;
+    std::unique_ptr<TomlValidator> toml_validator_;
+    std::unique_ptr<SchemaCache> schema_cache_;
+    std::unique_ptr<RuleSetCache> rule_cache_;
+    std::unique_ptr<ResultCache> result_cache_;  // L1 in front of Redis
+    std::unique_ptr<BaselineCache> baseline_cache_;  // Null when incremental validation is off
+    std::unique_ptr<HistoryRecorder> history_;
+    std::unique_ptr<WorkerPool> batch_pool_;  // ValidateConfigs items
     std::unique_ptr<statsdclient::StatsDClient> statsd_;
 
     // Redis for caching validation results
@@ -58,15 +87,45 @@ class ValidationServiceImpl final : public configservice::ValidationService::Ser
 
     bool initialized_;
 
+    // The validation pipeline shared by ValidateConfig and ValidateConfigs. Stops early once
+    // the budget runs out, keeping the diagnostics found so far.
+    Outcome Validate(const configservice::ValidateConfigRequest& request,
+                     const ValidationInputs& inputs, ValidationBudget& budget,
+                     configservice::ValidateConfigResponse* response);
+
+    // validation.timeout_seconds from now or the client's deadline, whichever is sooner;
+    // cancelled with the call
+    ValidationBudget MakeBudget(grpc::ServerContext* context) const;
+
+    // Fills the partial response for a validation stopped during stage
+    Outcome OverBudget(const ValidationBudget& budget, const std::string& stage,
+                       const std::vector<configservice::ValidationError>& errors,
+                       const std::vector<configservice::ValidationWarning>& warnings,
+                       configservice::ValidateConfigResponse* response);
+
     // Helper methods
     bool ValidateSize(const std::string& content,
                       std::vector<configservice::ValidationError>& errors);
 
-    bool ApplyCustomRules(const std::string& service_name, const std::string& content,
-                          std::vector<configservice::ValidationError>& errors);
+    std::shared_ptr<const CompiledRuleSet> LoadRules(const std::string& service_name);
+
+    bool ApplyCustomRules(const CompiledRuleSet& rules, const jsonscan::Value& document,
+                          std::vector<configservice::ValidationError>& errors,
+                          ValidationBudget& budget, IncrementalPass* incremental);
+
+    SchemaCache::Entry LoadSchema(const std::string& schema_id);
+
+    // Local cache first, then Redis (filling the local cache)
+    bool GetCachedResponse(const std::string& cache_key,
+                           configservice::ValidateConfigResponse* response);
+    // No-op for an empty key (caching disabled or not applicable)
+    void CacheResponse(const std::string& cache_key,
+                       const configservice::ValidateConfigResponse& response);
 
-    std::string GetCachedValidationResult(const std::string& cache_key);
-    void CacheValidationResult(const std::string& cache_key, const std::string& result);
+    // Queues a validation_history row; never waits for the database
+    void RecordHistory(const configservice::ValidateConfigRequest& request,
+                       const std::string& content_hash, bool valid, const std::string& errors,
+                       const std::string& warnings);
 
     void RecordMetric(const std::string& metric);
     void RecordTimer(const std::string& metric, int milliseconds);
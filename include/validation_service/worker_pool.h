@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace validationservice {
+
+/**
+ * @brief Fixed set of threads running submitted tasks in FIFO order
+ *
+ * Shared by every ValidateConfigs call, so concurrent batches split the cores between them
+ * instead of each starting its own threads.
+ */
+class WorkerPool {
+   public:
+    explicit WorkerPool(size_t threads);  // 0 = one per core
+    ~WorkerPool();                        // Finishes queued tasks, then joins
+
+    void Submit(std::function<void()> task);
+
+    size_t size() const { return threads_.size(); }
+
+   private:
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+
+    void Run();
+};
+
+}  // namespace validationservice
@@ -3,28 +3,58 @@
 #include <string>
 #include <vector>
 
+#include "jsonscan/json_scanner.h"
+#include "validation_service/rule_set.h"
+#include "validation_service/validation_budget.h"
 #include "validation.pb.h"
 
 namespace validationservice {
 
 class YamlValidator {
    public:
-    YamlValidator() = default;
+    // Documents nested deeper than max_depth, or whose aliases expand to more than
+    // max_alias_nodes values in total (billion laughs), are rejected with a "limit" error
+    explicit YamlValidator(size_t max_depth = jsonscan::kDefaultMaxDepth,
+                           size_t max_alias_nodes = 100000);
 
-    // Validate YAML syntax
+    // Every pass below stops, returning false without an error of its own, once the budget
+    // (if any) is exhausted
+
+    // Validate YAML syntax (one pass over the parser events; nothing is built)
     bool ValidateSyntax(const std::string& content,
-                        std::vector<configservice::ValidationError>& errors);
+                        std::vector<configservice::ValidationError>& errors,
+                        ValidationBudget* budget = nullptr);
 
-    // Validate YAML structure
-    bool ValidateStructure(const std::string& content,
-                           std::vector<configservice::ValidationError>& errors,
-                           std::vector<configservice::ValidationWarning>& warnings);
+    // One parse of the first document serving every YAML check: syntax, structure (the root
+    // must be a map or sequence; empty configs, duplicate keys and complex keys are warned
+    // about) and CheckCommonIssues, while converting the document to a jsonscan tree for rules
+    // and schemas. Plain scalars are typed per the YAML 1.2 core schema (null, bool, int,
+    // float); quoted scalars stay strings. Returns false only when the content is not YAML;
+    // structure errors are appended either way.
+    bool Parse(const std::string& content, jsonscan::Value& document,
+               std::vector<configservice::ValidationError>& errors,
+               std::vector<configservice::ValidationWarning>& warnings,
+               ValidationBudget* budget = nullptr);
+
+    // Parse without the tree, for large documents: rules (optional) are checked as the parser
+    // events go by, so memory follows nesting depth and anchored subtrees rather than size
+    bool Stream(const std::string& content, RuleStream* rules,
+                std::vector<configservice::ValidationError>& errors,
+                std::vector<configservice::ValidationWarning>& warnings,
+                ValidationBudget* budget = nullptr);
 
-    // Check for common YAML issues
+    // Check for common YAML issues in the text (tabs, trailing whitespace, odd indentation)
     bool CheckCommonIssues(const std::string& content,
                            std::vector<configservice::ValidationWarning>& warnings);
 
    private:
+    size_t max_depth_;
+    size_t max_alias_nodes_;
+
+    bool Read(const std::string& content, jsonscan::Value* document, RuleStream* rules,
+              std::vector<configservice::ValidationError>& errors,
+              std::vector<configservice::ValidationWarning>* warnings, ValidationBudget* budget);
+
     void AddError(std::vector<configservice::ValidationError>& errors, const std::string& field,
                   const std::string& type, const std::string& message, int line = 0);
 
@@ -7,15 +7,18 @@ import (
 	"time"
 
 	"github.com/codec404/Konfig/pkg/apiclient"
+	pb "github.com/codec404/Konfig/pkg/pb"
 	"github.com/spf13/cobra"
 )
 
 func NewListCommand() *cobra.Command {
 	var (
-		service string
-		limit   int32
-		offset  int32
-		server  string
+		service   string
+		limit     int32
+		offset    int32
+		pageToken string
+		total     bool
+		server    string
 	)
 
 	cmd := &cobra.Command{
@@ -26,7 +29,8 @@ func NewListCommand() *cobra.Command {
 Examples:
   konfig list
   konfig list --service my-service
-  konfig list --limit 10`,
+  konfig list --limit 10
+  konfig list --service my-service --page-token <token>`,
 		RunE: func(cmd *cobra.Command, args []string) error {
 			// Get server
 			if server == "" {
@@ -47,12 +51,21 @@ Examples:
 			ctx, cancel := context.WithTimeout(context.Background(), 10*time.Second)
 			defer cancel()
 
-			resp, err := client.ListConfigs(ctx, service, limit, offset)
+			resp, err := client.ListConfigsPage(ctx, &pb.ListConfigsRequest{
+				ServiceName:  service,
+				Limit:        limit,
+				Offset:       offset,
+				PageToken:    pageToken,
+				IncludeTotal: total,
+			})
 			if err != nil {
 				return fmt.Errorf("list failed: %w", err)
 			}
 
 			if !resp.Success {
+				if resp.Message != "" {
+					return fmt.Errorf("list failed: %s", resp.Message)
+				}
 				return fmt.Errorf("list failed")
 			}
 
@@ -82,6 +95,9 @@ Examples:
 
 			fmt.Println()
 			fmt.Printf("Total: %d configurations\n", resp.TotalCount)
+			if resp.NextPageToken != "" {
+				fmt.Printf("Next page: --page-token %s\n", resp.NextPageToken)
+			}
 
 			return nil
 		},
@@ -89,7 +105,9 @@ Examples:
 
 	cmd.Flags().StringVarP(&service, "service", "s", "", "Filter by service name")
 	cmd.Flags().Int32VarP(&limit, "limit", "l", 50, "Maximum number of results")
-	cmd.Flags().Int32Var(&offset, "offset", 0, "Pagination offset")
+	cmd.Flags().Int32Var(&offset, "offset", 0, "Pagination offset (deprecated, use --page-token)")
+	cmd.Flags().StringVar(&pageToken, "page-token", "", "Continue from a previous page")
+	cmd.Flags().BoolVar(&total, "total", false, "Recount the total instead of using the summary table")
 	cmd.Flags().StringVar(&server, "server", "", "API server address")
 
 	return cmd
@@ -3,10 +3,12 @@ package apiclient
 import (
 	"context"
 	"fmt"
+	"io"
 	"time"
 
 	"google.golang.org/grpc"
 	"google.golang.org/grpc/credentials/insecure"
+	"google.golang.org/protobuf/types/known/fieldmaskpb"
 
 	pb "github.com/codec404/Konfig/pkg/pb"
 )
@@ -55,6 +57,19 @@ func (c *Client) GetConfig(ctx context.Context, configID string) (*pb.GetConfigR
 	})
 }
 
+// BatchGetConfigs gets many configurations in one call. With metadataOnly the
+// content field is omitted (and never read from the database).
+func (c *Client) BatchGetConfigs(ctx context.Context, configIDs []string, metadataOnly bool) (*pb.BatchGetConfigsResponse, error) {
+	req := &pb.BatchGetConfigsRequest{ConfigIds: configIDs}
+	if metadataOnly {
+		req.ReadMask = &fieldmaskpb.FieldMask{Paths: []string{
+			"config_id", "service_name", "config_name", "version", "format",
+			"content_hash", "created_at", "created_by",
+		}}
+	}
+	return c.client.BatchGetConfigs(ctx, req)
+}
+
 // ListConfigs lists configurations for a service
 func (c *Client) ListConfigs(ctx context.Context, serviceName string, limit, offset int32) (*pb.ListConfigsResponse, error) {
 	return c.client.ListConfigs(ctx, &pb.ListConfigsRequest{
@@ -64,6 +79,54 @@ func (c *Client) ListConfigs(ctx context.Context, serviceName string, limit, off
 	})
 }
 
+// ListConfigsPage lists configurations with keyset pagination. Pass the previous
+// response's NextPageToken to fetch the following page.
+func (c *Client) ListConfigsPage(ctx context.Context, req *pb.ListConfigsRequest) (*pb.ListConfigsResponse, error) {
+	return c.client.ListConfigs(ctx, req)
+}
+
+// ExportAuditLog streams audit entries oldest first, calling fn once per received
+// chunk. Returning an error from fn stops the export.
+func (c *Client) ExportAuditLog(ctx context.Context, req *pb.ExportAuditLogRequest, fn func([]*pb.AuditEntry) error) error {
+	stream, err := c.client.ExportAuditLog(ctx, req)
+	if err != nil {
+		return err
+	}
+	for {
+		resp, err := stream.Recv()
+		if err == io.EOF {
+			return nil
+		}
+		if err != nil {
+			return err
+		}
+		if err := fn(resp.Entries); err != nil {
+			return err
+		}
+	}
+}
+
+// ExportConfigHistory streams every version of a service's named configs,
+// calling fn once per received chunk. Returning an error from fn stops the export.
+func (c *Client) ExportConfigHistory(ctx context.Context, req *pb.ExportConfigHistoryRequest, fn func([]*pb.ConfigHistoryEntry) error) error {
+	stream, err := c.client.ExportConfigHistory(ctx, req)
+	if err != nil {
+		return err
+	}
+	for {
+		resp, err := stream.Recv()
+		if err == io.EOF {
+			return nil
+		}
+		if err != nil {
+			return err
+		}
+		if err := fn(resp.Entries); err != nil {
+			return err
+		}
+	}
+}
+
 // DeleteConfig deletes a configuration
 func (c *Client) DeleteConfig(ctx context.Context, configID string) (*pb.DeleteConfigResponse, error) {
 	return c.client.DeleteConfig(ctx, &pb.DeleteConfigRequest{
@@ -1,13 +1,78 @@
 #include "api_service/api_service.h"
+#include "contenthash/content_hash.h"
+#include "jsonscan/json_scanner.h"
 
+#include <google/protobuf/util/field_mask_util.h>
+
+#include <algorithm>
+#include <chrono>
 #include <ctime>
-#include <functional>
+#include <deque>
 #include <iostream>
+#include <set>
 #include <sstream>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace apiservice {
 
-ApiServiceImpl::ApiServiceImpl(const ServiceConfig& config) : config_(config), initialized_(false) {
+namespace {
+
+// UploadConfigs limits
+constexpr size_t kMaxBatchUploadItems = 5000;
+constexpr size_t kMaxValidationsInFlight = 64;
+
+// BatchGetConfigs limit
+constexpr int kMaxBatchGetIds = 1000;
+
+// Exports: each one holds its own Postgres connection for the length of the stream
+constexpr int kMaxConcurrentExports = 4;
+constexpr size_t kExportMessageBytes = 1024 * 1024;
+
+class ExportSlot {
+   public:
+    explicit ExportSlot(std::atomic<int>& active)
+        : active_(active), acquired_(active.fetch_add(1) < kMaxConcurrentExports) {}
+    ~ExportSlot() { active_--; }
+
+    bool acquired() const { return acquired_; }
+
+   private:
+    std::atomic<int>& active_;
+    bool acquired_;
+};
+
+// Packs a fetched chunk into stream messages of at most kExportMessageBytes. Write() blocks
+// while the client's flow-control window is full, so a slow reader throttles the cursor
+// instead of letting rows pile up here. Returns false once the client has gone away.
+template <typename Response, typename Entry>
+bool WriteExportChunk(grpc::ServerContext* context, grpc::ServerWriter<Response>* writer,
+                      const std::vector<Entry>& entries, int64_t& rows) {
+    Response message;
+    size_t bytes = 0;
+    for (const auto& entry : entries) {
+        size_t entry_bytes = entry.ByteSizeLong();
+        if (message.entries_size() > 0 && bytes + entry_bytes > kExportMessageBytes) {
+            if (context->IsCancelled() || !writer->Write(message)) {
+                return false;
+            }
+            message.Clear();
+            bytes = 0;
+        }
+        *message.add_entries() = entry;
+        bytes += entry_bytes;
+    }
+    if (message.entries_size() > 0 && (context->IsCancelled() || !writer->Write(message))) {
+        return false;
+    }
+    rows += static_cast<int64_t>(entries.size());
+    return true;
+}
+
+}  // anonymous namespace
+
+ApiServiceImpl::ApiServiceImpl(const ServiceConfig& config)
+    : config_(config), active_exports_(0), initialized_(false) {
     std::cout << "[ApiService] Creating service..." << std::endl;
 }
 
@@ -36,6 +101,14 @@ bool ApiServiceImpl::Initialize() {
         return false;
     }
 
+    // Redis read cache
+    cache_ = std::make_unique<CacheManager>(config_.redis);
+    if (cache_->Initialize()) {
+        std::cout << "[ApiService] ✓ Read cache enabled" << std::endl;
+    } else {
+        std::cerr << "[ApiService] ⚠ Redis not available - reads go to the database" << std::endl;
+    }
+
     // Kafka
     try {
         std::string errstr;
@@ -59,7 +132,9 @@ bool ApiServiceImpl::Initialize() {
     }
 
     // Validation client
-    validation_client_ = std::make_unique<ValidationClient>(config_.validation.address);
+    validation_client_ = std::make_unique<ValidationClient>(
+        config_.validation.address, config_.validation.channel_pool_size,
+        config_.validation.timeout_ms, statsd_.get());
     if (validation_client_->Initialize()) {
         std::cout << "[ApiService] ✓ Validation client connected" << std::endl;
     } else {
@@ -82,6 +157,8 @@ void ApiServiceImpl::Shutdown() {
         kafka_producer_->flush(5000);
         kafka_producer_.reset();
     }
+    if (cache_)
+        cache_->Shutdown();
     if (db_)
         db_->Shutdown();
     std::cout << "[ApiService] Shutdown complete" << std::endl;
@@ -93,108 +170,245 @@ grpc::Status ApiServiceImpl::UploadConfig(grpc::ServerContext* context,
     std::cout << "[ApiService] UploadConfig: service=" << request->service_name() << std::endl;
     RecordMetric("upload.request");
 
-    // Validate required fields
-    if (request->service_name().empty()) {
-        response->set_success(false);
-        response->set_message("service_name is required");
+    if (!CheckUpload(*request, response)) {
         return grpc::Status::OK;
     }
-    if (request->config_name().empty()) {
-        response->set_success(false);
-        response->set_message("config_name is required");
+
+    configservice::ConfigData config = BuildUploadConfig(*request);
+
+    // Re-uploading the latest content stores nothing and is not validated. A failed lookup
+    // just falls through; CreateConfigVersion repeats the check transactionally.
+    configservice::ConfigData latest;
+    try {
+        latest = db_->GetLatestConfigByName(request->service_name(), request->config_name(),
+                                            /*include_content=*/false);
+    } catch (const std::exception&) {
+    }
+    if (!latest.config_id().empty() && latest.content_hash() == config.content_hash()) {
+        response->set_success(true);
+        response->set_config_id(latest.config_id());
+        response->set_version(latest.version());
+        response->set_unchanged(true);
+        response->set_message("Content unchanged — matches v" +
+                              std::to_string(latest.version()));
+
+        RecordMetric("upload.unchanged");
+        std::cout << "[ApiService] Unchanged: " << latest.config_id() << std::endl;
         return grpc::Status::OK;
     }
-    if (request->content().empty()) {
+
+    // Against the latest version as base, the validation service only re-checks what changed
+    // if it still has that version; the call shares this RPC's deadline
+    auto validation = validation_client_->ValidateConfigAsync(
+        request->service_name(), request->content(), request->format(), false,
+        context->deadline(), latest.content_hash());
+    if (!CheckValidationResult(validation.get(), response)) {
+        return grpc::Status::OK;
+    }
+
+    // Version allocation, metadata, content and audit row in one transaction. Content equal to
+    // the latest version (same SHA-256) is detected there and creates no new version.
+    bool unchanged = false;
+    auto [success, result] = db_->CreateConfigVersion(
+        config, request->description(), "uploaded", request->created_by(), "",
+        /*activate=*/false, /*skip_unchanged=*/true, &unchanged);
+
+    if (!success) {
         response->set_success(false);
-        response->set_message("content is required");
+        response->set_message("Failed to store: " + result);
+        RecordMetric("upload.db_failed");
         return grpc::Status::OK;
     }
 
-    // Validate content if requested
-    std::vector<std::string> errors;
-    if (request->validate() || true) {  // Always validate
-        if (!ValidateContent(request->format(), request->content(), errors)) {
-            response->set_success(false);
-            response->set_message("Validation failed");
-            for (const auto& err : errors) {
-                response->add_validation_errors(err);
-            }
-            RecordMetric("upload.validation_failed");
-            return grpc::Status::OK;
+    const std::string& config_id = config.config_id();
+    int64_t next_version = config.version();
+
+    if (unchanged) {
+        response->set_success(true);
+        response->set_config_id(config_id);
+        response->set_version(next_version);
+        response->set_unchanged(true);
+        response->set_message("Content unchanged — matches v" + std::to_string(next_version));
+
+        RecordMetric("upload.unchanged");
+        std::cout << "[ApiService] Unchanged: " << config_id << std::endl;
+        return grpc::Status::OK;
+    }
+
+    InvalidateCachedLists(request->service_name());
+
+    // Publish Kafka event
+    PublishEvent("config.uploaded", request->service_name(), next_version, request->created_by(),
+                 request->config_name());
+
+    // Response
+    response->set_success(true);
+    response->set_config_id(config_id);
+    response->set_version(next_version);
+    response->set_message("Uploaded successfully");
+
+    RecordMetric("upload.success");
+
+    std::cout << "[ApiService] ✓ Uploaded: " << config_id << " v" << next_version << std::endl;
+
+    return grpc::Status::OK;
+}
+
+grpc::Status ApiServiceImpl::UploadConfigs(
+    grpc::ServerContext* context,
+    grpc::ServerReader<configservice::UploadConfigsRequest>* reader,
+    configservice::UploadConfigsResponse* response) {
+    RecordMetric("upload_batch.request");
+
+    std::vector<configservice::UploadConfigRequest> items;
+    bool atomic = false;
+
+    configservice::UploadConfigsRequest message;
+    while (reader->Read(&message)) {
+        if (items.empty()) {
+            atomic = message.atomic();
+        }
+        if (items.size() == kMaxBatchUploadItems) {
+            RecordMetric("upload_batch.too_large");
+            return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                                "UploadConfigs accepts at most " +
+                                    std::to_string(kMaxBatchUploadItems) + " items per call");
         }
+        items.push_back(std::move(*message.mutable_item()));
     }
 
-    // Call validation service
-    if (validation_client_) {
-        auto val_response = validation_client_->ValidateConfig(
-            request->service_name(), request->content(), request->format(), false);
+    std::cout << "[ApiService] UploadConfigs: " << items.size() << " items"
+              << (atomic ? " (atomic)" : "") << std::endl;
 
-        if (!val_response.valid()) {
-            response->set_success(false);
-            response->set_message("Validation service rejected config");
+    auto start = std::chrono::steady_clock::now();
+    std::vector<configservice::UploadConfigResponse> results(items.size());
 
-            for (const auto& err : val_response.errors()) {
-                response->add_validation_errors(err.field() + ": " + err.message());
-            }
+    // Remote validations are issued asynchronously with a bounded number in flight; each
+    // verdict is collected in issue order once the window is full.
+    std::vector<char> accepted(items.size(), 0);
+    std::vector<std::future<configservice::ValidateConfigResponse>> verdicts(items.size());
+    std::deque<size_t> in_flight;
 
-            RecordMetric("upload.validation_service_failed");
-            return grpc::Status::OK;
+    // Each item is validated against the latest stored version of its config as base. Without
+    // them (a failed lookup) items are just validated in full.
+    std::vector<std::string> base_hashes(items.size());
+    try {
+        std::vector<std::pair<std::string, std::string>> names;
+        for (const auto& item : items) {
+            names.emplace_back(item.service_name(), item.config_name());
         }
+        base_hashes = db_->GetLatestContentHashes(names);
+    } catch (const std::exception&) {
+    }
 
-        // Log warnings but proceed
-        if (val_response.warnings_size() > 0) {
-            std::cout << "[ApiService] Validation warnings:" << std::endl;
-            for (const auto& warn : val_response.warnings()) {
-                std::cout << "  - " << warn.field() << ": " << warn.message() << std::endl;
-            }
+    auto collect_oldest = [&] {
+        size_t i = in_flight.front();
+        in_flight.pop_front();
+        accepted[i] = CheckValidationResult(verdicts[i].get(), &results[i]) ? 1 : 0;
+    };
+
+    for (size_t i = 0; i < items.size(); ++i) {
+        if (!CheckUpload(items[i], &results[i])) {
+            continue;
+        }
+        verdicts[i] = validation_client_->ValidateConfigAsync(
+            items[i].service_name(), items[i].content(), items[i].format(), false,
+            context->deadline(), base_hashes[i]);
+        in_flight.push_back(i);
+        if (in_flight.size() == kMaxValidationsInFlight) {
+            collect_oldest();
         }
     }
+    while (!in_flight.empty()) {
+        collect_oldest();
+    }
 
-    // Get next version for this named config
-    int64_t next_version = db_->GetNextVersion(request->service_name(), request->config_name());
+    size_t rejected = std::count(accepted.begin(), accepted.end(), 0);
 
-    // Build config_id: service-configname-vN
-    std::string config_id =
-        GenerateConfigId(request->service_name(), request->config_name(), next_version);
+    if (atomic && rejected > 0) {
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (accepted[i]) {
+                results[i].set_success(false);
+                results[i].set_message("Not stored: another item in the atomic batch was rejected");
+            }
+        }
+    } else {
+        std::vector<configservice::ConfigData> configs;
+        std::vector<std::string> descriptions;
+        std::vector<size_t> positions;
+        for (size_t i = 0; i < items.size(); ++i) {
+            if (accepted[i]) {
+                configs.push_back(BuildUploadConfig(items[i]));
+                descriptions.push_back(items[i].description());
+                positions.push_back(i);
+            }
+        }
 
-    // Build ConfigData matching proto
-    configservice::ConfigData config;
-    config.set_config_id(config_id);
-    config.set_service_name(request->service_name());
-    config.set_config_name(request->config_name());
-    config.set_version(next_version);
-    config.set_content(request->content());
-    config.set_format(request->format().empty() ? "json" : request->format());
-    config.set_content_hash(ComputeHash(request->content()));
-    config.set_created_at(static_cast<int64_t>(std::time(nullptr)));
-    config.set_created_by(request->created_by().empty() ? "api" : request->created_by());
+        auto stored = db_->CreateConfigVersions(configs, descriptions, atomic);
 
-    // Store in database
-    auto [success, result] = db_->InsertConfig(config, request->description());
+        std::set<std::string> changed_services;
+        for (size_t k = 0; k < positions.size(); ++k) {
+            const auto& config = configs[k];
+            auto& result = results[positions[k]];
 
-    if (!success) {
-        response->set_success(false);
-        response->set_message("Failed to store: " + result);
-        RecordMetric("upload.db_failed");
-        return grpc::Status::OK;
+            if (!stored[k].success) {
+                result.set_success(false);
+                result.set_message("Failed to store: " + stored[k].error);
+                continue;
+            }
+
+            result.set_success(true);
+            result.set_config_id(config.config_id());
+            result.set_version(config.version());
+
+            if (stored[k].unchanged) {
+                result.set_unchanged(true);
+                result.set_message("Content unchanged — matches v" +
+                                   std::to_string(config.version()));
+                continue;
+            }
+
+            result.set_message("Uploaded successfully");
+            changed_services.insert(config.service_name());
+            PublishEvent("config.uploaded", config.service_name(), config.version(),
+                         config.created_by(), config.config_name());
+        }
+
+        for (const auto& service_name : changed_services) {
+            InvalidateCachedLists(service_name);
+        }
     }
 
-    // Audit log
-    db_->RecordAuditEvent(request->service_name(), config_id, "uploaded", request->created_by(),
-                          "Version " + std::to_string(next_version));
+    int32_t uploaded = 0, unchanged = 0, failed = 0;
+    for (auto& result : results) {
+        if (!result.success()) {
+            failed++;
+        } else if (result.unchanged()) {
+            unchanged++;
+        } else {
+            uploaded++;
+        }
+        *response->add_results() = std::move(result);
+    }
 
-    // Publish Kafka event
-    PublishEvent("config.uploaded", request->service_name(), next_version, request->created_by());
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
 
-    // Response
-    response->set_success(true);
-    response->set_config_id(config_id);
-    response->set_version(next_version);
-    response->set_message("Uploaded successfully");
+    response->set_success(failed == 0);
+    response->set_uploaded_count(uploaded);
+    response->set_unchanged_count(unchanged);
+    response->set_failed_count(failed);
+    response->set_message(std::to_string(uploaded) + " uploaded, " + std::to_string(unchanged) +
+                          " unchanged, " + std::to_string(failed) + " failed");
 
-    RecordMetric("upload.success");
+    RecordMetric(failed == 0 ? "upload_batch.success" : "upload_batch.failed");
+    if (statsd_ && statsd_->isConnected()) {
+        statsd_->timing("upload_batch.duration", elapsed_ms);
+    }
 
-    std::cout << "[ApiService] ✓ Uploaded: " << config_id << " v" << next_version << std::endl;
+    std::cout << "[ApiService] " << (failed == 0 ? "✓" : "⚠") << " UploadConfigs: "
+              << response->message() << " in " << elapsed_ms << "ms" << std::endl;
 
     return grpc::Status::OK;
 }
@@ -212,6 +426,21 @@ grpc::Status ApiServiceImpl::GetConfig(grpc::ServerContext* context,
     }
 
     try {
+        // Versions are immutable, so a cached entry is valid until the version is deleted
+        const std::string cache_key = CacheManager::ConfigKey(request->config_id());
+        std::string cached;
+        if (cache_ && cache_->Get(cache_key, cached) &&
+            response->mutable_config()->ParseFromString(cached)) {
+            response->set_success(true);
+            response->set_message("Success");
+            RecordMetric("cache.get.hit");
+            RecordMetric("get.success");
+            return grpc::Status::OK;
+        }
+        if (cache_) {
+            RecordMetric("cache.get.miss");
+        }
+
         auto config = db_->GetConfigById(request->config_id());
 
         if (config.config_id().empty()) {
@@ -221,6 +450,10 @@ grpc::Status ApiServiceImpl::GetConfig(grpc::ServerContext* context,
             return grpc::Status::OK;
         }
 
+        if (cache_) {
+            cache_->Set(cache_key, config.SerializeAsString());
+        }
+
         *response->mutable_config() = config;
         response->set_success(true);
         response->set_message("Success");
@@ -235,6 +468,70 @@ grpc::Status ApiServiceImpl::GetConfig(grpc::ServerContext* context,
     return grpc::Status::OK;
 }
 
+grpc::Status ApiServiceImpl::BatchGetConfigs(grpc::ServerContext* context,
+                                             const configservice::BatchGetConfigsRequest* request,
+                                             configservice::BatchGetConfigsResponse* response) {
+    using google::protobuf::util::FieldMaskUtil;
+
+    std::cout << "[ApiService] BatchGetConfigs: " << request->config_ids_size() << " ids"
+              << std::endl;
+    RecordMetric("batch_get.request");
+
+    if (request->config_ids_size() > kMaxBatchGetIds) {
+        response->set_success(false);
+        response->set_message("At most " + std::to_string(kMaxBatchGetIds) + " config_ids");
+        return grpc::Status::OK;
+    }
+
+    const auto& mask = request->read_mask();
+    if (!FieldMaskUtil::IsValidFieldMask<configservice::ConfigData>(mask)) {
+        response->set_success(false);
+        response->set_message("Invalid read_mask: " + FieldMaskUtil::ToString(mask));
+        return grpc::Status::OK;
+    }
+
+    bool project = mask.paths_size() > 0;
+    bool include_content =
+        !project || std::find(mask.paths().begin(), mask.paths().end(), "content") !=
+                        mask.paths().end();
+
+    try {
+        std::vector<std::string> ids(request->config_ids().begin(), request->config_ids().end());
+        auto configs = db_->GetConfigsByIds(ids, include_content);
+
+        std::unordered_map<std::string, const configservice::ConfigData*> by_id;
+        for (const auto& config : configs) {
+            by_id[config.config_id()] = &config;
+        }
+
+        for (const auto& id : request->config_ids()) {
+            auto it = by_id.find(id);
+            if (it == by_id.end()) {
+                response->add_not_found_ids(id);
+                continue;
+            }
+            auto* config = response->add_configs();
+            *config = *it->second;
+            if (project) {
+                FieldMaskUtil::TrimMessage(mask, config);
+            }
+        }
+
+        response->set_success(true);
+        response->set_message("Success");
+        RecordMetric(include_content ? "batch_get.success" : "batch_get.metadata_only");
+
+    } catch (const std::exception& e) {
+        response->clear_configs();
+        response->clear_not_found_ids();
+        response->set_success(false);
+        response->set_message("Internal error: " + std::string(e.what()));
+        RecordMetric("batch_get.error");
+    }
+
+    return grpc::Status::OK;
+}
+
 grpc::Status ApiServiceImpl::ListConfigs(grpc::ServerContext* context,
                                          const configservice::ListConfigsRequest* request,
                                          configservice::ListConfigsResponse* response) {
@@ -242,21 +539,49 @@ grpc::Status ApiServiceImpl::ListConfigs(grpc::ServerContext* context,
     RecordMetric("list.request");
 
     try {
-        int limit = request->limit() == 0 ? 50 : request->limit();
-        int offset = request->offset();
-        int total_count = 0;
+        int limit = request->limit() <= 0 ? 50 : request->limit();
+        int offset = request->page_token().empty() ? request->offset() : 0;
+        PageInfo page;
+
+        // The service's write generation is part of the key, so any write orphans old pages
+        std::string cache_key;
+        if (cache_) {
+            cache_key = "api:list:" + request->service_name() + ":" + request->config_name() +
+                        ":" + std::to_string(limit) + ":" + std::to_string(offset) + ":" +
+                        request->page_token() + ":" + (request->include_total() ? "t" : "e") +
+                        ":g" + cache_->GetGeneration(request->service_name());
+            std::string cached;
+            if (cache_->Get(cache_key, cached) && response->ParseFromString(cached)) {
+                RecordMetric("cache.list.hit");
+                RecordMetric("list.success");
+                return grpc::Status::OK;
+            }
+            response->Clear();
+            RecordMetric("cache.list.miss");
+        }
 
         auto configs = db_->ListConfigs(request->service_name(), request->config_name(), limit,
-                                        offset, total_count);
+                                        offset, request->page_token(), request->include_total(),
+                                        page);
 
         for (const auto& config : configs) {
             *response->add_configs() = config;
         }
 
         response->set_success(true);
-        response->set_total_count(total_count);
+        response->set_total_count(page.total_count);
+        response->set_next_page_token(page.next_page_token);
         RecordMetric("list.success");
 
+        if (cache_) {
+            cache_->Set(cache_key, response->SerializeAsString(), cache_->ListTtlSeconds());
+        }
+
+    } catch (const std::invalid_argument& e) {
+        response->Clear();
+        response->set_success(false);
+        response->set_message(e.what());
+        RecordMetric("list.invalid_token");
     } catch (const std::exception& e) {
         response->set_success(false);
         RecordMetric("list.error");
@@ -277,9 +602,14 @@ grpc::Status ApiServiceImpl::DeleteConfig(grpc::ServerContext* context,
         return grpc::Status::OK;
     }
 
-    auto [success, message] = db_->DeleteConfigById(request->config_id());
+    std::string service_name;
+    auto [success, message] = db_->DeleteConfigById(request->config_id(), &service_name);
 
     if (success) {
+        if (cache_) {
+            cache_->Delete(CacheManager::ConfigKey(request->config_id()));
+        }
+        InvalidateCachedLists(service_name);
         db_->RecordAuditEvent("", request->config_id(), "deleted", "api", "");
         PublishEvent("config.deleted", "", 0, "api");
         RecordMetric("delete.success");
@@ -329,9 +659,11 @@ grpc::Status ApiServiceImpl::StartRollout(grpc::ServerContext* context,
     // The is_active flag tracks which version is the current live version;
     // rollout progress (current_percentage) is tracked separately in rollout_state.
     db_->SetActiveConfig(config.service_name(), config.config_name(), request->config_id());
+    InvalidateCachedLists(config.service_name());
 
     // Publish rollout event
-    PublishEvent("config.rollout_started", config.service_name(), config.version(), "api");
+    PublishEvent("config.rollout_started", config.service_name(), config.version(), "api",
+                 config.config_name());
 
     response->set_success(true);
     response->set_rollout_id(rollout_id);
@@ -429,23 +761,20 @@ grpc::Status ApiServiceImpl::Rollback(grpc::ServerContext* context,
             return grpc::Status::OK;
         }
 
-        // Create new version with old content
-        int64_t next_version = db_->GetNextVersion(svc, cfg);
-        std::string new_config_id = GenerateConfigId(svc, cfg, next_version);
-
+        // Create new version with old content, activated immediately — rollback is an
+        // emergency deploy, no staged rollout needed
         configservice::ConfigData rollback_config;
-        rollback_config.set_config_id(new_config_id);
         rollback_config.set_service_name(svc);
         rollback_config.set_config_name(cfg);
-        rollback_config.set_version(next_version);
-        rollback_config.set_content(target.content());
         rollback_config.set_format(target.format());
-        rollback_config.set_content_hash(ComputeHash(target.content()));
+        // Content left empty: the new version reuses the target's stored blob
+        rollback_config.set_content_hash(target.content_hash());
         rollback_config.set_created_at(static_cast<int64_t>(std::time(nullptr)));
         rollback_config.set_created_by("rollback");
 
-        auto [success, result] =
-            db_->InsertConfig(rollback_config, "Rollback to v" + std::to_string(target.version()));
+        auto [success, result] = db_->CreateConfigVersion(
+            rollback_config, "Rollback to v" + std::to_string(target.version()), "rollback", "api",
+            "Rolled back to v" + std::to_string(target.version()), /*activate=*/true);
 
         if (!success) {
             response->set_success(false);
@@ -454,15 +783,13 @@ grpc::Status ApiServiceImpl::Rollback(grpc::ServerContext* context,
             return grpc::Status::OK;
         }
 
-        // Immediately activate — rollback is an emergency deploy, no staged rollout needed
-        db_->SetActiveConfig(svc, cfg, new_config_id);
+        const std::string& new_config_id = rollback_config.config_id();
+        int64_t next_version = rollback_config.version();
 
-        // Audit
-        db_->RecordAuditEvent(svc, new_config_id, "rollback", "api",
-                              "Rolled back to v" + std::to_string(target.version()));
+        InvalidateCachedLists(svc);
 
         // Publish event
-        PublishEvent("config.rolled_back", svc, next_version, "api");
+        PublishEvent("config.rolled_back", svc, next_version, "api", cfg);
 
         response->set_success(true);
         response->set_config_id(new_config_id);
@@ -516,7 +843,9 @@ grpc::Status ApiServiceImpl::PromoteRollout(grpc::ServerContext* context,
 
     auto config = db_->GetConfigById(request->config_id());
     if (!config.service_name().empty()) {
-        PublishEvent("config.rollout_promoted", config.service_name(), config.version(), "api");
+        InvalidateCachedLists(config.service_name());
+        PublishEvent("config.rollout_promoted", config.service_name(), config.version(), "api",
+                     config.config_name());
     }
 
     response->set_success(true);
@@ -533,6 +862,116 @@ grpc::Status ApiServiceImpl::PromoteRollout(grpc::ServerContext* context,
 // Private Helpers
 // ─────────────────────────────────────────────
 
+bool ApiServiceImpl::CheckUpload(const configservice::UploadConfigRequest& request,
+                                 configservice::UploadConfigResponse* response) {
+    // Validate required fields
+    if (request.service_name().empty()) {
+        response->set_success(false);
+        response->set_message("service_name is required");
+        return false;
+    }
+    if (request.config_name().empty()) {
+        response->set_success(false);
+        response->set_message("config_name is required");
+        return false;
+    }
+    if (request.content().empty()) {
+        response->set_success(false);
+        response->set_message("content is required");
+        return false;
+    }
+
+    // Validate content if requested
+    std::vector<std::string> errors;
+    if (request.validate() || true) {  // Always validate
+        if (!ValidateContent(request.format(), request.content(), errors)) {
+            response->set_success(false);
+            response->set_message("Validation failed");
+            for (const auto& err : errors) {
+                response->add_validation_errors(err);
+            }
+            RecordMetric("upload.validation_failed");
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ApiServiceImpl::CheckValidationResult(
+    const configservice::ValidateConfigResponse& val_response,
+    configservice::UploadConfigResponse* response) {
+    if (!val_response.valid()) {
+        response->set_success(false);
+        response->set_message(val_response.errors_size() > 0
+                                  ? "Validation service rejected config"
+                                  : "Validation service rejected config: " +
+                                        val_response.message());
+
+        for (const auto& err : val_response.errors()) {
+            response->add_validation_errors(err.field() + ": " + err.message());
+        }
+
+        RecordMetric("upload.validation_service_failed");
+        return false;
+    }
+
+    // Log warnings but proceed
+    if (val_response.warnings_size() > 0) {
+        std::cout << "[ApiService] Validation warnings:" << std::endl;
+        for (const auto& warn : val_response.warnings()) {
+            std::cout << "  - " << warn.field() << ": " << warn.message() << std::endl;
+        }
+    }
+
+    return true;
+}
+
+configservice::ConfigData ApiServiceImpl::BuildUploadConfig(
+    const configservice::UploadConfigRequest& request) {
+    // Build ConfigData matching proto; version and config_id are allocated by the database
+    configservice::ConfigData config;
+    config.set_service_name(request.service_name());
+    config.set_config_name(request.config_name());
+    config.set_content(request.content());
+    config.set_format(request.format().empty() ? "json" : request.format());
+    config.set_content_hash(ComputeHash(request.content()));
+    config.set_created_at(static_cast<int64_t>(std::time(nullptr)));
+    config.set_created_by(request.created_by().empty() ? "api" : request.created_by());
+    return config;
+}
+
+grpc::Status ApiServiceImpl::FinishExport(const std::string& kind, bool success,
+                                          const std::string& error, bool cancelled, int64_t rows,
+                                          std::chrono::steady_clock::time_point start) {
+    auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                          std::chrono::steady_clock::now() - start)
+                          .count();
+
+    if (cancelled) {
+        RecordMetric("export." + kind + ".cancelled");
+        std::cout << "[ApiService] ⚠ Export (" << kind << ") cancelled by client after " << rows
+                  << " rows" << std::endl;
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Export cancelled by client");
+    }
+
+    if (!success) {
+        RecordMetric("export." + kind + ".failed");
+        std::cerr << "[ApiService] ✗ Export (" << kind << ") failed after " << rows
+                  << " rows: " << error << std::endl;
+        return grpc::Status(grpc::StatusCode::INTERNAL, "Export failed: " + error);
+    }
+
+    RecordMetric("export." + kind + ".success");
+    if (statsd_ && statsd_->isConnected()) {
+        statsd_->timing("export." + kind + ".duration", static_cast<int>(elapsed_ms));
+    }
+
+    std::cout << "[ApiService] ✓ Export (" << kind << "): " << rows << " rows in " << elapsed_ms
+              << "ms" << std::endl;
+    return grpc::Status::OK;
+}
+
 bool ApiServiceImpl::ValidateContent(const std::string& format, const std::string& content,
                                      std::vector<std::string>& errors) {
     if (content.empty()) {
@@ -546,50 +985,9 @@ bool ApiServiceImpl::ValidateContent(const std::string& format, const std::strin
     }
 
     if (format == "json" || format.empty()) {
-        int depth = 0;
-        bool in_string = false;
-        bool escaped = false;
-
-        for (size_t i = 0; i < content.size(); ++i) {
-            char c = content[i];
-            if (escaped) {
-                escaped = false;
-                continue;
-            }
-            if (c == '\\' && in_string) {
-                escaped = true;
-                continue;
-            }
-            if (c == '"') {
-                in_string = !in_string;
-                continue;
-            }
-            if (!in_string) {
-                if (c == '{' || c == '[')
-                    depth++;
-                if (c == '}' || c == ']') {
-                    // Check for trailing comma
-                    for (size_t j = i; j > 0; --j) {
-                        char p = content[j - 1];
-                        if (p == ' ' || p == '\t' || p == '\n' || p == '\r')
-                            continue;
-                        if (p == ',') {
-                            errors.push_back("Invalid JSON: trailing comma");
-                            return false;
-                        }
-                        break;
-                    }
-                    depth--;
-                    if (depth < 0) {
-                        errors.push_back("Invalid JSON: unexpected closing bracket");
-                        return false;
-                    }
-                }
-            }
-        }
-
-        if (depth != 0) {
-            errors.push_back("Invalid JSON: unclosed brackets");
+        auto scan = jsonscan::Validate(content);
+        if (!scan.valid) {
+            errors.push_back("Invalid JSON: " + scan.Describe());
             return false;
         }
     }
@@ -598,7 +996,8 @@ bool ApiServiceImpl::ValidateContent(const std::string& format, const std::strin
 }
 
 bool ApiServiceImpl::PublishEvent(const std::string& event_type, const std::string& service_name,
-                                  int64_t version, const std::string& performed_by) {
+                                  int64_t version, const std::string& performed_by,
+                                  const std::string& config_name) {
     if (!kafka_producer_) {
         return false;
     }
@@ -607,6 +1006,7 @@ bool ApiServiceImpl::PublishEvent(const std::string& event_type, const std::stri
     event << "{";
     event << "\"event_type\":\"" << event_type << "\",";
     event << "\"service_name\":\"" << service_name << "\",";
+    event << "\"config_name\":\"" << config_name << "\",";
     event << "\"version\":" << version << ",";
     event << "\"performed_by\":\"" << performed_by << "\",";
     event << "\"timestamp\":" << std::time(nullptr);
@@ -639,20 +1039,14 @@ void ApiServiceImpl::RecordMetric(const std::string& metric) {
     }
 }
 
-std::string ApiServiceImpl::GenerateConfigId(const std::string& service_name,
-                                             const std::string& config_name, int64_t version) {
-    return service_name + "-" + config_name + "-v" + std::to_string(version);
+void ApiServiceImpl::InvalidateCachedLists(const std::string& service_name) {
+    if (cache_ && !service_name.empty()) {
+        cache_->InvalidateService(service_name);
+    }
 }
 
 std::string ApiServiceImpl::ComputeHash(const std::string& content) {
-    // Simple hash using std::hash for now
-    // In production, use SHA256 (openssl or similar)
-    std::hash<std::string> hasher;
-    size_t hash = hasher(content);
-
-    std::ostringstream oss;
-    oss << std::hex << hash;
-    return oss.str();
+    return contenthash::Sha256Hex(content);
 }
 
 grpc::Status ApiServiceImpl::GetAuditLog(grpc::ServerContext* context,
@@ -661,16 +1055,93 @@ grpc::Status ApiServiceImpl::GetAuditLog(grpc::ServerContext* context,
     std::cout << "[ApiService] GetAuditLog: service=" << request->service_name() << std::endl;
 
     int limit = request->limit() > 0 ? request->limit() : 20;
-    auto entries = db_->GetAuditLog(request->service_name(), limit);
+    std::string next_page_token;
 
-    for (const auto& entry : entries) {
-        *response->add_entries() = entry;
+    try {
+        auto entries = db_->GetAuditLog(request->service_name(), limit, request->page_token(),
+                                        next_page_token);
+
+        for (const auto& entry : entries) {
+            *response->add_entries() = entry;
+        }
+    } catch (const std::invalid_argument& e) {
+        response->set_success(false);
+        response->set_message(e.what());
+        return grpc::Status::OK;
     }
 
+    response->set_next_page_token(next_page_token);
     response->set_success(true);
     return grpc::Status::OK;
 }
 
+grpc::Status ApiServiceImpl::ExportAuditLog(
+    grpc::ServerContext* context, const configservice::ExportAuditLogRequest* request,
+    grpc::ServerWriter<configservice::ExportAuditLogResponse>* writer) {
+    std::cout << "[ApiService] ExportAuditLog: service=" << request->service_name()
+              << " since=" << request->since() << " until=" << request->until() << std::endl;
+    RecordMetric("export.audit.request");
+
+    if (request->until() > 0 && request->until() <= request->since()) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "until must be after since");
+    }
+
+    ExportSlot slot(active_exports_);
+    if (!slot.acquired()) {
+        RecordMetric("export.rejected");
+        return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                            "Too many exports in progress, retry later");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int64_t rows = 0;
+    bool cancelled = false;
+
+    auto [success, error] = db_->ExportAuditLog(
+        request->service_name(), request->since(), request->until(), [&](const auto& chunk) {
+            cancelled = !WriteExportChunk(context, writer, chunk, rows);
+            return !cancelled;
+        });
+
+    return FinishExport("audit", success, error, cancelled, rows, start);
+}
+
+grpc::Status ApiServiceImpl::ExportConfigHistory(
+    grpc::ServerContext* context, const configservice::ExportConfigHistoryRequest* request,
+    grpc::ServerWriter<configservice::ExportConfigHistoryResponse>* writer) {
+    std::cout << "[ApiService] ExportConfigHistory: service=" << request->service_name()
+              << " config=" << request->config_name()
+              << (request->include_content() ? " (with content)" : "") << std::endl;
+    RecordMetric("export.history.request");
+
+    if (request->service_name().empty()) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "service_name is required");
+    }
+    if (request->until() > 0 && request->until() <= request->since()) {
+        return grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, "until must be after since");
+    }
+
+    ExportSlot slot(active_exports_);
+    if (!slot.acquired()) {
+        RecordMetric("export.rejected");
+        return grpc::Status(grpc::StatusCode::RESOURCE_EXHAUSTED,
+                            "Too many exports in progress, retry later");
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int64_t rows = 0;
+    bool cancelled = false;
+
+    auto [success, error] = db_->ExportConfigHistory(
+        request->service_name(), request->config_name(), request->since(), request->until(),
+        request->include_content(), [&](const auto& chunk) {
+            cancelled = !WriteExportChunk(context, writer, chunk, rows);
+            return !cancelled;
+        });
+
+    return FinishExport("history", success, error, cancelled, rows, start);
+}
+
 grpc::Status ApiServiceImpl::GetStats(grpc::ServerContext* context,
                                       const configservice::GetStatsRequest* request,
                                       configservice::GetStatsResponse* response) {
@@ -719,11 +1190,29 @@ grpc::Status ApiServiceImpl::ListNamedConfigs(grpc::ServerContext* context,
     }
 
     try {
+        std::string cache_key;
+        if (cache_) {
+            cache_key = "api:named:" + request->service_name() + ":g" +
+                        cache_->GetGeneration(request->service_name());
+            std::string cached;
+            if (cache_->Get(cache_key, cached) && response->ParseFromString(cached)) {
+                RecordMetric("cache.named.hit");
+                return grpc::Status::OK;
+            }
+            response->Clear();
+            RecordMetric("cache.named.miss");
+        }
+
         auto named_configs = db_->ListNamedConfigs(request->service_name());
         for (const auto& nc : named_configs) {
             *response->add_configs() = nc;
         }
         response->set_success(true);
+
+        // An empty result may be a swallowed DB error; don't pin it for a whole TTL
+        if (cache_ && response->configs_size() > 0) {
+            cache_->Set(cache_key, response->SerializeAsString(), cache_->ListTtlSeconds());
+        }
     } catch (const std::exception& e) {
         response->set_success(false);
     }
@@ -0,0 +1,214 @@
+#include "api_service/cache_manager.h"
+
+#include <iostream>
+
+namespace apiservice {
+
+namespace {
+
+// Minimum gap between reconnect attempts while Redis is down, so a dead cache costs one
+// failed connect every few seconds instead of one per request.
+constexpr std::chrono::seconds kReconnectInterval(5);
+
+}  // anonymous namespace
+
+CacheManager::CacheManager(const RedisConfig& config)
+    : config_(config), context_(nullptr), initialized_(false) {}
+
+CacheManager::~CacheManager() {
+    Shutdown();
+}
+
+bool CacheManager::Initialize() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return Connect();
+}
+
+void CacheManager::Shutdown() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (context_) {
+        Disconnect();
+        std::cout << "[Cache] Connection closed" << std::endl;
+    }
+}
+
+// ─── Connection handling (mutex_ held) ────────────────────────────────────────
+
+bool CacheManager::Connect() {
+    last_connect_attempt_ = std::chrono::steady_clock::now();
+
+    struct timeval timeout = {config_.connection_timeout_seconds, 0};
+    context_ = redisConnectWithTimeout(config_.host.c_str(), config_.port, timeout);
+
+    if (context_ == nullptr || context_->err) {
+        if (context_) {
+            std::cerr << "[Cache] ✗ Connection failed: " << context_->errstr << std::endl;
+            redisFree(context_);
+            context_ = nullptr;
+        } else {
+            std::cerr << "[Cache] ✗ Connection failed: Cannot allocate context" << std::endl;
+        }
+        return false;
+    }
+
+    // Commands must not stall an RPC for longer than the connect itself would
+    redisSetTimeout(context_, timeout);
+
+    redisReply* reply = (redisReply*)redisCommand(context_, "PING");
+    if (reply == nullptr || reply->type == REDIS_REPLY_ERROR) {
+        std::cerr << "[Cache] ✗ PING failed" << std::endl;
+        if (reply)
+            freeReplyObject(reply);
+        Disconnect();
+        return false;
+    }
+    freeReplyObject(reply);
+
+    std::cout << "[Cache] ✓ Connected to Redis" << std::endl;
+    std::cout << "[Cache]   Host: " << config_.host << ":" << config_.port << std::endl;
+
+    initialized_ = true;
+    return true;
+}
+
+bool CacheManager::EnsureConnected() {
+    if (initialized_ && context_ && context_->err == 0) {
+        return true;
+    }
+    if (context_) {
+        std::cerr << "[Cache] ⚠ Connection lost: " << context_->errstr << std::endl;
+        Disconnect();
+    }
+    if (std::chrono::steady_clock::now() - last_connect_attempt_ < kReconnectInterval) {
+        return false;
+    }
+    return Connect();
+}
+
+void CacheManager::Disconnect() {
+    if (context_) {
+        redisFree(context_);
+        context_ = nullptr;
+    }
+    initialized_ = false;
+}
+
+// ─── Cache operations ─────────────────────────────────────────────────────────
+
+bool CacheManager::Set(const std::string& key, const std::string& value, int ttl_seconds) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!EnsureConnected()) {
+        return false;
+    }
+
+    redisReply* reply;
+
+    if (ttl_seconds > 0) {
+        reply = (redisReply*)redisCommand(context_, "SETEX %b %d %b", key.data(), key.size(),
+                                          ttl_seconds, value.data(), value.size());
+    } else {
+        reply = (redisReply*)redisCommand(context_, "SET %b %b", key.data(), key.size(),
+                                          value.data(), value.size());
+    }
+
+    if (reply == nullptr || reply->type == REDIS_REPLY_ERROR) {
+        if (reply) {
+            std::cerr << "[Cache] SET failed: " << reply->str << std::endl;
+            freeReplyObject(reply);
+        }
+        return false;
+    }
+
+    freeReplyObject(reply);
+    return true;
+}
+
+bool CacheManager::Get(const std::string& key, std::string& value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!EnsureConnected()) {
+        return false;
+    }
+
+    redisReply* reply = (redisReply*)redisCommand(context_, "GET %b", key.data(), key.size());
+
+    if (reply == nullptr || reply->type != REDIS_REPLY_STRING) {
+        if (reply)
+            freeReplyObject(reply);
+        return false;
+    }
+
+    value.assign(reply->str, reply->len);
+    freeReplyObject(reply);
+
+    return true;
+}
+
+bool CacheManager::Delete(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!EnsureConnected()) {
+        return false;
+    }
+
+    redisReply* reply = (redisReply*)redisCommand(context_, "DEL %b", key.data(), key.size());
+
+    if (reply == nullptr) {
+        return false;
+    }
+
+    bool success = reply->type == REDIS_REPLY_INTEGER && reply->integer > 0;
+    freeReplyObject(reply);
+
+    return success;
+}
+
+int64_t CacheManager::IncrementCounter(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!EnsureConnected()) {
+        return 0;
+    }
+
+    redisReply* reply = (redisReply*)redisCommand(context_, "INCR %b", key.data(), key.size());
+
+    if (reply == nullptr || reply->type != REDIS_REPLY_INTEGER) {
+        if (reply)
+            freeReplyObject(reply);
+        return 0;
+    }
+
+    int64_t value = reply->integer;
+    freeReplyObject(reply);
+
+    return value;
+}
+
+// ─── Key scheme ───────────────────────────────────────────────────────────────
+
+std::string CacheManager::ConfigKey(const std::string& config_id) {
+    return "api:config:" + config_id;
+}
+
+std::string CacheManager::GenerationKey(const std::string& service_name) {
+    // Also bumped by the distribution service when a rollout flips the active version
+    return "api:gen:" + service_name;
+}
+
+std::string CacheManager::GetGeneration(const std::string& service_name) {
+    std::string generation;
+    if (!Get(GenerationKey(service_name), generation)) {
+        return "0";
+    }
+    return generation;
+}
+
+void CacheManager::InvalidateService(const std::string& service_name) {
+    if (IncrementCounter(GenerationKey(service_name)) == 0) {
+        std::cerr << "[Cache] ⚠ Could not invalidate lists for " << service_name << std::endl;
+    }
+}
+
+}  // namespace apiservice
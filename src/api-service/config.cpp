@@ -34,6 +34,8 @@ ServiceConfig ServiceConfig::LoadFromFile(const std::string& path) {
             config.redis.host = yaml["redis"]["host"].as<std::string>("redis");
             config.redis.port = yaml["redis"]["port"].as<int>(6379);
             config.redis.cache_ttl_seconds = yaml["redis"]["cache_ttl"].as<int>(300);
+            config.redis.connection_timeout_seconds =
+                yaml["redis"]["connection_timeout"].as<int>(2);
         }
 
         if (yaml["statsd"]) {
@@ -45,6 +47,9 @@ ServiceConfig ServiceConfig::LoadFromFile(const std::string& path) {
         if (yaml["validation_service"]) {
             config.validation.address =
                 yaml["validation_service"]["address"].as<std::string>("validation-service:8083");
+            config.validation.channel_pool_size =
+                yaml["validation_service"]["channel_pool_size"].as<int>(4);
+            config.validation.timeout_ms = yaml["validation_service"]["timeout_ms"].as<int>(10000);
         }
 
         std::cout << "[Config] Loaded from: " << path << std::endl;
@@ -1,12 +1,151 @@
 #include "api_service/database_manager.h"
 
+#include <algorithm>
 #include <ctime>
 #include <iomanip>
 #include <iostream>
+#include <cstring>
+#include <map>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
+#include <tuple>
 
 namespace apiservice {
 
+namespace {
+
+// ─── Page tokens ──────────────────────────────────────────────────────────────
+// A token is the sort key of the last row of a page, tagged with the list it belongs to and
+// base64url-encoded so clients treat it as opaque.
+
+const char kBase64Url[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+std::string EncodePageToken(const std::string& kind, const std::string& cursor) {
+    std::string raw = kind + ":" + cursor;
+    std::string out;
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (unsigned char c : raw) {
+        buffer = (buffer << 8) | c;
+        bits += 8;
+        while (bits >= 6) {
+            bits -= 6;
+            out.push_back(kBase64Url[(buffer >> bits) & 0x3F]);
+        }
+    }
+    if (bits > 0) {
+        out.push_back(kBase64Url[(buffer << (6 - bits)) & 0x3F]);
+    }
+    return out;
+}
+
+// Returns the cursor, or throws std::invalid_argument if the token is not a `kind` token
+std::string DecodePageToken(const std::string& kind, const std::string& token) {
+    std::string raw;
+    uint32_t buffer = 0;
+    int bits = 0;
+    for (char c : token) {
+        const char* pos = std::strchr(kBase64Url, c);
+        if (c == '\0' || pos == nullptr) {
+            throw std::invalid_argument("invalid page_token");
+        }
+        buffer = (buffer << 6) | static_cast<uint32_t>(pos - kBase64Url);
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            raw.push_back(static_cast<char>((buffer >> bits) & 0xFF));
+        }
+    }
+    if (raw.compare(0, kind.size() + 1, kind + ":") != 0) {
+        throw std::invalid_argument("invalid page_token");
+    }
+    return raw.substr(kind.size() + 1);
+}
+
+// ─── Bulk uploads ─────────────────────────────────────────────────────────────
+
+// Items and payload bytes per CreateConfigVersions statement
+constexpr size_t kUploadBatchItems = 100;
+constexpr size_t kUploadBatchBytes = 8 * 1024 * 1024;
+
+void AppendJsonString(std::string& out, const std::string& value) {
+    static const char kHex[] = "0123456789abcdef";
+    out.push_back('"');
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"':
+                out += "\\\"";
+                break;
+            case '\\':
+                out += "\\\\";
+                break;
+            case '\n':
+                out += "\\n";
+                break;
+            case '\r':
+                out += "\\r";
+                break;
+            case '\t':
+                out += "\\t";
+                break;
+            default:
+                if (c < 0x20) {
+                    out += "\\u00";
+                    out.push_back(kHex[c >> 4]);
+                    out.push_back(kHex[c & 0xF]);
+                } else {
+                    out.push_back(static_cast<char>(c));
+                }
+        }
+    }
+    out.push_back('"');
+}
+
+// ─── Arrays ───────────────────────────────────────────────────────────────────
+
+// Postgres text[] literal, e.g. {"a","b\"c"}
+std::string ToTextArray(const std::vector<std::string>& values) {
+    std::string out = "{";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i != 0) {
+            out += ',';
+        }
+        out += '"';
+        for (char c : values[i]) {
+            if (c == '"' || c == '\\') {
+                out += '\\';
+            }
+            out += c;
+        }
+        out += '"';
+    }
+    out += '}';
+    return out;
+}
+
+// ─── Exports ──────────────────────────────────────────────────────────────────
+
+// Rows per FETCH: small enough that a chunk of full config bodies stays a few MB
+constexpr int kExportFetchRows = 500;
+constexpr int kExportFetchRowsWithContent = 16;
+
+// created_at holds UTC wall time, matching EXTRACT(EPOCH ...) on the way out
+std::string TimeRangeFilter(const std::string& column, int64_t since, int64_t until) {
+    std::string filter;
+    if (since > 0) {
+        filter += " AND " + column + " >= to_timestamp(" + std::to_string(since) +
+                  ") AT TIME ZONE 'UTC'";
+    }
+    if (until > 0) {
+        filter += " AND " + column + " < to_timestamp(" + std::to_string(until) +
+                  ") AT TIME ZONE 'UTC'";
+    }
+    return filter;
+}
+
+}  // anonymous namespace
+
 DatabaseManager::DatabaseManager(const PostgresConfig& config)
     : config_(config), initialized_(false) {}
 
@@ -58,68 +197,233 @@ void DatabaseManager::Shutdown() {
     std::cout << "[DB] Connection closed" << std::endl;
 }
 
-int64_t DatabaseManager::GetNextVersion(const std::string& service_name,
-                                        const std::string& config_name) {
+std::pair<bool, std::string> DatabaseManager::CreateConfigVersion(
+    configservice::ConfigData& config, const std::string& description,
+    const std::string& audit_action, const std::string& performed_by,
+    const std::string& audit_details, bool activate, bool skip_unchanged, bool* unchanged) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!initialized_) {
+        return {false, "Database not initialized"};
+    }
+
+    try {
+        // A single statement is atomic on its own; skipping BEGIN/COMMIT keeps the
+        // upload to one round trip on the shared connection.
+        pqxx::nontransaction txn(*conn_);
+
+        auto optional = [](const std::string& value) {
+            return value.empty() ? std::nullopt : std::optional<std::string>(value);
+        };
+
+        pqxx::result r = txn.exec_params(
+            "SELECT config_id, version, is_active, unchanged "
+            "FROM create_config_version($1, $2, $3, $4, $5, $6, $7, $8, $9, $10, $11, $12)",
+            config.service_name(), config.config_name(), config.format(), config.created_by(),
+            description, optional(config.content()), config.content_hash(), audit_action,
+            performed_by, optional(audit_details), activate, skip_unchanged);
+
+        config.set_config_id(r[0]["config_id"].as<std::string>());
+        config.set_version(r[0]["version"].as<int64_t>());
+
+        bool is_unchanged = r[0]["unchanged"].as<bool>();
+        if (unchanged) {
+            *unchanged = is_unchanged;
+        }
+
+        std::cout << "[DB] " << (is_unchanged ? "Unchanged config: " : "Created config: ")
+                  << config.config_id() << (r[0]["is_active"].as<bool>() ? " (active)" : "")
+                  << std::endl;
+
+        return {true, config.config_id()};
+
+    } catch (const std::exception& e) {
+        std::cerr << "[DB] CreateConfigVersion failed: " << e.what() << std::endl;
+        return {false, e.what()};
+    }
+}
+
+std::vector<configservice::ConfigData> DatabaseManager::GetConfigsByIds(
+    const std::vector<std::string>& config_ids, bool include_content) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<configservice::ConfigData> configs;
+
     try {
         pqxx::work txn(*conn_);
 
-        pqxx::result r = txn.exec_params("SELECT COALESCE(MAX(version), 0) + 1 "
-                                         "FROM config_metadata "
-                                         "WHERE service_name = $1 AND config_name = $2",
-                                         service_name, config_name);
+        pqxx::result r;
+        if (include_content) {
+            r = txn.exec_params("SELECT m.config_id, m.service_name, m.config_name, m.version, "
+                                "       b.content, m.format, "
+                                "       COALESCE(d.content_hash, '') as content_hash, "
+                                "       m.created_at, m.created_by "
+                                "FROM config_metadata m "
+                                "JOIN config_data d ON m.config_id = d.config_id "
+                                "JOIN config_blobs b ON b.content_hash = d.content_hash "
+                                "WHERE m.config_id = ANY($1::text[])",
+                                ToTextArray(config_ids));
+        } else {
+            // Metadata only: config_blobs (the large rows) is never touched
+            r = txn.exec_params("SELECT m.config_id, m.service_name, m.config_name, m.version, "
+                                "       '' AS content, m.format, "
+                                "       COALESCE(d.content_hash, '') as content_hash, "
+                                "       m.created_at, m.created_by "
+                                "FROM config_metadata m "
+                                "JOIN config_data d ON m.config_id = d.config_id "
+                                "WHERE m.config_id = ANY($1::text[])",
+                                ToTextArray(config_ids));
+        }
 
         txn.commit();
 
-        return r[0][0].as<int64_t>(1);
+        configs.reserve(r.size());
+        for (const auto& row : r) {
+            configs.push_back(ParseConfigRow(row));
+        }
+
+        return configs;
 
     } catch (const std::exception& e) {
-        std::cerr << "[DB] GetNextVersion failed: " << e.what() << std::endl;
-        return 1;
+        std::cerr << "[DB] GetConfigsByIds failed: " << e.what() << std::endl;
+        throw;
     }
 }
 
-std::pair<bool, std::string> DatabaseManager::InsertConfig(const configservice::ConfigData& config,
-                                                           const std::string& description) {
+std::vector<VersionResult> DatabaseManager::CreateConfigVersions(
+    std::vector<configservice::ConfigData>& configs, const std::vector<std::string>& descriptions,
+    bool atomic) {
     std::lock_guard<std::mutex> lock(mutex_);
 
+    std::vector<VersionResult> results(configs.size());
+
     if (!initialized_) {
-        return {false, "Database not initialized"};
+        for (auto& result : results) {
+            result.error = "Database not initialized";
+        }
+        return results;
     }
 
-    try {
-        pqxx::work txn(*conn_);
+    // Items go in (service_name, config_name) order, so concurrent calls lock
+    // config_version_counters rows in the same order and cannot deadlock. The sort is
+    // stable: items for the same named config keep their stream order.
+    std::vector<size_t> order(configs.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        return std::tie(configs[a].service_name(), configs[a].config_name()) <
+               std::tie(configs[b].service_name(), configs[b].config_name());
+    });
+
+    // [begin, end) ranges of order, of at most kUploadBatchItems items / ~kUploadBatchBytes
+    std::vector<std::pair<size_t, size_t>> batches;
+    size_t batch_start = 0;
+    size_t batch_bytes = 0;
+    for (size_t i = 0; i < configs.size(); ++i) {
+        batch_bytes += configs[order[i]].content().size();
+        if (i + 1 - batch_start == kUploadBatchItems || batch_bytes >= kUploadBatchBytes ||
+            i + 1 == configs.size()) {
+            batches.emplace_back(batch_start, i + 1);
+            batch_start = i + 1;
+            batch_bytes = 0;
+        }
+    }
 
-        // v1 of a named config is auto-activated; later versions stay inactive
-        // until a rollout promotes them.
-        pqxx::result existing = txn.exec_params("SELECT COUNT(*) FROM config_metadata "
-                                                "WHERE service_name = $1 AND config_name = $2",
-                                                config.service_name(), config.config_name());
-        bool is_first = existing[0][0].as<int64_t>() == 0;
-
-        txn.exec_params("INSERT INTO config_metadata "
-                        "  (config_id, service_name, config_name, version, format, "
-                        "   created_by, description, is_active) "
-                        "VALUES ($1, $2, $3, $4, $5, $6, $7, $8)",
-                        config.config_id(), config.service_name(), config.config_name(),
-                        config.version(), config.format(), config.created_by(), description,
-                        is_first);
-
-        txn.exec_params("INSERT INTO config_data "
-                        "  (config_id, content, content_hash, size_bytes) "
-                        "VALUES ($1, $2, $3, $4)",
-                        config.config_id(), config.content(), config.content_hash(),
-                        static_cast<int64_t>(config.content().size()));
+    // One statement per batch: create_config_version runs once per jsonb element, in array
+    // order, so items for the same named config get consecutive versions
+    auto store_batch = [&](pqxx::transaction_base& txn, size_t begin, size_t end) {
+        std::string items = "[";
+        for (size_t position = begin; position < end; ++position) {
+            size_t i = order[position];
+            const auto& config = configs[i];
+            if (position != begin) {
+                items += ',';
+            }
+            items += "{\"idx\":" + std::to_string(i) + ",\"service_name\":";
+            AppendJsonString(items, config.service_name());
+            items += ",\"config_name\":";
+            AppendJsonString(items, config.config_name());
+            items += ",\"format\":";
+            AppendJsonString(items, config.format());
+            items += ",\"created_by\":";
+            AppendJsonString(items, config.created_by());
+            items += ",\"description\":";
+            AppendJsonString(items, descriptions[i]);
+            items += ",\"content\":";
+            AppendJsonString(items, config.content());
+            items += ",\"content_hash\":";
+            AppendJsonString(items, config.content_hash());
+            items += '}';
+        }
+        items += ']';
+
+        pqxx::result r = txn.exec_params(
+            "SELECT i.idx, v.config_id, v.version, v.unchanged "
+            "FROM jsonb_to_recordset($1::jsonb) AS i(idx int, service_name varchar, "
+            "     config_name varchar, format varchar, created_by varchar, description text, "
+            "     content text, content_hash varchar) "
+            "CROSS JOIN LATERAL create_config_version(i.service_name, i.config_name, i.format, "
+            "     i.created_by, i.description, i.content, i.content_hash, 'uploaded', "
+            "     i.created_by, NULL, false, true) AS v",
+            items);
 
-        txn.commit();
+        for (const auto& row : r) {
+            size_t idx = row["idx"].as<size_t>();
+            configs[idx].set_config_id(row["config_id"].as<std::string>());
+            configs[idx].set_version(row["version"].as<int64_t>());
+            results[idx].success = true;
+            results[idx].unchanged = row["unchanged"].as<bool>();
+        }
+    };
 
-        std::cout << "[DB] Inserted config: " << config.config_id() << std::endl;
+    if (atomic) {
+        try {
+            pqxx::work txn(*conn_);
+            for (const auto& [begin, end] : batches) {
+                store_batch(txn, begin, end);
+            }
+            txn.commit();
 
-        return {true, config.config_id()};
+        } catch (const std::exception& e) {
+            std::cerr << "[DB] CreateConfigVersions (atomic) failed: " << e.what() << std::endl;
+            for (auto& result : results) {
+                result = VersionResult{false, false, e.what()};
+            }
+            return results;
+        }
 
-    } catch (const std::exception& e) {
-        std::cerr << "[DB] InsertConfig failed: " << e.what() << std::endl;
-        return {false, e.what()};
+        std::cout << "[DB] Stored " << configs.size() << " uploads in " << batches.size()
+                  << " batch(es)" << std::endl;
+        return results;
+    }
+
+    size_t failed = 0;
+    for (const auto& [begin, end] : batches) {
+        try {
+            // A single statement is atomic on its own
+            pqxx::nontransaction txn(*conn_);
+            store_batch(txn, begin, end);
+            continue;
+        } catch (const std::exception& e) {
+            std::cerr << "[DB] Upload batch failed, retrying items individually: " << e.what()
+                      << std::endl;
+        }
+
+        for (size_t position = begin; position < end; ++position) {
+            try {
+                pqxx::nontransaction txn(*conn_);
+                store_batch(txn, position, position + 1);
+            } catch (const std::exception& e) {
+                results[order[position]].error = e.what();
+                failed++;
+            }
+        }
     }
+
+    std::cout << "[DB] Stored " << (configs.size() - failed) << "/" << configs.size()
+              << " uploads in " << batches.size() << " batch(es)" << std::endl;
+    return results;
 }
 
 configservice::ConfigData DatabaseManager::GetConfigById(const std::string& config_id) {
@@ -130,11 +434,12 @@ configservice::ConfigData DatabaseManager::GetConfigById(const std::string& conf
 
         pqxx::result r =
             txn.exec_params("SELECT m.config_id, m.service_name, m.config_name, m.version, "
-                            "       d.content, m.format, "
+                            "       b.content, m.format, "
                             "       COALESCE(d.content_hash, '') as content_hash, "
                             "       m.created_at, m.created_by "
                             "FROM config_metadata m "
                             "JOIN config_data d ON m.config_id = d.config_id "
+                            "JOIN config_blobs b ON b.content_hash = d.content_hash "
                             "WHERE m.config_id = $1",
                             config_id);
 
@@ -153,22 +458,36 @@ configservice::ConfigData DatabaseManager::GetConfigById(const std::string& conf
 }
 
 configservice::ConfigData DatabaseManager::GetLatestConfigByName(const std::string& service_name,
-                                                                 const std::string& config_name) {
+                                                                 const std::string& config_name,
+                                                                 bool include_content) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     try {
         pqxx::work txn(*conn_);
 
-        pqxx::result r =
-            txn.exec_params("SELECT m.config_id, m.service_name, m.config_name, m.version, "
-                            "       d.content, m.format, "
-                            "       COALESCE(d.content_hash, '') as content_hash, "
-                            "       m.created_at, m.created_by "
-                            "FROM config_metadata m "
-                            "JOIN config_data d ON m.config_id = d.config_id "
-                            "WHERE m.service_name = $1 AND m.config_name = $2 "
-                            "ORDER BY m.version DESC LIMIT 1",
-                            service_name, config_name);
+        pqxx::result r;
+        if (include_content) {
+            r = txn.exec_params("SELECT m.config_id, m.service_name, m.config_name, m.version, "
+                                "       b.content, m.format, "
+                                "       COALESCE(d.content_hash, '') as content_hash, "
+                                "       m.created_at, m.created_by "
+                                "FROM config_metadata m "
+                                "JOIN config_data d ON m.config_id = d.config_id "
+                                "JOIN config_blobs b ON b.content_hash = d.content_hash "
+                                "WHERE m.service_name = $1 AND m.config_name = $2 "
+                                "ORDER BY m.version DESC LIMIT 1",
+                                service_name, config_name);
+        } else {
+            r = txn.exec_params("SELECT m.config_id, m.service_name, m.config_name, m.version, "
+                                "       '' AS content, m.format, "
+                                "       COALESCE(d.content_hash, '') as content_hash, "
+                                "       m.created_at, m.created_by "
+                                "FROM config_metadata m "
+                                "JOIN config_data d ON m.config_id = d.config_id "
+                                "WHERE m.service_name = $1 AND m.config_name = $2 "
+                                "ORDER BY m.version DESC LIMIT 1",
+                                service_name, config_name);
+        }
 
         txn.commit();
 
@@ -184,6 +503,56 @@ configservice::ConfigData DatabaseManager::GetLatestConfigByName(const std::stri
     }
 }
 
+std::vector<std::string> DatabaseManager::GetLatestContentHashes(
+    const std::vector<std::pair<std::string, std::string>>& names) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    std::vector<std::string> hashes(names.size());
+    if (names.empty()) {
+        return hashes;
+    }
+
+    std::vector<std::string> service_names, config_names;
+    for (const auto& [service_name, config_name] : names) {
+        service_names.push_back(service_name);
+        config_names.push_back(config_name);
+    }
+
+    try {
+        pqxx::work txn(*conn_);
+
+        pqxx::result r = txn.exec_params(
+            "SELECT DISTINCT ON (m.service_name, m.config_name) "
+            "       m.service_name, m.config_name, COALESCE(d.content_hash, '') AS content_hash "
+            "FROM unnest($1::text[], $2::text[]) AS n(service_name, config_name) "
+            "JOIN config_metadata m "
+            "  ON m.service_name = n.service_name AND m.config_name = n.config_name "
+            "JOIN config_data d ON m.config_id = d.config_id "
+            "ORDER BY m.service_name, m.config_name, m.version DESC",
+            ToTextArray(service_names), ToTextArray(config_names));
+
+        txn.commit();
+
+        std::map<std::pair<std::string, std::string>, std::string> latest;
+        for (const auto& row : r) {
+            latest[{row["service_name"].as<std::string>(), row["config_name"].as<std::string>()}] =
+                row["content_hash"].as<std::string>();
+        }
+        for (size_t i = 0; i < names.size(); ++i) {
+            auto found = latest.find(names[i]);
+            if (found != latest.end()) {
+                hashes[i] = found->second;
+            }
+        }
+
+        return hashes;
+
+    } catch (const std::exception& e) {
+        std::cerr << "[DB] GetLatestContentHashes failed: " << e.what() << std::endl;
+        throw;
+    }
+}
+
 configservice::ConfigData DatabaseManager::GetActiveConfig(const std::string& service_name,
                                                            const std::string& config_name) {
     std::lock_guard<std::mutex> lock(mutex_);
@@ -193,11 +562,12 @@ configservice::ConfigData DatabaseManager::GetActiveConfig(const std::string& se
 
         pqxx::result r =
             txn.exec_params("SELECT m.config_id, m.service_name, m.config_name, m.version, "
-                            "       d.content, m.format, "
+                            "       b.content, m.format, "
                             "       COALESCE(d.content_hash, '') as content_hash, "
                             "       m.created_at, m.created_by "
                             "FROM config_metadata m "
                             "JOIN config_data d ON m.config_id = d.config_id "
+                            "JOIN config_blobs b ON b.content_hash = d.content_hash "
                             "WHERE m.service_name = $1 AND m.config_name = $2 "
                             "  AND m.is_active = true "
                             "LIMIT 1",
@@ -251,11 +621,12 @@ configservice::ConfigData DatabaseManager::GetConfigByVersion(const std::string&
 
         pqxx::result r =
             txn.exec_params("SELECT m.config_id, m.service_name, m.config_name, m.version, "
-                            "       d.content, m.format, "
+                            "       b.content, m.format, "
                             "       COALESCE(d.content_hash, '') as content_hash, "
                             "       m.created_at, m.created_by "
                             "FROM config_metadata m "
                             "JOIN config_data d ON m.config_id = d.config_id "
+                            "JOIN config_blobs b ON b.content_hash = d.content_hash "
                             "WHERE m.service_name = $1 AND m.config_name = $2 "
                             "  AND m.version = $3",
                             service_name, config_name, version);
@@ -276,7 +647,17 @@ configservice::ConfigData DatabaseManager::GetConfigByVersion(const std::string&
 
 std::vector<configservice::ConfigMetadata> DatabaseManager::ListConfigs(
     const std::string& service_name, const std::string& config_name, int limit, int offset,
-    int& total_count) {
+    const std::string& page_token, bool include_total, PageInfo& page) {
+    // Versions are unique per named config, so the last version seen is a complete cursor
+    std::optional<int64_t> after_version;
+    if (!page_token.empty()) {
+        try {
+            after_version = std::stoll(DecodePageToken("cfg", page_token));
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument("invalid page_token");
+        }
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
 
     std::vector<configservice::ConfigMetadata> configs;
@@ -284,25 +665,50 @@ std::vector<configservice::ConfigMetadata> DatabaseManager::ListConfigs(
     try {
         pqxx::work txn(*conn_);
 
-        pqxx::result r =
-            txn.exec_params("SELECT config_id, service_name, config_name, version, format, "
-                            "       created_at, created_by, "
-                            "       COALESCE(description, '') as description, is_active "
-                            "FROM config_metadata "
-                            "WHERE service_name = $1 AND config_name = $2 "
-                            "ORDER BY version DESC "
-                            "LIMIT $3 OFFSET $4",
-                            service_name, config_name, limit, offset);
-
-        pqxx::result count_r = txn.exec_params("SELECT COUNT(*) FROM config_metadata "
-                                               "WHERE service_name = $1 AND config_name = $2",
-                                               service_name, config_name);
+        // One extra row tells whether another page follows
+        pqxx::result r;
+        if (after_version) {
+            r = txn.exec_params("SELECT config_id, service_name, config_name, version, format, "
+                                "       created_at, created_by, "
+                                "       COALESCE(description, '') as description, is_active "
+                                "FROM config_metadata "
+                                "WHERE service_name = $1 AND config_name = $2 AND version < $3 "
+                                "ORDER BY version DESC "
+                                "LIMIT $4",
+                                service_name, config_name, *after_version, limit + 1);
+        } else {
+            r = txn.exec_params("SELECT config_id, service_name, config_name, version, format, "
+                                "       created_at, created_by, "
+                                "       COALESCE(description, '') as description, is_active "
+                                "FROM config_metadata "
+                                "WHERE service_name = $1 AND config_name = $2 "
+                                "ORDER BY version DESC "
+                                "LIMIT $3 OFFSET $4",
+                                service_name, config_name, limit + 1, offset);
+        }
+
+        pqxx::result count_r;
+        if (include_total) {
+            count_r = txn.exec_params("SELECT COUNT(*) FROM config_metadata "
+                                      "WHERE service_name = $1 AND config_name = $2",
+                                      service_name, config_name);
+        } else {
+            // Trigger-maintained count (migration 015): exact, and a single-row lookup
+            count_r = txn.exec_params("SELECT version_count FROM named_config_summaries "
+                                      "WHERE service_name = $1 AND config_name = $2",
+                                      service_name, config_name);
+        }
 
         txn.commit();
 
-        total_count = count_r[0][0].as<int>(0);
+        page.total_count = count_r.empty() ? 0 : count_r[0][0].as<int>(0);
 
         for (const auto& row : r) {
+            if (static_cast<int>(configs.size()) == limit) {
+                page.next_page_token =
+                    EncodePageToken("cfg", std::to_string(configs.back().version()));
+                break;
+            }
             configs.push_back(ParseMetadataRow(row));
         }
 
@@ -324,22 +730,12 @@ std::vector<configservice::NamedConfigSummary> DatabaseManager::ListNamedConfigs
         pqxx::work txn(*conn_);
 
         pqxx::result r =
-            txn.exec_params("SELECT cm.service_name, cm.config_name, "
-                            "       MAX(cm.format) AS format, "
-                            "       COUNT(*) AS version_count, "
-                            "       MAX(cm.version) AS latest_version, "
-                            "       MAX(cm.created_at)::text AS latest_updated_at, "
-                            "       EXISTS( "
-                            "         SELECT 1 FROM rollout_state rs "
-                            "         JOIN config_metadata cm2 ON cm2.config_id = rs.config_id "
-                            "         WHERE cm2.service_name = cm.service_name "
-                            "           AND cm2.config_name = cm.config_name "
-                            "           AND rs.status IN ('IN_PROGRESS', 'PENDING') "
-                            "       ) AS has_active_rollout "
-                            "FROM config_metadata cm "
-                            "WHERE cm.service_name = $1 "
-                            "GROUP BY cm.service_name, cm.config_name "
-                            "ORDER BY cm.config_name",
+            txn.exec_params("SELECT service_name, config_name, format, version_count, "
+                            "       latest_version, latest_created_at::text AS latest_updated_at, "
+                            "       active_rollouts > 0 AS has_active_rollout "
+                            "FROM named_config_summaries "
+                            "WHERE service_name = $1 "
+                            "ORDER BY config_name",
                             service_name);
 
         txn.commit();
@@ -366,7 +762,8 @@ std::vector<configservice::NamedConfigSummary> DatabaseManager::ListNamedConfigs
     }
 }
 
-std::pair<bool, std::string> DatabaseManager::DeleteConfigById(const std::string& config_id) {
+std::pair<bool, std::string> DatabaseManager::DeleteConfigById(const std::string& config_id,
+                                                               std::string* service_name) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (!initialized_) {
@@ -376,10 +773,12 @@ std::pair<bool, std::string> DatabaseManager::DeleteConfigById(const std::string
     try {
         pqxx::work txn(*conn_);
 
-        pqxx::result r = txn.exec_params("DELETE FROM config_metadata "
-                                         "WHERE config_id = $1 "
-                                         "RETURNING config_id, service_name",
-                                         config_id);
+        pqxx::result r = txn.exec_params(
+            "WITH body AS (SELECT content_hash FROM config_data WHERE config_id = $1) "
+            "DELETE FROM config_metadata "
+            "WHERE config_id = $1 "
+            "RETURNING config_id, service_name, (SELECT content_hash FROM body) AS content_hash",
+            config_id);
 
         txn.commit();
 
@@ -389,6 +788,29 @@ std::pair<bool, std::string> DatabaseManager::DeleteConfigById(const std::string
 
         std::cout << "[DB] Deleted config: " << config_id << std::endl;
 
+        if (service_name) {
+            *service_name = r[0]["service_name"].as<std::string>();
+        }
+
+        // Drop the body if no other version or validation record shares it. Best effort: an
+        // upload reusing the blob key-share locks it in create_config_version, so this waits and
+        // then fails on the foreign key instead of pulling the blob from under the upload.
+        if (!r[0]["content_hash"].is_null()) {
+            try {
+                pqxx::work gc(*conn_);
+                gc.exec_params("DELETE FROM config_blobs b "
+                               "WHERE b.content_hash = $1 "
+                               "  AND NOT EXISTS (SELECT 1 FROM config_data d "
+                               "                  WHERE d.content_hash = b.content_hash) "
+                               "  AND NOT EXISTS (SELECT 1 FROM validation_history h "
+                               "                  WHERE h.content_hash = b.content_hash)",
+                               r[0]["content_hash"].as<std::string>());
+                gc.commit();
+            } catch (const std::exception& e) {
+                std::cerr << "[DB] Blob cleanup skipped: " << e.what() << std::endl;
+            }
+        }
+
         return {true, "Deleted successfully"};
 
     } catch (const std::exception& e) {
@@ -653,49 +1075,85 @@ configservice::ConfigMetadata DatabaseManager::ParseMetadataRow(const pqxx::row&
     return meta;
 }
 
+configservice::AuditEntry DatabaseManager::ParseAuditRow(const pqxx::row& row) {
+    configservice::AuditEntry entry;
+    entry.set_id(row["id"].as<int64_t>(0));
+    entry.set_config_id(row["config_id"].as<std::string>(""));
+    entry.set_action(row["action"].as<std::string>(""));
+    entry.set_performed_by(row["performed_by"].as<std::string>(""));
+    entry.set_service_name(row["service_name"].is_null() ? ""
+                                                         : row["service_name"].as<std::string>());
+    entry.set_details(row["detail_text"].is_null() ? "" : row["detail_text"].as<std::string>());
+    entry.set_created_at(row["created_at_unix"].as<int64_t>(0));
+    return entry;
+}
+
 std::vector<configservice::AuditEntry> DatabaseManager::GetAuditLog(const std::string& service_name,
-                                                                    int limit) {
+                                                                    int limit,
+                                                                    const std::string& page_token,
+                                                                    std::string& next_page_token) {
+    // Cursor is "<created_at as text>|<id>"; the full-precision timestamp text round-trips
+    // through ::timestamp exactly, unlike the epoch seconds returned to clients
+    std::string after_ts;
+    int64_t after_id = 0;
+    if (!page_token.empty()) {
+        std::string cursor = DecodePageToken("audit", page_token);
+        size_t sep = cursor.rfind('|');
+        if (sep == std::string::npos) {
+            throw std::invalid_argument("invalid page_token");
+        }
+        after_ts = cursor.substr(0, sep);
+        try {
+            after_id = std::stoll(cursor.substr(sep + 1));
+        } catch (const std::logic_error&) {
+            throw std::invalid_argument("invalid page_token");
+        }
+    }
+
+    if (limit <= 0) {
+        limit = 20;
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
 
     std::vector<configservice::AuditEntry> entries;
 
     try {
         pqxx::work txn(*conn_);
-        pqxx::result r;
 
-        if (!service_name.empty()) {
-            r = txn.exec_params("SELECT id, config_id, action, performed_by, "
-                                "       details->>'service_name' AS service_name, "
-                                "       details->>'details' AS detail_text, "
-                                "       EXTRACT(EPOCH FROM created_at)::bigint AS created_at_unix "
-                                "FROM audit_log "
-                                "WHERE details->>'service_name' = $1 "
-                                "ORDER BY created_at DESC LIMIT $2",
-                                service_name, limit > 0 ? limit : 20);
-        } else {
-            r = txn.exec_params("SELECT id, config_id, action, performed_by, "
-                                "       details->>'service_name' AS service_name, "
-                                "       details->>'details' AS detail_text, "
-                                "       EXTRACT(EPOCH FROM created_at)::bigint AS created_at_unix "
-                                "FROM audit_log "
-                                "ORDER BY created_at DESC LIMIT $1",
-                                limit > 0 ? limit : 20);
+        // Empty service_name / NULL cursor disable their predicates. exec_params plans with the
+        // bound values, so the dead branches fold away and each page is a range scan on
+        // idx_audit_created_at_id or idx_audit_service_created_at_id (migration 014).
+        std::optional<std::string> ts_param;
+        std::optional<int64_t> id_param;
+        if (!page_token.empty()) {
+            ts_param = after_ts;
+            id_param = after_id;
         }
 
+        pqxx::result r = txn.exec_params(
+            "SELECT id, config_id, action, performed_by, "
+            "       details->>'service_name' AS service_name, "
+            "       details->>'details' AS detail_text, "
+            "       EXTRACT(EPOCH FROM created_at)::bigint AS created_at_unix, "
+            "       created_at::text AS cursor_ts "
+            "FROM audit_log "
+            "WHERE ($1::text = '' OR details->>'service_name' = $1::text) "
+            "  AND ($2::timestamp IS NULL OR (created_at, id) < ($2::timestamp, $3::bigint)) "
+            "ORDER BY created_at DESC, id DESC LIMIT $4",
+            service_name, ts_param, id_param, limit + 1);
+
         txn.commit();
 
         for (const auto& row : r) {
-            configservice::AuditEntry entry;
-            entry.set_id(row["id"].as<int64_t>(0));
-            entry.set_config_id(row["config_id"].as<std::string>(""));
-            entry.set_action(row["action"].as<std::string>(""));
-            entry.set_performed_by(row["performed_by"].as<std::string>(""));
-            entry.set_service_name(
-                row["service_name"].is_null() ? "" : row["service_name"].as<std::string>());
-            entry.set_details(row["detail_text"].is_null() ? ""
-                                                           : row["detail_text"].as<std::string>());
-            entry.set_created_at(row["created_at_unix"].as<int64_t>(0));
-            entries.push_back(entry);
+            if (static_cast<int>(entries.size()) == limit) {
+                const auto& last = r[limit - 1];
+                next_page_token = EncodePageToken(
+                    "audit", last["cursor_ts"].as<std::string>() + "|" +
+                                 std::to_string(last["id"].as<int64_t>()));
+                break;
+            }
+            entries.push_back(ParseAuditRow(row));
         }
 
         return entries;
@@ -706,35 +1164,142 @@ std::vector<configservice::AuditEntry> DatabaseManager::GetAuditLog(const std::s
     }
 }
 
-configservice::KonfigStats DatabaseManager::GetStats() {
-    std::lock_guard<std::mutex> lock(mutex_);
+std::pair<bool, std::string> DatabaseManager::ExportAuditLog(
+    const std::string& service_name, int64_t since, int64_t until,
+    const std::function<bool(const std::vector<configservice::AuditEntry>&)>& on_chunk) {
+    try {
+        // Not conn_: the cursor lives as long as the stream, and holding the shared
+        // connection (and mutex_) that long would stall every other RPC
+        pqxx::connection conn(BuildConnectionString());
+        pqxx::work txn(conn);
 
-    configservice::KonfigStats stats;
+        // DECLARE takes no bind parameters, so values are quoted into the statement
+        std::string filter = TimeRangeFilter("created_at", since, until);
+        if (!service_name.empty()) {
+            filter += " AND details->>'service_name' = " + txn.quote(service_name);
+        }
+
+        txn.exec("DECLARE audit_export NO SCROLL CURSOR FOR "
+                 "SELECT id, config_id, action, performed_by, "
+                 "       details->>'service_name' AS service_name, "
+                 "       details->>'details' AS detail_text, "
+                 "       EXTRACT(EPOCH FROM created_at)::bigint AS created_at_unix "
+                 "FROM audit_log "
+                 "WHERE TRUE" +
+                 filter + " ORDER BY created_at, id");
+
+        const std::string fetch =
+            "FETCH " + std::to_string(kExportFetchRows) + " FROM audit_export";
+        std::vector<configservice::AuditEntry> chunk;
+        while (true) {
+            pqxx::result r = txn.exec(fetch);
+            if (r.empty()) {
+                break;
+            }
+
+            chunk.clear();
+            for (const auto& row : r) {
+                chunk.push_back(ParseAuditRow(row));
+            }
+            if (!on_chunk(chunk) || static_cast<int>(r.size()) < kExportFetchRows) {
+                break;
+            }
+        }
+
+        txn.commit();
+        return {true, ""};
 
+    } catch (const std::exception& e) {
+        std::cerr << "[DB] ExportAuditLog failed: " << e.what() << std::endl;
+        return {false, e.what()};
+    }
+}
+
+std::pair<bool, std::string> DatabaseManager::ExportConfigHistory(
+    const std::string& service_name, const std::string& config_name, int64_t since,
+    int64_t until, bool include_content,
+    const std::function<bool(const std::vector<configservice::ConfigHistoryEntry>&)>& on_chunk) {
     try {
-        pqxx::work txn(*conn_);
+        pqxx::connection conn(BuildConnectionString());
+        pqxx::work txn(conn);
 
-        // Total configs
-        auto r1 = txn.exec("SELECT COUNT(*) FROM config_metadata");
-        stats.set_total_configs(r1[0][0].as<int32_t>(0));
+        std::string filter = " AND m.service_name = " + txn.quote(service_name) +
+                             TimeRangeFilter("m.created_at", since, until);
+        if (!config_name.empty()) {
+            filter += " AND m.config_name = " + txn.quote(config_name);
+        }
 
-        // Total services
-        auto r2 = txn.exec("SELECT COUNT(DISTINCT service_name) FROM config_metadata");
-        stats.set_total_services(r2[0][0].as<int32_t>(0));
+        txn.exec(std::string("DECLARE history_export NO SCROLL CURSOR FOR "
+                             "SELECT m.config_id, m.service_name, m.config_name, m.version, "
+                             "       m.format, m.created_at, m.created_by, "
+                             "       COALESCE(m.description, '') AS description, m.is_active, "
+                             "       COALESCE(d.content_hash, '') AS content_hash, ") +
+                 (include_content ? "b.content " : "'' AS content ") +
+                 "FROM config_metadata m "
+                 "JOIN config_data d ON m.config_id = d.config_id " +
+                 (include_content ? "JOIN config_blobs b ON b.content_hash = d.content_hash "
+                                  : "") +
+                 "WHERE TRUE" + filter + " ORDER BY m.config_name, m.version");
+
+        const int fetch_rows = include_content ? kExportFetchRowsWithContent : kExportFetchRows;
+        const std::string fetch =
+            "FETCH " + std::to_string(fetch_rows) + " FROM history_export";
+        std::vector<configservice::ConfigHistoryEntry> chunk;
+        while (true) {
+            pqxx::result r = txn.exec(fetch);
+            if (r.empty()) {
+                break;
+            }
 
-        // Active rollouts (IN_PROGRESS or PENDING)
-        auto r3 = txn.exec(
-            "SELECT COUNT(*) FROM rollout_state WHERE status IN ('IN_PROGRESS', 'PENDING')");
-        stats.set_active_rollouts(r3[0][0].as<int32_t>(0));
+            chunk.clear();
+            for (const auto& row : r) {
+                configservice::ConfigHistoryEntry entry;
+                *entry.mutable_metadata() = ParseMetadataRow(row);
+                entry.set_content_hash(row["content_hash"].as<std::string>(""));
+                entry.set_content(row["content"].as<std::string>(""));
+                chunk.push_back(std::move(entry));
+            }
+            if (!on_chunk(chunk) || static_cast<int>(r.size()) < fetch_rows) {
+                break;
+            }
+        }
 
-        // Total schemas
-        auto r4 = txn.exec("SELECT COUNT(*) FROM validation_schemas WHERE is_active = true");
-        stats.set_total_schemas(r4[0][0].as<int32_t>(0));
+        txn.commit();
+        return {true, ""};
 
-        // Connected instances (heartbeat within last 120 seconds)
-        auto r5 = txn.exec("SELECT COUNT(*) FROM service_instances "
-                           "WHERE last_heartbeat > NOW() - INTERVAL '120 seconds'");
-        stats.set_connected_instances(r5[0][0].as<int32_t>(0));
+    } catch (const std::exception& e) {
+        std::cerr << "[DB] ExportConfigHistory failed: " << e.what() << std::endl;
+        return {false, e.what()};
+    }
+}
+
+configservice::KonfigStats DatabaseManager::GetStats() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    configservice::KonfigStats stats;
+
+    try {
+        pqxx::work txn(*conn_);
+
+        // Counts come from the trigger-maintained summaries (migration 015), so this is
+        // O(named configs) rather than a scan of every version and rollout ever created
+        pqxx::result r =
+            txn.exec("SELECT COALESCE(SUM(version_count), 0) AS total_configs, "
+                     "       COUNT(DISTINCT service_name) AS total_services, "
+                     "       COALESCE(SUM(active_rollouts), 0) AS active_rollouts, "
+                     "       (SELECT value FROM konfig_counters "
+                     "        WHERE name = 'active_schemas') AS total_schemas, "
+                     "       (SELECT COUNT(*) FROM service_instances "
+                     "        WHERE last_heartbeat > NOW() - INTERVAL '120 seconds') "
+                     "         AS connected_instances "
+                     "FROM named_config_summaries");
+
+        stats.set_total_configs(r[0]["total_configs"].as<int32_t>(0));
+        stats.set_total_services(r[0]["total_services"].as<int32_t>(0));
+        stats.set_active_rollouts(r[0]["active_rollouts"].as<int32_t>(0));
+        stats.set_total_schemas(r[0]["total_schemas"].as<int32_t>(0));
+        // Heartbeat within last 120 seconds
+        stats.set_connected_instances(r[0]["connected_instances"].as<int32_t>(0));
 
         txn.commit();
 
@@ -754,20 +1319,15 @@ std::vector<configservice::ServiceSummary> DatabaseManager::ListServices() {
     try {
         pqxx::work txn(*conn_);
 
-        pqxx::result r = txn.exec("SELECT "
-                                  "  cm.service_name, "
-                                  "  MAX(cm.version) AS latest_version, "
-                                  "  COUNT(DISTINCT cm.config_name) AS config_count, "
-                                  "  MAX(cm.created_at) AS latest_updated_at, "
-                                  "  EXISTS( "
-                                  "    SELECT 1 FROM rollout_state rs "
-                                  "    JOIN config_metadata cm2 ON cm2.config_id = rs.config_id "
-                                  "    WHERE cm2.service_name = cm.service_name "
-                                  "      AND rs.status IN ('IN_PROGRESS', 'PENDING') "
-                                  "  ) AS has_active_rollout "
-                                  "FROM config_metadata cm "
-                                  "GROUP BY cm.service_name "
-                                  "ORDER BY cm.service_name");
+        // One row per named config (migration 015), independent of version history
+        pqxx::result r = txn.exec("SELECT service_name, "
+                                  "       MAX(latest_version) AS latest_version, "
+                                  "       COUNT(*) AS config_count, "
+                                  "       MAX(latest_created_at) AS latest_updated_at, "
+                                  "       SUM(active_rollouts) > 0 AS has_active_rollout "
+                                  "FROM named_config_summaries "
+                                  "GROUP BY service_name "
+                                  "ORDER BY service_name");
 
         txn.commit();
 
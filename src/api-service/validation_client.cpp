@@ -1,11 +1,38 @@
 #include "api_service/validation_client.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace apiservice {
 
-ValidationClient::ValidationClient(const std::string& server_address)
-    : server_address_(server_address), initialized_(false) {}
+namespace {
+
+// State of one in-flight call; shared with the completion callback
+struct PendingValidation {
+    grpc::ClientContext context;
+    configservice::ValidateConfigRequest request;
+    configservice::ValidateConfigResponse response;
+    std::promise<configservice::ValidateConfigResponse> promise;
+    std::chrono::steady_clock::time_point started;
+};
+
+configservice::ValidateConfigResponse FailedResponse(const std::string& message) {
+    configservice::ValidateConfigResponse response;
+    response.set_valid(false);
+    response.set_message(message);
+    return response;
+}
+
+}  // anonymous namespace
+
+ValidationClient::ValidationClient(const std::string& server_address, int pool_size,
+                                   int timeout_ms, statsdclient::StatsDClient* statsd)
+    : server_address_(server_address),
+      pool_size_(static_cast<size_t>(std::max(1, pool_size))),
+      timeout_(timeout_ms),
+      statsd_(statsd),
+      next_stub_(0),
+      initialized_(false) {}
 
 ValidationClient::~ValidationClient() {
     Shutdown();
@@ -13,10 +40,21 @@ ValidationClient::~ValidationClient() {
 
 bool ValidationClient::Initialize() {
     try {
-        channel_ = grpc::CreateChannel(server_address_, grpc::InsecureChannelCredentials());
-        stub_ = configservice::ValidationService::NewStub(channel_);
-
-        std::cout << "[ValidationClient] Connected to " << server_address_ << std::endl;
+        for (size_t i = 0; i < pool_size_; ++i) {
+            // Distinct args plus a local subchannel pool give each channel its own connection
+            grpc::ChannelArguments args;
+            args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+            args.SetInt("konfig.validation_channel", static_cast<int>(i));
+
+            auto channel = grpc::CreateCustomChannel(server_address_,
+                                                     grpc::InsecureChannelCredentials(), args);
+            stubs_.push_back(configservice::ValidationService::NewStub(channel));
+            channels_.push_back(std::move(channel));
+        }
+
+        std::cout << "[ValidationClient] Connected to " << server_address_ << " ("
+                  << pool_size_ << " channels, timeout " << timeout_.count() << "ms)"
+                  << std::endl;
 
         initialized_ = true;
         return true;
@@ -28,42 +66,78 @@ bool ValidationClient::Initialize() {
 }
 
 void ValidationClient::Shutdown() {
-    channel_.reset();
-    stub_.reset();
+    stubs_.clear();
+    channels_.clear();
     initialized_ = false;
 }
 
-configservice::ValidateConfigResponse ValidationClient::ValidateConfig(
+std::future<configservice::ValidateConfigResponse> ValidationClient::ValidateConfigAsync(
     const std::string& service_name, const std::string& content, const std::string& format,
-    bool strict) {
-    configservice::ValidateConfigResponse response;
-
+    bool strict, Clock::time_point deadline, const std::string& base_content_hash) {
     if (!initialized_) {
-        response.set_valid(false);
-        response.set_message("Validation client not initialized");
-        return response;
+        std::promise<configservice::ValidateConfigResponse> failed;
+        failed.set_value(FailedResponse("Validation client not initialized"));
+        return failed.get_future();
     }
 
-    configservice::ValidateConfigRequest request;
-    request.set_service_name(service_name);
-    request.set_content(content);
-    request.set_format(format);
-    request.set_strict(strict);
-
-    grpc::ClientContext context;
-    std::chrono::system_clock::time_point deadline =
-        std::chrono::system_clock::now() + std::chrono::seconds(10);
-    context.set_deadline(deadline);
-
-    grpc::Status status = stub_->ValidateConfig(&context, request, &response);
-
-    if (!status.ok()) {
-        std::cerr << "[ValidationClient] gRPC error: " << status.error_message() << std::endl;
-        response.set_valid(false);
-        response.set_message("Validation service error: " + status.error_message());
+    auto now = Clock::now();
+    if (deadline <= now) {
+        if (statsd_ && statsd_->isConnected()) {
+            statsd_->increment("validation_client.deadline_already_passed");
+        }
+        std::promise<configservice::ValidateConfigResponse> failed;
+        failed.set_value(FailedResponse("Validation skipped: request deadline already passed"));
+        return failed.get_future();
     }
 
-    return response;
+    auto call = std::make_shared<PendingValidation>();
+    call->request.set_service_name(service_name);
+    call->request.set_content(content);
+    call->request.set_format(format);
+    call->request.set_strict(strict);
+    call->request.set_base_content_hash(base_content_hash);
+    call->context.set_deadline(std::min(deadline, now + timeout_));
+    call->started = std::chrono::steady_clock::now();
+
+    auto future = call->promise.get_future();
+    auto& stub = stubs_[next_stub_++ % stubs_.size()];
+
+    statsdclient::StatsDClient* statsd = statsd_;
+    stub->async()->ValidateConfig(
+        &call->context, &call->request, &call->response, [call, statsd](grpc::Status status) {
+            auto elapsed_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                                  std::chrono::steady_clock::now() - call->started)
+                                  .count();
+
+            const char* outcome = "ok";
+            if (!status.ok()) {
+                outcome = status.error_code() == grpc::StatusCode::DEADLINE_EXCEEDED
+                              ? "deadline_exceeded"
+                              : "error";
+                std::cerr << "[ValidationClient] gRPC error: " << status.error_message()
+                          << std::endl;
+                call->response.set_valid(false);
+                call->response.set_message("Validation service error: " +
+                                           status.error_message());
+            }
+
+            if (statsd && statsd->isConnected()) {
+                statsd->timing(std::string("validation_client.") + outcome + ".duration",
+                               static_cast<int>(elapsed_ms));
+            }
+
+            call->promise.set_value(std::move(call->response));
+        });
+
+    return future;
+}
+
+configservice::ValidateConfigResponse ValidationClient::ValidateConfig(
+    const std::string& service_name, const std::string& content, const std::string& format,
+    bool strict, Clock::time_point deadline, const std::string& base_content_hash) {
+    return ValidateConfigAsync(service_name, content, format, strict, deadline,
+                               base_content_hash)
+        .get();
 }
 
-}  // namespace apiservice
\ No newline at end of file
+}  // namespace apiservice
@@ -0,0 +1,117 @@
+#include "configclient/channel_registry.h"
+
+#include <grpc/compression.h>
+
+#include <iostream>
+#include <sstream>
+
+namespace configservice {
+
+// ---------------------------------------------------------------------------
+// Public API
+// ---------------------------------------------------------------------------
+
+ChannelRegistry& ChannelRegistry::Instance() {
+    static ChannelRegistry registry;
+    return registry;
+}
+
+std::shared_ptr<grpc::Channel> ChannelRegistry::GetChannel(const std::string& target,
+                                                           const ChannelOptions& options) {
+    std::string key = BuildKey(target, options);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = channels_.find(key);
+    if (it != channels_.end()) {
+        if (auto channel = it->second.lock()) {
+            return channel;
+        }
+    }
+
+    PruneExpired();
+
+    auto channel = grpc::CreateCustomChannel(target, grpc::InsecureChannelCredentials(),
+                                             BuildArguments(options));
+    channels_[key] = channel;
+
+    std::cout << "[ChannelRegistry] Created channel to " << target << " (" << channels_.size()
+              << " active)" << std::endl;
+    return channel;
+}
+
+size_t ChannelRegistry::ChannelCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PruneExpired();
+    return channels_.size();
+}
+
+size_t ChannelRegistry::OpenConnectionCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    PruneExpired();
+
+    size_t open = 0;
+    for (const auto& entry : channels_) {
+        auto channel = entry.second.lock();
+        // try_to_connect=false: only observe, never dial
+        if (channel && channel->GetState(false) == GRPC_CHANNEL_READY) {
+            open++;
+        }
+    }
+    return open;
+}
+
+// ---------------------------------------------------------------------------
+// Private helpers
+// ---------------------------------------------------------------------------
+
+void ChannelRegistry::PruneExpired() {
+    for (auto it = channels_.begin(); it != channels_.end();) {
+        if (it->second.expired()) {
+            it = channels_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+std::string ChannelRegistry::BuildKey(const std::string& target, const ChannelOptions& options) {
+    std::ostringstream oss;
+    oss << target << "|" << options.keepalive_time_ms << "|" << options.keepalive_timeout_ms << "|"
+        << options.keepalive_permit_without_calls << "|" << options.max_receive_message_size
+        << "|" << options.max_send_message_size << "|" << options.compression;
+    return oss.str();
+}
+
+grpc::ChannelArguments ChannelRegistry::BuildArguments(const ChannelOptions& options) {
+    grpc::ChannelArguments args;
+
+    if (options.keepalive_time_ms > 0) {
+        args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, options.keepalive_time_ms);
+    }
+    if (options.keepalive_timeout_ms > 0) {
+        args.SetInt(GRPC_ARG_KEEPALIVE_TIMEOUT_MS, options.keepalive_timeout_ms);
+    }
+    if (options.keepalive_permit_without_calls) {
+        args.SetInt(GRPC_ARG_KEEPALIVE_PERMIT_WITHOUT_CALLS, 1);
+    }
+    if (options.max_receive_message_size > 0) {
+        args.SetMaxReceiveMessageSize(options.max_receive_message_size);
+    }
+    if (options.max_send_message_size > 0) {
+        args.SetMaxSendMessageSize(options.max_send_message_size);
+    }
+
+    if (options.compression == "gzip") {
+        args.SetCompressionAlgorithm(GRPC_COMPRESS_GZIP);
+    } else if (options.compression == "deflate") {
+        args.SetCompressionAlgorithm(GRPC_COMPRESS_DEFLATE);
+    } else if (!options.compression.empty()) {
+        std::cerr << "[ChannelRegistry] ⚠ Unknown compression '" << options.compression
+                  << "' — sending uncompressed" << std::endl;
+    }
+
+    return args;
+}
+
+}  // namespace configservice
@@ -23,12 +23,13 @@ std::string GenerateInstanceId() {
 
 ConfigClient::ConfigClient(const std::string& server_address, const std::string& service_name,
                            const std::string& instance_id, const std::string& cache_dir,
-                           int heartbeat_interval_seconds, int max_heartbeat_failures)
+                           int heartbeat_interval_seconds, int max_heartbeat_failures,
+                           const ChannelOptions& channel_options)
     : server_address_(server_address), service_name_(service_name),
       instance_id_(instance_id.empty() ? GenerateInstanceId() : instance_id) {
-    impl_ =
-        std::make_unique<ConfigClientImpl>(server_address_, service_name_, instance_id_, cache_dir,
-                                           heartbeat_interval_seconds, max_heartbeat_failures);
+    impl_ = std::make_unique<ConfigClientImpl>(server_address_, service_name_, instance_id_,
+                                               cache_dir, heartbeat_interval_seconds,
+                                               max_heartbeat_failures, channel_options);
 }
 
 ConfigClient::~ConfigClient() {
@@ -39,6 +40,10 @@ bool ConfigClient::Start() {
     return impl_->Start();
 }
 
+bool ConfigClient::StartAndWait(std::chrono::milliseconds timeout) {
+    return impl_->StartAndWait(timeout);
+}
+
 void ConfigClient::Stop() {
     impl_->Stop();
 }
@@ -51,6 +56,11 @@ void ConfigClient::OnConfigUpdate(ConfigUpdateCallback callback) {
     impl_->OnConfigUpdate(callback);
 }
 
+void ConfigClient::Subscribe(const std::string& service_name, const std::string& config_name,
+                             ConfigUpdateCallback callback) {
+    impl_->Subscribe(service_name, config_name, callback);
+}
+
 void ConfigClient::OnConnectionStatus(ConnectionStatusCallback callback) {
     impl_->OnConnectionStatus(callback);
 }
@@ -63,4 +73,30 @@ int64_t ConfigClient::GetCurrentVersion() const {
     return impl_->GetCurrentVersion();
 }
 
+ConfigData ConfigClient::GetConfig(const std::string& service_name,
+                                   const std::string& config_name) const {
+    return impl_->GetConfig(service_name, config_name);
+}
+
+int64_t ConfigClient::GetVersion(const std::string& service_name,
+                                 const std::string& config_name) const {
+    return impl_->GetVersion(service_name, config_name);
+}
+
+int64_t ConfigClient::GetTimeToFirstConfigMs() const {
+    return impl_->GetTimeToFirstConfigMs();
+}
+
+int64_t ConfigClient::GetTimeToSyncMs() const {
+    return impl_->GetTimeToSyncMs();
+}
+
+void ConfigClient::EnableMetrics(const std::string& statsd_host, int statsd_port) {
+    impl_->EnableMetrics(statsd_host, statsd_port);
+}
+
+size_t ConfigClient::OpenConnectionCount() {
+    return ChannelRegistry::Instance().OpenConnectionCount();
+}
+
 }  // namespace configservice
\ No newline at end of file
@@ -2,19 +2,25 @@
 
 #include <chrono>
 #include <iostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace configservice {
 
 ConfigClientImpl::ConfigClientImpl(const std::string& server_address,
                                    const std::string& service_name, const std::string& instance_id,
                                    const std::string& cache_dir, int heartbeat_interval_seconds,
-                                   int max_heartbeat_failures)
+                                   int max_heartbeat_failures,
+                                   const ChannelOptions& channel_options)
     : server_address_(server_address), service_name_(service_name), instance_id_(instance_id),
-      current_version_(0), running_(false), connected_(false),
+      stream_open_(false), current_version_(0), first_config_ms_(-1), sync_ms_(-1),
+      synced_(false), running_(false), connected_(false),
       heartbeat_interval_seconds_(heartbeat_interval_seconds),
       max_heartbeat_failures_(max_heartbeat_failures) {
-    // Create gRPC channel
-    channel_ = grpc::CreateChannel(server_address_, grpc::InsecureChannelCredentials());
+    // Reuse the process-wide channel for this address (one HTTP/2 connection per endpoint)
+    channel_ = ChannelRegistry::Instance().GetChannel(server_address_, channel_options);
     stub_ = DistributionService::NewStub(channel_);
 
     // Initialise disk cache
@@ -36,16 +42,38 @@ bool ConfigClientImpl::Start() {
     std::cout << "[ConfigClient] Starting client..." << std::endl;
     running_ = true;
 
-    // Load cached config from disk before connecting — gives app an immediate value
+    start_time_ = std::chrono::steady_clock::now();
+    first_config_ms_ = -1;
+    sync_ms_ = -1;
     {
-        ConfigData cached;
-        if (disk_cache_->Load(service_name_, cached)) {
-            std::lock_guard<std::mutex> lock(config_mutex_);
-            current_config_ = cached;
-            current_version_ = cached.version();
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        synced_ = false;
+    }
+
+    // Begin the TCP/HTTP2 handshake now so it overlaps with the disk-cache load below
+    channel_->GetState(/*try_to_connect=*/true);
+
+    // Load cached configs from disk before subscribing — gives app an immediate value
+    // and lets the server skip re-sending versions we already hold
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+
+        // No explicit subscriptions: follow every config of our own service
+        if (subscriptions_.empty()) {
+            Subscription sub;
+            sub.service_name = service_name_;
+            subscriptions_[SubscriptionKey(service_name_, "")] = sub;
+        }
+
+        for (auto& entry : subscriptions_) {
+            LoadCachedSubscription(entry.second);
         }
     }
 
+    if (GetCurrentVersion() > 0) {
+        MarkFirstConfig();
+    }
+
     // Start stream thread
     stream_thread_ = std::make_unique<std::thread>(&ConfigClientImpl::StreamLoop, this);
 
@@ -55,6 +83,34 @@ bool ConfigClientImpl::Start() {
     return true;
 }
 
+bool ConfigClientImpl::StartAndWait(std::chrono::milliseconds timeout) {
+    if (!Start()) {
+        return false;
+    }
+
+    bool synced;
+    {
+        std::unique_lock<std::mutex> lock(sync_mutex_);
+        synced = sync_cv_.wait_for(lock, timeout, [this] { return synced_ || !running_; }) &&
+                 synced_;
+    }
+
+    if (synced) {
+        std::cout << "[ConfigClient] ✓ Config is current (v" << GetCurrentVersion() << ") after "
+                  << sync_ms_.load() << " ms" << std::endl;
+        return true;
+    }
+
+    int64_t version = GetCurrentVersion();
+    std::cerr << "[ConfigClient] ⚠ No server confirmation within " << timeout.count() << " ms — "
+              << (version > 0 ? "serving cached v" + std::to_string(version) : "no config yet")
+              << std::endl;
+    if (statsd_) {
+        statsd_->increment(service_name_ + ".startup_cache_fallback");
+    }
+    return false;
+}
+
 void ConfigClientImpl::Stop() {
     if (!running_) {
         return;
@@ -63,6 +119,12 @@ void ConfigClientImpl::Stop() {
     std::cout << "[ConfigClient] Stopping client..." << std::endl;
     running_ = false;
 
+    // Release StartAndWait()
+    {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+    }
+    sync_cv_.notify_all();
+
     // Cancel gRPC context
     if (context_) {
         context_->TryCancel();
@@ -98,6 +160,46 @@ void ConfigClientImpl::OnConnectionStatus(ConnectionStatusCallback callback) {
     connection_callback_ = callback;
 }
 
+void ConfigClientImpl::Subscribe(const std::string& service_name, const std::string& config_name,
+                                 ConfigUpdateCallback callback) {
+    std::lock_guard<std::mutex> stream_lock(stream_mutex_);
+
+    SubscribeRequest request;
+    {
+        std::lock_guard<std::mutex> lock(config_mutex_);
+        std::string key = SubscriptionKey(service_name, config_name);
+
+        auto it = subscriptions_.find(key);
+        if (it != subscriptions_.end()) {
+            // Already subscribed — just swap the callback
+            it->second.callback = callback;
+            return;
+        }
+
+        Subscription& sub = subscriptions_[key];
+        sub.service_name = service_name;
+        sub.config_name = config_name;
+        sub.callback = callback;
+
+        if (running_) {
+            LoadCachedSubscription(sub);
+        }
+
+        request.set_service_name(service_name_);
+        request.set_instance_id(instance_id_);
+        FillSubscription(sub, request.add_subscriptions());
+    }
+
+    std::cout << "[ConfigClient] Subscribed to " << service_name << "/"
+              << (config_name.empty() ? "*" : config_name) << std::endl;
+
+    // Not connected yet: the subscription goes out with the initial request
+    if (stream_open_ && !stream_->Write(request)) {
+        std::cerr << "[ConfigClient] Failed to send subscription for " << service_name << "/"
+                  << config_name << std::endl;
+    }
+}
+
 ConfigData ConfigClientImpl::GetCurrentConfig() const {
     std::lock_guard<std::mutex> lock(config_mutex_);
     return current_config_;
@@ -108,6 +210,25 @@ int64_t ConfigClientImpl::GetCurrentVersion() const {
     return current_version_;
 }
 
+ConfigData ConfigClientImpl::GetConfig(const std::string& service_name,
+                                       const std::string& config_name) const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    const ConfigData* config = FindConfig(service_name, config_name);
+    return config ? *config : ConfigData();
+}
+
+int64_t ConfigClientImpl::GetVersion(const std::string& service_name,
+                                     const std::string& config_name) const {
+    std::lock_guard<std::mutex> lock(config_mutex_);
+    const ConfigData* config = FindConfig(service_name, config_name);
+    return config ? config->version() : 0;
+}
+
+void ConfigClientImpl::EnableMetrics(const std::string& statsd_host, int statsd_port) {
+    statsd_ = std::make_unique<statsdclient::StatsDClient>(statsd_host, statsd_port,
+                                                           "konfig.client.");
+}
+
 void ConfigClientImpl::StreamLoop() {
     while (running_) {
         try {
@@ -147,12 +268,18 @@ void ConfigClientImpl::HeartbeatLoop() {
             continue;
         }
 
+        // Report the version held per subscription (per named config for whole-service ones)
         SubscribeRequest heartbeat;
         heartbeat.set_service_name(service_name_);
         heartbeat.set_instance_id(instance_id_);
-        heartbeat.set_current_version(GetCurrentVersion());
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            for (const auto& entry : subscriptions_) {
+                FillSubscription(entry.second, heartbeat.add_held_versions());
+            }
+        }
 
-        if (stream_ && stream_->Write(heartbeat)) {
+        if (WriteRequest(heartbeat)) {
             consecutive_failures = 0;
         } else {
             consecutive_failures++;
@@ -172,28 +299,38 @@ void ConfigClientImpl::HeartbeatLoop() {
 }
 
 void ConfigClientImpl::ConnectAndSubscribe() {
-    // Create new context
-    context_ = std::make_unique<grpc::ClientContext>();
+    {
+        std::lock_guard<std::mutex> stream_lock(stream_mutex_);
 
-    // Create bidirectional stream
-    stream_ = stub_->Subscribe(context_.get());
+        // Create new context
+        context_ = std::make_unique<grpc::ClientContext>();
 
-    if (!stream_) {
-        std::cerr << "[ConfigClient] Failed to create stream" << std::endl;
-        SetConnectionStatus(false);
-        return;
-    }
+        // Create bidirectional stream
+        stream_ = stub_->Subscribe(context_.get());
 
-    // Send subscribe request
-    SubscribeRequest request;
-    request.set_service_name(service_name_);
-    request.set_instance_id(instance_id_);
-    request.set_current_version(GetCurrentVersion());
+        if (!stream_) {
+            std::cerr << "[ConfigClient] Failed to create stream" << std::endl;
+            SetConnectionStatus(false);
+            return;
+        }
 
-    if (!stream_->Write(request)) {
-        std::cerr << "[ConfigClient] Failed to send subscribe request" << std::endl;
-        SetConnectionStatus(false);
-        return;
+        // Send subscribe request carrying every subscription and the versions we hold
+        SubscribeRequest request;
+        request.set_service_name(service_name_);
+        request.set_instance_id(instance_id_);
+        {
+            std::lock_guard<std::mutex> lock(config_mutex_);
+            for (const auto& entry : subscriptions_) {
+                FillSubscription(entry.second, request.add_subscriptions());
+            }
+        }
+
+        if (!stream_->Write(request)) {
+            std::cerr << "[ConfigClient] Failed to send subscribe request" << std::endl;
+            SetConnectionStatus(false);
+            return;
+        }
+        stream_open_ = true;
     }
 
     SetConnectionStatus(true);
@@ -206,6 +343,10 @@ void ConfigClientImpl::ConnectAndSubscribe() {
     }
 
     // Connection lost
+    {
+        std::lock_guard<std::mutex> stream_lock(stream_mutex_);
+        stream_open_ = false;
+    }
     SetConnectionStatus(false);
 
     grpc::Status status = stream_->Finish();
@@ -215,25 +356,50 @@ void ConfigClientImpl::ConnectAndSubscribe() {
 }
 
 void ConfigClientImpl::HandleConfigUpdate(const ConfigUpdate& update) {
+    if (update.update_type() == INITIAL_SYNC_COMPLETE) {
+        MarkSynced();
+        return;
+    }
+
     if (!update.has_config()) {
         return;
     }
 
     const ConfigData& config = update.config();
 
-    std::cout << "[ConfigClient] Received config update v" << config.version() << std::endl;
+    std::cout << "[ConfigClient] Received config update " << config.service_name() << "/"
+              << config.config_name() << " v" << config.version() << std::endl;
 
-    // Update current config
+    // Update current config and every subscription the update belongs to
+    std::set<std::string> cache_names;
+    std::vector<ConfigUpdateCallback> callbacks;
     {
         std::lock_guard<std::mutex> lock(config_mutex_);
         current_config_ = config;
         current_version_ = config.version();
+
+        for (auto& entry : subscriptions_) {
+            Subscription& sub = entry.second;
+            if (!Matches(sub, config)) {
+                continue;
+            }
+            StoreConfig(sub, config);
+            // Cache slots are per named config, whole-service subscriptions included
+            cache_names.insert(sub.config_name.empty() ? config.config_name() : sub.config_name);
+            if (sub.callback) {
+                callbacks.push_back(sub.callback);
+            }
+        }
     }
 
+    MarkFirstConfig();
+
     // Persist to disk cache
-    disk_cache_->Save(config);
+    for (const auto& name : cache_names) {
+        disk_cache_->Save(config, name);
+    }
 
-    // Trigger callback
+    // Trigger callbacks
     {
         std::lock_guard<std::mutex> lock(callback_mutex_);
         if (config_callback_) {
@@ -243,6 +409,14 @@ void ConfigClientImpl::HandleConfigUpdate(const ConfigUpdate& update) {
                 std::cerr << "[ConfigClient] Callback error: " << e.what() << std::endl;
             }
         }
+        for (const auto& callback : callbacks) {
+            try {
+                callback(config);
+            } catch (const std::exception& e) {
+                std::cerr << "[ConfigClient] Subscription callback error: " << e.what()
+                          << std::endl;
+            }
+        }
     }
 }
 
@@ -264,4 +438,128 @@ void ConfigClientImpl::SetConnectionStatus(bool connected) {
     }
 }
 
+void ConfigClientImpl::MarkFirstConfig() {
+    int64_t unset = -1;
+    int64_t elapsed = MillisSinceStart();
+    if (first_config_ms_.compare_exchange_strong(unset, elapsed)) {
+        std::cout << "[ConfigClient] Time to first config: " << elapsed << " ms" << std::endl;
+        if (statsd_) {
+            statsd_->timing(service_name_ + ".time_to_first_config", static_cast<int>(elapsed));
+        }
+    }
+}
+
+void ConfigClientImpl::MarkSynced() {
+    int64_t unset = -1;
+    int64_t elapsed = MillisSinceStart();
+    if (!sync_ms_.compare_exchange_strong(unset, elapsed)) {
+        return;  // Reconnects confirm again; only the first one counts
+    }
+
+    // A server that has nothing newer confirms the cached config is current
+    if (GetCurrentVersion() > 0) {
+        MarkFirstConfig();
+    }
+    if (statsd_) {
+        statsd_->timing(service_name_ + ".time_to_sync", static_cast<int>(elapsed));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sync_mutex_);
+        synced_ = true;
+    }
+    sync_cv_.notify_all();
+}
+
+int64_t ConfigClientImpl::MillisSinceStart() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                 start_time_)
+        .count();
+}
+
+bool ConfigClientImpl::WriteRequest(const SubscribeRequest& request) {
+    std::lock_guard<std::mutex> stream_lock(stream_mutex_);
+    return stream_open_ && stream_->Write(request);
+}
+
+void ConfigClientImpl::LoadCachedSubscription(Subscription& sub) {
+    // A whole-service subscription has one cache slot per named config; load the most
+    // recently saved one last so it becomes the subscription's latest
+    std::vector<std::string> names = {sub.config_name};
+    if (sub.config_name.empty()) {
+        names = disk_cache_->ListConfigNames(sub.service_name);
+    }
+
+    for (auto name = names.rbegin(); name != names.rend(); ++name) {
+        // View() has checked content_hash; the content is copied out of the mapping once
+        CachedConfigView view;
+        if (!disk_cache_->View(sub.service_name, view, *name)) {
+            continue;
+        }
+        ConfigData config = std::move(view.metadata);
+        config.set_content(view.content.data(), view.content.size());
+
+        if (config.version() > current_version_) {
+            current_config_ = config;
+            current_version_ = config.version();
+        }
+        StoreConfig(sub, std::move(config));
+    }
+}
+
+void ConfigClientImpl::StoreConfig(Subscription& sub, ConfigData config) {
+    if (sub.config_name.empty()) {
+        sub.last_config_name = config.config_name();
+        sub.configs[sub.last_config_name] = std::move(config);
+        return;
+    }
+    sub.version = config.version();
+    sub.config = std::move(config);
+}
+
+const ConfigData* ConfigClientImpl::FindConfig(const std::string& service_name,
+                                               const std::string& config_name) const {
+    auto it = subscriptions_.find(SubscriptionKey(service_name, config_name));
+    if (it != subscriptions_.end() && !config_name.empty()) {
+        return &it->second.config;
+    }
+
+    // Whole-service subscription: the named config, or the one updated last
+    if (it == subscriptions_.end()) {
+        it = subscriptions_.find(SubscriptionKey(service_name, ""));
+        if (it == subscriptions_.end() || config_name.empty()) {
+            return nullptr;
+        }
+    }
+    const Subscription& sub = it->second;
+    auto config = sub.configs.find(config_name.empty() ? sub.last_config_name : config_name);
+    return config != sub.configs.end() ? &config->second : nullptr;
+}
+
+void ConfigClientImpl::FillSubscription(const Subscription& sub, ConfigSubscription* out) {
+    out->set_service_name(sub.service_name);
+    out->set_config_name(sub.config_name);
+    if (!sub.config_name.empty()) {
+        out->set_current_version(sub.version);
+        return;
+    }
+    for (const auto& [config_name, config] : sub.configs) {
+        (*out->mutable_config_versions())[config_name] = config.version();
+    }
+}
+
+std::string ConfigClientImpl::SubscriptionKey(const std::string& service_name,
+                                              const std::string& config_name) {
+    return service_name + "/" + config_name;
+}
+
+bool ConfigClientImpl::Matches(const Subscription& sub, const ConfigData& config) {
+    if (sub.service_name != config.service_name()) {
+        return false;
+    }
+    // Older servers do not fill config_name; route by service alone in that case
+    return sub.config_name.empty() || config.config_name().empty() ||
+           sub.config_name == config.config_name();
+}
+
 }  // namespace configservice
\ No newline at end of file
@@ -1,24 +1,197 @@
 #include "configclient/disk_cache.h"
+#include "contenthash/content_hash.h"
 
+#include <algorithm>
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
-#include <fstream>
-#include <iomanip>
+#include <cstring>
+#include <fcntl.h>
+#include <set>
 #include <iostream>
-#include <sstream>
+#include <sys/file.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
-
-// SHA-256 via OpenSSL (already a transitive dependency of gRPC)
-#include <openssl/sha.h>
+#include <unistd.h>
+#include <vector>
 
 namespace configservice {
 
+namespace {
+
+// ---------------------------------------------------------------------------
+// On-disk format
+// ---------------------------------------------------------------------------
+
+constexpr char kMagic[8] = {'K', 'O', 'N', 'F', 'C', 'A', 'C', '1'};
+constexpr uint32_t kFormatVersion = 1;
+// Index slots per file: the minimum, grown by compaction when live entries need more
+constexpr uint32_t kMinIndexCapacity = 64;
+constexpr uint32_t kMaxIndexCapacity = 64 * 1024;
+constexpr size_t kNameSize = 96;
+constexpr uint32_t kEntryLive = 1;
+
+// Compact once this many bytes are dead and they outweigh the live bytes
+constexpr uint64_t kCompactDeadBytes = 4 * 1024 * 1024;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t format_version;
+    uint32_t index_capacity;
+    uint64_t entry_count;  // committed index entries
+    uint64_t data_end;     // committed end of the record region
+    uint64_t reserved[4];
+};
+static_assert(sizeof(FileHeader) == 64, "FileHeader must stay 64 bytes");
+
+struct IndexEntry {
+    char service_name[kNameSize];
+    char config_name[kNameSize];
+    int64_t version;
+    uint64_t record_offset;
+    uint64_t meta_length;
+    uint64_t content_length;
+    uint32_t flags;
+    uint32_t meta_checksum;  // FNV-1a of the metadata bytes
+    uint64_t reserved[3];
+};
+static_assert(sizeof(IndexEntry) == 256, "IndexEntry must stay 256 bytes");
+
+// Records start after the index
+uint64_t DataStart(uint32_t index_capacity) {
+    return sizeof(FileHeader) + uint64_t(index_capacity) * sizeof(IndexEntry);
+}
+
+// Room for twice the live entries, so compaction is not needed again right away
+uint32_t IndexCapacityFor(uint64_t live_entries) {
+    uint32_t capacity = kMinIndexCapacity;
+    while (capacity < 2 * live_entries && capacity < kMaxIndexCapacity) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+uint32_t Fnv1a(const char* data, size_t len) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+bool NameEquals(const char (&field)[kNameSize], const std::string& name) {
+    return name.size() < kNameSize && std::strncmp(field, name.c_str(), kNameSize) == 0;
+}
+
+void CopyName(char (&field)[kNameSize], const std::string& name) {
+    std::memset(field, 0, kNameSize);
+    std::memcpy(field, name.data(), std::min(name.size(), kNameSize - 1));
+}
+
+bool WriteAll(int fd, const void* data, size_t len, uint64_t offset) {
+    const char* p = static_cast<const char*>(data);
+    while (len > 0) {
+        ssize_t n = pwrite(fd, p, len, static_cast<off_t>(offset));
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool ReadAll(int fd, void* data, size_t len, uint64_t offset) {
+    char* p = static_cast<char*>(data);
+    while (len > 0) {
+        ssize_t n = pread(fd, p, len, static_cast<off_t>(offset));
+        if (n <= 0) {
+            if (n < 0 && errno == EINTR)
+                continue;
+            return false;
+        }
+        p += n;
+        len -= static_cast<size_t>(n);
+        offset += static_cast<uint64_t>(n);
+    }
+    return true;
+}
+
+bool ValidHeader(const FileHeader& header) {
+    return std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 &&
+           header.format_version == kFormatVersion &&
+           header.index_capacity >= kMinIndexCapacity &&
+           header.index_capacity <= kMaxIndexCapacity &&
+           header.entry_count <= header.index_capacity &&
+           header.data_end >= DataStart(header.index_capacity);
+}
+
+FileHeader EmptyHeader(uint32_t index_capacity = kMinIndexCapacity) {
+    FileHeader header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.format_version = kFormatVersion;
+    header.index_capacity = index_capacity;
+    header.entry_count = 0;
+    header.data_end = DataStart(index_capacity);
+    return header;
+}
+
+// Exclusive advisory lock on {cache file}.lock, shared by every writer process
+class FileLock {
+   public:
+    explicit FileLock(const std::string& path)
+        : fd_(open((path + ".lock").c_str(), O_CREAT | O_RDWR, 0644)) {
+        if (fd_ >= 0 && flock(fd_, LOCK_EX) != 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+    }
+    ~FileLock() {
+        if (fd_ >= 0) {
+            flock(fd_, LOCK_UN);
+            close(fd_);
+        }
+    }
+    bool locked() const { return fd_ >= 0; }
+
+   private:
+    int fd_;
+};
+
+}  // anonymous namespace
+
+// Read-only mapping of one cache file
+struct DiskCache::Mapping {
+    const char* base = nullptr;
+    size_t size = 0;
+    dev_t device = 0;
+    ino_t inode = 0;
+
+    // Entries (record offset, metadata checksum) whose content matched content_hash. Records
+    // are never rewritten in place, so this carries over when an append remaps the file.
+    std::mutex mutex;
+    std::set<std::pair<uint64_t, uint32_t>> verified;
+
+    ~Mapping() {
+        if (base) {
+            munmap(const_cast<char*>(base), size);
+        }
+    }
+};
+
 // ---------------------------------------------------------------------------
 // Construction
 // ---------------------------------------------------------------------------
 
-DiskCache::DiskCache(const std::string& cache_dir)
-    : cache_dir_(cache_dir.empty() ? ResolveDefaultCacheDir() : cache_dir) {}
+DiskCache::DiskCache(const std::string& cache_dir, int max_versions)
+    : cache_dir_(cache_dir.empty() ? ResolveDefaultCacheDir() : cache_dir),
+      max_versions_(std::max(1, max_versions)) {}
+
+DiskCache::~DiskCache() = default;
 
 std::string DiskCache::ResolveDefaultCacheDir() {
     const char* home = std::getenv("HOME");
@@ -40,87 +213,399 @@ std::string DiskCache::GetCachePath(const std::string& service_name) const {
         if (c == '/' || c == '\\')
             c = '_';
     }
-    return cache_dir_ + "/" + safe + ".cache";
+    return cache_dir_ + "/" + safe + ".kcache";
 }
 
-bool DiskCache::Exists(const std::string& service_name) const {
-    struct stat st = {};
-    return stat(GetCachePath(service_name).c_str(), &st) == 0;
+bool DiskCache::Exists(const std::string& service_name, const std::string& config_name) {
+    CachedConfigView view;
+    return View(service_name, view, config_name);
 }
 
-bool DiskCache::Save(const ConfigData& config) {
+bool DiskCache::Save(const ConfigData& config, const std::string& config_name) {
     if (!EnsureCacheDir()) {
         std::cerr << "[DiskCache] Cannot create cache directory: " << cache_dir_ << std::endl;
         return false;
     }
 
-    std::string data;
-    if (!config.SerializeToString(&data)) {
-        std::cerr << "[DiskCache] Serialization failed for " << config.service_name() << std::endl;
+    const std::string& service_name = config.service_name();
+    if (service_name.size() >= kNameSize || config_name.size() >= kNameSize) {
+        std::cerr << "[DiskCache] Name too long for cache index: " << service_name << "/"
+                  << config_name << std::endl;
         return false;
     }
 
-    std::string path = GetCachePath(config.service_name());
-    std::string tmp_path = path + ".tmp";
+    // Record = metadata (ConfigData without content) + raw content
+    ConfigData metadata = config;
+    metadata.clear_content();
+    std::string meta;
+    if (!metadata.SerializeToString(&meta)) {
+        std::cerr << "[DiskCache] Serialization failed for " << service_name << std::endl;
+        return false;
+    }
 
-    // Write to temp file first
-    {
-        std::ofstream f(tmp_path, std::ios::binary | std::ios::trunc);
-        if (!f) {
-            std::cerr << "[DiskCache] Cannot write to " << tmp_path << std::endl;
+    std::string path = GetCachePath(service_name);
+    FileLock lock(path);
+    if (!lock.locked()) {
+        std::cerr << "[DiskCache] Cannot lock " << path << std::endl;
+        return false;
+    }
+
+    int fd = open(path.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "[DiskCache] Cannot open " << path << ": " << std::strerror(errno)
+                  << std::endl;
+        return false;
+    }
+
+    FileHeader header = {};
+    if (!ReadAll(fd, &header, sizeof(header), 0) || !ValidHeader(header)) {
+        // New or unrecognised file: start a fresh, empty cache
+        header = EmptyHeader();
+        if (ftruncate(fd, static_cast<off_t>(DataStart(header.index_capacity))) != 0 ||
+            !WriteAll(fd, &header, sizeof(header), 0)) {
+            std::cerr << "[DiskCache] Cannot initialise " << path << std::endl;
+            close(fd);
             return false;
         }
-        f.write(data.data(), static_cast<std::streamsize>(data.size()));
     }
 
-    // Atomic rename
-    if (std::rename(tmp_path.c_str(), path.c_str()) != 0) {
-        std::cerr << "[DiskCache] Rename failed: " << tmp_path << " -> " << path << std::endl;
-        std::remove(tmp_path.c_str());
+    // Index full: drop dead entries first, growing the index if the live ones need it
+    if (header.entry_count >= header.index_capacity) {
+        close(fd);
+        if (!Compact(path)) {
+            return false;
+        }
+        fd = open(path.c_str(), O_RDWR);
+        if (fd < 0 || !ReadAll(fd, &header, sizeof(header), 0) || !ValidHeader(header) ||
+            header.entry_count >= header.index_capacity) {
+            std::cerr << "[DiskCache] Cache index full: " << path << std::endl;
+            if (fd >= 0)
+                close(fd);
+            return false;
+        }
+    }
+
+    // 1. Append the record and its index entry past the committed end (invisible to readers)
+    uint64_t offset = header.data_end;
+    IndexEntry entry = {};
+    CopyName(entry.service_name, service_name);
+    CopyName(entry.config_name, config_name);
+    entry.version = config.version();
+    entry.record_offset = offset;
+    entry.meta_length = meta.size();
+    entry.content_length = config.content().size();
+    entry.flags = kEntryLive;
+    entry.meta_checksum = Fnv1a(meta.data(), meta.size());
+
+    uint64_t slot = header.entry_count;
+    bool ok = WriteAll(fd, meta.data(), meta.size(), offset) &&
+              WriteAll(fd, config.content().data(), config.content().size(),
+                       offset + meta.size()) &&
+              WriteAll(fd, &entry, sizeof(entry), sizeof(FileHeader) + slot * sizeof(IndexEntry)) &&
+              fdatasync(fd) == 0;
+
+    // 2. Commit: advance entry_count and data_end in the header
+    if (ok) {
+        header.entry_count = slot + 1;
+        header.data_end = offset + meta.size() + config.content().size();
+        ok = WriteAll(fd, &header, sizeof(header), 0) && fdatasync(fd) == 0;
+    }
+
+    if (!ok) {
+        std::cerr << "[DiskCache] Write failed for " << path << ": " << std::strerror(errno)
+                  << std::endl;
+        close(fd);
         return false;
     }
 
-    std::cout << "[DiskCache] Saved config v" << config.version() << " for "
-              << config.service_name() << " -> " << path << std::endl;
+    // 3. Retire versions beyond max_versions_ (after commit, so a crash never loses the key)
+    std::vector<IndexEntry> index(header.entry_count);
+    uint64_t live_bytes = 0;
+    uint64_t dead_bytes = 0;
+    if (ReadAll(fd, index.data(), index.size() * sizeof(IndexEntry), sizeof(FileHeader))) {
+        int kept = 0;
+        for (size_t i = index.size(); i-- > 0;) {
+            IndexEntry& e = index[i];
+            uint64_t bytes = e.meta_length + e.content_length;
+            if ((e.flags & kEntryLive) && NameEquals(e.service_name, service_name) &&
+                NameEquals(e.config_name, config_name) && ++kept > max_versions_) {
+                e.flags &= ~kEntryLive;
+                WriteAll(fd, &e, sizeof(e), sizeof(FileHeader) + i * sizeof(IndexEntry));
+            }
+            ((e.flags & kEntryLive) ? live_bytes : dead_bytes) += bytes;
+        }
+    }
+    close(fd);
+
+    if (dead_bytes > kCompactDeadBytes && dead_bytes > live_bytes) {
+        Compact(path);
+    }
+
+    std::cout << "[DiskCache] Saved config v" << config.version() << " for " << service_name
+              << (config_name.empty() ? "" : "/" + config_name) << " -> " << path << std::endl;
     return true;
 }
 
-bool DiskCache::Load(const std::string& service_name, ConfigData& out) {
-    std::string path = GetCachePath(service_name);
-
-    std::ifstream f(path, std::ios::binary);
-    if (!f) {
+bool DiskCache::View(const std::string& service_name, CachedConfigView& out,
+                     const std::string& config_name, int64_t version) {
+    auto mapping = MapFile(GetCachePath(service_name));
+    if (!mapping) {
         return false;  // Cache miss — not an error
     }
 
-    std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+    const auto* header = reinterpret_cast<const FileHeader*>(mapping->base);
+    const auto* entries = reinterpret_cast<const IndexEntry*>(mapping->base + sizeof(FileHeader));
+    uint64_t data_start = DataStart(header->index_capacity);
+    uint64_t data_end = std::min<uint64_t>(header->data_end, mapping->size);
+    uint64_t count = header->entry_count;
 
-    if (!out.ParseFromString(data)) {
-        std::cerr << "[DiskCache] Parse failed for " << path << " — discarding" << std::endl;
-        std::remove(path.c_str());
-        return false;
-    }
+    // Newest first: later entries were saved later
+    for (uint64_t i = count; i-- > 0;) {
+        const IndexEntry& e = entries[i];
+        if (!(e.flags & kEntryLive) || !NameEquals(e.service_name, service_name) ||
+            !NameEquals(e.config_name, config_name) || (version != 0 && e.version != version)) {
+            continue;
+        }
 
-    // Verify content integrity using stored hash
-    if (!out.content_hash().empty()) {
-        std::string actual_hash = ComputeHash(out.content());
-        if (actual_hash != out.content_hash()) {
-            std::cerr << "[DiskCache] Hash mismatch for " << service_name << " — discarding"
-                      << std::endl;
-            std::remove(path.c_str());
-            return false;
+        uint64_t end = e.record_offset + e.meta_length + e.content_length;
+        if (e.record_offset < data_start || end > data_end || end < e.record_offset) {
+            std::cerr << "[DiskCache] Entry out of bounds in " << GetCachePath(service_name)
+                      << " — skipping" << std::endl;
+            continue;
         }
+
+        const char* record = mapping->base + e.record_offset;
+        if (Fnv1a(record, e.meta_length) != e.meta_checksum ||
+            !out.metadata.ParseFromArray(record, static_cast<int>(e.meta_length))) {
+            std::cerr << "[DiskCache] Corrupt entry v" << e.version << " for " << service_name
+                      << " — skipping" << std::endl;
+            continue;
+        }
+
+        std::string_view content(record + e.meta_length, e.content_length);
+        if (!VerifyContent(*mapping, e.record_offset, e.meta_checksum, out.metadata, content)) {
+            std::cerr << "[DiskCache] Hash mismatch for " << service_name << " v" << e.version
+                      << " — skipping" << std::endl;
+            continue;
+        }
+
+        out.content = content;
+        out.owner = mapping;
+        return true;
     }
+    return false;
+}
+
+bool DiskCache::Load(const std::string& service_name, ConfigData& out,
+                     const std::string& config_name) {
+    CachedConfigView view;
+    if (!View(service_name, view, config_name)) {
+        return false;
+    }
+
+    // View() has verified content_hash
+    out = std::move(view.metadata);
+    out.set_content(view.content.data(), view.content.size());
 
     std::cout << "[DiskCache] Loaded cached config v" << out.version() << " for " << service_name
-              << std::endl;
+              << (config_name.empty() ? "" : "/" + config_name) << std::endl;
     return true;
 }
 
+std::vector<int64_t> DiskCache::ListVersions(const std::string& service_name,
+                                             const std::string& config_name) {
+    std::vector<int64_t> versions;
+    auto mapping = MapFile(GetCachePath(service_name));
+    if (!mapping) {
+        return versions;
+    }
+
+    const auto* header = reinterpret_cast<const FileHeader*>(mapping->base);
+    const auto* entries = reinterpret_cast<const IndexEntry*>(mapping->base + sizeof(FileHeader));
+    uint64_t count = header->entry_count;
+
+    for (uint64_t i = count; i-- > 0;) {
+        const IndexEntry& e = entries[i];
+        if ((e.flags & kEntryLive) && NameEquals(e.service_name, service_name) &&
+            NameEquals(e.config_name, config_name)) {
+            versions.push_back(e.version);
+        }
+    }
+    return versions;
+}
+
+std::vector<std::string> DiskCache::ListConfigNames(const std::string& service_name) {
+    std::vector<std::string> names;
+    auto mapping = MapFile(GetCachePath(service_name));
+    if (!mapping) {
+        return names;
+    }
+
+    const auto* header = reinterpret_cast<const FileHeader*>(mapping->base);
+    const auto* entries = reinterpret_cast<const IndexEntry*>(mapping->base + sizeof(FileHeader));
+    uint64_t count = header->entry_count;
+
+    std::set<std::string> seen;
+    for (uint64_t i = count; i-- > 0;) {
+        const IndexEntry& e = entries[i];
+        if (!(e.flags & kEntryLive) || !NameEquals(e.service_name, service_name)) {
+            continue;
+        }
+        std::string name(e.config_name, strnlen(e.config_name, kNameSize));
+        if (!name.empty() && seen.insert(name).second) {
+            names.push_back(name);
+        }
+    }
+    return names;
+}
+
 // ---------------------------------------------------------------------------
 // Private helpers
 // ---------------------------------------------------------------------------
 
+std::shared_ptr<DiskCache::Mapping> DiskCache::MapFile(const std::string& path) {
+    struct stat st = {};
+    if (stat(path.c_str(), &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(FileHeader)) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Appends grow the file and compaction replaces it; reuse the mapping otherwise
+    auto it = mappings_.find(path);
+    if (it != mappings_.end() && it->second->inode == st.st_ino &&
+        it->second->device == st.st_dev && it->second->size == static_cast<size_t>(st.st_size)) {
+        return it->second;
+    }
+
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < sizeof(FileHeader)) {
+        close(fd);
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping stays valid
+    if (base == MAP_FAILED) {
+        std::cerr << "[DiskCache] mmap failed for " << path << ": " << std::strerror(errno)
+                  << std::endl;
+        return nullptr;
+    }
+
+    auto mapping = std::make_shared<Mapping>();
+    mapping->base = static_cast<const char*>(base);
+    mapping->size = static_cast<size_t>(st.st_size);
+    mapping->device = st.st_dev;
+    mapping->inode = st.st_ino;
+
+    const auto* header = reinterpret_cast<const FileHeader*>(mapping->base);
+    if (!ValidHeader(*header) || mapping->size < DataStart(header->index_capacity)) {
+        std::cerr << "[DiskCache] Unrecognised cache file " << path << " — ignoring" << std::endl;
+        mappings_.erase(path);
+        return nullptr;
+    }
+
+    // Grown by appends: what was verified still holds
+    if (it != mappings_.end() && it->second->inode == st.st_ino &&
+        it->second->device == st.st_dev) {
+        std::lock_guard<std::mutex> verified_lock(it->second->mutex);
+        mapping->verified = it->second->verified;
+    }
+    mappings_[path] = mapping;
+    return mapping;
+}
+
+bool DiskCache::Compact(const std::string& path) {
+    // Caller holds the writer lock. Copy live records into a fresh file, then rename
+    // over the old one; readers holding the old mapping keep a valid (old) inode.
+    int src = open(path.c_str(), O_RDONLY);
+    if (src < 0) {
+        return false;
+    }
+
+    FileHeader header = {};
+    std::vector<IndexEntry> index;
+    if (ReadAll(src, &header, sizeof(header), 0) && ValidHeader(header)) {
+        index.resize(header.entry_count);
+        if (!ReadAll(src, index.data(), index.size() * sizeof(IndexEntry), sizeof(FileHeader))) {
+            index.clear();
+        }
+    }
+
+    std::string tmp_path = path + ".tmp";
+    int dst = open(tmp_path.c_str(), O_CREAT | O_TRUNC | O_RDWR, 0644);
+    if (dst < 0) {
+        close(src);
+        std::cerr << "[DiskCache] Cannot write to " << tmp_path << std::endl;
+        return false;
+    }
+
+    uint64_t live = std::count_if(index.begin(), index.end(),
+                                  [](const IndexEntry& e) { return e.flags & kEntryLive; });
+    FileHeader fresh = EmptyHeader(IndexCapacityFor(live));
+    bool ok = ftruncate(dst, static_cast<off_t>(DataStart(fresh.index_capacity))) == 0;
+    std::string buffer;
+
+    for (const IndexEntry& e : index) {
+        if (!ok || fresh.entry_count >= fresh.index_capacity)
+            break;
+        if (!(e.flags & kEntryLive) || e.record_offset + e.meta_length + e.content_length >
+                                           header.data_end) {
+            continue;
+        }
+
+        buffer.resize(e.meta_length + e.content_length);
+        IndexEntry moved = e;
+        moved.record_offset = fresh.data_end;
+        ok = ReadAll(src, &buffer[0], buffer.size(), e.record_offset) &&
+             WriteAll(dst, buffer.data(), buffer.size(), moved.record_offset) &&
+             WriteAll(dst, &moved, sizeof(moved),
+                      sizeof(FileHeader) + fresh.entry_count * sizeof(IndexEntry));
+        fresh.entry_count++;
+        fresh.data_end += buffer.size();
+    }
+
+    ok = ok && WriteAll(dst, &fresh, sizeof(fresh), 0) && fdatasync(dst) == 0;
+    close(src);
+    close(dst);
+
+    // Atomic rename
+    if (!ok || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::cerr << "[DiskCache] Compaction failed for " << path << std::endl;
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+
+    std::cout << "[DiskCache] Compacted " << path << " (" << fresh.entry_count
+              << " live entries)" << std::endl;
+    return true;
+}
+
+bool DiskCache::VerifyContent(Mapping& mapping, uint64_t record_offset, uint32_t meta_checksum,
+                              const ConfigData& metadata, std::string_view content) {
+    if (metadata.content_hash().empty()) {
+        return true;
+    }
+
+    std::pair<uint64_t, uint32_t> key(record_offset, meta_checksum);
+    {
+        std::lock_guard<std::mutex> lock(mapping.mutex);
+        if (mapping.verified.count(key)) {
+            return true;
+        }
+    }
+
+    if (contenthash::Sha256Hex(content) != metadata.content_hash()) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mapping.mutex);
+    mapping.verified.insert(key);
+    return true;
+}
+
 bool DiskCache::EnsureCacheDir() const {
     struct stat st = {};
     if (stat(cache_dir_.c_str(), &st) == 0) {
@@ -151,15 +636,7 @@ bool DiskCache::EnsureCacheDir() const {
 }
 
 std::string DiskCache::ComputeHash(const std::string& content) {
-    unsigned char hash[SHA256_DIGEST_LENGTH];
-    SHA256(reinterpret_cast<const unsigned char*>(content.data()), content.size(), hash);
-
-    std::ostringstream oss;
-    oss << std::hex << std::setfill('0');
-    for (unsigned char byte : hash) {
-        oss << std::setw(2) << static_cast<int>(byte);
-    }
-    return oss.str();
+    return contenthash::Sha256Hex(content);
 }
 
 }  // namespace configservice
@@ -0,0 +1,405 @@
+#include "configclient/shm_config_store.h"
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace configservice {
+
+namespace {
+
+using shm::ShmEntry;
+using shm::ShmHeader;
+
+size_t DataOffset(uint32_t max_entries) {
+    size_t offset = sizeof(ShmHeader) + max_entries * sizeof(ShmEntry);
+    return (offset + 63) & ~size_t(63);
+}
+
+size_t SegmentSize(uint32_t max_entries, uint32_t buffer_capacity) {
+    return DataOffset(max_entries) + size_t(2) * max_entries * buffer_capacity;
+}
+
+int64_t NowUnixMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+std::string EntryKey(const std::string& service_name, const std::string& config_name) {
+    return service_name + '\0' + config_name;
+}
+
+}  // anonymous namespace
+
+// ---------------------------------------------------------------------------
+// ShmConfigPublisher
+// ---------------------------------------------------------------------------
+
+ShmConfigPublisher::ShmConfigPublisher(const std::string& shm_name, uint32_t max_entries,
+                                       uint32_t buffer_capacity)
+    : shm_name_(shm_name), max_entries_(max_entries), buffer_capacity_(buffer_capacity), fd_(-1),
+      base_(nullptr), mapped_size_(0) {}
+
+ShmConfigPublisher::~ShmConfigPublisher() {
+    Shutdown();
+}
+
+bool ShmConfigPublisher::Initialize() {
+    size_t required = SegmentSize(max_entries_, buffer_capacity_);
+
+    fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd_ < 0) {
+        std::cerr << "[ShmStore] ✗ shm_open failed for " << shm_name_ << ": "
+                  << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Reuse a segment left by a previous agent run when the geometry matches,
+    // so readers that are already attached keep working across restarts.
+    struct stat st = {};
+    bool reuse = false;
+    if (fstat(fd_, &st) == 0 && static_cast<size_t>(st.st_size) == required) {
+        base_ = mmap(nullptr, required, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base_ != MAP_FAILED) {
+            auto* header = static_cast<ShmHeader*>(base_);
+            reuse = header->magic == shm::kMagic &&
+                    header->layout_version == shm::kLayoutVersion &&
+                    header->max_entries == max_entries_ &&
+                    header->buffer_capacity == buffer_capacity_;
+            if (!reuse) {
+                munmap(base_, required);
+            }
+        }
+    } else if (st.st_size != 0) {
+        // Incompatible segment: unlink it (attached readers keep their old mapping
+        // and see a stale heartbeat) and start over with a fresh one.
+        close(fd_);
+        shm_unlink(shm_name_.c_str());
+        fd_ = shm_open(shm_name_.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd_ < 0) {
+            std::cerr << "[ShmStore] ✗ shm_open failed for " << shm_name_ << ": "
+                      << std::strerror(errno) << std::endl;
+            return false;
+        }
+    }
+
+    if (!reuse) {
+        if (ftruncate(fd_, static_cast<off_t>(required)) != 0) {
+            std::cerr << "[ShmStore] ✗ ftruncate failed: " << std::strerror(errno) << std::endl;
+            close(fd_);
+            fd_ = -1;
+            return false;
+        }
+        base_ = mmap(nullptr, required, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (base_ == MAP_FAILED) {
+            std::cerr << "[ShmStore] ✗ mmap failed: " << std::strerror(errno) << std::endl;
+            base_ = nullptr;
+            close(fd_);
+            fd_ = -1;
+            return false;
+        }
+
+        std::memset(base_, 0, DataOffset(max_entries_));
+        auto* header = static_cast<ShmHeader*>(base_);
+        header->layout_version = shm::kLayoutVersion;
+        header->max_entries = max_entries_;
+        header->buffer_capacity = buffer_capacity_;
+        // Magic last: a reader that sees it also sees a complete header
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = shm::kMagic;
+    }
+
+    mapped_size_ = required;
+
+    auto* header = static_cast<ShmHeader*>(base_);
+    header->agent_pid = static_cast<int64_t>(getpid());
+    Heartbeat();
+
+    // Rebuild the lookup index from entries that survived a restart
+    auto* entries = reinterpret_cast<ShmEntry*>(header + 1);
+    uint32_t count = header->entry_count.load(std::memory_order_acquire);
+    for (uint32_t i = 0; i < count; ++i) {
+        index_[EntryKey(entries[i].service_name, entries[i].config_name)] = i;
+
+        // A previous agent died mid-publish: its active buffer is still complete
+        uint64_t seq = entries[i].seq.load(std::memory_order_relaxed);
+        if (seq & 1) {
+            entries[i].seq.store(seq + 1, std::memory_order_release);
+        }
+    }
+
+    std::cout << "[ShmStore] ✓ " << (reuse ? "Reopened " : "Created ") << shm_name_ << " ("
+              << max_entries_ << " entries x 2 x " << buffer_capacity_ << " bytes, " << count
+              << " in use)" << std::endl;
+    return true;
+}
+
+void ShmConfigPublisher::Shutdown(bool unlink) {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
+    if (base_) {
+        munmap(base_, mapped_size_);
+        base_ = nullptr;
+        mapped_size_ = 0;
+    }
+    if (fd_ >= 0) {
+        close(fd_);
+        fd_ = -1;
+    }
+    if (unlink) {
+        shm_unlink(shm_name_.c_str());
+    }
+    index_.clear();
+}
+
+bool ShmConfigPublisher::Publish(const std::string& service_name, const std::string& config_name,
+                                 const ConfigData& config) {
+    std::string data;
+    if (!config.SerializeToString(&data)) {
+        std::cerr << "[ShmStore] Serialization failed for " << service_name << "/" << config_name
+                  << std::endl;
+        return false;
+    }
+    if (data.size() > buffer_capacity_) {
+        std::cerr << "[ShmStore] Config " << service_name << "/" << config_name << " ("
+                  << data.size() << " bytes) exceeds buffer capacity " << buffer_capacity_
+                  << std::endl;
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(write_mutex_);
+
+    if (!base_) {
+        return false;
+    }
+
+    int idx = FindOrClaimEntry(service_name, config_name);
+    if (idx < 0) {
+        return false;
+    }
+
+    auto* header = static_cast<ShmHeader*>(base_);
+    auto* entry = reinterpret_cast<ShmEntry*>(header + 1) + idx;
+    uint32_t next = 1 - entry->active.load(std::memory_order_relaxed);
+    char* buffer = static_cast<char*>(base_) + DataOffset(max_entries_) +
+                   (size_t(2) * idx + next) * buffer_capacity_;
+
+    // Seqlock: odd while writing the inactive buffer and flipping
+    uint64_t seq = entry->seq.load(std::memory_order_relaxed);
+    entry->seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::memcpy(buffer, data.data(), data.size());
+    entry->size[next].store(static_cast<uint32_t>(data.size()), std::memory_order_relaxed);
+    entry->active.store(next, std::memory_order_release);
+    entry->version.store(config.version(), std::memory_order_release);
+
+    entry->seq.store(seq + 2, std::memory_order_release);
+
+    header->publish_count.fetch_add(1, std::memory_order_relaxed);
+    header->heartbeat_unix_ms.store(NowUnixMs(), std::memory_order_release);
+
+    std::cout << "[ShmStore] Published " << service_name << "/" << config_name << " v"
+              << config.version() << " (" << data.size() << " bytes)" << std::endl;
+    return true;
+}
+
+void ShmConfigPublisher::Heartbeat() {
+    if (base_) {
+        static_cast<ShmHeader*>(base_)->heartbeat_unix_ms.store(NowUnixMs(),
+                                                                std::memory_order_release);
+    }
+}
+
+int ShmConfigPublisher::FindOrClaimEntry(const std::string& service_name,
+                                         const std::string& config_name) {
+    auto it = index_.find(EntryKey(service_name, config_name));
+    if (it != index_.end()) {
+        return static_cast<int>(it->second);
+    }
+
+    if (service_name.size() >= shm::kNameSize || config_name.size() >= shm::kNameSize) {
+        std::cerr << "[ShmStore] Name too long: " << service_name << "/" << config_name
+                  << std::endl;
+        return -1;
+    }
+
+    auto* header = static_cast<ShmHeader*>(base_);
+    uint32_t idx = header->entry_count.load(std::memory_order_relaxed);
+    if (idx >= max_entries_) {
+        std::cerr << "[ShmStore] Entry table full (" << max_entries_ << "), cannot publish "
+                  << service_name << "/" << config_name << std::endl;
+        return -1;
+    }
+
+    auto* entry = reinterpret_cast<ShmEntry*>(header + 1) + idx;
+    std::memset(entry->service_name, 0, shm::kNameSize);
+    std::memset(entry->config_name, 0, shm::kNameSize);
+    std::memcpy(entry->service_name, service_name.data(), service_name.size());
+    std::memcpy(entry->config_name, config_name.data(), config_name.size());
+
+    // Publish the slot only after its names are in place
+    header->entry_count.store(idx + 1, std::memory_order_release);
+    index_[EntryKey(service_name, config_name)] = idx;
+    return static_cast<int>(idx);
+}
+
+// ---------------------------------------------------------------------------
+// ShmConfigReader
+// ---------------------------------------------------------------------------
+
+ShmConfigReader::ShmConfigReader(const std::string& shm_name)
+    : shm_name_(shm_name), base_(nullptr), mapped_size_(0) {}
+
+ShmConfigReader::~ShmConfigReader() {
+    Detach();
+}
+
+bool ShmConfigReader::Attach() {
+    if (base_) {
+        return true;
+    }
+
+    int fd = shm_open(shm_name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        std::cerr << "[ShmStore] Cannot open " << shm_name_ << " — is konfig-agent running?"
+                  << std::endl;
+        return false;
+    }
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmHeader)) {
+        close(fd);
+        return false;
+    }
+
+    size_t size = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);  // the mapping stays valid
+    if (base == MAP_FAILED) {
+        std::cerr << "[ShmStore] mmap failed for " << shm_name_ << ": " << std::strerror(errno)
+                  << std::endl;
+        return false;
+    }
+
+    const auto* header = static_cast<const ShmHeader*>(base);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (header->magic != shm::kMagic || header->layout_version != shm::kLayoutVersion ||
+        size < SegmentSize(header->max_entries, header->buffer_capacity)) {
+        std::cerr << "[ShmStore] Incompatible segment layout in " << shm_name_ << std::endl;
+        munmap(base, size);
+        return false;
+    }
+
+    base_ = base;
+    mapped_size_ = size;
+    return true;
+}
+
+void ShmConfigReader::Detach() {
+    if (base_) {
+        munmap(const_cast<void*>(base_), mapped_size_);
+        base_ = nullptr;
+        mapped_size_ = 0;
+    }
+}
+
+int ShmConfigReader::FindEntry(const std::string& service_name,
+                               const std::string& config_name) const {
+    if (!base_) {
+        return -1;
+    }
+
+    const auto* header = static_cast<const ShmHeader*>(base_);
+    const auto* entries = reinterpret_cast<const ShmEntry*>(header + 1);
+    uint32_t count = header->entry_count.load(std::memory_order_acquire);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        if (service_name.compare(0, shm::kNameSize, entries[i].service_name) == 0 &&
+            config_name.compare(0, shm::kNameSize, entries[i].config_name) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+int64_t ShmConfigReader::GetVersion(int entry) const {
+    if (!base_ || entry < 0) {
+        return 0;
+    }
+    const auto* header = static_cast<const ShmHeader*>(base_);
+    if (static_cast<uint32_t>(entry) >= header->entry_count.load(std::memory_order_acquire)) {
+        return 0;
+    }
+    const auto* e = reinterpret_cast<const ShmEntry*>(header + 1) + entry;
+    return e->version.load(std::memory_order_acquire);
+}
+
+int64_t ShmConfigReader::GetVersion(const std::string& service_name,
+                                    const std::string& config_name) const {
+    return GetVersion(FindEntry(service_name, config_name));
+}
+
+bool ShmConfigReader::Read(int entry, ConfigData& out) const {
+    if (!base_ || entry < 0) {
+        return false;
+    }
+
+    const auto* header = static_cast<const ShmHeader*>(base_);
+    if (static_cast<uint32_t>(entry) >= header->entry_count.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    const auto* e = reinterpret_cast<const ShmEntry*>(header + 1) + entry;
+    const char* data = static_cast<const char*>(base_) + DataOffset(header->max_entries);
+
+    std::string copy;
+    for (int attempt = 0; attempt < kMaxReadRetries; ++attempt) {
+        uint64_t seq_before = e->seq.load(std::memory_order_acquire);
+        uint32_t idx = e->active.load(std::memory_order_acquire) & 1;
+        uint32_t size = e->size[idx].load(std::memory_order_acquire);
+
+        if (size == 0) {
+            return false;  // claimed but never published
+        }
+        if (size <= header->buffer_capacity) {
+            copy.assign(data + (size_t(2) * entry + idx) * header->buffer_capacity, size);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t seq_after = e->seq.load(std::memory_order_relaxed);
+
+        // The buffer we copied is only rewritten by the publish *after* the one that
+        // made it inactive, so up to one complete flip (or the tail of one already in
+        // progress) during the copy is harmless.
+        uint64_t tolerated = (seq_before & 1) ? 1 : 2;
+        if (size <= header->buffer_capacity && seq_after - seq_before <= tolerated) {
+            return out.ParseFromString(copy);
+        }
+    }
+
+    std::cerr << "[ShmStore] Gave up reading entry " << entry << " after " << kMaxReadRetries
+              << " retries" << std::endl;
+    return false;
+}
+
+bool ShmConfigReader::Read(const std::string& service_name, const std::string& config_name,
+                           ConfigData& out) const {
+    return Read(FindEntry(service_name, config_name), out);
+}
+
+int64_t ShmConfigReader::HeartbeatAgeMs() const {
+    if (!base_) {
+        return -1;
+    }
+    const auto* header = static_cast<const ShmHeader*>(base_);
+    return NowUnixMs() - header->heartbeat_unix_ms.load(std::memory_order_acquire);
+}
+
+}  // namespace configservice
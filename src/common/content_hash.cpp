@@ -0,0 +1,22 @@
+#include "contenthash/content_hash.h"
+
+#include <openssl/evp.h>
+
+namespace contenthash {
+
+std::string Sha256Hex(std::string_view content) {
+    static constexpr char kHexDigits[] = "0123456789abcdef";
+
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int digest_len = 0;
+    EVP_Digest(content.data(), content.size(), digest, &digest_len, EVP_sha256(), nullptr);
+
+    std::string hex(digest_len * 2, '0');
+    for (unsigned int i = 0; i < digest_len; ++i) {
+        hex[2 * i] = kHexDigits[digest[i] >> 4];
+        hex[2 * i + 1] = kHexDigits[digest[i] & 0x0F];
+    }
+    return hex;
+}
+
+}  // namespace contenthash
@@ -0,0 +1,692 @@
+#include "jsonscan/json_scanner.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace jsonscan {
+
+namespace {
+
+using Byte = unsigned char;
+
+inline bool IsWhitespace(Byte c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool IsDigit(Byte c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool IsHexDigit(Byte c) {
+    return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+inline bool IsPlainStringByte(Byte c) {
+    return c >= 0x20 && c < 0x80 && c != '"' && c != '\\';
+}
+
+#if defined(__SSE2__)
+
+// Bytes from p up to the first one a string body needs to look at: '"', '\\', a control
+// character or a non-ASCII byte. Signed compare against 0x20 catches both of the last two.
+inline size_t PlainStringRun(const Byte* p, const Byte* end) {
+    const Byte* start = p;
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i space = _mm_set1_epi8(0x20);
+
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i special = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, quote), _mm_cmpeq_epi8(block, backslash)),
+            _mm_cmplt_epi8(block, space));
+        int mask = _mm_movemask_epi8(special);
+        if (mask != 0) {
+            return static_cast<size_t>(p - start) + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    while (p < end && IsPlainStringByte(*p)) {
+        ++p;
+    }
+    return static_cast<size_t>(p - start);
+}
+
+inline size_t WhitespaceRun(const Byte* p, const Byte* end) {
+    // Most runs are a single space after ':' or nothing at all
+    if (p == end || !IsWhitespace(*p)) {
+        return 0;
+    }
+
+    const Byte* start = p;
+    while (end - p >= 16) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i ws = _mm_or_si128(
+            _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8(' ')),
+                         _mm_cmpeq_epi8(block, _mm_set1_epi8('\n'))),
+            _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\r')),
+                         _mm_cmpeq_epi8(block, _mm_set1_epi8('\t'))));
+        int mask = ~_mm_movemask_epi8(ws) & 0xFFFF;
+        if (mask != 0) {
+            return static_cast<size_t>(p - start) + __builtin_ctz(mask);
+        }
+        p += 16;
+    }
+    while (p < end && IsWhitespace(*p)) {
+        ++p;
+    }
+    return static_cast<size_t>(p - start);
+}
+
+#else
+
+inline size_t PlainStringRun(const Byte* p, const Byte* end) {
+    const Byte* start = p;
+    while (p < end && IsPlainStringByte(*p)) {
+        ++p;
+    }
+    return static_cast<size_t>(p - start);
+}
+
+inline size_t WhitespaceRun(const Byte* p, const Byte* end) {
+    const Byte* start = p;
+    while (p < end && IsWhitespace(*p)) {
+        ++p;
+    }
+    return static_cast<size_t>(p - start);
+}
+
+#endif
+
+// Length of the well-formed UTF-8 sequence starting at p (lead byte >= 0x80), or 0.
+// Rejects overlong forms, surrogates and code points above U+10FFFF.
+size_t Utf8SequenceLength(const Byte* p, const Byte* end) {
+    Byte lead = p[0];
+    size_t length;
+    uint32_t code_point;
+
+    if (lead >= 0xC2 && lead <= 0xDF) {
+        length = 2;
+        code_point = lead & 0x1F;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        length = 3;
+        code_point = lead & 0x0F;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        length = 4;
+        code_point = lead & 0x07;
+    } else {
+        return 0;
+    }
+
+    if (static_cast<size_t>(end - p) < length) {
+        return 0;
+    }
+    for (size_t i = 1; i < length; ++i) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        code_point = (code_point << 6) | (p[i] & 0x3F);
+    }
+
+    if (length == 3 && (code_point < 0x800 || (code_point >= 0xD800 && code_point <= 0xDFFF))) {
+        return 0;
+    }
+    if (length == 4 && (code_point < 0x10000 || code_point > 0x10FFFF)) {
+        return 0;
+    }
+    return length;
+}
+
+std::string Quoted(Byte c) {
+    if (c >= 0x20 && c < 0x7F) {
+        return std::string("'") + static_cast<char>(c) + "'";
+    }
+    static constexpr char kHexDigits[] = "0123456789ABCDEF";
+    return std::string("byte 0x") + kHexDigits[c >> 4] + kHexDigits[c & 0x0F];
+}
+
+Byte Closer(Byte opener) {
+    return opener == '{' ? '}' : ']';
+}
+
+// ─── Builders ─────────────────────────────────────────────────────────────────
+// The scanner reports each token to a builder. NullBuilder compiles away entirely, so
+// Validate() pays nothing for Parse() existing.
+
+struct NullBuilder {
+    void Open(const Byte*) {}
+    void Close(const Byte*) {}
+    void Key(const Byte*, const Byte*, bool) {}
+    void String(const Byte*, const Byte*, bool) {}
+    void Number(const Byte*, const Byte*) {}
+    void Literal(const Byte*, const Byte*) {}
+};
+
+// Appends the UTF-8 encoding of a \u escape (with its low surrogate, if it starts a pair)
+// and returns the position after it
+const Byte* DecodeUnicodeEscape(const Byte* p, const Byte* end, std::string& out) {
+    auto hex4 = [](const Byte* h) {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i) {
+            Byte c = h[i];
+            value = (value << 4) |
+                    static_cast<uint32_t>(IsDigit(c) ? c - '0' : (c | 0x20) - 'a' + 10);
+        }
+        return value;
+    };
+
+    uint32_t code_point = hex4(p + 2);
+    p += 6;
+    if (code_point >= 0xD800 && code_point <= 0xDBFF && end - p >= 6 && p[0] == '\\' &&
+        p[1] == 'u') {
+        uint32_t low = hex4(p + 2);
+        if (low >= 0xDC00 && low <= 0xDFFF) {
+            code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+            p += 6;
+        }
+    }
+    // A lone surrogate is grammatical JSON (RFC 8259 section 8.2); keep it as U+FFFD
+    if (code_point >= 0xD800 && code_point <= 0xDFFF) {
+        code_point = 0xFFFD;
+    }
+
+    if (code_point < 0x80) {
+        out += static_cast<char>(code_point);
+    } else if (code_point < 0x800) {
+        out += static_cast<char>(0xC0 | (code_point >> 6));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else if (code_point < 0x10000) {
+        out += static_cast<char>(0xE0 | (code_point >> 12));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code_point >> 18));
+        out += static_cast<char>(0x80 | ((code_point >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code_point >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code_point & 0x3F));
+    }
+    return p;
+}
+
+// String body [begin, end) has already been checked by the scanner
+void DecodeString(const Byte* begin, const Byte* end, bool escaped, std::string& out) {
+    if (!escaped) {
+        out.assign(reinterpret_cast<const char*>(begin), end - begin);
+        return;
+    }
+
+    out.clear();
+    out.reserve(end - begin);
+    const Byte* p = begin;
+    while (p < end) {
+        if (*p != '\\') {
+            out += static_cast<char>(*p++);
+            continue;
+        }
+        switch (p[1]) {
+            case 'b':
+                out += '\b';
+                break;
+            case 'f':
+                out += '\f';
+                break;
+            case 'n':
+                out += '\n';
+                break;
+            case 'r':
+                out += '\r';
+                break;
+            case 't':
+                out += '\t';
+                break;
+            case 'u':
+                p = DecodeUnicodeEscape(p, end, out);
+                continue;
+            default:  // '"', '\\', '/'
+                out += static_cast<char>(p[1]);
+                break;
+        }
+        p += 2;
+    }
+}
+
+// Builds a Value tree. Only the innermost open container is ever appended to, so pointers
+// to the open containers stay valid while their children are filled in.
+class DomBuilder {
+   public:
+    DomBuilder(Value& root, std::string_view json)
+        : root_(root),
+          root_used_(false),
+          text_(reinterpret_cast<const Byte*>(json.data())),
+          positions_(json.size() < UINT32_MAX) {}
+
+    void Open(const Byte* at) {
+        Value& value = Slot(at, at);
+        value.type = *at == '{' ? Value::Type::kObject : Value::Type::kArray;
+        open_.push_back(&value);
+    }
+
+    // end is just past the closing bracket
+    void Close(const Byte* end) {
+        if (positions_) {
+            open_.back()->end = static_cast<uint32_t>(end - text_);
+        }
+        open_.pop_back();
+    }
+
+    void Key(const Byte* begin, const Byte* end, bool escaped) {
+        auto& members = open_.back()->members;
+        members.emplace_back();
+        DecodeString(begin, end, escaped, members.back().first);
+    }
+
+    // The body, without the quotes
+    void String(const Byte* begin, const Byte* end, bool escaped) {
+        Value& value = Slot(begin - 1, end + 1);
+        value.type = Value::Type::kString;
+        DecodeString(begin, end, escaped, value.string);
+    }
+
+    void Number(const Byte* begin, const Byte* end) {
+        Value& value = Slot(begin, end);
+        value.type = Value::Type::kNumber;
+        value.string.assign(reinterpret_cast<const char*>(begin), end - begin);
+        value.number = std::strtod(value.string.c_str(), nullptr);
+    }
+
+    void Literal(const Byte* begin, const Byte* end) {
+        Value& value = Slot(begin, end);
+        value.type = *begin == 'n' ? Value::Type::kNull : Value::Type::kBool;
+        value.boolean = *begin == 't';
+    }
+
+   private:
+    Value& root_;
+    bool root_used_;
+    const Byte* text_;
+    bool positions_;  // Offsets fit in a Value
+    std::vector<Value*> open_;
+
+    // Where the next value, whose text is [begin, end), goes: the root, the next array
+    // element, or the value of the object member whose key was just read
+    Value& Slot(const Byte* begin, const Byte* end) {
+        Value* value;
+        if (open_.empty()) {
+            root_used_ = true;
+            value = &root_;
+        } else if (open_.back()->type == Value::Type::kArray) {
+            open_.back()->items.emplace_back();
+            value = &open_.back()->items.back();
+        } else {
+            value = &open_.back()->members.back().second;
+        }
+        if (positions_) {
+            value->begin = static_cast<uint32_t>(begin - text_);
+            value->end = static_cast<uint32_t>(end - text_);
+        }
+        return *value;
+    }
+};
+
+// ─── Scanner ──────────────────────────────────────────────────────────────────
+
+template <typename Builder>
+class Scanner {
+   public:
+    Scanner(std::string_view json, size_t max_depth, Builder& builder)
+        : begin_(reinterpret_cast<const Byte*>(json.data())),
+          end_(begin_ + json.size()),
+          p_(begin_),
+          max_depth_(max_depth),
+          builder_(builder),
+          string_begin_(nullptr),
+          string_end_(nullptr),
+          string_escaped_(false),
+          error_at_(nullptr) {}
+
+    ScanResult Run();
+
+   private:
+    enum class State { kValue, kKey, kAfterValue };
+
+    const Byte* begin_;
+    const Byte* end_;
+    const Byte* p_;
+    size_t max_depth_;
+    std::string stack_;  // Open containers, '{' or '['
+    Builder& builder_;
+
+    // Body of the string ScanString() last accepted
+    const Byte* string_begin_;
+    const Byte* string_end_;
+    bool string_escaped_;
+
+    const Byte* error_at_;
+    std::string error_message_;
+
+    bool Error(const Byte* at, std::string message) {
+        error_at_ = at;
+        error_message_ = std::move(message);
+        return false;
+    }
+
+    void SkipWhitespace() { p_ += WhitespaceRun(p_, end_); }
+
+    bool ScanString();
+    bool ScanNumber();
+    bool ScanLiteral(const char* literal, size_t length);
+    ScanResult Result() const;
+};
+
+template <typename Builder>
+ScanResult Scanner<Builder>::Run() {
+    // A leading UTF-8 byte order mark may be ignored (RFC 8259 section 8.1)
+    if (end_ - p_ >= 3 && p_[0] == 0xEF && p_[1] == 0xBB && p_[2] == 0xBF) {
+        p_ += 3;
+    }
+
+    State state = State::kValue;
+    bool after_comma = false;
+
+    while (true) {
+        SkipWhitespace();
+
+        if (state == State::kValue) {
+            if (p_ == end_) {
+                Error(p_, stack_.empty() ? "Empty document"
+                                         : "Unexpected end of input, expected a value");
+                return Result();
+            }
+
+            Byte c = *p_;
+            if (c == '{' || c == '[') {
+                if (stack_.size() >= max_depth_) {
+                    Error(p_, "Nesting deeper than " + std::to_string(max_depth_) + " levels");
+                    return Result();
+                }
+                stack_.push_back(static_cast<char>(c));
+                builder_.Open(p_);
+                ++p_;
+                SkipWhitespace();
+                if (p_ != end_ && *p_ == Closer(c)) {
+                    ++p_;
+                    stack_.pop_back();
+                    builder_.Close(p_);
+                    state = State::kAfterValue;
+                } else {
+                    state = c == '{' ? State::kKey : State::kValue;
+                }
+                after_comma = false;
+                continue;
+            }
+
+            bool ok;
+            const Byte* start = p_;
+            if (c == '"') {
+                ok = ScanString();
+                if (ok) {
+                    builder_.String(string_begin_, string_end_, string_escaped_);
+                }
+            } else if (c == '-' || IsDigit(c)) {
+                ok = ScanNumber();
+                if (ok) {
+                    builder_.Number(start, p_);
+                }
+            } else if (c == 't' || c == 'f' || c == 'n') {
+                ok = c == 't' ? ScanLiteral("true", 4)
+                              : c == 'f' ? ScanLiteral("false", 5) : ScanLiteral("null", 4);
+                if (ok) {
+                    builder_.Literal(start, p_);
+                }
+            } else if ((c == ']' || c == '}') && after_comma) {
+                ok = Error(p_, "Trailing comma before " + Quoted(c));
+            } else {
+                ok = Error(p_, "Unexpected " + Quoted(c) + ", expected a value");
+            }
+            if (!ok) {
+                return Result();
+            }
+            state = State::kAfterValue;
+            continue;
+        }
+
+        if (state == State::kKey) {
+            if (p_ == end_) {
+                Error(p_, "Unexpected end of input, expected an object key");
+                return Result();
+            }
+            if (*p_ != '"') {
+                Error(p_, *p_ == '}' && after_comma
+                              ? "Trailing comma before '}'"
+                              : "Unexpected " + Quoted(*p_) + ", expected a string object key");
+                return Result();
+            }
+            if (!ScanString()) {
+                return Result();
+            }
+            builder_.Key(string_begin_, string_end_, string_escaped_);
+            SkipWhitespace();
+            if (p_ == end_ || *p_ != ':') {
+                Error(p_, "Expected ':' after object key");
+                return Result();
+            }
+            ++p_;
+            state = State::kValue;
+            after_comma = false;
+            continue;
+        }
+
+        // kAfterValue
+        if (stack_.empty()) {
+            if (p_ != end_) {
+                Error(p_, "Unexpected " + Quoted(*p_) + " after the top-level value");
+            }
+            return Result();
+        }
+
+        Byte open = static_cast<Byte>(stack_.back());
+        if (p_ == end_) {
+            Error(p_, "Unexpected end of input, unclosed " + Quoted(open));
+            return Result();
+        }
+        if (*p_ == ',') {
+            ++p_;
+            state = open == '{' ? State::kKey : State::kValue;
+            after_comma = true;
+            continue;
+        }
+        if (*p_ == Closer(open)) {
+            ++p_;
+            stack_.pop_back();
+            builder_.Close(p_);
+            continue;
+        }
+        Error(p_, "Unexpected " + Quoted(*p_) + ", expected ',' or " + Quoted(Closer(open)));
+        return Result();
+    }
+}
+
+template <typename Builder>
+bool Scanner<Builder>::ScanString() {
+    const Byte* open = p_;
+    ++p_;
+    string_begin_ = p_;
+    string_escaped_ = false;
+
+    while (true) {
+        p_ += PlainStringRun(p_, end_);
+        if (p_ == end_) {
+            return Error(open, "Unterminated string");
+        }
+
+        Byte c = *p_;
+        if (c == '"') {
+            string_end_ = p_;
+            ++p_;
+            return true;
+        }
+
+        if (c == '\\') {
+            string_escaped_ = true;
+            if (end_ - p_ < 2) {
+                return Error(open, "Unterminated string");
+            }
+            switch (p_[1]) {
+                case '"':
+                case '\\':
+                case '/':
+                case 'b':
+                case 'f':
+                case 'n':
+                case 'r':
+                case 't':
+                    p_ += 2;
+                    break;
+                case 'u':
+                    if (end_ - p_ < 6 || !IsHexDigit(p_[2]) || !IsHexDigit(p_[3]) ||
+                        !IsHexDigit(p_[4]) || !IsHexDigit(p_[5])) {
+                        return Error(p_, "Invalid \\u escape, expected four hex digits");
+                    }
+                    p_ += 6;
+                    break;
+                default:
+                    return Error(p_, "Invalid escape sequence '\\" +
+                                         std::string(1, static_cast<char>(p_[1])) + "'");
+            }
+            continue;
+        }
+
+        if (c < 0x20) {
+            return Error(p_, c == '\n' ? "Unescaped newline in string"
+                                       : "Unescaped control character in string");
+        }
+
+        size_t length = Utf8SequenceLength(p_, end_);
+        if (length == 0) {
+            return Error(p_, "Invalid UTF-8 in string");
+        }
+        p_ += length;
+    }
+}
+
+template <typename Builder>
+bool Scanner<Builder>::ScanNumber() {
+    const Byte* start = p_;
+
+    if (*p_ == '-') {
+        ++p_;
+    }
+    if (p_ == end_ || !IsDigit(*p_)) {
+        return Error(start, "Invalid number");
+    }
+
+    if (*p_ == '0') {
+        ++p_;
+        if (p_ != end_ && IsDigit(*p_)) {
+            return Error(start, "Leading zeros are not allowed in numbers");
+        }
+    } else {
+        while (p_ != end_ && IsDigit(*p_)) {
+            ++p_;
+        }
+    }
+
+    if (p_ != end_ && *p_ == '.') {
+        ++p_;
+        if (p_ == end_ || !IsDigit(*p_)) {
+            return Error(p_, "Expected digits after the decimal point");
+        }
+        while (p_ != end_ && IsDigit(*p_)) {
+            ++p_;
+        }
+    }
+
+    if (p_ != end_ && (*p_ == 'e' || *p_ == 'E')) {
+        ++p_;
+        if (p_ != end_ && (*p_ == '+' || *p_ == '-')) {
+            ++p_;
+        }
+        if (p_ == end_ || !IsDigit(*p_)) {
+            return Error(p_, "Expected digits in the exponent");
+        }
+        while (p_ != end_ && IsDigit(*p_)) {
+            ++p_;
+        }
+    }
+
+    return true;
+}
+
+template <typename Builder>
+bool Scanner<Builder>::ScanLiteral(const char* literal, size_t length) {
+    if (static_cast<size_t>(end_ - p_) < length || std::memcmp(p_, literal, length) != 0) {
+        return Error(p_, "Invalid literal, expected '" + std::string(literal, length) + "'");
+    }
+    p_ += length;
+    return true;
+}
+
+template <typename Builder>
+ScanResult Scanner<Builder>::Result() const {
+    ScanResult result;
+    if (error_at_ == nullptr) {
+        return result;
+    }
+
+    result.valid = false;
+    result.message = error_message_;
+    result.offset = static_cast<size_t>(error_at_ - begin_);
+
+    // Positions are only needed on failure, so they are derived here instead of being
+    // tracked for every byte
+    result.line = 1 + static_cast<int>(std::count(begin_, error_at_, '\n'));
+    const Byte* line_start = error_at_;
+    while (line_start > begin_ && line_start[-1] != '\n') {
+        --line_start;
+    }
+    result.column = 1 + static_cast<int>(std::count_if(
+                            line_start, error_at_, [](Byte c) { return (c & 0xC0) != 0x80; }));
+    return result;
+}
+
+}  // anonymous namespace
+
+std::string ScanResult::Describe() const {
+    if (valid) {
+        return "";
+    }
+    return message + " at line " + std::to_string(line) + ", column " + std::to_string(column);
+}
+
+const Value* Value::Find(std::string_view key) const {
+    // Duplicate names are legal JSON; the last one wins, as in most parsers
+    for (auto it = members.rbegin(); it != members.rend(); ++it) {
+        if (it->first == key) {
+            return &it->second;
+        }
+    }
+    return nullptr;
+}
+
+ScanResult Validate(std::string_view json, size_t max_depth) {
+    NullBuilder builder;
+    return Scanner<NullBuilder>(json, max_depth, builder).Run();
+}
+
+ScanResult Parse(std::string_view json, Value& root, size_t max_depth) {
+    root = Value();
+    DomBuilder builder(root, json);
+    ScanResult result = Scanner<DomBuilder>(json, max_depth, builder).Run();
+    if (!result.valid) {
+        root = Value();
+    }
+    return result;
+}
+
+}  // namespace jsonscan
@@ -67,14 +67,15 @@ ConfigData DatabaseManager::GetLatestConfig(const std::string& service_name) {
     try {
         pqxx::work txn(*conn_);
 
-        pqxx::result r =
-            txn.exec_params("SELECT m.config_id, m.service_name, m.version, m.format, d.content, "
-                            "       m.created_at, m.created_by "
-                            "FROM config_metadata m "
-                            "JOIN config_data d ON m.config_id = d.config_id "
-                            "WHERE m.service_name = $1 "
-                            "ORDER BY m.version DESC LIMIT 1",
-                            service_name);
+        pqxx::result r = txn.exec_params(
+            "SELECT m.config_id, m.service_name, m.config_name, m.version, m.format, "
+            "       b.content, d.content_hash, m.created_at, m.created_by "
+            "FROM config_metadata m "
+            "JOIN config_data d ON m.config_id = d.config_id "
+            "JOIN config_blobs b ON b.content_hash = d.content_hash "
+            "WHERE m.service_name = $1 "
+            "ORDER BY m.version DESC LIMIT 1",
+            service_name);
 
         if (r.empty()) {
             // Return empty config
@@ -98,7 +99,8 @@ ConfigData DatabaseManager::GetLatestConfig(const std::string& service_name) {
     }
 }
 
-ConfigData DatabaseManager::GetLatestRolledOutConfig(const std::string& service_name) {
+ConfigData DatabaseManager::GetLatestRolledOutConfig(const std::string& service_name,
+                                                     const std::string& config_name) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     if (!initialized_) {
@@ -109,31 +111,35 @@ ConfigData DatabaseManager::GetLatestRolledOutConfig(const std::string& service_
         pqxx::work txn(*conn_);
 
         // Latest version that has a COMPLETED rollout
-        pqxx::result r =
-            txn.exec_params("SELECT m.config_id, m.service_name, m.version, m.format, d.content, "
-                            "       m.created_at, m.created_by "
-                            "FROM config_metadata m "
-                            "JOIN config_data d ON m.config_id = d.config_id "
-                            "JOIN rollout_state rs ON rs.config_id = m.config_id "
-                            "WHERE m.service_name = $1 AND rs.status = 'COMPLETED' "
-                            "ORDER BY m.version DESC LIMIT 1",
-                            service_name);
+        pqxx::result r = txn.exec_params(
+            "SELECT m.config_id, m.service_name, m.config_name, m.version, m.format, "
+            "       b.content, d.content_hash, m.created_at, m.created_by "
+            "FROM config_metadata m "
+            "JOIN config_data d ON m.config_id = d.config_id "
+            "JOIN config_blobs b ON b.content_hash = d.content_hash "
+            "JOIN rollout_state rs ON rs.config_id = m.config_id "
+            "WHERE m.service_name = $1 AND m.config_name = $2 "
+            "AND rs.status = 'COMPLETED' "
+            "ORDER BY m.version DESC LIMIT 1",
+            service_name, config_name);
 
         if (r.empty()) {
             // No completed rollout — fall back to absolute latest
             // (handles first-time setup before any rollout has been run)
             pqxx::result r2 = txn.exec_params(
-                "SELECT m.config_id, m.service_name, m.version, m.format, d.content, "
-                "       m.created_at, m.created_by "
+                "SELECT m.config_id, m.service_name, m.config_name, m.version, m.format, "
+                "       b.content, d.content_hash, m.created_at, m.created_by "
                 "FROM config_metadata m "
                 "JOIN config_data d ON m.config_id = d.config_id "
-                "WHERE m.service_name = $1 "
+                "JOIN config_blobs b ON b.content_hash = d.content_hash "
+                "WHERE m.service_name = $1 AND m.config_name = $2 "
                 "ORDER BY m.version DESC LIMIT 1",
-                service_name);
+                service_name, config_name);
 
             if (r2.empty()) {
                 ConfigData config;
                 config.set_service_name(service_name);
+                config.set_config_name(config_name);
                 config.set_version(0);
                 return config;
             }
@@ -145,8 +151,8 @@ ConfigData DatabaseManager::GetLatestRolledOutConfig(const std::string& service_
         auto result = ParseConfigRow(r[0]);
         txn.commit();
 
-        std::cout << "[DB] Latest rolled-out config: " << service_name << " v" << result.version()
-                  << std::endl;
+        std::cout << "[DB] Latest rolled-out config: " << service_name << "/"
+                  << result.config_name() << " v" << result.version() << std::endl;
         return result;
 
     } catch (const std::exception& e) {
@@ -155,6 +161,48 @@ ConfigData DatabaseManager::GetLatestRolledOutConfig(const std::string& service_
     }
 }
 
+std::vector<ConfigData> DatabaseManager::GetLatestRolledOutConfigs(
+    const std::string& service_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<ConfigData> configs;
+
+    if (!initialized_) {
+        throw std::runtime_error("Database not initialized");
+    }
+
+    try {
+        pqxx::work txn(*conn_);
+
+        // Versions are only ordered within one named config: per config_name, the latest
+        // version with a COMPLETED rollout, or the absolute latest if none has completed
+        pqxx::result r = txn.exec_params(
+            "SELECT DISTINCT ON (m.config_name) "
+            "       m.config_id, m.service_name, m.config_name, m.version, m.format, "
+            "       b.content, d.content_hash, m.created_at, m.created_by "
+            "FROM config_metadata m "
+            "JOIN config_data d ON m.config_id = d.config_id "
+            "JOIN config_blobs b ON b.content_hash = d.content_hash "
+            "LEFT JOIN rollout_state rs "
+            "       ON rs.config_id = m.config_id AND rs.status = 'COMPLETED' "
+            "WHERE m.service_name = $1 "
+            "ORDER BY m.config_name, (rs.config_id IS NOT NULL) DESC, m.version DESC",
+            service_name);
+
+        for (const auto& row : r) {
+            configs.push_back(ParseConfigRow(row));
+        }
+        txn.commit();
+
+        std::cout << "[DB] Latest rolled-out configs: " << service_name << " ("
+                  << configs.size() << " named configs)" << std::endl;
+        return configs;
+
+    } catch (const std::exception& e) {
+        std::cerr << "[DB] GetLatestRolledOutConfigs failed: " << e.what() << std::endl;
+        throw;
+    }
+}
+
 ConfigData DatabaseManager::GetConfigByVersion(const std::string& service_name, int64_t version) {
     std::lock_guard<std::mutex> lock(mutex_);
 
@@ -165,13 +213,14 @@ ConfigData DatabaseManager::GetConfigByVersion(const std::string& service_name,
     try {
         pqxx::work txn(*conn_);
 
-        pqxx::result r =
-            txn.exec_params("SELECT m.config_id, m.service_name, m.version, m.format, d.content, "
-                            "       m.created_at, m.created_by "
-                            "FROM config_metadata m "
-                            "JOIN config_data d ON m.config_id = d.config_id "
-                            "WHERE m.service_name = $1 AND m.version = $2",
-                            service_name, version);
+        pqxx::result r = txn.exec_params(
+            "SELECT m.config_id, m.service_name, m.config_name, m.version, m.format, "
+            "       b.content, d.content_hash, m.created_at, m.created_by "
+            "FROM config_metadata m "
+            "JOIN config_data d ON m.config_id = d.config_id "
+            "JOIN config_blobs b ON b.content_hash = d.content_hash "
+            "WHERE m.service_name = $1 AND m.version = $2",
+            service_name, version);
 
         if (r.empty()) {
             ConfigData config;
@@ -206,19 +255,21 @@ std::vector<ConfigData> DatabaseManager::ListConfigs(const std::string& service_
         if (service_name.empty()) {
             r = txn.exec_params(
                 "SELECT DISTINCT ON (m.service_name) "
-                "       m.config_id, m.service_name, m.version, m.format, d.content, "
-                "       m.created_at, m.created_by "
+                "       m.config_id, m.service_name, m.config_name, m.version, m.format, "
+                "       b.content, d.content_hash, m.created_at, m.created_by "
                 "FROM config_metadata m "
                 "JOIN config_data d ON m.config_id = d.config_id "
+                "JOIN config_blobs b ON b.content_hash = d.content_hash "
                 "ORDER BY m.service_name, m.version DESC "
                 "LIMIT $1",
                 limit);
         } else {
             r = txn.exec_params(
-                "SELECT m.config_id, m.service_name, m.version, m.format, d.content, "
-                "       m.created_at, m.created_by "
+                "SELECT m.config_id, m.service_name, m.config_name, m.version, m.format, "
+                "       b.content, d.content_hash, m.created_at, m.created_by "
                 "FROM config_metadata m "
                 "JOIN config_data d ON m.config_id = d.config_id "
+                "JOIN config_blobs b ON b.content_hash = d.content_hash "
                 "WHERE m.service_name = $1 "
                 "ORDER BY m.version DESC "
                 "LIMIT $2",
@@ -305,13 +356,14 @@ ConfigData DatabaseManager::GetConfigById(const std::string& config_id) {
     try {
         pqxx::work txn(*conn_);
 
-        pqxx::result r =
-            txn.exec_params("SELECT m.config_id, m.service_name, m.version, m.format, d.content, "
-                            "       m.created_at, m.created_by "
-                            "FROM config_metadata m "
-                            "JOIN config_data d ON m.config_id = d.config_id "
-                            "WHERE m.config_id = $1",
-                            config_id);
+        pqxx::result r = txn.exec_params(
+            "SELECT m.config_id, m.service_name, m.config_name, m.version, m.format, "
+            "       b.content, d.content_hash, m.created_at, m.created_by "
+            "FROM config_metadata m "
+            "JOIN config_data d ON m.config_id = d.config_id "
+            "JOIN config_blobs b ON b.content_hash = d.content_hash "
+            "WHERE m.config_id = $1",
+            config_id);
 
         if (r.empty()) {
             ConfigData config;
@@ -381,11 +433,13 @@ bool DatabaseManager::UpdateRolloutProgress(const std::string& config_id, int32_
 
         txn.exec_params(sql, config_id, current_pct, status);
 
-        // On successful completion, mark this config active and deactivate others
+        // On successful completion, mark this config active and deactivate the other
+        // versions of the same named config
         if (status == "COMPLETED") {
             txn.exec_params("UPDATE config_metadata SET is_active = false "
-                            "WHERE service_name = (SELECT service_name FROM config_metadata WHERE "
-                            "config_id = $1) "
+                            "WHERE (service_name, config_name) = "
+                            "      (SELECT service_name, config_name FROM config_metadata "
+                            "       WHERE config_id = $1) "
                             "AND config_id != $1",
                             config_id);
             txn.exec_params("UPDATE config_metadata SET is_active = true WHERE config_id = $1",
@@ -439,9 +493,11 @@ ConfigData DatabaseManager::ParseConfigRow(const pqxx::row& row) {
 
     config.set_config_id(row["config_id"].as<std::string>());
     config.set_service_name(row["service_name"].as<std::string>());
+    config.set_config_name(row["config_name"].as<std::string>());
     config.set_version(row["version"].as<int64_t>());
     config.set_format(row["format"].as<std::string>());
     config.set_content(row["content"].as<std::string>());
+    config.set_content_hash(row["content_hash"].as<std::string>(""));
 
     // Convert PostgreSQL TIMESTAMP to Unix timestamp
     if (!row["created_at"].is_null()) {
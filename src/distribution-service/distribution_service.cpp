@@ -112,23 +112,31 @@ grpc::Status DistributionServiceImpl::Subscribe(
 
     std::string service_name = initial_request.service_name();
     std::string instance_id = initial_request.instance_id();
-    int64_t current_version = initial_request.current_version();
-
-    std::cout << "[DistributionService] New subscription:" << std::endl;
-    std::cout << "  Service:  " << service_name << std::endl;
-    std::cout << "  Instance: " << instance_id << std::endl;
-    std::cout << "  Version:  " << current_version << std::endl;
 
     // Create client info
     auto client = std::make_shared<ClientInfo>();
     client->service_name = service_name;
     client->instance_id = instance_id;
-    client->current_version = current_version;
     client->context = context;
     client->stream = stream;
     client->last_heartbeat = std::chrono::steady_clock::now();
     client->active = true;
 
+    std::vector<ClientSubscription> subscriptions = AddSubscriptions(client, initial_request);
+
+    std::cout << "[DistributionService] New subscription:" << std::endl;
+    std::cout << "  Service:  " << service_name << std::endl;
+    std::cout << "  Instance: " << instance_id << std::endl;
+    for (const auto& sub : subscriptions) {
+        std::cout << "  Config:   " << sub.service_name << "/"
+                  << (sub.config_name.empty() ? "*" : sub.config_name);
+        if (sub.config_name.empty() && !sub.config_versions.empty()) {
+            std::cout << " (" << sub.config_versions.size() << " configs held)" << std::endl;
+        } else {
+            std::cout << " (v" << sub.current_version << ")" << std::endl;
+        }
+    }
+
     // Register client
     std::string client_key = service_name + ":" + instance_id;
     RegisterClient(client_key, client);
@@ -144,60 +152,67 @@ grpc::Status DistributionServiceImpl::Subscribe(
         events_->PublishClientConnect(service_name, instance_id);
     }
 
-    // Update client status in database
-    if (db_) {
-        db_->UpdateClientStatus(service_name, instance_id, current_version, "connected");
-    }
-
-    // Fetch and send config if needed
-    try {
-        auto start = std::chrono::steady_clock::now();
-        // Only send the latest *rolled-out* version on connect, not the latest uploaded.
-        // This ensures uploads don't bypass rollout strategies.
-        ConfigData config =
-            db_ ? db_->GetLatestRolledOutConfig(service_name) : FetchConfig(service_name, -1);
-        auto end = std::chrono::steady_clock::now();
-        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-
-        if (metrics_) {
-            metrics_->RecordConfigFetchTime(duration.count());
+    // Fetch and send configs if needed
+    bool synced = true;
+    for (const auto& sub : subscriptions) {
+        bool fetched = true;
+        if (!SendInitialConfig(client, sub, &fetched)) {
+            UnregisterClient(client_key);
+            if (metrics_)
+                metrics_->RecordConfigFailed();
+            return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to send config");
         }
+        synced = synced && fetched;
+    }
+    ReportClientStatus(instance_id, SnapshotSubscriptions(*client),
+                       SubscribedServices(subscriptions), "connected");
 
-        if (config.version() > current_version) {
-            if (!SendConfigToClient(client, config)) {
-                UnregisterClient(client_key);
-                if (metrics_)
-                    metrics_->RecordConfigFailed();
-                return grpc::Status(grpc::StatusCode::INTERNAL, "Failed to send config");
-            }
-
-            // Update client status
-            if (db_) {
-                db_->UpdateClientStatus(service_name, instance_id, config.version(), "connected");
-                db_->RecordConfigDelivery(service_name, instance_id, config.version());
-            }
+    // Tell the client its versions are now current, so it can stop waiting on start-up.
+    // Skipped when a lookup failed: the client then keeps serving its cache.
+    if (synced) {
+        ConfigUpdate sync_complete;
+        sync_complete.set_update_type(INITIAL_SYNC_COMPLETE);
 
-            // Publish event
-            if (events_) {
-                events_->PublishConfigUpdate(service_name, instance_id, config.version());
-            }
-        }
-    } catch (const std::exception& e) {
-        std::cerr << "[DistributionService] Error fetching config: " << e.what() << std::endl;
-        if (metrics_)
-            metrics_->RecordConfigFailed();
+        std::lock_guard<std::mutex> write_lock(client->write_mutex);
+        stream->Write(sync_complete);
     }
 
-    // Keep connection alive - handle heartbeats
+    // Keep connection alive - handle heartbeats and subscriptions added later
     SubscribeRequest request;
     while (client->active && stream->Read(&request)) {
         // Update last heartbeat
         client->last_heartbeat = std::chrono::steady_clock::now();
 
+        if (request.subscriptions_size() > 0) {
+            bool sent = true;
+            auto added = AddSubscriptions(client, request);
+            for (const auto& sub : added) {
+                if (!SendInitialConfig(client, sub)) {
+                    sent = false;
+                    break;
+                }
+            }
+            if (!sent) {
+                break;
+            }
+            ReportClientStatus(instance_id, SnapshotSubscriptions(*client),
+                               SubscribedServices(added), "connected");
+            continue;
+        }
+
         if (metrics_) {
             metrics_->RecordHeartbeat();
         }
 
+        // Newer clients report what they hold; refresh their status rows (and last_heartbeat)
+        if (request.held_versions_size() > 0) {
+            std::vector<ClientSubscription> held;
+            for (const auto& s : request.held_versions()) {
+                held.push_back(ParseSubscription(s, service_name));
+            }
+            ReportClientStatus(instance_id, held, SubscribedServices(held), "connected");
+        }
+
         // Send heartbeat ACK
         ConfigUpdate heartbeat;
         heartbeat.set_update_type(HEARTBEAT_ACK);
@@ -224,14 +239,98 @@ grpc::Status DistributionServiceImpl::Subscribe(
         events_->PublishClientDisconnect(service_name, instance_id);
     }
 
-    if (db_) {
-        db_->UpdateClientStatus(service_name, instance_id, client->current_version, "disconnected");
-    }
+    auto final_subscriptions = SnapshotSubscriptions(*client);
+    ReportClientStatus(instance_id, final_subscriptions, SubscribedServices(final_subscriptions),
+                       "disconnected");
 
     std::cout << "[DistributionService] Subscription ended: " << instance_id << std::endl;
     return grpc::Status::OK;
 }
 
+std::vector<ClientSubscription> DistributionServiceImpl::AddSubscriptions(
+    std::shared_ptr<ClientInfo> client, const SubscribeRequest& request) {
+    std::vector<ClientSubscription> requested;
+    if (request.subscriptions_size() == 0) {
+        // Single-config client: the top-level fields are the subscription
+        ClientSubscription sub;
+        sub.service_name = request.service_name();
+        sub.config_name = request.config_name();
+        sub.current_version = request.current_version();
+        requested.push_back(sub);
+    } else {
+        for (const auto& s : request.subscriptions()) {
+            requested.push_back(ParseSubscription(s, request.service_name()));
+        }
+    }
+
+    std::vector<ClientSubscription> added;
+    std::lock_guard<std::mutex> lock(client->subscriptions_mutex);
+    for (const auto& sub : requested) {
+        auto existing = std::find_if(
+            client->subscriptions.begin(), client->subscriptions.end(),
+            [&sub](const ClientSubscription& s) {
+                return s.service_name == sub.service_name && s.config_name == sub.config_name;
+            });
+        if (existing == client->subscriptions.end()) {
+            client->subscriptions.push_back(sub);
+            added.push_back(sub);
+        }
+    }
+    return added;
+}
+
+bool DistributionServiceImpl::SendInitialConfig(std::shared_ptr<ClientInfo> client,
+                                                const ClientSubscription& sub, bool* fetched) {
+    try {
+        auto start = std::chrono::steady_clock::now();
+        // Only send the latest *rolled-out* version on connect, not the latest uploaded.
+        // This ensures uploads don't bypass rollout strategies. A whole-service subscription
+        // gets the latest of each named config: versions of different configs don't compare.
+        std::vector<ConfigData> configs;
+        if (!db_) {
+            configs.push_back(FetchConfig(sub.service_name, -1));
+        } else if (sub.config_name.empty()) {
+            configs = db_->GetLatestRolledOutConfigs(sub.service_name);
+        } else {
+            configs.push_back(db_->GetLatestRolledOutConfig(sub.service_name, sub.config_name));
+        }
+        auto end = std::chrono::steady_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
+
+        if (metrics_) {
+            metrics_->RecordConfigFetchTime(duration.count());
+        }
+
+        for (const auto& config : configs) {
+            if (config.version() <= HeldVersion(sub, config.config_name())) {
+                continue;
+            }
+            if (!SendConfigToClient(client, config)) {
+                return false;
+            }
+
+            if (db_) {
+                db_->RecordConfigDelivery(sub.service_name, client->instance_id,
+                                          config.version());
+            }
+
+            // Publish event
+            if (events_) {
+                events_->PublishConfigUpdate(sub.service_name, client->instance_id,
+                                             config.version());
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[DistributionService] Error fetching config: " << e.what() << std::endl;
+        if (metrics_)
+            metrics_->RecordConfigFailed();
+        if (fetched)
+            *fetched = false;
+    }
+
+    return true;
+}
+
 ConfigData DistributionServiceImpl::FetchConfig(const std::string& service_name, int64_t version) {
     ConfigData config;
 
@@ -294,14 +393,27 @@ bool DistributionServiceImpl::SendConfigToClient(std::shared_ptr<ClientInfo> cli
     ConfigUpdate update;
     *update.mutable_config() = config;
     update.set_update_type(NEW_CONFIG);
-    update.set_force_reload(config.version() > client->current_version);
+    update.set_force_reload(config.version() > SubscribedVersion(*client, config));
 
     std::lock_guard<std::mutex> write_lock(client->write_mutex);
     if (client->stream->Write(update)) {
-        std::cout << "[DistributionService] Sent config v" << config.version() << " to "
+        std::cout << "[DistributionService] Sent config " << config.service_name() << "/"
+                  << config.config_name() << " v" << config.version() << " to "
                   << client->instance_id << std::endl;
 
-        client->current_version = config.version();
+        {
+            std::lock_guard<std::mutex> lock(client->subscriptions_mutex);
+            for (auto& sub : client->subscriptions) {
+                if (!SubscriptionMatches(sub, config)) {
+                    continue;
+                }
+                if (sub.config_name.empty()) {
+                    sub.config_versions[config.config_name()] = config.version();
+                } else {
+                    sub.current_version = config.version();
+                }
+            }
+        }
 
         if (metrics_) {
             metrics_->RecordConfigSent();
@@ -502,11 +614,15 @@ void DistributionServiceImpl::RolloutConsumerLoop() {
             if (event_type == "config.rollout_started" || event_type == "config.rolled_back" ||
                 event_type == "config.rollout_promoted") {
                 std::string service_name = ExtractJsonString(payload, "service_name");
+                std::string config_name = ExtractJsonString(payload, "config_name");
                 int64_t version = ExtractJsonInt(payload, "version");
 
                 if (!service_name.empty() && version > 0) {
-                    // Reconstruct config_id (matches GenerateConfigId in api-service)
-                    std::string config_id = service_name + "-v" + std::to_string(version);
+                    // Reconstruct config_id (matches create_config_version, migration 012)
+                    std::string config_id =
+                        config_name.empty()
+                            ? service_name + "-v" + std::to_string(version)
+                            : service_name + "-" + config_name + "-v" + std::to_string(version);
                     std::cout << "[DistributionService] Rollout event received: " << event_type
                               << " config=" << config_id << std::endl;
                     // Run in a detached thread so the consumer loop is never blocked
@@ -528,13 +644,20 @@ void DistributionServiceImpl::RolloutConsumerLoop() {
 
 // ─── Rollout execution ────────────────────────────────────────────────────────
 
-std::vector<std::shared_ptr<ClientInfo>> DistributionServiceImpl::GetClientsForService(
-    const std::string& service_name) {
+std::vector<std::shared_ptr<ClientInfo>> DistributionServiceImpl::GetClientsForConfig(
+    const ConfigData& config) {
     std::lock_guard<std::mutex> lock(clients_mutex_);
     std::vector<std::shared_ptr<ClientInfo>> result;
     for (auto& [key, client] : active_clients_) {
-        if (client->service_name == service_name && client->active) {
-            result.push_back(client);
+        if (!client->active) {
+            continue;
+        }
+        std::lock_guard<std::mutex> sub_lock(client->subscriptions_mutex);
+        for (const auto& sub : client->subscriptions) {
+            if (SubscriptionMatches(sub, config)) {
+                result.push_back(client);
+                break;
+            }
         }
     }
     // Sort by instance_id for deterministic canary/percentage selection
@@ -572,7 +695,7 @@ void DistributionServiceImpl::ExecuteRollout(const std::string& service_name,
         return;
     }
 
-    auto clients = GetClientsForService(service_name);
+    auto clients = GetClientsForConfig(config);
     size_t total = clients.size();
 
     if (total == 0) {
@@ -582,6 +705,7 @@ void DistributionServiceImpl::ExecuteRollout(const std::string& service_name,
         // ALL_AT_ONCE / PERCENTAGE with 0 clients: complete trivially (nothing to push)
         if (rollout.strategy != 1) {
             db_->UpdateRolloutProgress(config_id, 100, "COMPLETED");
+            InvalidateApiReadCache(service_name);
         }
         return;
     }
@@ -642,16 +766,15 @@ void DistributionServiceImpl::ExecuteRollout(const std::string& service_name,
     size_t pushed = 0;
     for (size_t i = 0; i < target_count && i < clients.size(); ++i) {
         // Skip clients that already have this version or newer
-        if (clients[i]->current_version >= config.version()) {
+        if (SubscribedVersion(*clients[i], config) >= config.version()) {
             pushed++;  // count as delivered — they already have it
             continue;
         }
         if (SendConfigToClient(clients[i], config)) {
-            clients[i]->current_version = config.version();
             pushed++;
             if (db_) {
-                db_->UpdateClientStatus(service_name, clients[i]->instance_id, config.version(),
-                                        "connected");
+                ReportClientStatus(clients[i]->instance_id, SnapshotSubscriptions(*clients[i]),
+                                   {config.service_name()}, "connected");
                 db_->RecordConfigDelivery(service_name, clients[i]->instance_id, config.version());
             }
             if (events_) {
@@ -675,11 +798,103 @@ void DistributionServiceImpl::ExecuteRollout(const std::string& service_name,
     }
 
     db_->UpdateRolloutProgress(config_id, current_pct, new_status);
+    InvalidateApiReadCache(config.service_name());
 
     std::cout << "[DistributionService] ✓ Rollout executed: " << pushed << "/" << total
               << " instances updated (" << current_pct << "%) status=" << new_status << std::endl;
 }
 
+void DistributionServiceImpl::InvalidateApiReadCache(const std::string& service_name) {
+    // Same key as apiservice::CacheManager::GenerationKey
+    if (cache_ && !service_name.empty()) {
+        cache_->IncrementCounter("api:gen:" + service_name);
+    }
+}
+
+// ─── Subscription utilities ───────────────────────────────────────────────────
+
+bool DistributionServiceImpl::SubscriptionMatches(const ClientSubscription& sub,
+                                                  const ConfigData& config) {
+    return sub.service_name == config.service_name() &&
+           (sub.config_name.empty() || sub.config_name == config.config_name());
+}
+
+ClientSubscription DistributionServiceImpl::ParseSubscription(const ConfigSubscription& s,
+                                                             const std::string& default_service) {
+    ClientSubscription sub;
+    sub.service_name = s.service_name().empty() ? default_service : s.service_name();
+    sub.config_name = s.config_name();
+    sub.current_version = s.current_version();
+    if (sub.config_name.empty()) {
+        sub.config_versions.insert(s.config_versions().begin(), s.config_versions().end());
+    }
+    return sub;
+}
+
+int64_t DistributionServiceImpl::HeldVersion(const ClientSubscription& sub,
+                                             const std::string& config_name) {
+    if (sub.config_name.empty()) {
+        auto it = sub.config_versions.find(config_name);
+        if (it != sub.config_versions.end()) {
+            return it->second;
+        }
+    }
+    return sub.current_version;
+}
+
+int64_t DistributionServiceImpl::SubscribedVersion(ClientInfo& client, const ConfigData& config) {
+    // Lowest version of this named config held by any subscription it belongs to
+    std::lock_guard<std::mutex> lock(client.subscriptions_mutex);
+    int64_t version = -1;
+    for (const auto& sub : client.subscriptions) {
+        if (!SubscriptionMatches(sub, config)) {
+            continue;
+        }
+        int64_t held = HeldVersion(sub, config.config_name());
+        if (version < 0 || held < version) {
+            version = held;
+        }
+    }
+    return version < 0 ? 0 : version;
+}
+
+std::vector<ClientSubscription> DistributionServiceImpl::SnapshotSubscriptions(
+    ClientInfo& client) {
+    std::lock_guard<std::mutex> lock(client.subscriptions_mutex);
+    return client.subscriptions;
+}
+
+std::set<std::string> DistributionServiceImpl::SubscribedServices(
+    const std::vector<ClientSubscription>& subs) {
+    std::set<std::string> services;
+    for (const auto& sub : subs) {
+        services.insert(sub.service_name);
+    }
+    return services;
+}
+
+void DistributionServiceImpl::ReportClientStatus(const std::string& instance_id,
+                                                 const std::vector<ClientSubscription>& held,
+                                                 const std::set<std::string>& services,
+                                                 const std::string& status) {
+    if (!db_) {
+        return;
+    }
+    for (const auto& service_name : services) {
+        int64_t version = 0;
+        for (const auto& sub : held) {
+            if (sub.service_name != service_name) {
+                continue;
+            }
+            version = std::max(version, sub.current_version);
+            for (const auto& [config_name, config_version] : sub.config_versions) {
+                version = std::max(version, config_version);
+            }
+        }
+        db_->UpdateClientStatus(service_name, instance_id, version, status);
+    }
+}
+
 // ─── JSON utilities ───────────────────────────────────────────────────────────
 
 std::string DistributionServiceImpl::ExtractJsonString(const std::string& json,
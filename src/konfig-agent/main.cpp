@@ -0,0 +1,147 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "configclient/config_client.h"
+#include "configclient/disk_cache.h"
+#include "configclient/shm_config_store.h"
+
+using configservice::ConfigClient;
+using configservice::ConfigData;
+using configservice::DiskCache;
+using configservice::ShmConfigPublisher;
+
+std::atomic<bool> keep_running(true);
+
+void SignalHandler(int signal) {
+    std::cout << "\nReceived signal " << signal << ", shutting down..." << std::endl;
+    keep_running = false;
+}
+
+namespace {
+
+void PrintUsage(const char* program) {
+    std::cerr << "Usage: " << program
+              << " <server_address> <shm_name> <service[/config_name]> [...]" << std::endl;
+    std::cerr << "Example: " << program
+              << " localhost:8082 /konfig payment-service/database-config global/default"
+              << std::endl;
+}
+
+// "service/config" -> (service, config); "service" -> (service, "") = every config, each
+// published under its own name
+std::pair<std::string, std::string> ParseSubscription(const std::string& arg) {
+    auto slash = arg.find('/');
+    if (slash == std::string::npos) {
+        return {arg, ""};
+    }
+    return {arg.substr(0, slash), arg.substr(slash + 1)};
+}
+
+std::string AgentInstanceId() {
+    char hostname[256] = {};
+    if (gethostname(hostname, sizeof(hostname) - 1) != 0 || hostname[0] == '\0') {
+        return "konfig-agent-" + std::to_string(getpid());
+    }
+    return std::string("konfig-agent-") + hostname;
+}
+
+}  // anonymous namespace
+
+int main(int argc, char** argv) {
+    // Setup signal handlers
+    std::signal(SIGINT, SignalHandler);
+    std::signal(SIGTERM, SignalHandler);
+
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+    std::cout << "  Konfig Agent (local shared-memory config sidecar)" << std::endl;
+    std::cout << "  Version: 1.0.0" << std::endl;
+    std::cout << "━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━" << std::endl;
+    std::cout << std::endl;
+
+    if (argc < 4) {
+        PrintUsage(argv[0]);
+        return 1;
+    }
+
+    std::string server_address = argv[1];
+    std::string shm_name = argv[2];
+
+    std::vector<std::pair<std::string, std::string>> subscriptions;
+    for (int i = 3; i < argc; ++i) {
+        auto sub = ParseSubscription(argv[i]);
+        if (sub.first.empty()) {
+            std::cerr << "Invalid subscription: " << argv[i] << std::endl;
+            PrintUsage(argv[0]);
+            return 1;
+        }
+        subscriptions.push_back(sub);
+    }
+
+    ShmConfigPublisher publisher(shm_name);
+    if (!publisher.Initialize()) {
+        std::cerr << "Failed to initialize shared memory " << shm_name << std::endl;
+        return 1;
+    }
+
+    // Serve the last known configs from disk before the upstream stream is up,
+    // so local readers have a value even when the distribution tier is down.
+    {
+        DiskCache cache;
+        for (const auto& [service_name, config_name] : subscriptions) {
+            std::vector<std::string> names = {config_name};
+            if (config_name.empty()) {
+                names = cache.ListConfigNames(service_name);
+            }
+            for (const auto& name : names) {
+                ConfigData cached;
+                if (cache.Load(service_name, cached, name)) {
+                    publisher.Publish(service_name, name, cached);
+                }
+            }
+        }
+    }
+
+    // One upstream stream carries every subscription
+    ConfigClient client(server_address, "konfig-agent", AgentInstanceId());
+
+    for (const auto& [service_name, config_name] : subscriptions) {
+        std::string svc = service_name;
+        std::string cfg = config_name;
+        client.Subscribe(svc, cfg, [&publisher, svc, cfg](const ConfigData& config) {
+            publisher.Publish(svc, cfg.empty() ? config.config_name() : cfg, config);
+        });
+    }
+
+    if (!client.Start()) {
+        std::cerr << "Failed to start upstream client" << std::endl;
+        return 1;
+    }
+
+    std::cout << "✓ Agent publishing " << subscriptions.size() << " subscription(s) to "
+              << shm_name << std::endl;
+    std::cout << "✓ Upstream: " << server_address << std::endl;
+    std::cout << "✓ Press Ctrl+C to stop" << std::endl;
+    std::cout << std::endl;
+
+    // Keep the liveness timestamp fresh so readers can detect a dead agent
+    while (keep_running) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        publisher.Heartbeat();
+    }
+
+    client.Stop();
+
+    // Leave the segment in place: attached readers keep serving the last known configs
+    publisher.Shutdown();
+
+    std::cout << "Agent stopped" << std::endl;
+    return 0;
+}
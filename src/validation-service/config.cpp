@@ -46,6 +46,29 @@ ServiceConfig ServiceConfig::LoadFromFile(const std::string& path) {
             config.validation.timeout_seconds = val["timeout_seconds"].as<int>(5);
             config.validation.enable_caching = val["enable_caching"].as<bool>(true);
             config.validation.strict_mode = val["strict_mode"].as<bool>(false);
+            config.validation.schema_cache_ttl_seconds =
+                val["schema_cache_ttl_seconds"].as<int>(300);
+            config.validation.rules_version_check_ms = val["rules_version_check_ms"].as<int>(1000);
+            config.validation.yaml_stream_threshold_bytes =
+                val["yaml_stream_threshold_bytes"].as<size_t>(262144);
+            config.validation.yaml_max_depth = val["yaml_max_depth"].as<size_t>(512);
+            config.validation.yaml_max_alias_nodes =
+                val["yaml_max_alias_nodes"].as<size_t>(100000);
+            config.validation.incremental_cache_mb = val["incremental_cache_mb"].as<int>(128);
+            config.validation.incremental_min_bytes =
+                val["incremental_min_bytes"].as<size_t>(65536);
+            config.validation.result_cache_max_mb = val["result_cache_max_mb"].as<int>(64);
+            config.validation.batch_workers = val["batch_workers"].as<int>(0);
+        }
+
+        if (yaml["history"]) {
+            auto history = yaml["history"];
+            config.history.enabled = history["enabled"].as<bool>(true);
+            config.history.sample_rate = history["sample_rate"].as<double>(1.0);
+            config.history.flush_interval_ms = history["flush_interval_ms"].as<int>(1000);
+            config.history.batch_size = history["batch_size"].as<size_t>(500);
+            config.history.queue_max_mb = history["queue_max_mb"].as<int>(64);
+            config.history.retention_days = history["retention_days"].as<int>(30);
         }
 
         std::cout << "[Config] Loaded from: " << path << std::endl;
@@ -1,5 +1,6 @@
 #include "validation_service/database_manager.h"
 
+#include <chrono>
 #include <ctime>
 #include <iostream>
 #include <sstream>
@@ -49,6 +50,11 @@ bool DatabaseManager::Initialize() {
 }
 
 void DatabaseManager::Shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(history_mutex_);
+        history_conn_.reset();
+    }
+
     std::lock_guard<std::mutex> lock(mutex_);
     conn_.reset();
     initialized_ = false;
@@ -89,7 +95,8 @@ std::pair<bool, std::string> DatabaseManager::RegisterSchema(
     }
 }
 
-configservice::ValidationSchema DatabaseManager::GetSchema(const std::string& schema_id) {
+std::optional<configservice::ValidationSchema> DatabaseManager::GetSchema(
+    const std::string& schema_id) {
     std::lock_guard<std::mutex> lock(mutex_);
 
     configservice::ValidationSchema schema;
@@ -127,7 +134,7 @@ configservice::ValidationSchema DatabaseManager::GetSchema(const std::string& sc
 
     } catch (const std::exception& e) {
         std::cerr << "[DB] GetSchema failed: " << e.what() << std::endl;
-        return schema;
+        return std::nullopt;
     }
 }
 
@@ -196,33 +203,78 @@ std::vector<configservice::ValidationSchema> DatabaseManager::ListSchemas(
     }
 }
 
-void DatabaseManager::RecordValidation(const std::string& service_name, const std::string& content,
-                                       bool result, const std::string& errors,
-                                       const std::string& warnings,
-                                       const std::string& validated_by) {
-    std::lock_guard<std::mutex> lock(mutex_);
+bool DatabaseManager::RecordValidations(const std::vector<HistoryRecord>& records) {
+    std::lock_guard<std::mutex> lock(history_mutex_);
 
-    if (!initialized_) {
-        return;
+    try {
+        if (!history_conn_ || !history_conn_->is_open()) {
+            history_conn_ = std::make_unique<pqxx::connection>(BuildConnectionString());
+        }
+
+        pqxx::work txn(*history_conn_);
+
+        // Bodies first: rows reference them by hash. An existing blob is key-share locked, as
+        // uploads do, so the API service's cleanup of a deleted config cannot drop it meanwhile.
+        for (const auto& record : records) {
+            if (record.content) {
+                txn.exec_params("WITH existing AS ("
+                                "  SELECT 1 FROM config_blobs WHERE content_hash = $1 "
+                                "  FOR KEY SHARE) "
+                                "INSERT INTO config_blobs (content_hash, content, size_bytes) "
+                                "SELECT $1, $2, $3 WHERE NOT EXISTS (SELECT 1 FROM existing) "
+                                "ON CONFLICT (content_hash) DO NOTHING",
+                                record.content_hash, *record.content,
+                                static_cast<int64_t>(record.content->size()));
+            }
+        }
+
+        for (const auto& record : records) {
+            double validated_at =
+                std::chrono::duration<double>(record.validated_at.time_since_epoch()).count();
+            txn.exec_params("INSERT INTO validation_history "
+                            "  (service_name, content_hash, validation_result, errors, "
+                            "   warnings, validated_at, validated_by, repeat_count) "
+                            "VALUES ($1, $2, $3, $4, $5, to_timestamp($6)::timestamp, $7, $8)",
+                            record.service_name, record.content_hash, record.result,
+                            record.errors, record.warnings, validated_at, record.validated_by,
+                            record.repeat_count);
+        }
+
+        txn.commit();
+        return true;
+
+    } catch (const std::exception& e) {
+        std::cerr << "[DB] RecordValidations failed: " << e.what() << std::endl;
+        history_conn_.reset();
+        return false;
     }
+}
+
+int64_t DatabaseManager::PruneValidationHistory(int retention_days, int batch_size) {
+    std::lock_guard<std::mutex> lock(history_mutex_);
 
     try {
-        pqxx::work txn(*conn_);
+        if (!history_conn_ || !history_conn_->is_open()) {
+            history_conn_ = std::make_unique<pqxx::connection>(BuildConnectionString());
+        }
+
+        pqxx::work txn(*history_conn_);
 
-        txn.exec_params("INSERT INTO validation_history "
-                        "  (service_name, config_content, validation_result, "
-                        "   errors, warnings, validated_at, validated_by) "
-                        "VALUES ($1, $2, $3, $4, $5, NOW(), $6)",
-                        service_name, content, result, errors, warnings, validated_by);
+        pqxx::result r = txn.exec_params("SELECT prune_validation_history($1, $2)",
+                                         retention_days, batch_size);
 
         txn.commit();
 
+        return r[0][0].as<int64_t>();
+
     } catch (const std::exception& e) {
-        std::cerr << "[DB] RecordValidation failed: " << e.what() << std::endl;
+        std::cerr << "[DB] PruneValidationHistory failed: " << e.what() << std::endl;
+        history_conn_.reset();
+        return -1;
     }
 }
 
-std::vector<DatabaseManager::ValidationRule> DatabaseManager::GetRulesForService(
+std::optional<std::vector<ValidationRule>> DatabaseManager::GetRulesForService(
     const std::string& service_name) {
     std::lock_guard<std::mutex> lock(mutex_);
 
@@ -256,7 +308,27 @@ std::vector<DatabaseManager::ValidationRule> DatabaseManager::GetRulesForService
 
     } catch (const std::exception& e) {
         std::cerr << "[DB] GetRulesForService failed: " << e.what() << std::endl;
-        return rules;
+        return std::nullopt;
+    }
+}
+
+int64_t DatabaseManager::GetRuleSetVersion(const std::string& service_name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    try {
+        pqxx::work txn(*conn_);
+
+        pqxx::result r = txn.exec_params(
+            "SELECT version FROM validation_rule_versions WHERE service_name = $1",
+            service_name);
+
+        txn.commit();
+
+        return r.empty() ? 0 : r[0][0].as<int64_t>();
+
+    } catch (const std::exception& e) {
+        std::cerr << "[DB] GetRuleSetVersion failed: " << e.what() << std::endl;
+        return -1;
     }
 }
 
@@ -0,0 +1,211 @@
+#include "validation_service/history_recorder.h"
+
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+namespace validationservice {
+
+namespace {
+
+// Known bodies are sent again after this long, so a blob pruned with old history is never
+// referenced by a new row without its content
+constexpr auto kKnownBlobTtl = std::chrono::minutes(10);
+constexpr size_t kMaxKnownBlobs = 100000;
+
+constexpr auto kPruneInterval = std::chrono::hours(1);
+constexpr int kPruneBatchSize = 10000;
+
+// Validations that would produce the same row
+std::string FoldKey(const std::string& service_name, const std::string& content_hash,
+                    bool result, const std::string& errors, const std::string& warnings,
+                    const std::string& validated_by) {
+    std::string key;
+    key.reserve(service_name.size() + content_hash.size() + errors.size() + warnings.size() +
+                validated_by.size() + 8);
+    key += service_name;
+    key += '\0';
+    key += content_hash;
+    key += '\0';
+    key += result ? '+' : '-';
+    key += '\0';
+    key += errors;
+    key += '\0';
+    key += warnings;
+    key += '\0';
+    key += validated_by;
+    return key;
+}
+
+bool Sampled(double rate) {
+    thread_local std::mt19937_64 engine{std::random_device{}()};
+    return std::uniform_real_distribution<double>(0.0, 1.0)(engine) < rate;
+}
+
+}  // anonymous namespace
+
+HistoryRecorder::HistoryRecorder(const HistoryConfig& config, Writer write, Pruner prune)
+    : config_(config), write_(std::move(write)), prune_(std::move(prune)) {}
+
+HistoryRecorder::~HistoryRecorder() {
+    Stop();
+}
+
+void HistoryRecorder::Start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_ || !config_.enabled) {
+        return;
+    }
+    running_ = true;
+    worker_ = std::thread(&HistoryRecorder::Run, this);
+}
+
+void HistoryRecorder::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return;
+        }
+        running_ = false;
+    }
+    wake_.notify_all();
+    worker_.join();
+}
+
+HistoryRecorder::Outcome HistoryRecorder::Record(const std::string& service_name,
+                                                 const std::string& content,
+                                                 const std::string& content_hash, bool result,
+                                                 const std::string& errors,
+                                                 const std::string& warnings,
+                                                 const std::string& validated_by) {
+    if (!config_.enabled) {
+        return Outcome::kDisabled;
+    }
+    if (result && config_.sample_rate < 1.0 && !Sampled(config_.sample_rate)) {
+        return Outcome::kSampledOut;
+    }
+
+    std::string key =
+        FoldKey(service_name, content_hash, result, errors, warnings, validated_by);
+    auto validated_at = std::chrono::system_clock::now();
+    auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!running_) {
+        return Outcome::kDropped;
+    }
+
+    auto folded = pending_index_.find(key);
+    if (folded != pending_index_.end()) {
+        HistoryRecord& record = pending_[folded->second];
+        ++record.repeat_count;
+        record.validated_at = validated_at;
+        return Outcome::kMerged;
+    }
+
+    bool needs_body = !pending_blobs_.count(content_hash) && !KnownBlob(content_hash, now);
+    size_t bytes = key.size() + (needs_body ? content.size() : 0);
+    if (pending_bytes_ + bytes > static_cast<size_t>(config_.queue_max_mb) * 1024 * 1024) {
+        return Outcome::kDropped;
+    }
+
+    HistoryRecord record;
+    record.service_name = service_name;
+    record.content_hash = content_hash;
+    if (needs_body) {
+        record.content = std::make_shared<const std::string>(content);
+        pending_blobs_.insert(content_hash);
+    }
+    record.result = result;
+    record.errors = errors;
+    record.warnings = warnings;
+    record.validated_by = validated_by;
+    record.validated_at = validated_at;
+
+    pending_index_.emplace(std::move(key), pending_.size());
+    pending_.push_back(std::move(record));
+    pending_bytes_ += bytes;
+
+    if (pending_.size() >= config_.batch_size) {
+        wake_.notify_one();
+    }
+    return Outcome::kQueued;
+}
+
+void HistoryRecorder::Run() {
+    auto interval = std::chrono::milliseconds(config_.flush_interval_ms);
+    auto next_prune = std::chrono::steady_clock::now() + std::chrono::minutes(1);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+        wake_.wait_for(lock, interval,
+                       [this] { return !running_ || pending_.size() >= config_.batch_size; });
+
+        std::vector<HistoryRecord> batch;
+        batch.swap(pending_);
+        pending_index_.clear();
+        pending_blobs_.clear();
+        pending_bytes_ = 0;
+        bool stopping = !running_;
+        lock.unlock();
+
+        if (!batch.empty()) {
+            Flush(std::move(batch));
+        }
+
+        auto now = std::chrono::steady_clock::now();
+        if (!stopping && config_.retention_days > 0 && now >= next_prune) {
+            int64_t pruned = 0;
+            int64_t deleted = 0;
+            do {
+                deleted = prune_(config_.retention_days, kPruneBatchSize);
+                pruned += std::max<int64_t>(deleted, 0);
+            } while (deleted == kPruneBatchSize);
+
+            if (pruned > 0) {
+                std::cout << "[History] Pruned " << pruned << " validation records older than "
+                          << config_.retention_days << " days" << std::endl;
+            }
+            next_prune = now + kPruneInterval;
+        }
+
+        lock.lock();
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void HistoryRecorder::Flush(std::vector<HistoryRecord> batch) {
+    if (!write_(batch)) {
+        std::cerr << "[History] ✗ Dropped " << batch.size()
+                  << " validation records (write failed)" << std::endl;
+        return;
+    }
+
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (known_blobs_.size() > kMaxKnownBlobs) {
+        known_blobs_.clear();
+    }
+    for (const auto& record : batch) {
+        if (record.content) {
+            known_blobs_[record.content_hash] = now;
+        }
+    }
+}
+
+bool HistoryRecorder::KnownBlob(const std::string& content_hash,
+                                std::chrono::steady_clock::time_point now) {
+    auto known = known_blobs_.find(content_hash);
+    if (known == known_blobs_.end()) {
+        return false;
+    }
+    if (now - known->second >= kKnownBlobTtl) {
+        known_blobs_.erase(known);
+        return false;
+    }
+    return true;
+}
+
+}  // namespace validationservice
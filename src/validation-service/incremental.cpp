@@ -0,0 +1,541 @@
+#include "validation_service/incremental.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string_view>
+
+namespace validationservice {
+
+namespace {
+
+using jsonscan::Value;
+
+bool IsContainer(const Value& value) {
+    return value.type == Value::Type::kObject || value.type == Value::Type::kArray;
+}
+
+// Heap memory held by a tree, approximately (allocator overhead is ignored)
+size_t HeapBytes(const Value& value) {
+    size_t bytes = value.string.capacity() + value.items.capacity() * sizeof(Value) +
+                   value.members.capacity() * sizeof(std::pair<std::string, Value>);
+    for (const auto& item : value.items) {
+        bytes += HeapBytes(item);
+    }
+    for (const auto& [key, member] : value.members) {
+        bytes += key.capacity() + HeapBytes(member);
+    }
+    return bytes;
+}
+
+size_t HeapBytes(const PassRecord& record) {
+    size_t bytes = record.errors.capacity() * sizeof(configservice::ValidationError);
+    for (const auto& error : record.errors) {
+        bytes += error.SpaceUsedLong() - sizeof(error);
+    }
+    bytes += record.verdicts.capacity() * sizeof(PassRecord::Verdict) +
+             record.latest.capacity() * sizeof(std::pair<uint32_t, uint32_t>);
+    // The base records are shared with other baselines; counting them for each keeps the
+    // cache within its bound
+    if (record.base) {
+        bytes += sizeof(PassRecord) + HeapBytes(*record.base) + sizeof(DocumentDiff) +
+                 record.diff->HeapBytes();
+    }
+    return bytes;
+}
+
+size_t Count(const Value& value) {
+    return value.is_array() ? value.items.size() : value.members.size();
+}
+
+const Value& Child(const Value& value, size_t i) {
+    return value.is_array() ? value.items[i] : value.members[i].second;
+}
+
+// Empty for array items
+std::string_view Key(const Value& value, size_t i) {
+    return value.is_array() ? std::string_view() : value.members[i].first;
+}
+
+// Index of the first child for which after() holds; it must hold for all children after it
+template <typename Predicate>
+size_t FirstChild(const Value& value, Predicate after) {
+    size_t low = 0;
+    size_t high = Count(value);
+    while (low < high) {
+        size_t middle = low + (high - low) / 2;
+        if (after(Child(value, middle))) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return low;
+}
+
+// Length of the common prefix, a block at a time while the blocks are equal
+size_t CommonPrefix(std::string_view a, std::string_view b) {
+    constexpr size_t kBlock = 256;
+    size_t common = std::min(a.size(), b.size());
+    size_t length = 0;
+    while (length + kBlock <= common && std::memcmp(a.data() + length, b.data() + length,
+                                                    kBlock) == 0) {
+        length += kBlock;
+    }
+    while (length < common && a[length] == b[length]) {
+        ++length;
+    }
+    return length;
+}
+
+// Length of the common suffix, at most limit
+size_t CommonSuffix(std::string_view a, std::string_view b, size_t limit) {
+    constexpr size_t kBlock = 256;
+    size_t length = 0;
+    while (length + kBlock <= limit &&
+           std::memcmp(a.data() + a.size() - length - kBlock,
+                       b.data() + b.size() - length - kBlock, kBlock) == 0) {
+        length += kBlock;
+    }
+    while (length < limit && a[a.size() - length - 1] == b[b.size() - length - 1]) {
+        ++length;
+    }
+    return length;
+}
+
+uint32_t Number(Value& value, uint32_t next) {
+    value.begin = next++;
+    for (auto& item : value.items) {
+        next = Number(item, next);
+    }
+    for (auto& member : value.members) {
+        next = Number(member.second, next);
+    }
+    value.end = next;
+    return next;
+}
+
+}  // anonymous namespace
+
+// ─── PositionIndex ──────────────────────────────────────────────────
+
+void PositionIndex::Reserve(size_t count) {
+    // At most half full
+    size_t capacity = 16;
+    while (capacity < 2 * count) {
+        capacity *= 2;
+    }
+    if (capacity <= slots_.size()) {
+        return;
+    }
+
+    std::vector<std::pair<uint32_t, uint32_t>> old(capacity, {kNone, kNone});
+    old.swap(slots_);
+    for (const auto& [position, index] : old) {
+        if (position != kNone) {
+            slots_[Slot(position)] = {position, index};
+        }
+    }
+}
+
+uint32_t& PositionIndex::operator[](uint32_t position) {
+    if (2 * (size_ + 1) > slots_.size()) {
+        Reserve(size_ + 1);
+    }
+    size_t slot = Slot(position);
+    if (slots_[slot].first == kNone) {
+        slots_[slot].first = position;
+        ++size_;
+    }
+    return slots_[slot].second;
+}
+
+uint32_t PositionIndex::Find(uint32_t position) const {
+    return slots_.empty() ? kNone : slots_[Slot(position)].second;
+}
+
+// position's slot, or the empty one where it would go (linear probing)
+size_t PositionIndex::Slot(uint32_t position) const {
+    size_t mask = slots_.size() - 1;
+    size_t slot = (position * 0x9E3779B97F4A7C15ull) >> 32 & mask;
+    while (slots_[slot].first != kNone && slots_[slot].first != position) {
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+void AssignPositions(Value& document) {
+    Number(document, 0);
+}
+
+// ─── PassRecord ─────────────────────────────────────────────────────
+
+void PassRecord::Add(uint32_t position, const Verdict& verdict) {
+    uint32_t& latest_on_value = latest[position];
+    verdicts.push_back(verdict);
+    verdicts.back().next = latest_on_value;
+    latest_on_value = static_cast<uint32_t>(verdicts.size() - 1);
+}
+
+uint32_t PassRecord::First(uint32_t position) const {
+    return latest.Find(position);
+}
+
+const PassRecord::Verdict* PassRecord::Find(uint32_t begin, uint32_t end, int step,
+                                            uint32_t depth, const PassRecord** owner) const {
+    for (const PassRecord* record = this;; record = record->base.get()) {
+        for (uint32_t i = record->First(begin); i != kNone; i = record->verdicts[i].next) {
+            const auto& verdict = record->verdicts[i];
+            if (verdict.step == step && verdict.depth == depth) {
+                *owner = record;
+                return &verdict;
+            }
+        }
+        uint32_t base_begin;
+        if (!record->base || !record->diff->Map(begin, end, &base_begin)) {
+            return nullptr;
+        }
+        end = base_begin + (end - begin);
+        begin = base_begin;
+    }
+}
+
+// ─── DocumentDiff ───────────────────────────────────────────────────
+
+DocumentDiff::DocumentDiff(const Value& document, std::string_view text, const Value& base,
+                           std::string_view base_text) {
+    if (text.size() >= UINT32_MAX || base_text.size() >= UINT32_MAX) {
+        return;  // Parse() left the positions unset
+    }
+
+    size_t prefix = CommonPrefix(text, base_text);
+    size_t suffix = CommonSuffix(text, base_text, std::min(text.size(), base_text.size()) - prefix);
+    prefix_ = static_cast<uint32_t>(prefix);
+    changed_end_ = static_cast<uint32_t>(text.size() - suffix);
+    shift_ = static_cast<int64_t>(text.size()) - static_cast<int64_t>(base_text.size());
+
+    if (!IsContainer(document) || document.type != base.type || document.end <= prefix_) {
+        return;
+    }
+    if (document.begin >= changed_end_) {
+        // Only what precedes the document changed
+        ranges_.push_back({document.begin, document.end, shift_});
+        return;
+    }
+    Descend(document, base);
+    std::sort(ranges_.begin(), ranges_.end(),
+              [](const Range& a, const Range& b) { return a.begin < b.begin; });
+}
+
+DocumentDiff::DocumentDiff(const Value& document, const Value& base) {
+    if (Compare(document, base) && IsContainer(document)) {
+        ranges_.push_back({document.begin, document.end,
+                           static_cast<int64_t>(document.begin) - base.begin});
+    }
+    std::sort(ranges_.begin(), ranges_.end(),
+              [](const Range& a, const Range& b) { return a.begin < b.begin; });
+}
+
+bool DocumentDiff::Map(uint32_t begin, uint32_t end, uint32_t* base_begin) const {
+    if (end <= prefix_) {
+        *base_begin = begin;
+        return true;
+    }
+    auto range = std::upper_bound(ranges_.begin(), ranges_.end(), begin,
+                                  [](uint32_t position, const Range& r) {
+                                      return position < r.begin;
+                                  });
+    if (range == ranges_.begin() || end > (--range)->end) {
+        return false;
+    }
+    *base_begin = static_cast<uint32_t>(begin - range->shift);
+    return true;
+}
+
+// value and base are containers of one type at the same path, and value's text overlaps the
+// edit. Its children ending before the edit are unchanged in place; after the edit, those
+// from the first one found at its shifted position in base (under the same key) on are
+// unchanged too, as both texts are then the same up to the end of both containers. Those
+// overlapping the edit are compared with their counterparts the same way.
+void DocumentDiff::Descend(const Value& value, const Value& base) {
+    size_t count = Count(value);
+    size_t base_count = Count(base);
+
+    // Items after an insertion or removal have moved to other indexes
+    size_t run = count;
+    if (!value.is_array() || count == base_count) {
+        run = FirstChild(value, [&](const Value& child) { return child.begin >= changed_end_; });
+    }
+    // The first child after the edit may still differ, by its key
+    for (size_t tries = 0; run < count; ++run) {
+        const Value& child = Child(value, run);
+        if (run + base_count >= count) {
+            size_t base_run = run + base_count - count;
+            const Value& base_child = Child(base, base_run);
+            if (child.begin == base_child.begin + shift_ && child.end == base_child.end + shift_ &&
+                Key(value, run) == Key(base, base_run)) {
+                ranges_.push_back({child.begin, Child(value, count - 1).end, shift_});
+                break;
+            }
+        }
+        if (++tries == 2) {
+            run = count;
+            break;
+        }
+    }
+
+    std::unordered_map<std::string_view, const Value*> by_key;
+    for (size_t i = FirstChild(value, [&](const Value& child) { return child.end > prefix_; });
+         i < run; ++i) {
+        const Value& child = Child(value, i);
+        // Those in between were moved (to another index, or after a changed key)
+        if (!IsContainer(child) || child.begin >= changed_end_ || child.end <= prefix_) {
+            continue;
+        }
+
+        const Value* counterpart = nullptr;
+        if (i < base_count && Key(value, i) == Key(base, i)) {
+            counterpart = &Child(base, i);
+        } else if (!value.is_array()) {
+            if (by_key.empty()) {
+                for (const auto& [base_key, base_member] : base.members) {
+                    by_key[base_key] = &base_member;
+                }
+            }
+            auto found = by_key.find(Key(value, i));
+            if (found != by_key.end()) {
+                counterpart = found->second;
+            }
+        }
+        if (counterpart && counterpart->type == child.type) {
+            Descend(child, *counterpart);
+        }
+    }
+}
+
+// True when both subtrees are equal. Equal containers below a difference are kept.
+bool DocumentDiff::Compare(const Value& value, const Value& base) {
+    if (value.type != base.type) {
+        return false;
+    }
+
+    // Equal child containers wait on pending_ until this one turns out to differ
+    size_t mark = pending_.size();
+    bool equal = true;
+    auto child = [&](const Value& member, const Value& base_member) {
+        if (!Compare(member, base_member)) {
+            return false;
+        }
+        if (IsContainer(member)) {
+            pending_.emplace_back(&member, &base_member);
+        }
+        return true;
+    };
+
+    switch (value.type) {
+        case Value::Type::kNull:
+            return true;
+        case Value::Type::kBool:
+            return value.boolean == base.boolean;
+        case Value::Type::kNumber:
+            return value.number == base.number && value.string == base.string;
+        case Value::Type::kString:
+            return value.string == base.string;
+        case Value::Type::kArray: {
+            equal = value.items.size() == base.items.size();
+            size_t common = std::min(value.items.size(), base.items.size());
+            for (size_t i = 0; i < common; ++i) {
+                equal = child(value.items[i], base.items[i]) && equal;
+            }
+            break;
+        }
+        case Value::Type::kObject: {
+            // Members usually keep their positions; the rest are looked up by name
+            equal = value.members.size() == base.members.size();
+            std::unordered_map<std::string_view, const Value*> by_key;
+            for (size_t i = 0; i < value.members.size(); ++i) {
+                const auto& [key, member] = value.members[i];
+                if (i < base.members.size() && base.members[i].first == key) {
+                    equal = child(member, base.members[i].second) && equal;
+                    continue;
+                }
+                equal = false;
+                if (by_key.empty()) {
+                    for (const auto& [base_key, base_member] : base.members) {
+                        by_key[base_key] = &base_member;
+                    }
+                }
+                auto found = by_key.find(key);
+                if (found != by_key.end()) {
+                    child(member, *found->second);
+                }
+            }
+            break;
+        }
+    }
+
+    if (!equal) {
+        for (size_t i = mark; i < pending_.size(); ++i) {
+            const auto& [member, base_member] = pending_[i];
+            ranges_.push_back({member->begin, member->end,
+                               static_cast<int64_t>(member->begin) - base_member->begin});
+        }
+    }
+    pending_.resize(mark);
+    return equal;
+}
+
+// ─── IncrementalPass ────────────────────────────────────────────────
+
+IncrementalPass::IncrementalPass(PassRecord* record, std::shared_ptr<const DocumentDiff> diff,
+                                 std::shared_ptr<const PassRecord> base)
+    : record_(record), diff_(std::move(diff)), base_(std::move(base)) {}
+
+void IncrementalPass::Start(size_t offset) {
+    offset_ = offset;
+}
+
+bool IncrementalPass::Replay(const Value& value, int step, size_t depth,
+                             std::vector<configservice::ValidationError>& errors, size_t room,
+                             bool* ok) {
+    uint32_t base_begin;
+    if (!diff_ || !base_ || !diff_->Map(value.begin, value.end, &base_begin)) {
+        return false;
+    }
+    const PassRecord* owner;
+    const auto* verdict = base_->Find(base_begin, base_begin + (value.end - value.begin), step,
+                                      static_cast<uint32_t>(depth), &owner);
+    if (!verdict || verdict->end - verdict->begin > room) {
+        return false;
+    }
+
+    errors.insert(errors.end(), owner->errors.begin() + verdict->begin,
+                  owner->errors.begin() + verdict->end);
+    *ok = verdict->ok;
+    ++replayed_;
+    return true;
+}
+
+void IncrementalPass::Record(const Value& value, int step, size_t depth, size_t begin,
+                             size_t end, bool ok) {
+    if (record_) {
+        record_->Add(value.begin, {step, static_cast<uint32_t>(depth),
+                                   static_cast<uint32_t>(begin - offset_),
+                                   static_cast<uint32_t>(end - offset_), PassRecord::kNone, ok});
+    }
+}
+
+void IncrementalPass::Finish(const Value& document,
+                             const std::vector<configservice::ValidationError>& errors) {
+    if (!record_) {
+        return;
+    }
+    record_->errors.assign(errors.begin() + offset_, errors.end());
+    if (!diff_ || !base_) {
+        return;
+    }
+
+    if (base_->chain + 1 < PassRecord::kMaxChain) {
+        record_->base = base_;
+        record_->diff = diff_;
+        record_->chain = base_->chain + 1;
+    } else {
+        Flatten(document);
+    }
+}
+
+void IncrementalPass::Flatten(const Value& value) {
+    if (!IsContainer(value)) {
+        return;
+    }
+
+    uint32_t begin;
+    if (diff_->Map(value.begin, value.end, &begin)) {
+        // The nearest record's verdict on a step wins, as in PassRecord::Find()
+        auto recorded = [&](const PassRecord::Verdict& verdict) {
+            for (uint32_t i = record_->First(value.begin); i != PassRecord::kNone;
+                 i = record_->verdicts[i].next) {
+                if (record_->verdicts[i].step == verdict.step &&
+                    record_->verdicts[i].depth == verdict.depth) {
+                    return true;
+                }
+            }
+            return false;
+        };
+
+        uint32_t end = begin + (value.end - value.begin);
+        for (const PassRecord* record = base_.get(); record; record = record->base.get()) {
+            for (uint32_t i = record->First(begin); i != PassRecord::kNone;
+                 i = record->verdicts[i].next) {
+                const auto& verdict = record->verdicts[i];
+                if (recorded(verdict)) {
+                    continue;
+                }
+                auto at = static_cast<uint32_t>(record_->errors.size());
+                record_->errors.insert(record_->errors.end(),
+                                       record->errors.begin() + verdict.begin,
+                                       record->errors.begin() + verdict.end);
+                record_->Add(value.begin,
+                             {verdict.step, verdict.depth, at,
+                              at + (verdict.end - verdict.begin), PassRecord::kNone, verdict.ok});
+            }
+            uint32_t base_begin;
+            if (!record->base || !record->diff->Map(begin, end, &base_begin)) {
+                break;
+            }
+            end = base_begin + (end - begin);
+            begin = base_begin;
+        }
+    }
+
+    for (const auto& item : value.items) {
+        Flatten(item);
+    }
+    for (const auto& member : value.members) {
+        Flatten(member.second);
+    }
+}
+
+// ─── BaselineCache ──────────────────────────────────────────────────
+
+BaselineCache::BaselineCache(size_t max_bytes) : max_bytes_(max_bytes) {}
+
+std::shared_ptr<const Baseline> BaselineCache::Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+        return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, found->second);
+    return found->second->baseline;
+}
+
+void BaselineCache::Put(const std::string& key, std::shared_ptr<const Baseline> baseline) {
+    size_t bytes = key.size() + sizeof(Baseline) + baseline->content.capacity() +
+                   HeapBytes(baseline->document) + HeapBytes(*baseline->rules) +
+                   HeapBytes(*baseline->schema);
+    if (bytes > max_bytes_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        Erase(found->second);
+    }
+
+    entries_.push_front(Entry{key, std::move(baseline), bytes});
+    index_[key] = entries_.begin();
+    bytes_ += bytes;
+
+    while (bytes_ > max_bytes_) {
+        Erase(std::prev(entries_.end()));
+    }
+}
+
+void BaselineCache::Erase(std::list<Entry>::iterator entry) {
+    bytes_ -= entry->bytes;
+    index_.erase(entry->key);
+    entries_.erase(entry);
+}
+
+}  // namespace validationservice
@@ -0,0 +1,1083 @@
+#include "validation_service/json_schema.h"
+#include "contenthash/content_hash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <optional>
+#include <regex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+
+namespace validationservice {
+
+namespace {
+
+using jsonscan::Value;
+
+// Bits of Node::types; every number carries kNumber, integral ones also kInteger
+constexpr uint8_t kTypeNull = 1 << 0;
+constexpr uint8_t kTypeBoolean = 1 << 1;
+constexpr uint8_t kTypeObject = 1 << 2;
+constexpr uint8_t kTypeArray = 1 << 3;
+constexpr uint8_t kTypeNumber = 1 << 4;
+constexpr uint8_t kTypeString = 1 << 5;
+constexpr uint8_t kTypeInteger = 1 << 6;
+
+// Guards against $ref cycles that never descend into the document
+constexpr size_t kMaxEvaluationDepth = 1024;
+
+// Longest allowed-values list quoted in an enum error
+constexpr size_t kMaxEnumTextBytes = 200;
+
+bool IsInteger(double number) {
+    return std::isfinite(number) && std::floor(number) == number;
+}
+
+uint8_t TypeBits(const Value& value) {
+    switch (value.type) {
+        case Value::Type::kNull:
+            return kTypeNull;
+        case Value::Type::kBool:
+            return kTypeBoolean;
+        case Value::Type::kNumber:
+            return IsInteger(value.number) ? (kTypeNumber | kTypeInteger) : kTypeNumber;
+        case Value::Type::kString:
+            return kTypeString;
+        case Value::Type::kArray:
+            return kTypeArray;
+        case Value::Type::kObject:
+            return kTypeObject;
+    }
+    return 0;
+}
+
+const char* TypeName(const Value& value) {
+    switch (value.type) {
+        case Value::Type::kNull:
+            return "null";
+        case Value::Type::kBool:
+            return "boolean";
+        case Value::Type::kNumber:
+            return IsInteger(value.number) ? "integer" : "number";
+        case Value::Type::kString:
+            return "string";
+        case Value::Type::kArray:
+            return "array";
+        case Value::Type::kObject:
+            return "object";
+    }
+    return "unknown";
+}
+
+std::string FormatNumber(double number) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", number);
+    return buffer;
+}
+
+// Encoding under which two values are equal exactly when JSON Schema says they are: numbers
+// compare mathematically (1 == 1.0) and object members regardless of order
+void AppendCanonical(const Value& value, std::string& out) {
+    switch (value.type) {
+        case Value::Type::kNull:
+            out += 'n';
+            break;
+        case Value::Type::kBool:
+            out += value.boolean ? 't' : 'f';
+            break;
+        case Value::Type::kNumber: {
+            char buffer[32];
+            double number = value.number == 0 ? 0.0 : value.number;  // -0 == 0
+            std::snprintf(buffer, sizeof(buffer), "d%.17g;", number);
+            out += buffer;
+            break;
+        }
+        case Value::Type::kString:
+            out += 's';
+            out += std::to_string(value.string.size());
+            out += ':';
+            out += value.string;
+            break;
+        case Value::Type::kArray:
+            out += '[';
+            for (const auto& item : value.items) {
+                AppendCanonical(item, out);
+            }
+            out += ']';
+            break;
+        case Value::Type::kObject: {
+            std::vector<const std::pair<std::string, Value>*> members;
+            members.reserve(value.members.size());
+            for (const auto& member : value.members) {
+                members.push_back(&member);
+            }
+            std::sort(members.begin(), members.end(),
+                      [](const auto* a, const auto* b) { return a->first < b->first; });
+            out += '{';
+            for (const auto* member : members) {
+                out += std::to_string(member->first.size());
+                out += ':';
+                out += member->first;
+                AppendCanonical(member->second, out);
+            }
+            out += '}';
+            break;
+        }
+    }
+}
+
+std::string Canonical(const Value& value) {
+    std::string out;
+    AppendCanonical(value, out);
+    return out;
+}
+
+// Compact re-serialization of a schema value, for error messages
+void AppendJson(const Value& value, std::string& out) {
+    switch (value.type) {
+        case Value::Type::kNull:
+            out += "null";
+            break;
+        case Value::Type::kBool:
+            out += value.boolean ? "true" : "false";
+            break;
+        case Value::Type::kNumber:
+            out += value.string;
+            break;
+        case Value::Type::kString:
+            out += '"';
+            out += value.string;
+            out += '"';
+            break;
+        case Value::Type::kArray:
+            out += value.items.empty() ? "[]" : "[...]";
+            break;
+        case Value::Type::kObject:
+            out += value.members.empty() ? "{}" : "{...}";
+            break;
+    }
+}
+
+size_t CodePointCount(const std::string& text) {
+    size_t count = 0;
+    for (unsigned char c : text) {
+        count += (c & 0xC0) != 0x80;
+    }
+    return count;
+}
+
+std::string EscapePointerToken(const std::string& token) {
+    std::string escaped;
+    escaped.reserve(token.size());
+    for (char c : token) {
+        if (c == '~') {
+            escaped += "~0";
+        } else if (c == '/') {
+            escaped += "~1";
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+[[noreturn]] void Invalid(const std::string& location, const std::string& message) {
+    throw std::invalid_argument(message + " (at " + location + ")");
+}
+
+}  // anonymous namespace
+
+// ─── Compiled form ──────────────────────────────────────────────────
+
+// One subschema; child schemas are indices into CompiledSchema::nodes_ (-1 = absent)
+struct CompiledSchema::Node {
+    bool reject_all = false;  // The `false` schema
+
+    uint8_t types = 0;  // 0 = any type
+    std::string type_names;
+
+    bool has_enum = false;
+    std::unordered_set<std::string> enum_values;   // Canonical encodings
+    std::unordered_set<std::string> enum_strings;  // The string values again, as-is
+    std::string enum_text;
+
+    std::optional<double> minimum;
+    std::optional<double> maximum;
+    std::optional<double> exclusive_minimum;
+    std::optional<double> exclusive_maximum;
+    std::optional<double> multiple_of;
+
+    std::optional<size_t> min_length;
+    std::optional<size_t> max_length;
+    std::optional<std::regex> pattern;
+    std::string pattern_text;
+
+    std::unordered_map<std::string, int> properties;
+    std::vector<std::pair<std::regex, int>> pattern_properties;
+    int additional_properties = -1;
+    int property_names = -1;
+    std::vector<std::string> required;
+    std::unordered_map<std::string, size_t> required_index;
+    std::unordered_map<std::string, std::vector<std::string>> dependent_required;
+    std::unordered_map<std::string, int> dependent_schemas;
+    std::optional<size_t> min_properties;
+    std::optional<size_t> max_properties;
+    bool walks_members = false;  // Any keyword above that looks at individual members
+
+    std::vector<int> prefix_items;
+    int items = -1;
+    int contains = -1;
+    size_t min_contains = 1;
+    std::optional<size_t> max_contains;
+    std::optional<size_t> min_items;
+    std::optional<size_t> max_items;
+    bool unique_items = false;
+
+    std::vector<int> all_of;  // Includes the $ref target
+    std::vector<int> any_of;
+    std::vector<int> one_of;
+    int not_schema = -1;
+    int if_schema = -1;
+    int then_schema = -1;
+    int else_schema = -1;
+};
+
+CompiledSchema::CompiledSchema() = default;
+CompiledSchema::~CompiledSchema() = default;
+
+// ─── Compiler ───────────────────────────────────────────────────────
+
+class CompiledSchema::Compiler {
+   public:
+    Compiler(const Value& root, std::vector<Node>& nodes) : root_(root), nodes_(nodes) {}
+
+    // Index of the node for schema, which lives at JSON pointer location
+    int Compile(const Value& schema, const std::string& location) {
+        auto existing = compiled_.find(location);
+        if (existing != compiled_.end()) {
+            return existing->second;
+        }
+
+        // Reserve the slot first so $ref cycles back to this schema terminate
+        int index = static_cast<int>(nodes_.size());
+        nodes_.emplace_back();
+        compiled_[location] = index;
+
+        // Children are compiled into nodes_ while this one is built, so build it off to the side
+        Node node;
+        if (schema.type == Value::Type::kBool) {
+            node.reject_all = !schema.boolean;
+        } else if (schema.is_object()) {
+            CompileKeywords(schema, location, node);
+        } else {
+            Invalid(location, "Schema must be an object or a boolean");
+        }
+
+        nodes_[index] = std::move(node);
+        return index;
+    }
+
+   private:
+    const Value& root_;
+    std::vector<Node>& nodes_;
+    std::unordered_map<std::string, int> compiled_;
+
+    void CompileKeywords(const Value& schema, const std::string& location, Node& node) {
+        bool tuple_items = false;
+        int additional_items = -1;
+        // Draft 4 form: a boolean that makes minimum/maximum exclusive
+        bool exclusive_minimum = false;
+        bool exclusive_maximum = false;
+
+        for (const auto& [keyword, value] : schema.members) {
+            std::string at = location + "/" + EscapePointerToken(keyword);
+
+            if (keyword == "type") {
+                CompileType(value, at, node);
+            } else if (keyword == "enum") {
+                if (!value.is_array()) {
+                    Invalid(at, "'enum' must be an array");
+                }
+                for (const auto& allowed : value.items) {
+                    AddEnumValue(allowed, node);
+                }
+            } else if (keyword == "const") {
+                AddEnumValue(value, node);
+            } else if (keyword == "minimum") {
+                node.minimum = NumberOf(value, at);
+            } else if (keyword == "maximum") {
+                node.maximum = NumberOf(value, at);
+            } else if (keyword == "exclusiveMinimum") {
+                if (value.type == Value::Type::kBool) {
+                    exclusive_minimum = value.boolean;
+                } else {
+                    node.exclusive_minimum = NumberOf(value, at);
+                }
+            } else if (keyword == "exclusiveMaximum") {
+                if (value.type == Value::Type::kBool) {
+                    exclusive_maximum = value.boolean;
+                } else {
+                    node.exclusive_maximum = NumberOf(value, at);
+                }
+            } else if (keyword == "multipleOf") {
+                node.multiple_of = NumberOf(value, at);
+                if (*node.multiple_of <= 0) {
+                    Invalid(at, "'multipleOf' must be greater than 0");
+                }
+            } else if (keyword == "minLength") {
+                node.min_length = CountOf(value, at);
+            } else if (keyword == "maxLength") {
+                node.max_length = CountOf(value, at);
+            } else if (keyword == "pattern") {
+                node.pattern_text = StringOf(value, at);
+                node.pattern = RegexOf(node.pattern_text, at);
+            } else if (keyword == "properties") {
+                for (const auto& [name, subschema] : ObjectOf(value, at).members) {
+                    node.properties[name] =
+                        Compile(subschema, at + "/" + EscapePointerToken(name));
+                }
+                node.walks_members = true;
+            } else if (keyword == "patternProperties") {
+                for (const auto& [regex, subschema] : ObjectOf(value, at).members) {
+                    std::string sub_at = at + "/" + EscapePointerToken(regex);
+                    node.pattern_properties.emplace_back(RegexOf(regex, sub_at),
+                                                         Compile(subschema, sub_at));
+                }
+                node.walks_members = true;
+            } else if (keyword == "additionalProperties") {
+                node.additional_properties = Compile(value, at);
+                node.walks_members = true;
+            } else if (keyword == "propertyNames") {
+                node.property_names = Compile(value, at);
+                node.walks_members = true;
+            } else if (keyword == "required") {
+                for (const auto& name : StringsOf(value, at)) {
+                    if (node.required_index.emplace(name, node.required.size()).second) {
+                        node.required.push_back(name);
+                    }
+                }
+                node.walks_members = true;
+            } else if (keyword == "dependentRequired") {
+                for (const auto& [name, dependencies] : ObjectOf(value, at).members) {
+                    node.dependent_required[name] =
+                        StringsOf(dependencies, at + "/" + EscapePointerToken(name));
+                }
+                node.walks_members = true;
+            } else if (keyword == "dependentSchemas") {
+                for (const auto& [name, subschema] : ObjectOf(value, at).members) {
+                    node.dependent_schemas[name] =
+                        Compile(subschema, at + "/" + EscapePointerToken(name));
+                }
+                node.walks_members = true;
+            } else if (keyword == "dependencies") {
+                // Draft 7 form of both: a list of names or a schema per property
+                for (const auto& [name, dependency] : ObjectOf(value, at).members) {
+                    std::string sub_at = at + "/" + EscapePointerToken(name);
+                    if (dependency.is_array()) {
+                        node.dependent_required[name] = StringsOf(dependency, sub_at);
+                    } else {
+                        node.dependent_schemas[name] = Compile(dependency, sub_at);
+                    }
+                }
+                node.walks_members = true;
+            } else if (keyword == "minProperties") {
+                node.min_properties = CountOf(value, at);
+            } else if (keyword == "maxProperties") {
+                node.max_properties = CountOf(value, at);
+            } else if (keyword == "prefixItems") {
+                node.prefix_items = SchemasOf(value, at);
+            } else if (keyword == "items") {
+                // Draft 7 tuple form: "items": [...] followed by "additionalItems"
+                if (value.is_array()) {
+                    node.prefix_items = SchemasOf(value, at);
+                    tuple_items = true;
+                } else {
+                    node.items = Compile(value, at);
+                }
+            } else if (keyword == "additionalItems") {
+                additional_items = Compile(value, at);
+            } else if (keyword == "contains") {
+                node.contains = Compile(value, at);
+            } else if (keyword == "minContains") {
+                node.min_contains = CountOf(value, at);
+            } else if (keyword == "maxContains") {
+                node.max_contains = CountOf(value, at);
+            } else if (keyword == "minItems") {
+                node.min_items = CountOf(value, at);
+            } else if (keyword == "maxItems") {
+                node.max_items = CountOf(value, at);
+            } else if (keyword == "uniqueItems") {
+                if (value.type != Value::Type::kBool) {
+                    Invalid(at, "'uniqueItems' must be a boolean");
+                }
+                node.unique_items = value.boolean;
+            } else if (keyword == "allOf") {
+                auto subschemas = SchemasOf(value, at);
+                node.all_of.insert(node.all_of.end(), subschemas.begin(), subschemas.end());
+            } else if (keyword == "anyOf") {
+                node.any_of = SchemasOf(value, at);
+            } else if (keyword == "oneOf") {
+                node.one_of = SchemasOf(value, at);
+            } else if (keyword == "not") {
+                node.not_schema = Compile(value, at);
+            } else if (keyword == "if") {
+                node.if_schema = Compile(value, at);
+            } else if (keyword == "then") {
+                node.then_schema = Compile(value, at);
+            } else if (keyword == "else") {
+                node.else_schema = Compile(value, at);
+            } else if (keyword == "$ref") {
+                node.all_of.push_back(Resolve(StringOf(value, at), at));
+            } else if (keyword == "unevaluatedProperties" || keyword == "unevaluatedItems" ||
+                       keyword == "$dynamicRef" || keyword == "$recursiveRef") {
+                Invalid(at, "Keyword '" + keyword + "' is not supported");
+            }
+            // Everything else is an annotation ($schema, $id, title, format, default, ...)
+            // or a container ($defs, definitions) that is compiled when referenced
+        }
+
+        if (tuple_items && additional_items >= 0) {
+            node.items = additional_items;
+        }
+        if (exclusive_minimum && node.minimum) {
+            node.exclusive_minimum = node.minimum;
+            node.minimum.reset();
+        }
+        if (exclusive_maximum && node.maximum) {
+            node.exclusive_maximum = node.maximum;
+            node.maximum.reset();
+        }
+    }
+
+    // $ref to a JSON pointer within this schema document
+    int Resolve(const std::string& ref, const std::string& at) {
+        if (ref.empty() || ref[0] != '#' || (ref.size() > 1 && ref[1] != '/')) {
+            Invalid(at, "Unsupported $ref '" + ref + "': only local JSON pointers ('#/...') are "
+                        "supported");
+        }
+
+        const Value* target = &root_;
+        std::string location = "#";
+        size_t pos = 1;
+        while (pos < ref.size()) {
+            size_t end = ref.find('/', pos + 1);
+            if (end == std::string::npos) {
+                end = ref.size();
+            }
+
+            std::string token;
+            for (size_t i = pos + 1; i < end; ++i) {
+                if (ref[i] == '~' && i + 1 < end && (ref[i + 1] == '0' || ref[i + 1] == '1')) {
+                    token += ref[i + 1] == '0' ? '~' : '/';
+                    ++i;
+                } else {
+                    token += ref[i];
+                }
+            }
+
+            if (target->is_object()) {
+                target = target->Find(token);
+            } else if (target->is_array() && !token.empty() &&
+                       token.find_first_not_of("0123456789") == std::string::npos &&
+                       std::stoul(token) < target->items.size()) {
+                target = &target->items[std::stoul(token)];
+            } else {
+                target = nullptr;
+            }
+            if (!target) {
+                Invalid(at, "$ref '" + ref + "' does not resolve");
+            }
+
+            location += "/" + EscapePointerToken(token);
+            pos = end;
+        }
+
+        return Compile(*target, location);
+    }
+
+    void CompileType(const Value& value, const std::string& at, Node& node) {
+        std::vector<const Value*> names;
+        if (value.type == Value::Type::kString) {
+            names.push_back(&value);
+        } else if (value.is_array() && !value.items.empty()) {
+            for (const auto& item : value.items) {
+                names.push_back(&item);
+            }
+        } else {
+            Invalid(at, "'type' must be a type name or a non-empty array of them");
+        }
+
+        for (const auto* name : names) {
+            const std::string& type = StringOf(*name, at);
+            if (type == "null") {
+                node.types |= kTypeNull;
+            } else if (type == "boolean") {
+                node.types |= kTypeBoolean;
+            } else if (type == "object") {
+                node.types |= kTypeObject;
+            } else if (type == "array") {
+                node.types |= kTypeArray;
+            } else if (type == "number") {
+                node.types |= kTypeNumber;
+            } else if (type == "string") {
+                node.types |= kTypeString;
+            } else if (type == "integer") {
+                node.types |= kTypeInteger;
+            } else {
+                Invalid(at, "Unknown type '" + type + "'");
+            }
+            node.type_names += node.type_names.empty() ? type : " or " + type;
+        }
+    }
+
+    static void AddEnumValue(const Value& value, Node& node) {
+        node.has_enum = true;
+        if (value.type == Value::Type::kString) {
+            node.enum_strings.insert(value.string);
+        }
+        if (node.enum_values.insert(Canonical(value)).second &&
+            node.enum_text.size() < kMaxEnumTextBytes) {
+            if (!node.enum_text.empty()) {
+                node.enum_text += ", ";
+            }
+            AppendJson(value, node.enum_text);
+        }
+    }
+
+    std::vector<int> SchemasOf(const Value& value, const std::string& at) {
+        if (!value.is_array() || value.items.empty()) {
+            Invalid(at, "Expected a non-empty array of schemas");
+        }
+        std::vector<int> indices;
+        for (size_t i = 0; i < value.items.size(); ++i) {
+            indices.push_back(Compile(value.items[i], at + "/" + std::to_string(i)));
+        }
+        return indices;
+    }
+
+    static const Value& ObjectOf(const Value& value, const std::string& at) {
+        if (!value.is_object()) {
+            Invalid(at, "Expected an object");
+        }
+        return value;
+    }
+
+    static const std::string& StringOf(const Value& value, const std::string& at) {
+        if (value.type != Value::Type::kString) {
+            Invalid(at, "Expected a string");
+        }
+        return value.string;
+    }
+
+    static std::vector<std::string> StringsOf(const Value& value, const std::string& at) {
+        if (!value.is_array()) {
+            Invalid(at, "Expected an array of strings");
+        }
+        std::vector<std::string> strings;
+        for (const auto& item : value.items) {
+            strings.push_back(StringOf(item, at));
+        }
+        return strings;
+    }
+
+    static double NumberOf(const Value& value, const std::string& at) {
+        if (value.type != Value::Type::kNumber) {
+            Invalid(at, "Expected a number");
+        }
+        return value.number;
+    }
+
+    static size_t CountOf(const Value& value, const std::string& at) {
+        if (value.type != Value::Type::kNumber || !IsInteger(value.number) || value.number < 0) {
+            Invalid(at, "Expected a non-negative integer");
+        }
+        return static_cast<size_t>(value.number);
+    }
+
+    static std::regex RegexOf(const std::string& pattern, const std::string& at) {
+        try {
+            return std::regex(pattern, std::regex::ECMAScript | std::regex::optimize);
+        } catch (const std::regex_error& e) {
+            Invalid(at, "Invalid pattern '" + pattern + "': " + e.what());
+        }
+    }
+};
+
+// ─── Evaluator ──────────────────────────────────────────────────────
+
+// One walk over a document. Without an error list it only answers "does it match" and stops
+// at the first mismatch, which is what anyOf/oneOf/not/if/contains need.
+class CompiledSchema::Evaluator {
+   public:
+    Evaluator(const std::vector<Node>& nodes, std::vector<configservice::ValidationError>* errors,
+              ValidationBudget* budget, IncrementalPass* incremental, size_t depth = 0)
+        : nodes_(nodes),
+          errors_(errors),
+          error_limit_(errors ? errors->size() + kMaxErrors : 0),
+          budget_(budget),
+          incremental_(errors ? incremental : nullptr),
+          depth_(depth) {}
+
+    bool Check(int index, const Value& value) {
+        if (errors_ && errors_->size() >= error_limit_) {
+            return false;
+        }
+        // Combinators can revisit a subtree many times, so this is per node, not per value
+        if (budget_ && budget_->Exhausted()) {
+            return false;
+        }
+        if (depth_ >= kMaxEvaluationDepth) {
+            return Fail("schema", "Schema recursion is too deep (cyclic $ref?)");
+        }
+
+        // Containers unchanged since the base version get the errors found there. Only the
+        // first step on a value counts; combinators' steps on the same value are part of it.
+        bool incremental =
+            incremental_ && checking_ != &value &&
+            (value.type == Value::Type::kObject || value.type == Value::Type::kArray);
+        bool ok = true;
+        if (incremental &&
+            incremental_->Replay(value, index, depth_, *errors_, error_limit_ - errors_->size(),
+                                 &ok)) {
+            return ok;
+        }
+
+        size_t begin = errors_ ? errors_->size() : 0;
+        const Value* outer = checking_;
+        checking_ = &value;
+        ++depth_;
+        ok = CheckNode(nodes_[index], value);
+        --depth_;
+        checking_ = outer;
+        if (incremental) {
+            incremental_->Record(value, index, depth_, begin, errors_->size(), ok);
+        }
+        return ok;
+    }
+
+   private:
+    struct Segment {
+        const std::string* key;  // nullptr for an array index
+        size_t index;
+    };
+
+    const std::vector<Node>& nodes_;
+    std::vector<configservice::ValidationError>* errors_;
+    size_t error_limit_;
+    ValidationBudget* budget_;
+    IncrementalPass* incremental_;  // Only when collecting errors
+    const Value* checking_ = nullptr;  // Value of the innermost Check()
+    size_t depth_;
+    std::vector<Segment> path_;
+    Value property_name_;  // Scratch value for propertyNames; names are never containers
+
+    bool Probe(int index, const Value& value) const {
+        return Evaluator(nodes_, nullptr, budget_, nullptr, depth_).Check(index, value);
+    }
+
+    bool Fail(const char* type, const std::string& message) {
+        // Past the budget, failed checks only mean "not evaluated"
+        if (errors_ && errors_->size() < error_limit_ && !(budget_ && budget_->exhausted())) {
+            configservice::ValidationError error;
+            error.set_field(Path());
+            error.set_error_type(type);
+            error.set_message(message);
+            errors_->push_back(std::move(error));
+        }
+        return false;
+    }
+
+    // "servers[2].port"
+    std::string Path() const {
+        std::string path;
+        for (const auto& segment : path_) {
+            if (segment.key) {
+                if (!path.empty()) {
+                    path += '.';
+                }
+                path += *segment.key;
+            } else {
+                path += '[' + std::to_string(segment.index) + ']';
+            }
+        }
+        return path;
+    }
+
+    bool CheckNode(const Node& node, const Value& value) {
+        if (node.reject_all) {
+            return Fail("schema", "Value is not allowed here");
+        }
+        if (node.types != 0 && (TypeBits(value) & node.types) == 0) {
+            return Fail("type", "Expected " + node.type_names + ", got " + TypeName(value));
+        }
+
+        bool ok = true;
+        // Strings, by far the common enum case, are looked up without encoding them first
+        if (node.has_enum && (value.type == Value::Type::kString
+                                  ? node.enum_strings.count(value.string) == 0
+                                  : node.enum_values.count(Canonical(value)) == 0)) {
+            ok = Fail("enum", (node.enum_values.size() == 1 ? "Value must be " :
+                                                              "Value must be one of ") +
+                                  node.enum_text);
+            if (!errors_) {
+                return false;
+            }
+        }
+
+        switch (value.type) {
+            case Value::Type::kNumber:
+                ok = CheckNumber(node, value.number) && ok;
+                break;
+            case Value::Type::kString:
+                ok = CheckString(node, value.string) && ok;
+                break;
+            case Value::Type::kObject:
+                ok = CheckObject(node, value) && ok;
+                break;
+            case Value::Type::kArray:
+                ok = CheckArray(node, value) && ok;
+                break;
+            default:
+                break;
+        }
+        if (!ok && !errors_) {
+            return false;
+        }
+
+        return CheckCombinators(node, value) && ok;
+    }
+
+    bool CheckNumber(const Node& node, double number) {
+        bool ok = true;
+        if (node.minimum && number < *node.minimum) {
+            ok = Fail("range", FormatNumber(number) + " is less than the minimum of " +
+                                   FormatNumber(*node.minimum));
+        }
+        if (node.maximum && number > *node.maximum) {
+            ok = Fail("range", FormatNumber(number) + " is greater than the maximum of " +
+                                   FormatNumber(*node.maximum));
+        }
+        if (node.exclusive_minimum && number <= *node.exclusive_minimum) {
+            ok = Fail("range", FormatNumber(number) + " must be greater than " +
+                                   FormatNumber(*node.exclusive_minimum));
+        }
+        if (node.exclusive_maximum && number >= *node.exclusive_maximum) {
+            ok = Fail("range", FormatNumber(number) + " must be less than " +
+                                   FormatNumber(*node.exclusive_maximum));
+        }
+        if (node.multiple_of) {
+            double quotient = number / *node.multiple_of;
+            if (std::fabs(quotient - std::round(quotient)) >
+                1e-9 * std::max(1.0, std::fabs(quotient))) {
+                ok = Fail("range", FormatNumber(number) + " is not a multiple of " +
+                                       FormatNumber(*node.multiple_of));
+            }
+        }
+        return ok;
+    }
+
+    bool CheckString(const Node& node, const std::string& text) {
+        bool ok = true;
+        if (node.min_length || node.max_length) {
+            size_t length = CodePointCount(text);
+            if (node.min_length && length < *node.min_length) {
+                ok = Fail("range", "String is shorter than " + std::to_string(*node.min_length) +
+                                       " characters");
+            }
+            if (node.max_length && length > *node.max_length) {
+                ok = Fail("range", "String is longer than " + std::to_string(*node.max_length) +
+                                       " characters");
+            }
+        }
+        if (node.pattern && !std::regex_search(text, *node.pattern)) {
+            ok = Fail("format", "Value does not match pattern '" + node.pattern_text + "'");
+        }
+        return ok;
+    }
+
+    bool CheckObject(const Node& node, const Value& object) {
+        bool ok = true;
+        size_t count = object.members.size();
+        if (node.min_properties && count < *node.min_properties) {
+            ok = Fail("range", "Object has " + std::to_string(count) +
+                                   " properties, expected at least " +
+                                   std::to_string(*node.min_properties));
+        }
+        if (node.max_properties && count > *node.max_properties) {
+            ok = Fail("range", "Object has " + std::to_string(count) +
+                                   " properties, expected at most " +
+                                   std::to_string(*node.max_properties));
+        }
+        if (!node.walks_members || (!ok && !errors_)) {
+            return ok;
+        }
+
+        // Required keys are ticked off during the single pass over the members
+        std::vector<bool> seen(node.required.size());
+        for (const auto& [key, member] : object.members) {
+            if (!node.required_index.empty()) {
+                auto required = node.required_index.find(key);
+                if (required != node.required_index.end()) {
+                    seen[required->second] = true;
+                }
+            }
+
+            path_.push_back({&key, 0});
+            bool matched = false;
+
+            auto property = node.properties.find(key);
+            if (property != node.properties.end()) {
+                matched = true;
+                ok = Check(property->second, member) && ok;
+            }
+            for (const auto& [regex, subschema] : node.pattern_properties) {
+                if (std::regex_search(key, regex)) {
+                    matched = true;
+                    ok = Check(subschema, member) && ok;
+                }
+            }
+            if (!matched && node.additional_properties >= 0) {
+                if (nodes_[node.additional_properties].reject_all) {
+                    ok = Fail("schema", "Property '" + key + "' is not allowed");
+                } else {
+                    ok = Check(node.additional_properties, member) && ok;
+                }
+            }
+            if (node.property_names >= 0) {
+                property_name_.type = Value::Type::kString;
+                property_name_.string = key;
+                ok = Check(node.property_names, property_name_) && ok;
+            }
+
+            path_.pop_back();
+
+            if (!node.dependent_required.empty()) {
+                auto dependent = node.dependent_required.find(key);
+                if (dependent != node.dependent_required.end()) {
+                    for (const auto& dependency : dependent->second) {
+                        if (!object.Find(dependency)) {
+                            ok = Fail("required", "Property '" + dependency +
+                                                      "' is required when '" + key +
+                                                      "' is present");
+                        }
+                    }
+                }
+            }
+            if (!node.dependent_schemas.empty()) {
+                auto dependent = node.dependent_schemas.find(key);
+                if (dependent != node.dependent_schemas.end()) {
+                    ok = Check(dependent->second, object) && ok;
+                }
+            }
+
+            if (!ok && !errors_) {
+                return false;
+            }
+        }
+
+        for (size_t i = 0; i < node.required.size(); ++i) {
+            if (!seen[i]) {
+                path_.push_back({&node.required[i], 0});
+                ok = Fail("required", "Missing required property '" + node.required[i] + "'");
+                path_.pop_back();
+            }
+        }
+        return ok;
+    }
+
+    bool CheckArray(const Node& node, const Value& array) {
+        bool ok = true;
+        size_t count = array.items.size();
+        if (node.min_items && count < *node.min_items) {
+            ok = Fail("range", "Array has " + std::to_string(count) +
+                                   " items, expected at least " + std::to_string(*node.min_items));
+        }
+        if (node.max_items && count > *node.max_items) {
+            ok = Fail("range", "Array has " + std::to_string(count) +
+                                   " items, expected at most " + std::to_string(*node.max_items));
+        }
+
+        if (!node.prefix_items.empty() || node.items >= 0) {
+            for (size_t i = 0; i < count; ++i) {
+                int subschema = i < node.prefix_items.size() ? node.prefix_items[i] : node.items;
+                if (subschema < 0) {
+                    break;
+                }
+                path_.push_back({nullptr, i});
+                ok = Check(subschema, array.items[i]) && ok;
+                path_.pop_back();
+                if (!ok && !errors_) {
+                    return false;
+                }
+            }
+        }
+
+        if (node.contains >= 0) {
+            size_t matches = 0;
+            for (const auto& item : array.items) {
+                matches += Probe(node.contains, item);
+            }
+            if (matches < node.min_contains) {
+                ok = Fail("schema", "Array must contain at least " +
+                                        std::to_string(node.min_contains) + " matching item(s)");
+            }
+            if (node.max_contains && matches > *node.max_contains) {
+                ok = Fail("schema", "Array must contain at most " +
+                                        std::to_string(*node.max_contains) + " matching item(s)");
+            }
+        }
+
+        if (node.unique_items && count > 1) {
+            bool strings =
+                std::all_of(array.items.begin(), array.items.end(),
+                            [](const auto& item) { return item.type == Value::Type::kString; });
+            std::unordered_set<std::string_view> distinct_strings;
+            std::unordered_set<std::string> distinct;
+            for (size_t i = 0; i < count; ++i) {
+                bool repeated = strings
+                                    ? !distinct_strings.insert(array.items[i].string).second
+                                    : !distinct.insert(Canonical(array.items[i])).second;
+                if (repeated) {
+                    path_.push_back({nullptr, i});
+                    ok = Fail("schema", "Array items must be unique");
+                    path_.pop_back();
+                    break;
+                }
+            }
+        }
+        return ok;
+    }
+
+    bool CheckCombinators(const Node& node, const Value& value) {
+        bool ok = true;
+        for (int subschema : node.all_of) {
+            ok = Check(subschema, value) && ok;
+            if (!ok && !errors_) {
+                return false;
+            }
+        }
+
+        if (!node.any_of.empty()) {
+            bool any = std::any_of(node.any_of.begin(), node.any_of.end(),
+                                   [&](int subschema) { return Probe(subschema, value); });
+            if (!any) {
+                ok = Fail("schema", "Value does not match any of the 'anyOf' schemas");
+            }
+        }
+
+        if (!node.one_of.empty()) {
+            size_t matches = 0;
+            for (int subschema : node.one_of) {
+                if (Probe(subschema, value) && ++matches > 1) {
+                    break;
+                }
+            }
+            if (matches != 1) {
+                ok = Fail("schema", matches == 0
+                                        ? "Value does not match any of the 'oneOf' schemas"
+                                        : "Value matches more than one of the 'oneOf' schemas");
+            }
+        }
+
+        if (node.not_schema >= 0 && Probe(node.not_schema, value)) {
+            ok = Fail("schema", "Value must not match the 'not' schema");
+        }
+
+        if (node.if_schema >= 0) {
+            int branch = Probe(node.if_schema, value) ? node.then_schema : node.else_schema;
+            if (branch >= 0) {
+                ok = Check(branch, value) && ok;
+            }
+        }
+        return ok;
+    }
+};
+
+// ─── CompiledSchema ─────────────────────────────────────────────────
+
+std::shared_ptr<const CompiledSchema> CompiledSchema::Compile(const std::string& schema_json) {
+    jsonscan::Value root;
+    auto scan = jsonscan::Parse(schema_json, root);
+    if (!scan.valid) {
+        throw std::invalid_argument("Schema is not valid JSON: " + scan.Describe());
+    }
+
+    auto schema = std::make_shared<CompiledSchema>();
+    Compiler(root, schema->nodes_).Compile(root, "#");
+    return schema;
+}
+
+bool CompiledSchema::Validate(const jsonscan::Value& document,
+                              std::vector<configservice::ValidationError>& errors,
+                              ValidationBudget* budget, IncrementalPass* incremental) const {
+    if (incremental) {
+        incremental->Start(errors.size());
+    }
+    bool ok = Evaluator(nodes_, &errors, budget, incremental).Check(0, document);
+    if (incremental) {
+        incremental->Finish(document, errors);
+    }
+    return ok;
+}
+
+size_t CompiledSchema::node_count() const {
+    return nodes_.size();
+}
+
+// ─── SchemaCache ────────────────────────────────────────────────────
+
+SchemaCache::SchemaCache(std::chrono::seconds ttl) : ttl_(ttl) {}
+
+SchemaCache::Entry SchemaCache::Get(const std::string& schema_id, const Loader& load) {
+    auto now = std::chrono::steady_clock::now();
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto slot = slots_.find(schema_id);
+        if (slot != slots_.end() &&
+            (ttl_.count() <= 0 || now - slot->second.loaded_at < ttl_)) {
+            return slot->second.entry;
+        }
+        generation = generation_;
+    }
+
+    Entry entry;
+    auto loaded = load(schema_id);
+    if (!loaded) {
+        entry.error = "Schema " + schema_id + " could not be loaded";
+        entry.load_failed = true;
+        return entry;
+    }
+    const auto& stored = *loaded;
+    if (stored.schema_id().empty()) {
+        entry.error = "Schema not found: " + schema_id;
+    } else {
+        entry.version =
+            contenthash::Sha256Hex(stored.schema_type() + '\n' + stored.schema_content());
+    }
+    if (entry.error.empty() && stored.schema_type() == "json-schema") {
+        try {
+            entry.schema = CompiledSchema::Compile(stored.schema_content());
+        } catch (const std::invalid_argument& e) {
+            entry.error = "Schema " + schema_id + " does not compile: " + e.what();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    // A RegisterSchema that raced with this load wins; the next request loads again
+    if (generation == generation_) {
+        slots_[schema_id] = Slot{entry, now};
+    }
+    return entry;
+}
+
+void SchemaCache::Invalidate(const std::string& schema_id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_.erase(schema_id);
+    ++generation_;
+}
+
+}  // namespace validationservice
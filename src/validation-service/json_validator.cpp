@@ -1,90 +1,56 @@
 #include "validation_service/json_validator.h"
+#include "jsonscan/json_scanner.h"
 
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 
 namespace validationservice {
 
 bool JsonValidator::ValidateSyntax(const std::string& content,
                                    std::vector<configservice::ValidationError>& errors) {
-    // Basic JSON syntax validation
-    int depth = 0;
-    bool in_string = false;
-    bool escaped = false;
-    int line = 1;
-    int column = 0;
-
-    for (size_t i = 0; i < content.size(); ++i) {
-        char c = content[i];
-        column++;
-
-        if (c == '\n') {
-            line++;
-            column = 0;
-            continue;
-        }
-
-        if (escaped) {
-            escaped = false;
-            continue;
-        }
-
-        if (c == '\\' && in_string) {
-            escaped = true;
-            continue;
-        }
+    auto scan = jsonscan::Validate(content);
+    if (!scan.valid) {
+        AddError(errors, "", "syntax", scan.Describe());
+        return false;
+    }
 
-        if (c == '"') {
-            in_string = !in_string;
-            continue;
-        }
+    return true;
+}
 
-        if (!in_string) {
-            if (c == '{' || c == '[') {
-                depth++;
-            } else if (c == '}' || c == ']') {
-                // Check for trailing comma before closing bracket
-                for (size_t j = i; j > 0; --j) {
-                    char p = content[j - 1];
-                    if (p == ' ' || p == '\t' || p == '\n' || p == '\r')
-                        continue;
-                    if (p == ',') {
-                        AddError(errors, "", "syntax",
-                                 "Trailing comma before '" + std::string(1, c) + "' at line " +
-                                     std::to_string(line) + ", column " + std::to_string(column));
-                        return false;
-                    }
-                    break;
-                }
-                depth--;
-                if (depth < 0) {
-                    AddError(errors, "", "syntax",
-                             "Unexpected closing bracket at line " + std::to_string(line) +
-                                 ", column " + std::to_string(column));
-                    return false;
-                }
-            }
-        }
+bool JsonValidator::Parse(const std::string& content, jsonscan::Value& document,
+                          std::vector<configservice::ValidationError>& errors) {
+    auto scan = jsonscan::Parse(content, document);
+    if (!scan.valid) {
+        AddError(errors, "", "syntax", scan.Describe());
+        return false;
     }
 
-    if (depth != 0) {
-        AddError(errors, "", "syntax", "Unclosed brackets (depth: " + std::to_string(depth) + ")");
+    return true;
+}
+
+bool JsonValidator::ValidateSchema(const std::string& content, const std::string& schema,
+                                   std::vector<configservice::ValidationError>& errors) {
+    std::shared_ptr<const CompiledSchema> compiled;
+    try {
+        compiled = CompiledSchema::Compile(schema);
+    } catch (const std::invalid_argument& e) {
+        AddError(errors, "", "schema", std::string("Invalid schema: ") + e.what());
         return false;
     }
 
-    if (in_string) {
-        AddError(errors, "", "syntax", "Unclosed string");
+    jsonscan::Value document;
+    if (!Parse(content, document, errors)) {
         return false;
     }
 
-    return true;
+    return ValidateSchema(document, *compiled, errors);
 }
 
-bool JsonValidator::ValidateSchema(const std::string& content, const std::string& schema,
-                                   std::vector<configservice::ValidationError>& errors) {
-    // TODO: Implement JSON Schema validation
-    // For now, return true (would use a library like rapidjson-schema)
-    return true;
+bool JsonValidator::ValidateSchema(const jsonscan::Value& document, const CompiledSchema& schema,
+                                   std::vector<configservice::ValidationError>& errors,
+                                   ValidationBudget* budget, IncrementalPass* incremental) {
+    return schema.Validate(document, errors, budget, incremental);
 }
 
 bool JsonValidator::ValidateRanges(const std::string& content, const std::string& service_name,
@@ -0,0 +1,82 @@
+#include "validation_service/result_cache.h"
+#include "contenthash/content_hash.h"
+
+namespace validationservice {
+
+namespace {
+
+// Bumped whenever the cached response layout or validation semantics change
+constexpr const char* kKeyVersion = "result-v1";
+
+void AppendField(std::string& out, const std::string& field) {
+    out += std::to_string(field.size());
+    out += ':';
+    out += field;
+}
+
+}  // anonymous namespace
+
+ResultCache::ResultCache(size_t max_bytes, std::chrono::seconds ttl)
+    : max_bytes_(max_bytes), ttl_(ttl) {}
+
+std::string ResultCache::Key(const configservice::ValidateConfigRequest& request,
+                             const std::string& format, const std::string& content_hash,
+                             const std::string& schema_version, int64_t rules_version) {
+    // Length-prefixed so no two field combinations serialize alike
+    std::string fields;
+    AppendField(fields, kKeyVersion);
+    AppendField(fields, request.service_name());
+    AppendField(fields, format);
+    AppendField(fields, request.schema_id());
+    AppendField(fields, schema_version);
+    AppendField(fields, std::to_string(rules_version));
+    AppendField(fields, request.strict() ? "strict" : "lenient");
+    AppendField(fields, content_hash);
+    return contenthash::Sha256Hex(fields);
+}
+
+std::shared_ptr<const ResultCache::Response> ResultCache::Get(const std::string& key) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found == index_.end()) {
+        return nullptr;
+    }
+
+    auto entry = found->second;
+    if (std::chrono::steady_clock::now() - entry->stored_at >= ttl_) {
+        Erase(entry);
+        return nullptr;
+    }
+    entries_.splice(entries_.begin(), entries_, entry);
+    return entry->response;
+}
+
+void ResultCache::Put(const std::string& key, std::shared_ptr<const Response> response) {
+    size_t bytes = key.size() + response->ByteSizeLong();
+    if (bytes > max_bytes_) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto found = index_.find(key);
+    if (found != index_.end()) {
+        Erase(found->second);
+    }
+
+    entries_.push_front(
+        Entry{key, std::move(response), bytes, std::chrono::steady_clock::now()});
+    index_[key] = entries_.begin();
+    bytes_ += bytes;
+
+    while (bytes_ > max_bytes_) {
+        Erase(std::prev(entries_.end()));
+    }
+}
+
+void ResultCache::Erase(std::list<Entry>::iterator entry) {
+    bytes_ -= entry->bytes;
+    index_.erase(entry->key);
+    entries_.erase(entry);
+}
+
+}  // namespace validationservice
\ No newline at end of file
@@ -0,0 +1,548 @@
+#include "validation_service/rule_set.h"
+
+#include <cstdio>
+#include <optional>
+#include <regex>
+#include <utility>
+
+namespace validationservice {
+
+namespace {
+
+using jsonscan::Value;
+
+std::vector<std::string> SplitPath(const std::string& path) {
+    std::vector<std::string> segments;
+    size_t start = 0;
+    while (start <= path.size()) {
+        size_t dot = path.find('.', start);
+        if (dot == std::string::npos) {
+            dot = path.size();
+        }
+        segments.push_back(path.substr(start, dot - start));
+        start = dot + 1;
+    }
+    return segments;
+}
+
+std::string FormatNumber(double number) {
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.15g", number);
+    return buffer;
+}
+
+}  // anonymous namespace
+
+// ─── Compiled form ──────────────────────────────────────────────────
+
+struct CompiledRuleSet::Rule {
+    enum class Type { kRequired, kRange, kFormat };
+
+    Type type = Type::kRequired;
+    std::vector<std::string> segments;  // field_path split on '.'
+    std::string error_message;          // Empty = generated
+    std::optional<double> min;
+    std::optional<double> max;
+    std::optional<std::regex> pattern;
+    std::string pattern_text;
+};
+
+struct CompiledRuleSet::TrieNode {
+    std::string key;
+    size_t depth = 0;  // Number of segments from the root
+
+    std::vector<const Rule*> checks;          // range / format rules on the value here
+    std::vector<const Rule*> required_below;  // required rules that need this key to exist
+    std::unordered_map<std::string, std::unique_ptr<TrieNode>> children;
+    std::unique_ptr<TrieNode> wildcard;
+
+    std::vector<const TrieNode*> required_children;  // Children with required rules below
+    int required_slot = -1;                          // Index in parent's required_children
+};
+
+CompiledRuleSet::CompiledRuleSet() = default;
+CompiledRuleSet::~CompiledRuleSet() = default;
+
+std::shared_ptr<const CompiledRuleSet> CompiledRuleSet::Compile(
+    const std::vector<ValidationRule>& rules, int64_t version) {
+    auto set = std::make_shared<CompiledRuleSet>();
+    set->version_ = version;
+    set->root_ = std::make_unique<TrieNode>();
+
+    for (const auto& source : rules) {
+        auto skip = [&](const std::string& reason) {
+            set->skipped_.push_back(source.rule_id + " (" + source.field_path + "): " + reason);
+        };
+
+        auto rule = std::make_unique<Rule>();
+        rule->segments = SplitPath(source.field_path);
+        rule->error_message = source.error_message;
+
+        bool empty_segment = false;
+        for (const auto& segment : rule->segments) {
+            empty_segment |= segment.empty();
+        }
+        if (empty_segment) {
+            skip("field_path has an empty segment");
+            continue;
+        }
+
+        jsonscan::Value config;
+        if (source.rule_config.empty()) {
+            config.type = Value::Type::kObject;
+        } else if (!jsonscan::Parse(source.rule_config, config).valid || !config.is_object()) {
+            skip("rule_config is not a JSON object");
+            continue;
+        }
+
+        if (source.rule_type == "required") {
+            rule->type = Rule::Type::kRequired;
+        } else if (source.rule_type == "range") {
+            rule->type = Rule::Type::kRange;
+            const Value* min = config.Find("min");
+            const Value* max = config.Find("max");
+            if ((min && min->type != Value::Type::kNumber) ||
+                (max && max->type != Value::Type::kNumber) || (!min && !max)) {
+                skip("range rules need a numeric min and/or max");
+                continue;
+            }
+            if (min) {
+                rule->min = min->number;
+            }
+            if (max) {
+                rule->max = max->number;
+            }
+        } else if (source.rule_type == "format") {
+            rule->type = Rule::Type::kFormat;
+            const Value* pattern = config.Find("pattern");
+            if (!pattern || pattern->type != Value::Type::kString) {
+                skip("format rules need a string pattern");
+                continue;
+            }
+            try {
+                rule->pattern.emplace(pattern->string,
+                                      std::regex::ECMAScript | std::regex::optimize);
+            } catch (const std::regex_error& e) {
+                skip(std::string("invalid pattern: ") + e.what());
+                continue;
+            }
+            rule->pattern_text = pattern->string;
+        } else {
+            skip("unsupported rule_type '" + source.rule_type + "'");
+            continue;
+        }
+
+        if (rule->type == Rule::Type::kRequired && rule->segments.back() == "*") {
+            skip("required rules must name a field, not end in '*'");
+            continue;
+        }
+
+        // Walk / extend the trie along the path. The named segments after the last "*" are
+        // the ones a required rule makes mandatory.
+        TrieNode* node = set->root_.get();
+        std::vector<TrieNode*> mandatory;
+        for (const auto& segment : rule->segments) {
+            std::unique_ptr<TrieNode>* child;
+            if (segment == "*") {
+                child = &node->wildcard;
+                mandatory.clear();
+            } else {
+                child = &node->children[segment];
+            }
+            if (!*child) {
+                *child = std::make_unique<TrieNode>();
+                (*child)->key = segment;
+                (*child)->depth = node->depth + 1;
+            }
+            node = child->get();
+            if (segment != "*") {
+                mandatory.push_back(node);
+            }
+        }
+
+        if (rule->type == Rule::Type::kRequired) {
+            for (TrieNode* required : mandatory) {
+                required->required_below.push_back(rule.get());
+            }
+        } else {
+            node->checks.push_back(rule.get());
+        }
+
+        set->rules_.push_back(std::move(rule));
+    }
+
+    // Each node lists the children it must see; only those are tracked during a walk
+    std::vector<TrieNode*> pending = {set->root_.get()};
+    while (!pending.empty()) {
+        TrieNode* node = pending.back();
+        pending.pop_back();
+
+        for (auto& [key, child] : node->children) {
+            if (!child->required_below.empty()) {
+                child->required_slot = static_cast<int>(node->required_children.size());
+                node->required_children.push_back(child.get());
+            }
+            pending.push_back(child.get());
+        }
+        if (node->wildcard) {
+            pending.push_back(node->wildcard.get());
+        }
+    }
+
+    set->rule_count_ = set->rules_.size();
+    return set;
+}
+
+// ─── Evaluation ─────────────────────────────────────────────────────
+
+bool CompiledRuleSet::Evaluate(const jsonscan::Value& document,
+                               std::vector<configservice::ValidationError>& errors,
+                               ValidationBudget* budget, IncrementalPass* incremental) const {
+    size_t before = errors.size();
+    if (incremental) {
+        incremental->Start(before);
+    }
+    RuleStream(*this, errors, budget, incremental).Feed(document);
+    if (incremental) {
+        incremental->Finish(document, errors);
+    }
+    return errors.size() == before;
+}
+
+// One open object or array that some rule looks into
+struct RuleStream::Frame {
+    struct Active {
+        const CompiledRuleSet::TrieNode* node;
+        std::vector<bool> seen;  // Per node->required_children
+    };
+
+    std::vector<Active> active;
+    bool array = false;
+    size_t next_index = 0;
+};
+
+RuleStream::RuleStream(const CompiledRuleSet& rules,
+                       std::vector<configservice::ValidationError>& errors,
+                       ValidationBudget* budget, IncrementalPass* incremental)
+    : rules_(rules), errors_(errors), budget_(budget), incremental_(incremental) {
+    next_.push_back(rules_.root_.get());
+}
+
+RuleStream::~RuleStream() = default;
+
+bool RuleStream::StartObject() {
+    return StartContainer(false);
+}
+
+bool RuleStream::StartArray() {
+    return StartContainer(true);
+}
+
+void RuleStream::End() {
+    if (stopped_) {
+        return;
+    }
+    if (ignored_depth_ > 0) {
+        if (--ignored_depth_ == 0) {
+            EndValue();
+        }
+        return;
+    }
+
+    Frame frame = std::move(frames_.back());
+    frames_.pop_back();
+    for (const auto& active : frame.active) {
+        for (size_t i = 0; i < active.seen.size(); ++i) {
+            if (!active.seen[i]) {
+                ReportMissing(*active.node->required_children[i]);
+            }
+        }
+    }
+    EndValue();
+}
+
+bool RuleStream::Key(const std::string& key) {
+    if (ignored_depth_ > 0 || Stopped()) {
+        return false;
+    }
+
+    path_.push_back("." + key);
+    next_.clear();
+    for (auto& active : frames_.back().active) {
+        auto child = active.node->children.find(key);
+        if (child != active.node->children.end()) {
+            if (child->second->required_slot >= 0) {
+                active.seen[child->second->required_slot] = true;
+            }
+            next_.push_back(child->second.get());
+        }
+        if (active.node->wildcard) {
+            next_.push_back(active.node->wildcard.get());
+        }
+    }
+    return !next_.empty();
+}
+
+void RuleStream::Scalar(const jsonscan::Value& value) {
+    if (ignored_depth_ > 0 || Stopped()) {
+        return;
+    }
+
+    for (const auto* node : StartValue()) {
+        for (const auto* rule : node->checks) {
+            Check(*rule, value);
+        }
+        // A scalar has no members, so everything required below it is missing
+        for (const auto* child : node->required_children) {
+            ReportMissing(*child);
+        }
+    }
+    EndValue();
+}
+
+void RuleStream::Skip() {
+    if (Stopped()) {
+        return;
+    }
+    StartValue();
+    EndValue();
+}
+
+void RuleStream::Feed(const jsonscan::Value& value) {
+    if (Stopped()) {
+        return;
+    }
+
+    // What rules find in a container depends only on its path and contents, so one that is
+    // unchanged since the base version gets the errors found there
+    bool container = value.type == Value::Type::kObject || value.type == Value::Type::kArray;
+    bool ok = true;
+    if (incremental_ && container && ignored_depth_ == 0) {
+        if (incremental_->Replay(value, 0, 0, errors_, errors_.max_size(), &ok)) {
+            Skip();
+            return;
+        }
+    }
+    size_t begin = errors_.size();
+
+    switch (value.type) {
+        case Value::Type::kObject:
+            if (StartObject()) {
+                for (const auto& [key, member] : value.members) {
+                    if (Key(key)) {
+                        Feed(member);
+                    } else {
+                        Skip();
+                    }
+                }
+            }
+            End();
+            break;
+        case Value::Type::kArray:
+            if (StartArray()) {
+                for (const auto& item : value.items) {
+                    Feed(item);
+                }
+            }
+            End();
+            break;
+        default:
+            Scalar(value);
+            break;
+    }
+
+    if (incremental_ && container && ignored_depth_ == 0) {
+        incremental_->Record(value, 0, 0, begin, errors_.size(), errors_.size() == begin);
+    }
+}
+
+bool RuleStream::Stopped() {
+    if (!stopped_ && budget_ && budget_->Exhausted()) {
+        stopped_ = true;
+    }
+    return stopped_;
+}
+
+// Trie nodes for the value that starts now; pushes its path segment inside arrays (Key()
+// already did inside objects)
+std::vector<const CompiledRuleSet::TrieNode*> RuleStream::StartValue() {
+    std::vector<const CompiledRuleSet::TrieNode*> nodes;
+    if (frames_.empty() || !frames_.back().array) {
+        nodes.swap(next_);
+        return nodes;
+    }
+
+    Frame& parent = frames_.back();
+    size_t index = parent.next_index++;
+    path_.push_back("[" + std::to_string(index) + "]");
+
+    // Numeric segments ("servers.0.host") address single elements
+    for (auto& active : parent.active) {
+        if (!active.node->children.empty()) {
+            auto child = active.node->children.find(std::to_string(index));
+            if (child != active.node->children.end()) {
+                if (child->second->required_slot >= 0) {
+                    active.seen[child->second->required_slot] = true;
+                }
+                nodes.push_back(child->second.get());
+            }
+        }
+        if (active.node->wildcard) {
+            nodes.push_back(active.node->wildcard.get());
+        }
+    }
+    return nodes;
+}
+
+void RuleStream::EndValue() {
+    if (!frames_.empty()) {
+        path_.pop_back();
+    }
+}
+
+bool RuleStream::StartContainer(bool array) {
+    if (ignored_depth_ > 0) {
+        ++ignored_depth_;
+        return false;
+    }
+    if (Stopped()) {
+        return false;
+    }
+
+    Value placeholder;
+    placeholder.type = array ? Value::Type::kArray : Value::Type::kObject;
+
+    Frame frame;
+    frame.array = array;
+    for (const auto* node : StartValue()) {
+        for (const auto* rule : node->checks) {
+            Check(*rule, placeholder);
+        }
+        if (!node->children.empty() || node->wildcard) {
+            frame.active.push_back({node, std::vector<bool>(node->required_children.size())});
+        }
+    }
+
+    if (frame.active.empty()) {
+        ignored_depth_ = 1;
+        return false;
+    }
+    frames_.push_back(std::move(frame));
+    return true;
+}
+
+void RuleStream::Check(const CompiledRuleSet::Rule& rule, const jsonscan::Value& value) {
+    using Type = CompiledRuleSet::Rule::Type;
+
+    if (rule.type == Type::kRange) {
+        if (value.type != Value::Type::kNumber) {
+            Fail(Path(), "range", rule, Path() + " must be a number");
+        } else if ((rule.min && value.number < *rule.min) ||
+                   (rule.max && value.number > *rule.max)) {
+            Fail(Path(), "range", rule,
+                 Path() + " must be between " + (rule.min ? FormatNumber(*rule.min) : "-inf") +
+                     " and " + (rule.max ? FormatNumber(*rule.max) : "inf") + ", got " +
+                     FormatNumber(value.number));
+        }
+    } else if (rule.type == Type::kFormat) {
+        if (value.type != Value::Type::kString ||
+            !std::regex_search(value.string, *rule.pattern)) {
+            Fail(Path(), "format", rule,
+                 Path() + " does not match pattern '" + rule.pattern_text + "'");
+        }
+    }
+}
+
+// child's key is absent: every required rule that needs it fails, reported at its full path
+// with the segments below child spelled out as in the rule
+void RuleStream::ReportMissing(const CompiledRuleSet::TrieNode& child) {
+    std::string prefix = Path();
+    if (!prefix.empty()) {
+        prefix += '.';
+    }
+    prefix += child.key;
+
+    for (const auto* rule : child.required_below) {
+        std::string field = prefix;
+        for (size_t i = child.depth; i < rule->segments.size(); ++i) {
+            field += '.' + rule->segments[i];
+        }
+        Fail(field, "required", *rule, "Required field '" + field + "' is missing");
+    }
+}
+
+void RuleStream::Fail(const std::string& field, const char* type,
+                      const CompiledRuleSet::Rule& rule, const std::string& default_message) {
+    configservice::ValidationError error;
+    error.set_field(field);
+    error.set_error_type(type);
+    error.set_message(rule.error_message.empty() ? default_message : rule.error_message);
+    errors_.push_back(std::move(error));
+}
+
+// "servers[2].port"
+std::string RuleStream::Path() const {
+    std::string path;
+    for (const auto& segment : path_) {
+        path += segment;
+    }
+    if (!path.empty() && path[0] == '.') {
+        path.erase(0, 1);
+    }
+    return path;
+}
+
+// ─── RuleSetCache ───────────────────────────────────────────────────
+
+RuleSetCache::RuleSetCache(std::chrono::milliseconds check_interval)
+    : check_interval_(check_interval) {}
+
+std::shared_ptr<const CompiledRuleSet> RuleSetCache::Get(const std::string& service_name,
+                                                         const VersionLoader& load_version,
+                                                         const RulesLoader& load_rules,
+                                                         bool* reloaded) {
+    auto now = std::chrono::steady_clock::now();
+    if (reloaded) {
+        *reloaded = false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto slot = slots_.find(service_name);
+        if (slot != slots_.end() && now - slot->second.checked_at < check_interval_) {
+            return slot->second.rules;
+        }
+    }
+
+    int64_t version = load_version();
+
+    if (version >= 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto slot = slots_.find(service_name);
+        if (slot != slots_.end() && slot->second.rules->version() == version) {
+            slot->second.checked_at = now;
+            return slot->second.rules;
+        }
+    }
+
+    // Changed, never loaded, or version unknown (then reload at most once per interval).
+    // A service that never had rules skips the rules query entirely.
+    std::optional<std::vector<ValidationRule>> loaded;
+    if (version != 0) {
+        loaded = load_rules();
+        if (!loaded) {
+            return CompiledRuleSet::Compile({}, -1);
+        }
+    }
+    auto rules = CompiledRuleSet::Compile(loaded ? *loaded : std::vector<ValidationRule>(),
+                                          version);
+    if (reloaded) {
+        *reloaded = true;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    slots_[service_name] = Slot{rules, now};
+    return rules;
+}
+
+}  // namespace validationservice
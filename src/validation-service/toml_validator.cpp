@@ -0,0 +1,1188 @@
+#include "validation_service/toml_validator.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+
+namespace validationservice {
+
+namespace {
+
+using Byte = unsigned char;
+using Value = jsonscan::Value;
+using Type = Value::Type;
+
+inline bool IsDigit(Byte c) {
+    return c >= '0' && c <= '9';
+}
+
+inline bool IsHexDigit(Byte c) {
+    return IsDigit(c) || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+inline bool IsOctalDigit(Byte c) {
+    return c >= '0' && c <= '7';
+}
+
+inline bool IsBinaryDigit(Byte c) {
+    return c == '0' || c == '1';
+}
+
+inline bool IsBareKeyByte(Byte c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || IsDigit(c) || c == '_' ||
+           c == '-';
+}
+
+// Tab is the only control character allowed in strings and comments
+inline bool IsControl(Byte c) {
+    return (c < 0x20 && c != '\t') || c == 0x7f;
+}
+
+// Printable ASCII up to the closing quote or a backslash: the bytes a string body can skip
+inline const char* PlainRun(const char* p, const char* end, char quote) {
+    while (p != end && static_cast<Byte>(*p) >= 0x20 && static_cast<Byte>(*p) < 0x7f &&
+           *p != quote && *p != '\\') {
+        ++p;
+    }
+    return p;
+}
+
+// Characters that end a bare value (number, boolean, date)
+inline bool IsValueEnd(Byte c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == ',' || c == ']' ||
+           c == '}' || c == '#';
+}
+
+// Length of the well-formed UTF-8 sequence at p, or 0 (overlong forms, surrogates and code
+// points past U+10FFFF are rejected)
+size_t Utf8Length(const Byte* p, const Byte* end) {
+    Byte c = p[0];
+    size_t length = 0;
+    uint32_t min = 0;
+    uint32_t code = 0;
+    if (c >= 0xC2 && c <= 0xDF) {
+        length = 2;
+        min = 0x80;
+        code = c & 0x1F;
+    } else if (c >= 0xE0 && c <= 0xEF) {
+        length = 3;
+        min = 0x800;
+        code = c & 0x0F;
+    } else if (c >= 0xF0 && c <= 0xF4) {
+        length = 4;
+        min = 0x10000;
+        code = c & 0x07;
+    } else {
+        return 0;
+    }
+    if (static_cast<size_t>(end - p) < length) {
+        return 0;
+    }
+    for (size_t i = 1; i < length; ++i) {
+        if ((p[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        code = (code << 6) | (p[i] & 0x3F);
+    }
+    if (code < min || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+        return 0;
+    }
+    return length;
+}
+
+void AppendUtf8(uint32_t code, std::string& out) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    } else {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+}
+
+// digit ('_'? digit)*, copying the digits to clean; false on a leading, trailing or doubled
+// underscore
+bool DigitRun(const char*& q, const char* end, bool (*is_digit)(Byte), std::string& clean) {
+    if (q == end || !is_digit(*q)) {
+        return false;
+    }
+    while (q != end) {
+        if (is_digit(*q)) {
+            clean += *q++;
+        } else if (*q == '_' && q + 1 != end && is_digit(q[1])) {
+            ++q;
+        } else {
+            break;
+        }
+    }
+    return true;
+}
+
+// n digits at text[pos], as a number; -1 if any is not a digit
+int Digits(std::string_view text, size_t pos, size_t n) {
+    if (pos + n > text.size()) {
+        return -1;
+    }
+    int number = 0;
+    for (size_t i = pos; i < pos + n; ++i) {
+        if (!IsDigit(text[i])) {
+            return -1;
+        }
+        number = number * 10 + (text[i] - '0');
+    }
+    return number;
+}
+
+// YYYY-MM-DD
+bool ValidDate(std::string_view text) {
+    static const int kDays[] = {31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    int year = Digits(text, 0, 4);
+    int month = Digits(text, 5, 2);
+    int day = Digits(text, 8, 2);
+    if (text.size() != 10 || year < 0 || text[4] != '-' || text[7] != '-' || month < 1 ||
+        month > 12 || day < 1 || day > kDays[month - 1]) {
+        return false;
+    }
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month != 2 || day <= 28 || leap;
+}
+
+// HH:MM:SS, optional fraction, then (when allowed) Z or a ±HH:MM offset
+bool ValidTime(std::string_view text, bool allow_offset) {
+    int hour = Digits(text, 0, 2);
+    int minute = Digits(text, 3, 2);
+    int second = Digits(text, 6, 2);
+    if (text.size() < 8 || text[2] != ':' || text[5] != ':' || hour < 0 || hour > 23 ||
+        minute < 0 || minute > 59 || second < 0 || second > 60) {
+        return false;
+    }
+
+    size_t pos = 8;
+    if (pos < text.size() && text[pos] == '.') {
+        size_t digits = ++pos;
+        while (pos < text.size() && IsDigit(text[pos])) {
+            ++pos;
+        }
+        if (pos == digits) {
+            return false;
+        }
+    }
+    if (pos == text.size()) {
+        return true;
+    }
+    if (!allow_offset) {
+        return false;
+    }
+    if (text[pos] == 'Z' || text[pos] == 'z') {
+        return pos + 1 == text.size();
+    }
+    std::string_view offset = text.substr(pos);
+    int offset_hour = Digits(offset, 1, 2);
+    int offset_minute = Digits(offset, 4, 2);
+    return offset.size() == 6 && (offset[0] == '+' || offset[0] == '-') && offset[3] == ':' &&
+           offset_hour >= 0 && offset_hour <= 23 && offset_minute >= 0 && offset_minute <= 59;
+}
+
+// How a key came to exist decides what may extend it later
+enum class Kind : uint8_t {
+    kImplicit,       // Parent of a [table] header, may still be defined by its own header
+    kHeader,         // Defined by [table] or as an element of [[table]]
+    kDotted,         // Created by a dotted key, may be extended by more dotted keys
+    kInline,         // Root of an inline table
+    kArrayOfTables,  // [[table]]
+};
+
+// Table in the key tree the parser checks definitions against. Values after '=' (inline
+// tables and arrays included) are leaves, not nodes, and go straight into the table's object
+// when the tree is built; subtables are moved into their slots once the document is done.
+struct Node {
+    struct Entry {
+        std::string_view key;
+        Node* table;    // Null for a value
+        size_t member;  // Index into object.members
+    };
+
+    Kind kind = Kind::kHeader;
+    std::vector<Entry> children;  // Document order
+    Value object;                 // Only filled when the tree is built
+    std::vector<Node*> tables;    // kArrayOfTables
+    std::unique_ptr<std::unordered_map<std::string_view, size_t>> index;  // Large tables only
+
+    // Small tables are scanned; an index only pays off past this many keys. Storage for
+    // that many is reserved up front, so most tables allocate once.
+    static constexpr size_t kIndexThreshold = 8;
+
+    const Entry* Find(std::string_view key) const {
+        if (index) {
+            auto it = index->find(key);
+            return it == index->end() ? nullptr : &children[it->second];
+        }
+        for (const auto& child : children) {
+            if (child.key == key) {
+                return &child;
+            }
+        }
+        return nullptr;
+    }
+
+    void Add(std::string_view key, Node* table) {
+        if (children.empty()) {
+            children.reserve(kIndexThreshold);
+        }
+        children.push_back({key, table, object.members.size()});
+        if (index) {
+            index->emplace(key, children.size() - 1);
+        } else if (children.size() > kIndexThreshold) {
+            index = std::make_unique<std::unordered_map<std::string_view, size_t>>();
+            index->reserve(children.size() * 2);
+            for (size_t i = 0; i < children.size(); ++i) {
+                index->emplace(children[i].key, i);
+            }
+        }
+    }
+};
+
+// A string token: a slice of the input, or decoded text when it had escapes
+struct Text {
+    std::string_view view;
+    std::string owned;
+    bool decoded = false;
+
+    std::string_view str() const { return decoded ? std::string_view(owned) : view; }
+};
+
+class Parser {
+   public:
+    Parser(std::string_view toml, bool build, size_t max_depth)
+        : begin_(toml.data()),
+          p_(toml.data()),
+          end_(toml.data() + toml.size()),
+          build_(build),
+          max_depth_(max_depth) {}
+
+    bool Run();
+    void Build(Value& root) { ToValue(*root_, root); }
+    jsonscan::ScanResult Result() const;
+
+   private:
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    bool build_;
+    size_t max_depth_;
+    size_t depth_ = 0;
+
+    const char* error_at_ = nullptr;
+    std::string error_message_;
+
+    std::deque<Node> nodes_;
+    std::deque<std::string> decoded_keys_;  // Keys that had escapes; nodes refer to these
+    Node* root_ = nullptr;
+    Node* current_ = nullptr;  // Table key/value lines go to
+    // Key being parsed at each nesting depth (0 = the current line), reused across lines
+    std::deque<std::vector<std::string_view>> keys_;
+
+    bool Error(const char* at, std::string message) {
+        if (error_at_ == nullptr) {
+            error_at_ = at;
+            error_message_ = std::move(message);
+        }
+        return false;
+    }
+
+    Node* NewNode(Kind kind) {
+        nodes_.emplace_back();
+        nodes_.back().kind = kind;
+        return &nodes_.back();
+    }
+
+    // Subtables get an empty member as their slot in the built tree
+    Node* AddTable(Node* parent, std::string_view key, Kind kind) {
+        Node* child = NewNode(kind);
+        parent->Add(key, child);
+        if (build_) {
+            AddMember(parent, key, Value());
+        }
+        return child;
+    }
+
+    void AddMember(Node* table, std::string_view key, Value&& value) {
+        auto& members = table->object.members;
+        if (members.empty()) {
+            members.reserve(Node::kIndexThreshold);
+        }
+        members.emplace_back(std::string(key), std::move(value));
+    }
+
+    std::vector<std::string_view>& KeyAtDepth() {
+        if (keys_.size() <= depth_) {
+            keys_.resize(depth_ + 1);
+        }
+        return keys_[depth_];
+    }
+
+    void SkipWhitespace() {
+        while (p_ != end_ && (*p_ == ' ' || *p_ == '\t')) {
+            ++p_;
+        }
+    }
+
+    bool AtNewline() const {
+        return p_ != end_ && (*p_ == '\n' || (*p_ == '\r' && p_ + 1 != end_ && p_[1] == '\n'));
+    }
+
+    void SkipNewline() { p_ += *p_ == '\r' ? 2 : 1; }
+
+    bool SkipComment();
+    bool EndOfLine(const char* what);
+    bool SkipBlank();
+
+    bool ParseKey(std::vector<std::string_view>& key);
+    bool ParseSimpleKey(std::string_view& key);
+    bool ParseHeader();
+    bool ParseKeyValue(Node* table);
+    bool Assign(Node* table, const std::vector<std::string_view>& key, Value&& value,
+                const char* at);
+
+    bool ParseValue(Value& value);
+    bool ParseBasicString(Text& text);
+    bool ParseLiteralString(Text& text);
+    bool ParseMultilineString(Text& text, char quote);
+    bool ParseEscape(std::string& out);
+    bool ParseBareValue(Value& value);
+    bool ParseNumber(std::string_view token, Value& value);
+    bool ParseArray(Value& value);
+    bool ParseInlineTable(Value& value);
+
+    void ToValue(Node& node, Value& out);
+};
+
+std::string JoinKey(const std::vector<std::string_view>& key, size_t count) {
+    std::string path;
+    for (size_t i = 0; i < count; ++i) {
+        if (i > 0) {
+            path += '.';
+        }
+        path.append(key[i].data(), key[i].size());
+    }
+    return path;
+}
+
+bool Parser::Run() {
+    root_ = NewNode(Kind::kHeader);
+    current_ = root_;
+
+    if (end_ - p_ >= 3 && std::memcmp(p_, "\xEF\xBB\xBF", 3) == 0) {
+        p_ += 3;
+    }
+
+    while (true) {
+        SkipWhitespace();
+        if (p_ == end_) {
+            return true;
+        }
+        if (AtNewline()) {
+            SkipNewline();
+            continue;
+        }
+
+        bool ok = false;
+        if (*p_ == '#') {
+            ok = EndOfLine("comment");
+        } else if (*p_ == '[') {
+            ok = ParseHeader() && EndOfLine("table header");
+        } else {
+            ok = ParseKeyValue(current_) && EndOfLine("value");
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+}
+
+bool Parser::SkipComment() {
+    ++p_;
+    while (p_ != end_ && *p_ != '\n') {
+        Byte c = *p_;
+        if (c == '\r' && p_ + 1 != end_ && p_[1] == '\n') {
+            return true;
+        }
+        if (c >= 0x80) {
+            size_t length = Utf8Length(reinterpret_cast<const Byte*>(p_),
+                                       reinterpret_cast<const Byte*>(end_));
+            if (length == 0) {
+                return Error(p_, "Invalid UTF-8 in comment");
+            }
+            p_ += length;
+            continue;
+        }
+        if (IsControl(c)) {
+            return Error(p_, "Control character in comment");
+        }
+        ++p_;
+    }
+    return true;
+}
+
+// Whitespace and an optional comment up to the end of the line
+bool Parser::EndOfLine(const char* what) {
+    SkipWhitespace();
+    if (p_ != end_ && *p_ == '#' && !SkipComment()) {
+        return false;
+    }
+    if (p_ == end_) {
+        return true;
+    }
+    if (!AtNewline()) {
+        return Error(p_, std::string("Expected a new line after ") + what);
+    }
+    SkipNewline();
+    return true;
+}
+
+// Whitespace, comments and newlines, as allowed between array elements
+bool Parser::SkipBlank() {
+    while (p_ != end_) {
+        if (*p_ == ' ' || *p_ == '\t') {
+            ++p_;
+        } else if (AtNewline()) {
+            SkipNewline();
+        } else if (*p_ == '#') {
+            if (!SkipComment()) {
+                return false;
+            }
+        } else {
+            break;
+        }
+    }
+    return true;
+}
+
+bool Parser::ParseSimpleKey(std::string_view& key) {
+    if (p_ == end_) {
+        return Error(p_, "Expected a key");
+    }
+    if (*p_ == '"' || *p_ == '\'') {
+        if (end_ - p_ >= 3 && p_[1] == *p_ && p_[2] == *p_) {
+            return Error(p_, "Multi-line strings cannot be keys");
+        }
+        Text text;
+        if (!(*p_ == '"' ? ParseBasicString(text) : ParseLiteralString(text))) {
+            return false;
+        }
+        if (text.decoded) {
+            decoded_keys_.push_back(std::move(text.owned));
+            key = decoded_keys_.back();
+        } else {
+            key = text.view;
+        }
+        return true;
+    }
+
+    const char* start = p_;
+    while (p_ != end_ && IsBareKeyByte(*p_)) {
+        ++p_;
+    }
+    if (p_ == start) {
+        return Error(p_, "Expected a key");
+    }
+    key = std::string_view(start, p_ - start);
+    return true;
+}
+
+// simple-key ('.' simple-key)*, with optional whitespace around the dots
+bool Parser::ParseKey(std::vector<std::string_view>& key) {
+    key.clear();
+    while (true) {
+        std::string_view part;
+        if (!ParseSimpleKey(part)) {
+            return false;
+        }
+        key.push_back(part);
+        if (key.size() > max_depth_) {
+            return Error(p_, "Key is nested too deeply");
+        }
+        SkipWhitespace();
+        if (p_ == end_ || *p_ != '.') {
+            return true;
+        }
+        ++p_;
+        SkipWhitespace();
+    }
+}
+
+bool Parser::ParseHeader() {
+    const char* at = p_;
+    bool array = end_ - p_ >= 2 && p_[1] == '[';
+    p_ += array ? 2 : 1;
+    SkipWhitespace();
+
+    auto& key = KeyAtDepth();
+    if (!ParseKey(key)) {
+        return false;
+    }
+    if (p_ == end_ || *p_ != ']' || (array && (end_ - p_ < 2 || p_[1] != ']'))) {
+        return Error(p_, array ? "Expected ']]' to close the table header"
+                               : "Expected ']' to close the table header");
+    }
+    p_ += array ? 2 : 1;
+
+    // Parents are created as needed; an array of tables is entered at its last element
+    Node* table = root_;
+    for (size_t i = 0; i + 1 < key.size(); ++i) {
+        const Node::Entry* entry = table->Find(key[i]);
+        Node* child = nullptr;
+        if (entry == nullptr) {
+            child = AddTable(table, key[i], Kind::kImplicit);
+        } else if (entry->table == nullptr) {
+            return Error(at, "Key '" + JoinKey(key, i + 1) + "' is a value, not a table");
+        } else if (entry->table->kind == Kind::kArrayOfTables) {
+            child = entry->table->tables.back();
+        } else {
+            child = entry->table;
+        }
+        table = child;
+    }
+
+    const Node::Entry* entry = table->Find(key.back());
+    if (entry != nullptr && entry->table == nullptr) {
+        return Error(at, "Key '" + JoinKey(key, key.size()) + "' is already defined");
+    }
+    Node* child = entry == nullptr ? nullptr : entry->table;
+    if (!array) {
+        if (child == nullptr) {
+            child = AddTable(table, key.back(), Kind::kHeader);
+        } else if (child->kind == Kind::kImplicit) {
+            child->kind = Kind::kHeader;
+        } else {
+            return Error(at, "Table '" + JoinKey(key, key.size()) + "' is already defined");
+        }
+        current_ = child;
+        return true;
+    }
+
+    if (child == nullptr) {
+        child = AddTable(table, key.back(), Kind::kArrayOfTables);
+    } else if (child->kind != Kind::kArrayOfTables) {
+        return Error(at, "Key '" + JoinKey(key, key.size()) +
+                             "' is already defined and is not an array of tables");
+    }
+    child->tables.push_back(NewNode(Kind::kHeader));
+    current_ = child->tables.back();
+    return true;
+}
+
+bool Parser::ParseKeyValue(Node* table) {
+    const char* at = p_;
+    auto& key = KeyAtDepth();
+    if (!ParseKey(key)) {
+        return false;
+    }
+    if (p_ == end_ || *p_ != '=') {
+        return Error(p_, "Expected '=' after key");
+    }
+    ++p_;
+    SkipWhitespace();
+
+    Value value;
+    return ParseValue(value) && Assign(table, key, std::move(value), at);
+}
+
+// Dotted keys create (or extend) tables of their own; anything else in the way is an error
+bool Parser::Assign(Node* table, const std::vector<std::string_view>& key, Value&& value,
+                    const char* at) {
+    for (size_t i = 0; i + 1 < key.size(); ++i) {
+        const Node::Entry* entry = table->Find(key[i]);
+        Node* child = nullptr;
+        if (entry == nullptr) {
+            child = AddTable(table, key[i], Kind::kDotted);
+        } else if (entry->table != nullptr && entry->table->kind == Kind::kDotted) {
+            child = entry->table;
+        } else {
+            return Error(at, "Key '" + JoinKey(key, i + 1) + "' is already defined");
+        }
+        table = child;
+    }
+
+    if (table->Find(key.back()) != nullptr) {
+        return Error(at, "Duplicate key '" + JoinKey(key, key.size()) + "'");
+    }
+    table->Add(key.back(), nullptr);
+    if (build_) {
+        AddMember(table, key.back(), std::move(value));
+    }
+    return true;
+}
+
+bool Parser::ParseValue(Value& value) {
+    if (p_ == end_) {
+        return Error(p_, "Expected a value");
+    }
+
+    Text text;
+    bool ok = true;
+    switch (*p_) {
+        case '"':
+        case '\'':
+            if (end_ - p_ >= 3 && p_[1] == *p_ && p_[2] == *p_) {
+                ok = ParseMultilineString(text, *p_);
+            } else {
+                ok = *p_ == '"' ? ParseBasicString(text) : ParseLiteralString(text);
+            }
+            if (ok) {
+                value.type = Type::kString;
+                if (build_) {
+                    value.string = text.decoded ? std::move(text.owned) : std::string(text.view);
+                }
+            }
+            return ok;
+        case '[':
+        case '{':
+            if (++depth_ > max_depth_) {
+                return Error(p_, "Maximum nesting depth of " + std::to_string(max_depth_) +
+                                     " exceeded");
+            }
+            ok = *p_ == '[' ? ParseArray(value) : ParseInlineTable(value);
+            --depth_;
+            return ok;
+        default:
+            return ParseBareValue(value);
+    }
+}
+
+bool Parser::ParseBasicString(Text& text) {
+    const char* open = p_++;
+    const char* start = p_;
+    while (p_ != end_) {
+        const char* run = PlainRun(p_, end_, '"');
+        if (text.decoded) {
+            text.owned.append(p_, run - p_);
+        }
+        p_ = run;
+        if (p_ == end_) {
+            break;
+        }
+
+        Byte c = *p_;
+        if (c == '"') {
+            if (!text.decoded) {
+                text.view = std::string_view(start, p_ - start);
+            }
+            ++p_;
+            return true;
+        }
+        if (c == '\\') {
+            if (!text.decoded) {
+                text.owned.assign(start, p_ - start);
+                text.decoded = true;
+            }
+            if (!ParseEscape(text.owned)) {
+                return false;
+            }
+            continue;
+        }
+        if (c == '\n' || c == '\r') {
+            return Error(open, "Unterminated string");
+        }
+        if (IsControl(c)) {
+            return Error(p_, "Control character in string");
+        }
+        size_t length = 1;
+        if (c >= 0x80) {
+            length = Utf8Length(reinterpret_cast<const Byte*>(p_),
+                                reinterpret_cast<const Byte*>(end_));
+            if (length == 0) {
+                return Error(p_, "Invalid UTF-8 in string");
+            }
+        }
+        if (text.decoded) {
+            text.owned.append(p_, length);
+        }
+        p_ += length;
+    }
+    return Error(open, "Unterminated string");
+}
+
+bool Parser::ParseLiteralString(Text& text) {
+    const char* open = p_++;
+    const char* start = p_;
+    while (p_ != end_) {
+        p_ = PlainRun(p_, end_, '\'');
+        if (p_ == end_) {
+            break;
+        }
+
+        Byte c = *p_;
+        if (c == '\'') {
+            text.view = std::string_view(start, p_ - start);
+            ++p_;
+            return true;
+        }
+        if (c == '\n' || c == '\r') {
+            return Error(open, "Unterminated string");
+        }
+        if (IsControl(c)) {
+            return Error(p_, "Control character in string");
+        }
+        if (c >= 0x80) {
+            size_t length = Utf8Length(reinterpret_cast<const Byte*>(p_),
+                                       reinterpret_cast<const Byte*>(end_));
+            if (length == 0) {
+                return Error(p_, "Invalid UTF-8 in string");
+            }
+            p_ += length;
+            continue;
+        }
+        ++p_;
+    }
+    return Error(open, "Unterminated string");
+}
+
+// """...""" or '''...''': a newline right after the opening quotes is dropped, up to two
+// quotes may precede the closing three, and (basic strings only) a backslash at the end of a
+// line trims the line break and the whitespace after it
+bool Parser::ParseMultilineString(Text& text, char quote) {
+    const char* open = p_;
+    p_ += 3;
+    if (AtNewline()) {
+        SkipNewline();
+    }
+    text.decoded = true;
+
+    while (p_ != end_) {
+        Byte c = *p_;
+        if (c == static_cast<Byte>(quote)) {
+            const char* run = p_;
+            while (p_ != end_ && *p_ == quote) {
+                ++p_;
+            }
+            size_t quotes = p_ - run;
+            if (quotes >= 3) {
+                if (quotes > 5) {
+                    return Error(run, "Too many quotes at the end of a multi-line string");
+                }
+                text.owned.append(quotes - 3, quote);
+                return true;
+            }
+            text.owned.append(quotes, quote);
+            continue;
+        }
+        if (c == '\\' && quote == '"') {
+            const char* q = p_ + 1;
+            while (q != end_ && (*q == ' ' || *q == '\t')) {
+                ++q;
+            }
+            if (q != end_ && (*q == '\n' || (*q == '\r' && q + 1 != end_ && q[1] == '\n'))) {
+                p_ = q;
+                while (p_ != end_ && (*p_ == ' ' || *p_ == '\t' || AtNewline())) {
+                    if (*p_ == ' ' || *p_ == '\t') {
+                        ++p_;
+                    } else {
+                        SkipNewline();
+                    }
+                }
+                continue;
+            }
+            if (!ParseEscape(text.owned)) {
+                return false;
+            }
+            continue;
+        }
+        if (AtNewline()) {
+            text.owned += '\n';
+            SkipNewline();
+            continue;
+        }
+        if (IsControl(c)) {
+            return Error(p_, "Control character in string");
+        }
+        size_t length = 1;
+        if (c >= 0x80) {
+            length = Utf8Length(reinterpret_cast<const Byte*>(p_),
+                                reinterpret_cast<const Byte*>(end_));
+            if (length == 0) {
+                return Error(p_, "Invalid UTF-8 in string");
+            }
+        }
+        text.owned.append(p_, length);
+        p_ += length;
+    }
+    return Error(open, "Unterminated multi-line string");
+}
+
+bool Parser::ParseEscape(std::string& out) {
+    const char* at = p_++;
+    if (p_ == end_) {
+        return Error(at, "Invalid escape sequence");
+    }
+
+    size_t digits = 0;
+    switch (*p_) {
+        case 'b':
+            out += '\b';
+            break;
+        case 't':
+            out += '\t';
+            break;
+        case 'n':
+            out += '\n';
+            break;
+        case 'f':
+            out += '\f';
+            break;
+        case 'r':
+            out += '\r';
+            break;
+        case '"':
+            out += '"';
+            break;
+        case '\\':
+            out += '\\';
+            break;
+        case 'u':
+            digits = 4;
+            break;
+        case 'U':
+            digits = 8;
+            break;
+        default:
+            return Error(at, "Invalid escape sequence");
+    }
+    ++p_;
+    if (digits == 0) {
+        return true;
+    }
+
+    if (static_cast<size_t>(end_ - p_) < digits) {
+        return Error(at, "Invalid Unicode escape");
+    }
+    uint32_t code = 0;
+    for (size_t i = 0; i < digits; ++i) {
+        Byte c = p_[i];
+        if (!IsHexDigit(c)) {
+            return Error(at, "Invalid Unicode escape");
+        }
+        code = (code << 4) | static_cast<uint32_t>(IsDigit(c) ? c - '0' : (c | 0x20) - 'a' + 10);
+    }
+    if (code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF)) {
+        return Error(at, "Unicode escape is not a scalar value");
+    }
+    AppendUtf8(code, out);
+    p_ += digits;
+    return true;
+}
+
+// Booleans, numbers, dates and times: everything up to the next delimiter
+bool Parser::ParseBareValue(Value& value) {
+    const char* start = p_;
+    while (p_ != end_ && !IsValueEnd(*p_)) {
+        ++p_;
+    }
+    // A date and a time may also be separated by a space
+    if (p_ - start == 10 && end_ - p_ >= 4 && *p_ == ' ' && IsDigit(p_[1]) && IsDigit(p_[2]) &&
+        p_[3] == ':') {
+        ++p_;
+        while (p_ != end_ && !IsValueEnd(*p_)) {
+            ++p_;
+        }
+    }
+    std::string_view token(start, p_ - start);
+    if (token.empty()) {
+        return Error(start, "Expected a value");
+    }
+
+    if (token == "true" || token == "false") {
+        value.type = Type::kBool;
+        value.boolean = token[0] == 't';
+        return true;
+    }
+
+    bool date = token.size() >= 10 && token[4] == '-' && Digits(token, 0, 4) >= 0;
+    bool time = !date && token.size() >= 8 && token[2] == ':' && Digits(token, 0, 2) >= 0;
+    if (date || time) {
+        bool ok = time ? ValidTime(token, false) : ValidDate(token.substr(0, 10));
+        if (ok && date && token.size() > 10) {
+            char separator = token[10];
+            ok = (separator == 'T' || separator == 't' || separator == ' ') &&
+                 ValidTime(token.substr(11), true);
+        }
+        if (!ok) {
+            return Error(start, "Invalid date-time '" + std::string(token) + "'");
+        }
+        value.type = Type::kString;
+        if (build_) {
+            value.string = std::string(token);
+        }
+        return true;
+    }
+
+    return ParseNumber(token, value);
+}
+
+bool Parser::ParseNumber(std::string_view token, Value& value) {
+    const char* q = token.data();
+    const char* end = q + token.size();
+    std::string clean;
+    value.type = Type::kNumber;
+
+    // Hexadecimal, octal and binary integers are unsigned and fit in 64-bit signed integers
+    if (token.size() > 2 && token[0] == '0' &&
+        (token[1] == 'x' || token[1] == 'o' || token[1] == 'b')) {
+        int base = token[1] == 'x' ? 16 : token[1] == 'o' ? 8 : 2;
+        q += 2;
+        if (!DigitRun(q, end, base == 16 ? IsHexDigit : base == 8 ? IsOctalDigit : IsBinaryDigit,
+                      clean) ||
+            q != end) {
+            return Error(token.data(), "Invalid number '" + std::string(token) + "'");
+        }
+        errno = 0;
+        unsigned long long number = std::strtoull(clean.c_str(), nullptr, base);
+        if (errno == ERANGE ||
+            number > static_cast<unsigned long long>(std::numeric_limits<int64_t>::max())) {
+            return Error(token.data(), "Integer '" + std::string(token) + "' is out of range");
+        }
+        value.number = static_cast<double>(number);
+        if (build_) {
+            value.string = std::to_string(number);
+        }
+        return true;
+    }
+
+    if (*q == '+' || *q == '-') {
+        if (*q == '-') {
+            clean += '-';
+        }
+        ++q;
+    }
+    std::string_view body(q, end - q);
+    if (body == "inf" || body == "nan") {
+        value.number = body == "nan" ? std::numeric_limits<double>::quiet_NaN()
+                       : token[0] == '-' ? -std::numeric_limits<double>::infinity()
+                                         : std::numeric_limits<double>::infinity();
+        if (build_) {
+            value.string = std::string(token);
+        }
+        return true;
+    }
+
+    if (q != end && *q == '0' && q + 1 != end && (IsDigit(q[1]) || q[1] == '_')) {
+        return Error(token.data(), "Leading zeros are not allowed in '" + std::string(token) + "'");
+    }
+    bool ok = DigitRun(q, end, IsDigit, clean);
+    bool fractional = false;
+    if (ok && q != end && *q == '.') {
+        clean += *q++;
+        ok = DigitRun(q, end, IsDigit, clean);
+        fractional = true;
+    }
+    if (ok && q != end && (*q == 'e' || *q == 'E')) {
+        clean += *q++;
+        if (q != end && (*q == '+' || *q == '-')) {
+            clean += *q++;
+        }
+        ok = DigitRun(q, end, IsDigit, clean);
+        fractional = true;
+    }
+    if (!ok || q != end) {
+        return Error(token.data(), "Invalid value '" + std::string(token) + "'");
+    }
+
+    // A syntax check only converts integers long enough to overflow
+    if (fractional) {
+        if (build_) {
+            value.number = std::strtod(clean.c_str(), nullptr);
+        }
+    } else if (build_ || clean.size() >= 19) {
+        errno = 0;
+        long long number = std::strtoll(clean.c_str(), nullptr, 10);
+        if (errno == ERANGE) {
+            return Error(token.data(), "Integer '" + std::string(token) + "' is out of range");
+        }
+        value.number = static_cast<double>(number);
+    }
+    if (build_) {
+        value.string = std::move(clean);
+    }
+    return true;
+}
+
+// Elements may span lines and be followed by comments; a trailing comma is allowed
+bool Parser::ParseArray(Value& value) {
+    ++p_;
+    value.type = Type::kArray;
+    while (true) {
+        if (!SkipBlank()) {
+            return false;
+        }
+        if (p_ != end_ && *p_ == ']') {
+            ++p_;
+            return true;
+        }
+
+        value.items.emplace_back();
+        if (!ParseValue(value.items.back()) || !SkipBlank()) {
+            return false;
+        }
+        if (p_ != end_ && *p_ == ',') {
+            ++p_;
+            continue;
+        }
+        if (p_ != end_ && *p_ == ']') {
+            ++p_;
+            return true;
+        }
+        return Error(p_, "Expected ',' or ']' after array element");
+    }
+}
+
+// One line, no trailing comma; keys follow the same rules as in a table
+bool Parser::ParseInlineTable(Value& value) {
+    ++p_;
+    Node* table = NewNode(Kind::kInline);
+    auto& key = KeyAtDepth();
+
+    SkipWhitespace();
+    if (p_ != end_ && *p_ == '}') {
+        ++p_;
+        ToValue(*table, value);
+        return true;
+    }
+
+    while (true) {
+        const char* at = p_;
+        if (!ParseKey(key)) {
+            return false;
+        }
+        if (p_ == end_ || *p_ != '=') {
+            return Error(p_, "Expected '=' after key");
+        }
+        ++p_;
+        SkipWhitespace();
+
+        Value member;
+        if (!ParseValue(member) || !Assign(table, key, std::move(member), at)) {
+            return false;
+        }
+
+        SkipWhitespace();
+        if (p_ != end_ && *p_ == '}') {
+            ++p_;
+            ToValue(*table, value);
+            return true;
+        }
+        if (p_ == end_ || *p_ != ',') {
+            return Error(p_, "Expected ',' or '}' in inline table");
+        }
+        ++p_;
+        SkipWhitespace();
+        if (p_ != end_ && *p_ == '}') {
+            return Error(p_, "Trailing comma is not allowed in an inline table");
+        }
+    }
+}
+
+void Parser::ToValue(Node& node, Value& out) {
+    if (node.kind == Kind::kArrayOfTables) {
+        out.type = Type::kArray;
+        if (build_) {
+            out.items.resize(node.tables.size());
+            for (size_t i = 0; i < node.tables.size(); ++i) {
+                ToValue(*node.tables[i], out.items[i]);
+            }
+        }
+        return;
+    }
+
+    out = std::move(node.object);
+    out.type = Type::kObject;
+    for (const auto& child : node.children) {
+        if (child.table != nullptr && build_) {
+            ToValue(*child.table, out.members[child.member].second);
+        }
+    }
+}
+
+jsonscan::ScanResult Parser::Result() const {
+    jsonscan::ScanResult result;
+    if (error_at_ == nullptr) {
+        return result;
+    }
+
+    result.valid = false;
+    result.message = error_message_;
+    result.offset = static_cast<size_t>(error_at_ - begin_);
+
+    // Positions are only needed on failure, so they are derived here instead of being
+    // tracked for every byte
+    result.line = 1 + static_cast<int>(std::count(begin_, error_at_, '\n'));
+    const char* line_start = error_at_;
+    while (line_start > begin_ && line_start[-1] != '\n') {
+        --line_start;
+    }
+    result.column = 1 + static_cast<int>(std::count_if(line_start, error_at_, [](char c) {
+                        return (static_cast<Byte>(c) & 0xC0) != 0x80;
+                    }));
+    return result;
+}
+
+}  // anonymous namespace
+
+jsonscan::ScanResult ParseToml(std::string_view toml, jsonscan::Value* root, size_t max_depth) {
+    if (root != nullptr) {
+        *root = Value();
+    }
+    Parser parser(toml, root != nullptr, max_depth);
+    if (parser.Run() && root != nullptr) {
+        parser.Build(*root);
+    }
+    return parser.Result();
+}
+
+bool TomlValidator::ValidateSyntax(const std::string& content,
+                                   std::vector<configservice::ValidationError>& errors) {
+    auto scan = ParseToml(content, nullptr);
+    if (!scan.valid) {
+        AddError(errors, scan);
+        return false;
+    }
+
+    return true;
+}
+
+bool TomlValidator::Parse(const std::string& content, jsonscan::Value& document,
+                          std::vector<configservice::ValidationError>& errors) {
+    auto scan = ParseToml(content, &document);
+    if (!scan.valid) {
+        AddError(errors, scan);
+        return false;
+    }
+
+    return true;
+}
+
+void TomlValidator::AddError(std::vector<configservice::ValidationError>& errors,
+                             const jsonscan::ScanResult& scan) {
+    configservice::ValidationError error;
+    error.set_error_type("syntax");
+    error.set_message(scan.Describe());
+    error.set_line(scan.line);
+    error.set_column(scan.column);
+    errors.push_back(error);
+}
+
+}  // namespace validationservice
@@ -0,0 +1,28 @@
+#include "validation_service/validation_budget.h"
+
+namespace validationservice {
+
+ValidationBudget::ValidationBudget()
+    : start_(Clock::now()), deadline_(Clock::time_point::max()) {}
+
+ValidationBudget::ValidationBudget(Clock::time_point deadline, std::function<bool()> cancelled)
+    : start_(Clock::now()), deadline_(deadline), cancelled_(std::move(cancelled)) {}
+
+bool ValidationBudget::Check() {
+    calls_ = 0;
+    if (state_ != State::kWithin) {
+        return true;
+    }
+    if (cancelled_ && cancelled_()) {
+        state_ = State::kCancelled;
+    } else if (deadline_ != Clock::time_point::max() && Clock::now() >= deadline_) {
+        state_ = State::kDeadlineExceeded;
+    }
+    return state_ != State::kWithin;
+}
+
+std::chrono::milliseconds ValidationBudget::elapsed() const {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_);
+}
+
+}  // namespace validationservice
@@ -1,11 +1,15 @@
 #include "validation_service/validation_service.h"
+#include "contenthash/content_hash.h"
 
+#include <algorithm>
 #include <chrono>
-#include <climits>
+#include <condition_variable>
 #include <ctime>
-#include <functional>
+#include <deque>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 
 namespace validationservice {
 
@@ -39,8 +43,40 @@ bool ValidationServiceImpl::Initialize() {
 
     // Initialize validators
     json_validator_ = std::make_unique<JsonValidator>();
-    yaml_validator_ = std::make_unique<YamlValidator>();
-    std::cout << "[ValidationService] ✓ Validators initialized" << std::endl;
+    yaml_validator_ = std::make_unique<YamlValidator>(config_.validation.yaml_max_depth,
+                                                      config_.validation.yaml_max_alias_nodes);
+    toml_validator_ = std::make_unique<TomlValidator>();
+    schema_cache_ = std::make_unique<SchemaCache>(
+        std::chrono::seconds(config_.validation.schema_cache_ttl_seconds));
+    rule_cache_ = std::make_unique<RuleSetCache>(
+        std::chrono::milliseconds(config_.validation.rules_version_check_ms));
+    result_cache_ = std::make_unique<ResultCache>(
+        static_cast<size_t>(config_.validation.result_cache_max_mb) * 1024 * 1024,
+        std::chrono::seconds(config_.redis.cache_ttl_seconds));
+    if (config_.validation.incremental_cache_mb > 0) {
+        baseline_cache_ = std::make_unique<BaselineCache>(
+            static_cast<size_t>(config_.validation.incremental_cache_mb) * 1024 * 1024);
+    }
+    batch_pool_ = std::make_unique<WorkerPool>(
+        static_cast<size_t>(std::max(config_.validation.batch_workers, 0)));
+    std::cout << "[ValidationService] ✓ Validators initialized (" << batch_pool_->size()
+              << " batch workers)" << std::endl;
+
+    // History is written in batches by a background thread
+    history_ = std::make_unique<HistoryRecorder>(
+        config_.history,
+        [this](const std::vector<HistoryRecord>& records) {
+            return db_->RecordValidations(records);
+        },
+        [this](int retention_days, int batch_size) {
+            return db_->PruneValidationHistory(retention_days, batch_size);
+        });
+    history_->Start();
+    if (config_.history.enabled) {
+        std::cout << "[ValidationService] ✓ History recorder started (sample rate "
+                  << config_.history.sample_rate << ", retention "
+                  << config_.history.retention_days << " days)" << std::endl;
+    }
 
     // Initialize Redis for caching
     if (config_.validation.enable_caching) {
@@ -77,6 +113,11 @@ void ValidationServiceImpl::Shutdown() {
         redis_ctx_ = nullptr;
     }
 
+    // Writes what is still queued, so before the database goes away
+    if (history_) {
+        history_->Stop();
+    }
+
     if (db_) {
         db_->Shutdown();
     }
@@ -87,58 +128,409 @@ void ValidationServiceImpl::Shutdown() {
 grpc::Status ValidationServiceImpl::ValidateConfig(
     grpc::ServerContext* context, const configservice::ValidateConfigRequest* request,
     configservice::ValidateConfigResponse* response) {
-    auto start_time = std::chrono::steady_clock::now();
-
     std::cout << "[ValidationService] ValidateConfig: service=" << request->service_name()
               << " format=" << request->format() << std::endl;
 
     RecordMetric("validate.request");
 
-    std::vector<configservice::ValidationError> errors;
-    std::vector<configservice::ValidationWarning> warnings;
+    ValidationBudget budget = MakeBudget(context);
+    ValidationInputs inputs;
+    inputs.rules = LoadRules(request->service_name());
+    if (!request->schema_id().empty()) {
+        inputs.schema = LoadSchema(request->schema_id());
+    }
 
-    // Check cache first
-    std::string content_hash = ComputeHash(request->content());
-    std::string cache_key = "validation:" + request->service_name() + ":" + content_hash;
+    switch (Validate(*request, inputs, budget, response)) {
+        case Outcome::kDeadlineExceeded:
+            // gRPC drops the response message on errors, so the partial result travels in
+            // the status details
+            return grpc::Status(grpc::StatusCode::DEADLINE_EXCEEDED, response->message(),
+                                response->SerializeAsString());
+        case Outcome::kCancelled:
+            return grpc::Status(grpc::StatusCode::CANCELLED, response->message());
+        default:
+            return grpc::Status::OK;
+    }
+}
 
-    if (config_.validation.enable_caching) {
-        std::string cached = GetCachedValidationResult(cache_key);
-        if (!cached.empty()) {
-            std::cout << "[ValidationService] Cache hit for " << cache_key << std::endl;
-            RecordMetric("validate.cache_hit");
+grpc::Status ValidationServiceImpl::ValidateConfigs(
+    grpc::ServerContext* context,
+    grpc::ServerReaderWriter<configservice::ValidateConfigsResponse,
+                             configservice::ValidateConfigsRequest>* stream) {
+    auto start_time = std::chrono::steady_clock::now();
+    RecordMetric("validate_batch.request");
+
+    // Rules and schemas are loaded once per batch, not once per item
+    std::unordered_map<std::string, std::shared_ptr<const CompiledRuleSet>> rules_by_service;
+    std::unordered_map<std::string, SchemaCache::Entry> schemas_by_id;
+
+    // Workers only queue finished responses; this thread writes them all, so a client that
+    // reads slowly holds up its own batch and never a pool worker. Requests are read on a
+    // thread of their own meanwhile, so responses flow while the client is still sending.
+    std::mutex mutex;
+    std::condition_variable progress;
+    std::deque<configservice::ValidateConfigsResponse> finished;
+    size_t in_flight = 0;  // Read but not yet written
+    bool reading = true;
+    bool write_failed = false;
+    configservice::ValidateConfigsSummary summary;
+
+    // Reading stops while this many items are queued, running or waiting to be written,
+    // bounding memory
+    const size_t max_in_flight = 2 * batch_pool_->size();
+
+    int64_t total_bytes = 0;
+    std::thread reader([&] {
+        int32_t index = 0;
+        configservice::ValidateConfigsRequest item;
+        while (!context->IsCancelled() && stream->Read(&item)) {
+            const auto& request = item.item();
+
+            ValidationInputs inputs;
+            auto rules = rules_by_service.find(request.service_name());
+            if (rules == rules_by_service.end()) {
+                rules = rules_by_service
+                            .emplace(request.service_name(), LoadRules(request.service_name()))
+                            .first;
+            }
+            inputs.rules = rules->second;
+            if (!request.schema_id().empty()) {
+                auto schema = schemas_by_id.find(request.schema_id());
+                if (schema == schemas_by_id.end()) {
+                    schema = schemas_by_id
+                                 .emplace(request.schema_id(), LoadSchema(request.schema_id()))
+                                 .first;
+                }
+                inputs.schema = schema->second;
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                progress.wait(lock, [&] { return in_flight < max_in_flight || write_failed; });
+                if (write_failed) {
+                    break;
+                }
+                ++in_flight;
+            }
+
+            total_bytes += request.content().size();
+            batch_pool_->Submit([&, index, item = std::move(item), inputs = std::move(inputs)] {
+                configservice::ValidateConfigsResponse result;
+                result.set_index(index);
+                result.set_item_id(item.item_id());
+                // Each item gets the full time budget from when a worker picks it up
+                ValidationBudget budget = MakeBudget(context);
+                Outcome outcome = Validate(item.item(), inputs, budget, result.mutable_result());
+
+                std::lock_guard<std::mutex> lock(mutex);
+                summary.set_total(summary.total() + 1);
+                if (result.result().valid()) {
+                    summary.set_valid(summary.valid() + 1);
+                } else {
+                    summary.set_invalid(summary.invalid() + 1);
+                }
+                if (outcome == Outcome::kCached) {
+                    summary.set_cached(summary.cached() + 1);
+                } else if (outcome == Outcome::kDeadlineExceeded) {
+                    summary.set_timed_out(summary.timed_out() + 1);
+                }
+                finished.push_back(std::move(result));
+                progress.notify_all();
+            });
+            item = configservice::ValidateConfigsRequest();
+            ++index;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        reading = false;
+        progress.notify_all();
+    });
+
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            progress.wait(lock, [&] { return !finished.empty() || (!reading && in_flight == 0); });
+            if (finished.empty()) {
+                break;
+            }
+            auto result = std::move(finished.front());
+            finished.pop_front();
+
+            // After a failed write the rest are only counted off
+            bool skip = write_failed;
+            lock.unlock();
+            bool written = !skip && stream->Write(result);
+            lock.lock();
+            if (!skip && !written) {
+                write_failed = true;
+            }
+            --in_flight;
+            progress.notify_all();
+        }
+    }
+    reader.join();
+
+    auto elapsed = std::chrono::steady_clock::now() - start_time;
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    summary.set_total_bytes(total_bytes);
+    summary.set_duration_ms(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count());
+    summary.set_workers(static_cast<int32_t>(batch_pool_->size()));
+    if (seconds > 0) {
+        summary.set_configs_per_second(summary.total() / seconds);
+        summary.set_megabytes_per_second(total_bytes / (1024.0 * 1024.0) / seconds);
+    }
+
+    RecordTimer("validate_batch.duration", summary.duration_ms());
+    std::cout << "[ValidationService] ValidateConfigs: " << summary.total() << " configs ("
+              << summary.valid() << " valid, " << summary.invalid() << " invalid, "
+              << summary.cached() << " cached) in " << summary.duration_ms() << " ms, "
+              << static_cast<int64_t>(summary.configs_per_second()) << " configs/s" << std::endl;
+
+    if (context->IsCancelled() || write_failed) {
+        return grpc::Status(grpc::StatusCode::CANCELLED, "Batch cancelled by the client");
+    }
+
+    configservice::ValidateConfigsResponse last;
+    last.set_index(-1);
+    *last.mutable_summary() = summary;
+    stream->Write(last);
+    return grpc::Status::OK;
+}
+
+grpc::Status ValidationServiceImpl::RegisterSchema(
+    grpc::ServerContext* context, const configservice::RegisterSchemaRequest* request,
+    configservice::RegisterSchemaResponse* response) {
+    std::cout << "[ValidationService] RegisterSchema: id=" << request->schema_id() << std::endl;
+    RecordMetric("schema.register");
 
-            // Parse cached result (simplified - in production, use protobuf)
-            response->set_valid(cached == "valid");
-            response->set_message(cached == "valid" ? "Valid (cached)" : "Invalid (cached)");
+    if (request->schema_id().empty()) {
+        response->set_success(false);
+        response->set_message("schema_id is required");
+        return grpc::Status::OK;
+    }
+
+    // JSON Schemas are compiled up front so a broken one never reaches ValidateConfig
+    if (request->schema_type() == "json-schema") {
+        try {
+            CompiledSchema::Compile(request->schema_content());
+        } catch (const std::invalid_argument& e) {
+            response->set_success(false);
+            response->set_message(std::string("Invalid JSON Schema: ") + e.what());
+            RecordMetric("schema.register_failed");
             return grpc::Status::OK;
         }
-        RecordMetric("validate.cache_miss");
     }
 
+    configservice::ValidationSchema schema;
+    schema.set_schema_id(request->schema_id());
+    schema.set_service_name(request->service_name());
+    schema.set_schema_type(request->schema_type());
+    schema.set_schema_content(request->schema_content());
+    schema.set_description(request->description());
+    schema.set_created_by(request->created_by());
+    schema.set_created_at(std::time(nullptr));
+    schema.set_is_active(true);
+
+    auto [success, message] = db_->RegisterSchema(schema);
+
+    response->set_success(success);
+    response->set_message(message);
+    if (success) {
+        response->set_schema_id(request->schema_id());
+        schema_cache_->Invalidate(request->schema_id());
+        RecordMetric("schema.register_success");
+    } else {
+        RecordMetric("schema.register_failed");
+    }
+
+    return grpc::Status::OK;
+}
+
+grpc::Status ValidationServiceImpl::GetSchema(grpc::ServerContext* context,
+                                              const configservice::GetSchemaRequest* request,
+                                              configservice::GetSchemaResponse* response) {
+    std::cout << "[ValidationService] GetSchema: id=" << request->schema_id() << std::endl;
+    RecordMetric("schema.get");
+
+    auto schema = db_->GetSchema(request->schema_id());
+
+    if (!schema) {
+        response->set_success(false);
+        response->set_message("Failed to load schema: " + request->schema_id());
+        RecordMetric("schema.get_failed");
+    } else if (schema->schema_id().empty()) {
+        response->set_success(false);
+        response->set_message("Schema not found: " + request->schema_id());
+        RecordMetric("schema.not_found");
+    } else {
+        response->set_success(true);
+        *response->mutable_schema() = std::move(*schema);
+        RecordMetric("schema.get_success");
+    }
+
+    return grpc::Status::OK;
+}
+
+grpc::Status ValidationServiceImpl::ListSchemas(grpc::ServerContext* context,
+                                                const configservice::ListSchemasRequest* request,
+                                                configservice::ListSchemasResponse* response) {
+    std::cout << "[ValidationService] ListSchemas" << std::endl;
+    RecordMetric("schema.list");
+
+    int limit = request->limit() == 0 ? 50 : request->limit();
+    int offset = request->offset();
+    int total_count = 0;
+
+    auto schemas = db_->ListSchemas(request->service_name(), limit, offset, total_count);
+
+    for (const auto& schema : schemas) {
+        *response->add_schemas() = schema;
+    }
+
+    response->set_total_count(total_count);
+    RecordMetric("schema.list_success");
+
+    return grpc::Status::OK;
+}
+
+// ─────────────────────────────────────────────
+// Helper Methods
+// ─────────────────────────────────────────────
+
+bool ValidationServiceImpl::ValidateSize(const std::string& content,
+                                         std::vector<configservice::ValidationError>& errors) {
+    if (content.size() > config_.validation.max_config_size) {
+        configservice::ValidationError err;
+        err.set_error_type("size");
+        err.set_message("Configuration size " + std::to_string(content.size()) +
+                        " bytes exceeds maximum " +
+                        std::to_string(config_.validation.max_config_size) + " bytes");
+        errors.push_back(err);
+        return false;
+    }
+    return true;
+}
+
+ValidationServiceImpl::Outcome ValidationServiceImpl::Validate(
+    const configservice::ValidateConfigRequest& request, const ValidationInputs& inputs,
+    ValidationBudget& budget, configservice::ValidateConfigResponse* response) {
+    auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<configservice::ValidationError> errors;
+    std::vector<configservice::ValidationWarning> warnings;
+
     // 1. Validate size
-    if (!ValidateSize(request->content(), errors)) {
+    if (!ValidateSize(request.content(), errors)) {
         response->set_valid(false);
         response->set_message("Configuration exceeds maximum size");
         for (const auto& err : errors) {
             *response->add_errors() = err;
         }
         RecordMetric("validate.size_exceeded");
-        return grpc::Status::OK;
+        return Outcome::kValidated;
+    }
+
+    // Rules and schema are resolved by the caller: their versions are part of the cache key,
+    // and when either applies the syntax pass itself builds the document tree they are
+    // evaluated on, so the content is parsed exactly once
+    const auto& rules = inputs.rules;
+    const SchemaCache::Entry& schema = inputs.schema;
+    std::string format = request.format().empty() ? "json" : request.format();
+    if (!schema.error.empty()) {
+        configservice::ValidationWarning warn;
+        warn.set_warning_type("schema");
+        warn.set_message(schema.error);
+        warnings.push_back(warn);
+    }
+
+    // Check cache: the whole response, keyed by everything it depends on. Results computed
+    // while the rule set version is unknown or the schema could not be loaded are not cached.
+    std::string content_hash = ComputeHash(request.content());
+    std::string cache_key;
+    bool inputs_known = rules->version() >= 0 && !schema.load_failed;
+    if (config_.validation.enable_caching && inputs_known) {
+        cache_key =
+            ResultCache::Key(request, format, content_hash, schema.version, rules->version());
+        if (GetCachedResponse(cache_key, response)) {
+            std::cout << "[ValidationService] Cache hit: "
+                      << (response->valid() ? "VALID" : "INVALID") << std::endl;
+            RecordMetric("validate.cache_hit");
+            RecordTimer("validate.duration",
+                        std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - start_time)
+                            .count());
+            return Outcome::kCached;
+        }
+        RecordMetric("validate.cache_miss");
+    }
+
+    // Time spent waiting for rules, schemas or a batch worker counts against the budget
+    if (budget.Check()) {
+        return OverBudget(budget, "setup", errors, warnings, response);
     }
 
     // 2. Validate syntax based on format
-    std::string format = request->format().empty() ? "json" : request->format();
+    bool needs_document = schema.schema || !rules->empty();
     bool syntax_valid = false;
 
+    // Large YAML documents checked by rules alone are never built: the rules run on the
+    // parser's events and their errors are collected here
+    bool rules_streamed =
+        (format == "yaml" || format == "yml") && !schema.schema && !rules->empty() &&
+        request.content().size() >= config_.validation.yaml_stream_threshold_bytes;
+    std::vector<configservice::ValidationError> rule_errors;
+
+    // Large documents are kept, with what rules and schema found in them, as the base of a
+    // later version that then only re-checks what changed
+    std::shared_ptr<Baseline> baseline;
+    std::shared_ptr<const Baseline> base;
+    std::string baseline_key;
+    if (baseline_cache_ && needs_document && !rules_streamed && inputs_known) {
+        if (request.content().size() >= config_.validation.incremental_min_bytes) {
+            baseline = std::make_shared<Baseline>();
+            if (format == "json") {
+                baseline->content = request.content();
+            }
+            baseline_key = cache_key.empty() ? ResultCache::Key(request, format, content_hash,
+                                                                schema.version, rules->version())
+                                             : cache_key;
+        }
+        if (!request.base_content_hash().empty()) {
+            base = baseline_cache_->Get(ResultCache::Key(
+                request, format, request.base_content_hash(), schema.version, rules->version()));
+            RecordMetric(base ? "validate.incremental.base_hit" : "validate.incremental.base_miss");
+        }
+    }
+    jsonscan::Value scratch_document;
+    jsonscan::Value& document = baseline ? baseline->document : scratch_document;
+
     if (format == "json") {
-        syntax_valid = json_validator_->ValidateSyntax(request->content(), errors);
+        syntax_valid = needs_document
+                           ? json_validator_->Parse(request.content(), document, errors)
+                           : json_validator_->ValidateSyntax(request.content(), errors);
     } else if (format == "yaml" || format == "yml") {
-        syntax_valid = yaml_validator_->ValidateSyntax(request->content(), errors);
-
-        // Additional YAML structure validation
-        if (syntax_valid) {
-            yaml_validator_->ValidateStructure(request->content(), errors, warnings);
+        // One parse covers syntax, structure and common issues
+        if (rules_streamed) {
+            auto rules_start = std::chrono::steady_clock::now();
+            RuleStream stream(*rules, rule_errors, &budget);
+            syntax_valid =
+                yaml_validator_->Stream(request.content(), &stream, errors, warnings, &budget);
+            RecordMetric("validate.yaml.streamed");
+            RecordTimer("validate.yaml.stream.duration",
+                        std::chrono::duration_cast<std::chrono::milliseconds>(
+                            std::chrono::steady_clock::now() - rules_start)
+                            .count());
+        } else if (needs_document) {
+            syntax_valid =
+                yaml_validator_->Parse(request.content(), document, errors, warnings, &budget);
+        } else {
+            syntax_valid =
+                yaml_validator_->Stream(request.content(), nullptr, errors, warnings, &budget);
         }
+    } else if (format == "toml") {
+        syntax_valid = needs_document
+                           ? toml_validator_->Parse(request.content(), document, errors)
+                           : toml_validator_->ValidateSyntax(request.content(), errors);
     } else {
         configservice::ValidationError err;
         err.set_error_type("format");
@@ -147,6 +539,12 @@ grpc::Status ValidationServiceImpl::ValidateConfig(
         syntax_valid = false;
     }
 
+    // An interrupted parse is not a syntax error: report what was found before the stop
+    if (budget.Check()) {
+        errors.insert(errors.end(), rule_errors.begin(), rule_errors.end());
+        return OverBudget(budget, "syntax validation", errors, warnings, response);
+    }
+
     if (!syntax_valid) {
         response->set_valid(false);
         response->set_message("Syntax validation failed");
@@ -154,36 +552,66 @@ grpc::Status ValidationServiceImpl::ValidateConfig(
             *response->add_errors() = err;
         }
         RecordMetric("validate.syntax_failed");
+        CacheResponse(cache_key, *response);
 
         // Record in database
-        db_->RecordValidation(request->service_name(), request->content(), false, "syntax_error",
-                              "", "validation-service");
+        RecordHistory(request, content_hash, false, "syntax_error", "");
 
-        return grpc::Status::OK;
+        return Outcome::kValidated;
     }
 
+    // Against a base version, rules and schema only evaluate the changed subtrees and take
+    // the rest of their errors from the base. JSON documents are compared by their text;
+    // other trees are numbered to be compared node by node.
+    if ((baseline || base) && format != "json") {
+        AssignPositions(document);
+    }
+    std::shared_ptr<const DocumentDiff> diff;
+    if (base) {
+        auto diff_start = std::chrono::steady_clock::now();
+        diff = format == "json" ? std::make_shared<DocumentDiff>(document, request.content(),
+                                                                 base->document, base->content)
+                                : std::make_shared<DocumentDiff>(document, base->document);
+        RecordMetric("validate.incremental");
+        RecordTimer("validate.incremental.diff.duration",
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - diff_start)
+                        .count());
+    }
+    IncrementalPass rule_pass(baseline ? baseline->rules.get() : nullptr, diff,
+                              base ? base->rules : nullptr);
+    IncrementalPass schema_pass(baseline ? baseline->schema.get() : nullptr, diff,
+                                base ? base->schema : nullptr);
+    bool incremental = baseline || diff;
+
     // 3. Apply custom validation rules from database
-    if (!ApplyCustomRules(request->service_name(), request->content(), errors)) {
+    bool rules_passed =
+        rules_streamed
+            ? rule_errors.empty()
+            : rules->empty() || ApplyCustomRules(*rules, document, errors, budget,
+                                                 incremental ? &rule_pass : nullptr);
+    errors.insert(errors.end(), rule_errors.begin(), rule_errors.end());
+    if (budget.Check()) {
+        return OverBudget(budget, "custom rules", errors, warnings, response);
+    }
+    if (!rules_passed) {
         std::cout << "[ValidationService] Custom rule violations found" << std::endl;
         RecordMetric("validate.custom_rules_failed");
     }
 
     // 4. Schema validation (if schema_id provided)
-    if (!request->schema_id().empty()) {
-        auto schema = db_->GetSchema(request->schema_id());
-
-        if (!schema.schema_id().empty()) {
-            if (format == "json" && schema.schema_type() == "json-schema") {
-                if (!json_validator_->ValidateSchema(request->content(), schema.schema_content(),
-                                                     errors)) {
-                    RecordMetric("validate.schema_failed");
-                }
-            }
-        } else {
-            configservice::ValidationWarning warn;
-            warn.set_warning_type("schema");
-            warn.set_message("Schema not found: " + request->schema_id());
-            warnings.push_back(warn);
+    if (schema.schema) {
+        auto schema_start = std::chrono::steady_clock::now();
+        if (!json_validator_->ValidateSchema(document, *schema.schema, errors, &budget,
+                                             incremental ? &schema_pass : nullptr)) {
+            RecordMetric("validate.schema_failed");
+        }
+        RecordTimer("validate.schema.duration",
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - schema_start)
+                        .count());
+        if (budget.Check()) {
+            return OverBudget(budget, "schema validation", errors, warnings, response);
         }
     }
 
@@ -191,7 +619,7 @@ grpc::Status ValidationServiceImpl::ValidateConfig(
     bool valid = errors.empty();
 
     // In strict mode, warnings also cause failure
-    if (request->strict() && !warnings.empty()) {
+    if (request.strict() && !warnings.empty()) {
         valid = false;
         response->set_message("Validation failed in strict mode (has warnings)");
     }
@@ -214,9 +642,17 @@ grpc::Status ValidationServiceImpl::ValidateConfig(
         *response->add_warnings() = warn;
     }
 
-    // Cache result
-    if (config_.validation.enable_caching) {
-        CacheValidationResult(cache_key, valid ? "valid" : "invalid");
+    CacheResponse(cache_key, *response);
+
+    // A schema pass cut short at its error limit has no complete verdicts to offer
+    if (baseline && baseline->schema->errors.size() < CompiledSchema::kMaxErrors) {
+        baseline_cache_->Put(baseline_key, std::move(baseline));
+    }
+    if (diff) {
+        std::cout << "[ValidationService] Incremental: " << diff->ranges()
+                  << " unchanged ranges, "
+                  << rule_pass.replayed() + schema_pass.replayed() << " verdicts reused"
+                  << std::endl;
     }
 
     // Record validation in database
@@ -241,8 +677,7 @@ grpc::Status ValidationServiceImpl::ValidateConfig(
     }
     warnings_json << "]";
 
-    db_->RecordValidation(request->service_name(), request->content(), valid, errors_json.str(),
-                          warnings_json.str(), "validation-service");
+    RecordHistory(request, content_hash, valid, errors_json.str(), warnings_json.str());
 
     // Record timing
     auto end_time = std::chrono::steady_clock::now();
@@ -253,280 +688,165 @@ grpc::Status ValidationServiceImpl::ValidateConfig(
               << " (errors: " << errors.size() << ", warnings: " << warnings.size() << ")"
               << std::endl;
 
-    return grpc::Status::OK;
+    return Outcome::kValidated;
 }
 
-grpc::Status ValidationServiceImpl::RegisterSchema(
-    grpc::ServerContext* context, const configservice::RegisterSchemaRequest* request,
-    configservice::RegisterSchemaResponse* response) {
-    std::cout << "[ValidationService] RegisterSchema: id=" << request->schema_id() << std::endl;
-    RecordMetric("schema.register");
-
-    if (request->schema_id().empty()) {
-        response->set_success(false);
-        response->set_message("schema_id is required");
-        return grpc::Status::OK;
+ValidationBudget ValidationServiceImpl::MakeBudget(grpc::ServerContext* context) const {
+    auto deadline = ValidationBudget::Clock::time_point::max();
+    auto now = ValidationBudget::Clock::now();
+    if (config_.validation.timeout_seconds > 0) {
+        deadline = now + std::chrono::seconds(config_.validation.timeout_seconds);
     }
 
-    configservice::ValidationSchema schema;
-    schema.set_schema_id(request->schema_id());
-    schema.set_service_name(request->service_name());
-    schema.set_schema_type(request->schema_type());
-    schema.set_schema_content(request->schema_content());
-    schema.set_description(request->description());
-    schema.set_created_by(request->created_by());
-    schema.set_created_at(std::time(nullptr));
-    schema.set_is_active(true);
-
-    auto [success, message] = db_->RegisterSchema(schema);
-
-    response->set_success(success);
-    response->set_message(message);
-    if (success) {
-        response->set_schema_id(request->schema_id());
-        RecordMetric("schema.register_success");
-    } else {
-        RecordMetric("schema.register_failed");
+    // Past the client's own deadline nobody is waiting for the answer
+    auto client_deadline = context->deadline();
+    if (client_deadline != std::chrono::system_clock::time_point::max()) {
+        auto remaining = std::chrono::duration_cast<ValidationBudget::Clock::duration>(
+            client_deadline - std::chrono::system_clock::now());
+        deadline = std::min(deadline, now + remaining);
     }
 
-    return grpc::Status::OK;
+    return ValidationBudget(deadline, [context] { return context->IsCancelled(); });
 }
 
-grpc::Status ValidationServiceImpl::GetSchema(grpc::ServerContext* context,
-                                              const configservice::GetSchemaRequest* request,
-                                              configservice::GetSchemaResponse* response) {
-    std::cout << "[ValidationService] GetSchema: id=" << request->schema_id() << std::endl;
-    RecordMetric("schema.get");
-
-    auto schema = db_->GetSchema(request->schema_id());
-
-    if (schema.schema_id().empty()) {
-        response->set_success(false);
-        response->set_message("Schema not found: " + request->schema_id());
-        RecordMetric("schema.not_found");
-    } else {
-        response->set_success(true);
-        *response->mutable_schema() = schema;
-        RecordMetric("schema.get_success");
+ValidationServiceImpl::Outcome ValidationServiceImpl::OverBudget(
+    const ValidationBudget& budget, const std::string& stage,
+    const std::vector<configservice::ValidationError>& errors,
+    const std::vector<configservice::ValidationWarning>& warnings,
+    configservice::ValidateConfigResponse* response) {
+    bool cancelled = budget.state() == ValidationBudget::State::kCancelled;
+
+    configservice::ValidationError stopped;
+    stopped.set_error_type(cancelled ? "cancelled" : "timeout");
+    stopped.set_message((cancelled ? "Cancelled by the client during "
+                                   : "Time budget exceeded during ") +
+                        stage + " after " + std::to_string(budget.elapsed().count()) + " ms");
+
+    // Partial: never cached or recorded in history
+    response->set_valid(false);
+    response->set_message(cancelled ? "Validation cancelled"
+                                    : "Validation exceeded its time budget");
+    for (const auto& err : errors) {
+        *response->add_errors() = err;
+    }
+    *response->add_errors() = stopped;
+    for (const auto& warn : warnings) {
+        *response->add_warnings() = warn;
     }
 
-    return grpc::Status::OK;
+    RecordMetric(cancelled ? "validate.cancelled" : "validate.deadline_exceeded");
+    std::cerr << "[ValidationService] ⚠ " << stopped.message() << std::endl;
+    return cancelled ? Outcome::kCancelled : Outcome::kDeadlineExceeded;
 }
 
-grpc::Status ValidationServiceImpl::ListSchemas(grpc::ServerContext* context,
-                                                const configservice::ListSchemasRequest* request,
-                                                configservice::ListSchemasResponse* response) {
-    std::cout << "[ValidationService] ListSchemas" << std::endl;
-    RecordMetric("schema.list");
-
-    int limit = request->limit() == 0 ? 50 : request->limit();
-    int offset = request->offset();
-    int total_count = 0;
-
-    auto schemas = db_->ListSchemas(request->service_name(), limit, offset, total_count);
-
-    for (const auto& schema : schemas) {
-        *response->add_schemas() = schema;
+std::shared_ptr<const CompiledRuleSet> ValidationServiceImpl::LoadRules(
+    const std::string& service_name) {
+    bool reloaded = false;
+    auto rules = rule_cache_->Get(
+        service_name, [&] { return db_->GetRuleSetVersion(service_name); },
+        [&] { return db_->GetRulesForService(service_name); }, &reloaded);
+
+    if (reloaded) {
+        RecordMetric("rules.reload");
+        std::cout << "[ValidationService] Compiled " << rules->rule_count() << " custom rules for "
+                  << service_name << " (version " << rules->version() << ")" << std::endl;
+        for (const auto& skipped : rules->skipped()) {
+            std::cerr << "[ValidationService] ⚠ Skipping rule " << skipped << std::endl;
+        }
     }
-
-    response->set_total_count(total_count);
-    RecordMetric("schema.list_success");
-
-    return grpc::Status::OK;
+    return rules;
 }
 
-// ─────────────────────────────────────────────
-// Helper Methods
-// ─────────────────────────────────────────────
+bool ValidationServiceImpl::ApplyCustomRules(const CompiledRuleSet& rules,
+                                             const jsonscan::Value& document,
+                                             std::vector<configservice::ValidationError>& errors,
+                                             ValidationBudget& budget,
+                                             IncrementalPass* incremental) {
+    auto start = std::chrono::steady_clock::now();
+    bool all_passed = rules.Evaluate(document, errors, &budget, incremental);
+
+    RecordTimer("rules.duration", std::chrono::duration_cast<std::chrono::milliseconds>(
+                                      std::chrono::steady_clock::now() - start)
+                                      .count());
+    return all_passed;
+}
 
-bool ValidationServiceImpl::ValidateSize(const std::string& content,
-                                         std::vector<configservice::ValidationError>& errors) {
-    if (content.size() > config_.validation.max_config_size) {
-        configservice::ValidationError err;
-        err.set_error_type("size");
-        err.set_message("Configuration size " + std::to_string(content.size()) +
-                        " bytes exceeds maximum " +
-                        std::to_string(config_.validation.max_config_size) + " bytes");
-        errors.push_back(err);
-        return false;
+SchemaCache::Entry ValidationServiceImpl::LoadSchema(const std::string& schema_id) {
+    bool loaded = false;
+    auto entry = schema_cache_->Get(schema_id, [this, &loaded](const std::string& id) {
+        loaded = true;
+        return db_->GetSchema(id);
+    });
+
+    RecordMetric(loaded ? "schema.cache_miss" : "schema.cache_hit");
+    if (loaded && entry.schema) {
+        std::cout << "[ValidationService] Compiled schema " << schema_id << " ("
+                  << entry.schema->node_count() << " nodes)" << std::endl;
     }
-    return true;
+    return entry;
 }
 
-bool ValidationServiceImpl::ApplyCustomRules(const std::string& service_name,
-                                             const std::string& content,
-                                             std::vector<configservice::ValidationError>& errors) {
-    auto rules = db_->GetRulesForService(service_name);
+bool ValidationServiceImpl::GetCachedResponse(const std::string& cache_key,
+                                              configservice::ValidateConfigResponse* response) {
+    if (auto cached = result_cache_->Get(cache_key)) {
+        response->CopyFrom(*cached);
+        RecordMetric("validate.cache_hit.local");
+        return true;
+    }
 
-    if (rules.empty()) {
-        return true;  // No custom rules defined
+    if (!redis_ctx_) {
+        return false;
     }
 
-    std::cout << "[ValidationService] Applying " << rules.size() << " custom rules for "
-              << service_name << std::endl;
+    std::string serialized;
+    {
+        std::lock_guard<std::mutex> lock(redis_mutex_);
 
-    bool all_passed = true;
+        redisReply* reply = (redisReply*)redisCommand(redis_ctx_, "GET validation:result:%s",
+                                                      cache_key.c_str());
 
-    // Helper: find a key in content (handles both JSON "key" and YAML key:)
-    auto findKey = [](const std::string& content, const std::string& key, size_t from) -> size_t {
-        // Try JSON format: "key"
-        std::string json_search = "\"" + key + "\"";
-        auto pos = content.find(json_search, from);
-        if (pos != std::string::npos) {
-            return pos;
-        }
-        // Try YAML format: key: (at start of line or after whitespace)
-        std::string yaml_key = key + ":";
-        pos = from;
-        while (pos < content.size()) {
-            pos = content.find(yaml_key, pos);
-            if (pos == std::string::npos) {
-                break;
-            }
-            // Verify it's at line start or preceded by whitespace
-            if (pos == 0 || content[pos - 1] == '\n' || content[pos - 1] == ' ' ||
-                content[pos - 1] == '\t') {
-                return pos;
-            }
-            pos += yaml_key.size();
+        if (!reply || reply->type != REDIS_REPLY_STRING) {
+            if (reply)
+                freeReplyObject(reply);
+            return false;
         }
-        return std::string::npos;
-    };
-
-    for (const auto& rule : rules) {
-        // Apply rule based on type
-        if (rule.rule_type == "required") {
-            // Check if field exists by walking dotted path
-            // For "database.host", verify "database" contains "host"
-            bool found = true;
-            std::string remaining = rule.field_path;
-            size_t search_from = 0;
-
-            while (!remaining.empty()) {
-                std::string key;
-                auto dot = remaining.find('.');
-                if (dot != std::string::npos) {
-                    key = remaining.substr(0, dot);
-                    remaining = remaining.substr(dot + 1);
-                } else {
-                    key = remaining;
-                    remaining.clear();
-                }
 
-                auto pos = findKey(content, key, search_from);
-                if (pos == std::string::npos) {
-                    found = false;
-                    break;
-                }
-                search_from = pos + key.size();
-            }
-
-            if (!found) {
-                configservice::ValidationError err;
-                err.set_field(rule.field_path);
-                err.set_error_type("required");
-                err.set_message(rule.error_message);
-                errors.push_back(err);
-                all_passed = false;
-            }
-        } else if (rule.rule_type == "range") {
-            // Parse rule_config to get min/max
-            // Simplified - in production, use JSON parser
-            // Example rule_config: {"min": 1, "max": 1000}
-
-            // Extract leaf key from dotted path
-            std::string leaf_key = rule.field_path;
-            auto last_dot = leaf_key.rfind('.');
-            if (last_dot != std::string::npos) {
-                leaf_key = leaf_key.substr(last_dot + 1);
-            }
-
-            size_t pos = findKey(content, leaf_key, 0);
-            if (pos != std::string::npos) {
-                size_t colon = content.find(":", pos);
-                // End delimiter: comma, brace (JSON) or newline (YAML)
-                size_t end = content.find_first_of(",}\n\r", colon + 1);
-
-                if (colon != std::string::npos && end != std::string::npos) {
-                    std::string value_str = content.substr(colon + 1, end - colon - 1);
-                    value_str.erase(0, value_str.find_first_not_of(" \t"));
-                    value_str.erase(value_str.find_last_not_of(" \t") + 1);
-
-                    // Parse min/max from rule_config
-                    int min_val = 0, max_val = INT_MAX;
-                    auto min_pos = rule.rule_config.find("\"min\"");
-                    auto max_pos = rule.rule_config.find("\"max\"");
-                    if (min_pos != std::string::npos) {
-                        auto c = rule.rule_config.find(":", min_pos);
-                        if (c != std::string::npos) {
-                            try {
-                                min_val = std::stoi(rule.rule_config.substr(c + 1));
-                            } catch (...) {
-                            }
-                        }
-                    }
-                    if (max_pos != std::string::npos) {
-                        auto c = rule.rule_config.find(":", max_pos);
-                        if (c != std::string::npos) {
-                            try {
-                                max_val = std::stoi(rule.rule_config.substr(c + 1));
-                            } catch (...) {
-                            }
-                        }
-                    }
-
-                    try {
-                        int value = std::stoi(value_str);
-                        if (value < min_val || value > max_val) {
-                            configservice::ValidationError err;
-                            err.set_field(rule.field_path);
-                            err.set_error_type("range");
-                            err.set_message(rule.error_message);
-                            errors.push_back(err);
-                            all_passed = false;
-                        }
-                    } catch (...) {
-                        // Invalid number
-                    }
-                }
-            }
-        }
+        serialized.assign(reply->str, reply->len);
+        freeReplyObject(reply);
     }
 
-    return all_passed;
-}
-
-std::string ValidationServiceImpl::GetCachedValidationResult(const std::string& cache_key) {
-    if (!redis_ctx_) {
-        return "";
+    auto cached = std::make_shared<configservice::ValidateConfigResponse>();
+    if (!cached->ParseFromString(serialized)) {
+        std::cerr << "[ValidationService] ⚠ Discarding unreadable cached result " << cache_key
+                  << std::endl;
+        return false;
     }
 
-    std::lock_guard<std::mutex> lock(redis_mutex_);
-
-    redisReply* reply = (redisReply*)redisCommand(redis_ctx_, "GET %s", cache_key.c_str());
+    response->CopyFrom(*cached);
+    result_cache_->Put(cache_key, std::move(cached));
+    RecordMetric("validate.cache_hit.redis");
+    return true;
+}
 
-    if (!reply || reply->type != REDIS_REPLY_STRING) {
-        if (reply)
-            freeReplyObject(reply);
-        return "";
+void ValidationServiceImpl::CacheResponse(const std::string& cache_key,
+                                          const configservice::ValidateConfigResponse& response) {
+    if (cache_key.empty()) {
+        return;
     }
 
-    std::string result(reply->str, reply->len);
-    freeReplyObject(reply);
-
-    return result;
-}
+    auto cached = std::make_shared<configservice::ValidateConfigResponse>(response);
+    std::string serialized = cached->SerializeAsString();
+    result_cache_->Put(cache_key, std::move(cached));
 
-void ValidationServiceImpl::CacheValidationResult(const std::string& cache_key,
-                                                  const std::string& result) {
     if (!redis_ctx_) {
         return;
     }
 
     std::lock_guard<std::mutex> lock(redis_mutex_);
 
-    redisReply* reply = (redisReply*)redisCommand(redis_ctx_, "SETEX %s %d %s", cache_key.c_str(),
-                                                  config_.redis.cache_ttl_seconds, result.c_str());
+    redisReply* reply = (redisReply*)redisCommand(
+        redis_ctx_, "SETEX validation:result:%s %d %b", cache_key.c_str(),
+        config_.redis.cache_ttl_seconds, serialized.data(), serialized.size());
     if (reply) {
         freeReplyObject(reply);
     }
@@ -544,13 +864,28 @@ void ValidationServiceImpl::RecordTimer(const std::string& metric, int milliseco
     }
 }
 
-std::string ValidationServiceImpl::ComputeHash(const std::string& content) {
-    std::hash<std::string> hasher;
-    size_t hash = hasher(content);
+void ValidationServiceImpl::RecordHistory(const configservice::ValidateConfigRequest& request,
+                                          const std::string& content_hash, bool valid,
+                                          const std::string& errors,
+                                          const std::string& warnings) {
+    switch (history_->Record(request.service_name(), request.content(), content_hash, valid,
+                             errors, warnings, "validation-service")) {
+        case HistoryRecorder::Outcome::kMerged:
+            RecordMetric("history.merged");
+            break;
+        case HistoryRecorder::Outcome::kSampledOut:
+            RecordMetric("history.sampled_out");
+            break;
+        case HistoryRecorder::Outcome::kDropped:
+            RecordMetric("history.dropped");
+            break;
+        default:
+            break;
+    }
+}
 
-    std::ostringstream oss;
-    oss << std::hex << hash;
-    return oss.str();
+std::string ValidationServiceImpl::ComputeHash(const std::string& content) {
+    return contenthash::Sha256Hex(content);
 }
 
 }  // namespace validationservice
\ No newline at end of file
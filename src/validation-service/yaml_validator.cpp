@@ -1,18 +1,462 @@
 #include "validation_service/yaml_validator.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <sstream>
+#include <streambuf>
+#include <unordered_map>
+#include <unordered_set>
+#include <yaml-cpp/eventhandler.h>
 #include <yaml-cpp/yaml.h>
 
 namespace validationservice {
 
+namespace {
+
+// Types a plain (unquoted) scalar the way YAML 1.2's core schema does
+void ConvertPlainScalar(const std::string& text, jsonscan::Value& value) {
+    using Type = jsonscan::Value::Type;
+
+    if (text.empty() || text == "~" || text == "null" || text == "Null" || text == "NULL") {
+        value.type = Type::kNull;
+        return;
+    }
+    if (text == "true" || text == "True" || text == "TRUE" || text == "false" ||
+        text == "False" || text == "FALSE") {
+        value.type = Type::kBool;
+        value.boolean = text[0] == 't' || text[0] == 'T';
+        return;
+    }
+
+    value.string = text;
+    const char* begin = text.c_str();
+    char* end = nullptr;
+
+    if (text.size() > 2 && text[0] == '0' && (text[1] == 'x' || text[1] == 'o')) {
+        long long number = std::strtoll(begin + 2, &end, text[1] == 'x' ? 16 : 8);
+        if (*end == '\0') {
+            value.type = Type::kNumber;
+            value.number = static_cast<double>(number);
+        } else {
+            value.type = Type::kString;
+        }
+        return;
+    }
+
+    std::string_view body(text);
+    if (body[0] == '+' || body[0] == '-') {
+        body.remove_prefix(1);
+    }
+    if (body == ".inf" || body == ".Inf" || body == ".INF") {
+        value.type = Type::kNumber;
+        value.number = text[0] == '-' ? -std::numeric_limits<double>::infinity()
+                                      : std::numeric_limits<double>::infinity();
+        return;
+    }
+    if (text == ".nan" || text == ".NaN" || text == ".NAN") {
+        value.type = Type::kNumber;
+        value.number = std::numeric_limits<double>::quiet_NaN();
+        return;
+    }
+
+    // strtod alone would also take hex floats, "inf" and "nan"
+    bool decimal = !body.empty() && body.find_first_not_of("0123456789.eE+-") == std::string::npos;
+    if (decimal) {
+        double number = std::strtod(begin, &end);
+        if (end != begin && *end == '\0') {
+            value.type = Type::kNumber;
+            value.number = number;
+            return;
+        }
+    }
+    value.type = Type::kString;
+}
+
+// Flow-style text of a key that is itself a map or sequence
+std::string KeyText(const jsonscan::Value& key) {
+    using Type = jsonscan::Value::Type;
+
+    switch (key.type) {
+        case Type::kObject: {
+            std::string text = "{";
+            for (const auto& [name, member] : key.members) {
+                text += (text.size() > 1 ? ", " : "") + name + ": " + KeyText(member);
+            }
+            return text + "}";
+        }
+        case Type::kArray: {
+            std::string text = "[";
+            for (const auto& item : key.items) {
+                text += (text.size() > 1 ? ", " : "") + KeyText(item);
+            }
+            return text + "]";
+        }
+        case Type::kBool:
+            return key.boolean ? "true" : "false";
+        case Type::kNull:
+            return "~";
+        default:
+            return key.string;  // Plain numbers keep their text
+    }
+}
+
+// Thrown out of the parser when the document must not be read any further
+struct ReadAborted {
+    std::string message;  // Empty when the budget ran out; the caller reports that
+    YAML::Mark mark;
+};
+
+// Receives yaml-cpp's parser events for one document. Depending on what it is given it builds
+// the jsonscan tree, forwards the document to a RuleStream, or just follows the structure
+// (root type, duplicate and complex keys). Anchored values are always kept, as a tree, so
+// aliases can be replayed; since every replay copies, their total size is capped, as is the
+// nesting depth aliases can reach.
+class DocumentReader : public YAML::EventHandler {
+   public:
+    DocumentReader(jsonscan::Value* document, RuleStream* rules, size_t max_depth,
+                   size_t max_alias_nodes, ValidationBudget* budget)
+        : document_(document),
+          rules_(rules),
+          max_depth_(max_depth),
+          max_alias_nodes_(max_alias_nodes),
+          budget_(budget) {}
+
+    bool has_root() const { return has_root_; }
+    jsonscan::Value::Type root_type() const { return root_type_; }
+    bool root_empty() const { return root_empty_; }
+    const std::vector<std::string>& duplicate_keys() const { return duplicate_keys_; }
+    const std::vector<std::string>& complex_keys() const { return complex_keys_; }
+
+    void OnDocumentStart(const YAML::Mark&) override {}
+    void OnDocumentEnd() override {}
+
+    void OnNull(const YAML::Mark& mark, YAML::anchor_t anchor) override {
+        CheckBudget(mark);
+        OnValue(jsonscan::Value(), "~", anchor);
+    }
+
+    void OnScalar(const YAML::Mark& mark, const std::string& tag, YAML::anchor_t anchor,
+                  const std::string& text) override {
+        CheckBudget(mark);
+        jsonscan::Value value;
+        if (tag == "?") {
+            ConvertPlainScalar(text, value);
+        } else {
+            value.type = jsonscan::Value::Type::kString;
+            value.string = text;
+        }
+        OnValue(std::move(value), text, anchor);
+    }
+
+    void OnAlias(const YAML::Mark& mark, YAML::anchor_t anchor) override {
+        CheckBudget(mark);
+        auto it = anchors_.find(anchor);
+        if (it == anchors_.end()) {
+            OnValue(jsonscan::Value(), "~", 0);
+            return;
+        }
+
+        const Anchor& anchored = it->second;
+        alias_nodes_ += anchored.nodes;
+        if (alias_nodes_ > max_alias_nodes_) {
+            throw ReadAborted{"Aliases expand to more than " + std::to_string(max_alias_nodes_) +
+                                  " values",
+                              mark};
+        }
+        if (frames_.size() + anchored.depth > max_depth_) {
+            throw ReadAborted{DepthMessage(), mark};
+        }
+
+        const jsonscan::Value& value = anchored.value;
+        if (IsKey()) {
+            SetKey(KeyText(value));
+            return;
+        }
+        if (frames_.empty()) {
+            SetRoot(value.type);
+        }
+        if (Streaming()) {
+            rules_->Feed(value);
+        }
+        if (jsonscan::Value* slot = Slot()) {
+            *slot = value;
+        }
+        EndValue(anchored.nodes, anchored.depth);
+    }
+
+    void OnSequenceStart(const YAML::Mark& mark, const std::string&, YAML::anchor_t anchor,
+                         YAML::EmitterStyle::value) override {
+        CheckBudget(mark);
+        StartContainer(false, anchor, mark);
+    }
+
+    void OnMapStart(const YAML::Mark& mark, const std::string&, YAML::anchor_t anchor,
+                    YAML::EmitterStyle::value) override {
+        CheckBudget(mark);
+        StartContainer(true, anchor, mark);
+    }
+
+    void OnSequenceEnd() override { EndContainer(); }
+    void OnMapEnd() override { EndContainer(); }
+
+   private:
+    struct Frame {
+        bool map = false;
+        bool is_key = false;  // A map or sequence used as a key
+        YAML::anchor_t anchor = 0;
+        jsonscan::Value* value = nullptr;         // Being built, if anything is
+        std::unique_ptr<jsonscan::Value> owned;  // Keys and anchored values nobody else builds
+        bool expecting_key = true;
+        std::string key;
+        std::unordered_set<std::string> keys;
+        size_t index = 0;
+        size_t nodes = 1;  // Values in this container, itself included, aliases expanded
+        size_t depth = 1;  // Containers on the longest path down, itself included
+    };
+
+    // An anchored value with the size every alias to it adds
+    struct Anchor {
+        jsonscan::Value value;
+        size_t nodes = 1;
+        size_t depth = 0;
+    };
+
+    jsonscan::Value* document_;
+    RuleStream* rules_;
+    size_t max_depth_;
+    size_t max_alias_nodes_;
+    ValidationBudget* budget_;
+    size_t alias_nodes_ = 0;  // Values copied by alias replay so far
+    std::vector<Frame> frames_;
+    std::unordered_map<YAML::anchor_t, Anchor> anchors_;
+    size_t key_depth_ = 0;  // Open frames with is_key
+    bool has_root_ = false;
+    bool root_empty_ = false;
+    jsonscan::Value::Type root_type_ = jsonscan::Value::Type::kNull;
+    std::vector<std::string> duplicate_keys_;
+    std::vector<std::string> complex_keys_;
+
+    bool IsKey() const {
+        return !frames_.empty() && frames_.back().map && frames_.back().expecting_key;
+    }
+
+    void CheckBudget(const YAML::Mark& mark) {
+        if (budget_ && budget_->Exhausted()) {
+            throw ReadAborted{"", mark};
+        }
+    }
+
+    std::string DepthMessage() const {
+        return "Maximum nesting depth of " + std::to_string(max_depth_) + " exceeded";
+    }
+
+    // Rules only see the document itself, not what happens inside complex keys
+    bool Streaming() const { return rules_ && key_depth_ == 0; }
+
+    void SetRoot(jsonscan::Value::Type type) {
+        has_root_ = true;
+        root_type_ = type;
+    }
+
+    void OnValue(jsonscan::Value&& value, const std::string& text, YAML::anchor_t anchor) {
+        if (IsKey()) {
+            SetKey(text);
+        } else {
+            if (frames_.empty()) {
+                SetRoot(value.type);
+            }
+            if (Streaming()) {
+                rules_->Scalar(value);
+            }
+            if (jsonscan::Value* slot = Slot()) {
+                if (anchor) {
+                    *slot = value;
+                } else {
+                    *slot = std::move(value);
+                }
+            }
+            EndValue(1, 0);
+        }
+        if (anchor) {
+            anchors_[anchor] = Anchor{std::move(value), 1, 0};
+        }
+    }
+
+    // Where the value starting now is built: in its parent, at the root, or nowhere
+    jsonscan::Value* Slot() {
+        if (frames_.empty()) {
+            return document_;
+        }
+        Frame& parent = frames_.back();
+        if (!parent.value) {
+            return nullptr;
+        }
+        if (parent.map) {
+            parent.value->members.emplace_back(parent.key, jsonscan::Value());
+            return &parent.value->members.back().second;
+        }
+        parent.value->items.emplace_back();
+        return &parent.value->items.back();
+    }
+
+    void SetKey(const std::string& key) {
+        Frame& frame = frames_.back();
+        if (!frame.keys.insert(key).second) {
+            duplicate_keys_.push_back(Path(key));
+        }
+        frame.key = key;
+        frame.expecting_key = false;
+        if (Streaming()) {
+            rules_->Key(key);
+        }
+    }
+
+    // A value of the given size is complete inside the innermost container
+    void EndValue(size_t nodes, size_t depth) {
+        if (frames_.empty()) {
+            return;
+        }
+        Frame& parent = frames_.back();
+        parent.nodes += nodes;
+        parent.depth = std::max(parent.depth, depth + 1);
+        if (parent.map) {
+            parent.expecting_key = true;
+        } else {
+            ++parent.index;
+        }
+    }
+
+    void StartContainer(bool map, YAML::anchor_t anchor, const YAML::Mark& mark) {
+        if (frames_.size() >= max_depth_) {
+            throw ReadAborted{DepthMessage(), mark};
+        }
+
+        Frame frame;
+        frame.map = map;
+        frame.anchor = anchor;
+        frame.is_key = IsKey();
+
+        if (frame.is_key) {
+            ++key_depth_;
+        } else {
+            if (frames_.empty()) {
+                SetRoot(map ? jsonscan::Value::Type::kObject : jsonscan::Value::Type::kArray);
+            }
+            if (Streaming()) {
+                map ? rules_->StartObject() : rules_->StartArray();
+            }
+            frame.value = Slot();
+        }
+        if (!frame.value && (frame.is_key || anchor)) {
+            frame.owned = std::make_unique<jsonscan::Value>();
+            frame.value = frame.owned.get();
+        }
+        if (frame.value) {
+            frame.value->type =
+                map ? jsonscan::Value::Type::kObject : jsonscan::Value::Type::kArray;
+        }
+        frames_.push_back(std::move(frame));
+    }
+
+    void EndContainer() {
+        Frame frame = std::move(frames_.back());
+        frames_.pop_back();
+
+        if (frame.is_key) {
+            --key_depth_;
+            std::string key = KeyText(*frame.value);
+            complex_keys_.push_back(Path(key));
+            SetKey(key);
+        } else {
+            if (Streaming()) {
+                rules_->End();
+            }
+            if (frames_.empty()) {
+                root_empty_ = frame.map ? frame.keys.empty() : frame.index == 0;
+            }
+            EndValue(frame.nodes, frame.depth);
+        }
+        if (frame.anchor) {
+            anchors_[frame.anchor] = Anchor{
+                frame.owned ? std::move(*frame.owned) : *frame.value, frame.nodes, frame.depth};
+        }
+    }
+
+    // "servers[2].host" for key inside the innermost map
+    std::string Path(const std::string& key) const {
+        std::string path;
+        for (size_t i = 0; i + 1 < frames_.size(); ++i) {
+            const Frame& frame = frames_[i];
+            if (frame.map) {
+                path += (path.empty() ? "" : ".") + frame.key;
+            } else {
+                path += "[" + std::to_string(frame.index) + "]";
+            }
+        }
+        return path + (path.empty() ? "" : ".") + key;
+    }
+};
+
+// Read-only std::istream source over the request content, without copying it
+class ContentBuffer : public std::streambuf {
+   public:
+    explicit ContentBuffer(const std::string& content) {
+        char* begin = const_cast<char*>(content.data());
+        setg(begin, begin, begin + content.size());
+    }
+};
+
+}  // anonymous namespace
+
+YamlValidator::YamlValidator(size_t max_depth, size_t max_alias_nodes)
+    : max_depth_(max_depth), max_alias_nodes_(max_alias_nodes) {}
+
 bool YamlValidator::ValidateSyntax(const std::string& content,
-                                   std::vector<configservice::ValidationError>& errors) {
+                                   std::vector<configservice::ValidationError>& errors,
+                                   ValidationBudget* budget) {
+    return Read(content, nullptr, nullptr, errors, nullptr, budget);
+}
+
+bool YamlValidator::Parse(const std::string& content, jsonscan::Value& document,
+                          std::vector<configservice::ValidationError>& errors,
+                          std::vector<configservice::ValidationWarning>& warnings,
+                          ValidationBudget* budget) {
+    document = jsonscan::Value();
+    return Read(content, &document, nullptr, errors, &warnings, budget);
+}
+
+bool YamlValidator::Stream(const std::string& content, RuleStream* rules,
+                           std::vector<configservice::ValidationError>& errors,
+                           std::vector<configservice::ValidationWarning>& warnings,
+                           ValidationBudget* budget) {
+    return Read(content, nullptr, rules, errors, &warnings, budget);
+}
+
+bool YamlValidator::Read(const std::string& content, jsonscan::Value* document,
+                         RuleStream* rules, std::vector<configservice::ValidationError>& errors,
+                         std::vector<configservice::ValidationWarning>* warnings,
+                         ValidationBudget* budget) {
+    DocumentReader reader(document, rules, max_depth_, max_alias_nodes_, budget);
     try {
-        YAML::Node config = YAML::Load(content);
+        ContentBuffer buffer(content);
+        std::istream stream(&buffer);
+        YAML::Parser parser(stream);
+        parser.HandleNextDocument(reader);
 
-        // Successfully parsed
-        return true;
+    } catch (const ReadAborted& e) {
+        if (!e.message.empty()) {
+            std::ostringstream oss;
+            oss << e.message << " at line " << (e.mark.line + 1) << ", column "
+                << (e.mark.column + 1);
+            AddError(errors, "", "limit", oss.str(), e.mark.line + 1);
+        }
+        if (document) {
+            *document = jsonscan::Value();
+        }
+        return false;
 
     } catch (const YAML::ParserException& e) {
         std::ostringstream oss;
@@ -26,34 +470,31 @@ bool YamlValidator::ValidateSyntax(const std::string& content,
         AddError(errors, "", "syntax", std::string("YAML error: ") + e.what());
         return false;
     }
-}
-
-bool YamlValidator::ValidateStructure(const std::string& content,
-                                      std::vector<configservice::ValidationError>& errors,
-                                      std::vector<configservice::ValidationWarning>& warnings) {
-    try {
-        YAML::Node config = YAML::Load(content);
-
-        // Check if root is a map (most configs should be)
-        if (!config.IsMap() && !config.IsSequence()) {
-            AddError(errors, "", "structure", "Root node must be a map or sequence, got scalar");
-            return false;
-        }
 
-        // Check for empty config
-        if (config.IsNull() || (config.IsMap() && config.size() == 0)) {
-            AddWarning(warnings, "", "empty", "Configuration is empty");
-        }
-
-        // Recursively check for common issues
-        CheckCommonIssues(content, warnings);
+    if (!warnings) {
+        return true;
+    }
 
-        return errors.empty();
+    // Structure: most configs should be a map
+    using Type = jsonscan::Value::Type;
+    if (!reader.has_root() || reader.root_type() == Type::kNull) {
+        AddError(errors, "", "structure", "Root node must be a map or sequence, got null");
+    } else if (reader.root_type() != Type::kObject && reader.root_type() != Type::kArray) {
+        AddError(errors, "", "structure", "Root node must be a map or sequence, got scalar");
+    } else if (reader.root_type() == Type::kObject && reader.root_empty()) {
+        AddWarning(*warnings, "", "empty", "Configuration is empty");
+    }
 
-    } catch (const YAML::Exception& e) {
-        AddError(errors, "", "structure", std::string("Structure error: ") + e.what());
-        return false;
+    for (const auto& field : reader.duplicate_keys()) {
+        AddWarning(*warnings, field, "duplicate_key", "Duplicate key '" + field + "'");
+    }
+    for (const auto& field : reader.complex_keys()) {
+        AddWarning(*warnings, field, "complex_key",
+                   "Key '" + field + "' is a map or sequence and is compared as text");
     }
+
+    CheckCommonIssues(content, *warnings);
+    return true;
 }
 
 bool YamlValidator::CheckCommonIssues(const std::string& content,
@@ -92,17 +533,6 @@ bool YamlValidator::CheckCommonIssues(const std::string& content,
         }
     }
 
-    // Check for duplicate keys
-    try {
-        YAML::Node config = YAML::Load(content);
-
-        // This is a simplified check - yaml-cpp will catch obvious duplicates
-        // For deeper checking, we'd need to traverse the tree
-
-    } catch (const YAML::Exception& e) {
-        // Already caught by syntax validation
-    }
-
     return true;
 }
 